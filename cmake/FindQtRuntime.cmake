@@ -29,10 +29,10 @@ if(WITH_ORACLE)
   set(_ORACLE_NEEDED Concurrent Network Svg Widgets)
 endif()
 if(WITH_DBCONVERTER)
-  set(_DBCONVERTER_NEEDED Network Widgets)
+  set(_DBCONVERTER_NEEDED Concurrent Network Widgets)
 endif()
 if(TEST)
-  set(_TEST_NEEDED Widgets)
+  set(_TEST_NEEDED Concurrent Network Widgets)
 endif()
 
 set(REQUIRED_QT_COMPONENTS ${REQUIRED_QT_COMPONENTS} ${_SERVATRICE_NEEDED} ${_COCKATRICE_NEEDED} ${_ORACLE_NEEDED}
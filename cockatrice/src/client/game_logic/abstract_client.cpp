@@ -19,10 +19,12 @@
 #include "pb/event_user_message.pb.h"
 #include "pb/server_message.pb.h"
 
+#include <QDebug>
+#include <QThread>
 #include <google/protobuf/descriptor.h>
 
 AbstractClient::AbstractClient(QObject *parent)
-    : QObject(parent), nextCmdId(0), status(StatusDisconnected), serverSupportsPasswordHash(false)
+    : QObject(parent), nextCmdId(0), status(StatusDisconnected), lastSeqNum(0), serverSupportsPasswordHash(false)
 {
     qRegisterMetaType<QVariant>("QVariant");
     qRegisterMetaType<CommandContainer>("CommandContainer");
@@ -31,6 +33,9 @@ AbstractClient::AbstractClient(QObject *parent)
     qRegisterMetaType<ClientStatus>("ClientStatus");
     qRegisterMetaType<RoomEvent>("RoomEvent");
     qRegisterMetaType<GameEventContainer>("GameEventContainer");
+    qRegisterMetaType<RoomEventPtr>("RoomEventPtr");
+    qRegisterMetaType<GameEventContainerPtr>("GameEventContainerPtr");
+    qRegisterMetaType<ResponsePtr>("ResponsePtr");
     qRegisterMetaType<Event_ServerIdentification>("Event_ServerIdentification");
     qRegisterMetaType<Event_ConnectionClosed>("Event_ConnectionClosed");
     qRegisterMetaType<Event_ServerShutdown>("Event_ServerShutdown");
@@ -59,20 +64,38 @@ AbstractClient::~AbstractClient()
 {
 }
 
-void AbstractClient::processProtocolItem(const ServerMessage &item)
+void AbstractClient::processProtocolItem(ServerMessage &item)
 {
+    // Game events missed while the connection was down are replayed on resume; skip those already processed
+    if (item.has_seq_num()) {
+        if (item.seq_num() <= lastSeqNum)
+            return;
+        lastSeqNum = item.seq_num();
+    }
+
     switch (item.message_type()) {
         case ServerMessage::RESPONSE: {
-            const Response &response = item.response();
-            const int cmdId = response.cmd_id();
+            const int cmdId = item.response().cmd_id();
 
             PendingCommand *pend = pendingCommands.value(cmdId, 0);
             if (!pend)
                 return;
             pendingCommands.remove(cmdId);
 
-            pend->processResponse(response);
-            pend->deleteLater();
+            QThread *responseThread = pend->getResponseThread();
+            if (!responseThread || responseThread == QThread::currentThread()) {
+                pend->processResponse(item.response());
+                pend->deleteLater();
+                break;
+            }
+
+            // The receivers of the response live in the thread that sent the command. Handing the response over
+            // there instead of emitting it from here means it isn't copied for every receiver.
+            QSharedPointer<Response> response(new Response);
+            response->Swap(item.mutable_response());
+            pend->moveToThread(responseThread);
+            QMetaObject::invokeMethod(pend, "processQueuedResponse", Qt::QueuedConnection,
+                                      Q_ARG(ResponsePtr, response));
             break;
         }
         case ServerMessage::SESSION_EVENT: {
@@ -123,11 +146,34 @@ void AbstractClient::processProtocolItem(const ServerMessage &item)
             break;
         }
         case ServerMessage::GAME_EVENT_CONTAINER: {
-            emit gameEventContainerReceived(item.game_event_container());
+            QSharedPointer<GameEventContainer> cont(new GameEventContainer);
+            cont->Swap(item.mutable_game_event_container());
+            emit gameEventContainerReceived(cont);
             break;
         }
         case ServerMessage::ROOM_EVENT: {
-            emit roomEventReceived(item.room_event());
+            QSharedPointer<RoomEvent> event(new RoomEvent);
+            event->Swap(item.mutable_room_event());
+            emit roomEventReceived(event);
+            break;
+        }
+        case ServerMessage::FRAGMENT: {
+            const ServerMessage::Fragment &fragment = item.fragment();
+            QByteArray &buffer = incompleteMessages[fragment.message_id()];
+            buffer.append(fragment.data().data(), static_cast<int>(fragment.data().size()));
+            if (static_cast<quint32>(buffer.size()) < fragment.total_size())
+                break;
+
+            ServerMessage message;
+            const bool complete = static_cast<quint32>(buffer.size()) == fragment.total_size() &&
+                                  message.ParseFromArray(buffer.constData(), buffer.size());
+            incompleteMessages.remove(fragment.message_id());
+            // A fragmented message never contains fragments itself
+            if (!complete || message.message_type() == ServerMessage::FRAGMENT) {
+                qDebug() << "Dropping malformed fragmented message" << fragment.message_id();
+                break;
+            }
+            processProtocolItem(message);
             break;
         }
     }
@@ -149,6 +195,7 @@ void AbstractClient::sendCommand(const CommandContainer &cont)
 
 void AbstractClient::sendCommand(PendingCommand *pend)
 {
+    pend->setResponseThread(pend->thread());
     pend->moveToThread(thread());
     emit sigQueuePendingCommand(pend);
 }
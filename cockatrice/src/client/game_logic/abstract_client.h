@@ -4,8 +4,10 @@
 #include "pb/response.pb.h"
 #include "pb/serverinfo_user.pb.h"
 
+#include <QHash>
 #include <QMutex>
 #include <QObject>
+#include <QSharedPointer>
 #include <QVariant>
 
 class PendingCommand;
@@ -28,6 +30,11 @@ class Event_ServerShutdown;
 class Event_ReplayAdded;
 class FeatureSet;
 
+// Room events and game events are moved out of the message they arrived in and shared with the gui thread, they can
+// be large and would otherwise be copied when crossing threads
+typedef QSharedPointer<const RoomEvent> RoomEventPtr;
+typedef QSharedPointer<const GameEventContainer> GameEventContainerPtr;
+
 enum ClientStatus
 {
     StatusDisconnected,
@@ -41,6 +48,7 @@ enum ClientStatus
     StatusSubmitForgotPasswordReset,
     StatusSubmitForgotPasswordChallenge,
     StatusGettingPasswordSalt,
+    StatusResuming,
 };
 
 class AbstractClient : public QObject
@@ -50,9 +58,9 @@ signals:
     void statusChanged(ClientStatus _status);
 
     // Room events
-    void roomEventReceived(const RoomEvent &event);
+    void roomEventReceived(const RoomEventPtr &event);
     // Game events
-    void gameEventContainerReceived(const GameEventContainer &event);
+    void gameEventContainerReceived(const GameEventContainerPtr &event);
     // Session events
     void serverIdentificationEventReceived(const Event_ServerIdentification &event);
     void connectionClosedEventReceived(const Event_ConnectionClosed &event);
@@ -83,10 +91,13 @@ private:
 private slots:
     void queuePendingCommand(PendingCommand *pend);
 protected slots:
-    void processProtocolItem(const ServerMessage &item);
+    // Takes the events and responses out of item
+    void processProtocolItem(ServerMessage &item);
 
 protected:
     QMap<int, PendingCommand *> pendingCommands;
+    QHash<quint32, QByteArray> incompleteMessages; // message id -> fragments received so far
+    quint64 lastSeqNum;                            // last numbered game event received in this session
     QString userName, password, email, country, realName, token;
     bool serverSupportsPasswordHash;
     void setStatus(ClientStatus _status);
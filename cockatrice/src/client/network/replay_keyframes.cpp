@@ -0,0 +1,42 @@
+#include "replay_keyframes.h"
+
+ReplayKeyframes::ReplayKeyframes(int _eventInterval, int _timeIntervalMs)
+    : eventInterval(_eventInterval), timeIntervalMs(_timeIntervalMs)
+{
+}
+
+bool ReplayKeyframes::isDue(int eventIndex, int eventTime) const
+{
+    if (eventIndex <= 0) {
+        // rewinding to the start is just as fast without a snapshot
+        return false;
+    }
+
+    const Keyframe *previous = closest(eventIndex);
+    if (!previous) {
+        return eventIndex >= eventInterval || eventTime >= timeIntervalMs;
+    }
+    if (previous->eventIndex == eventIndex) {
+        return false;
+    }
+    return eventIndex - previous->eventIndex >= eventInterval || eventTime - previous->eventTime >= timeIntervalMs;
+}
+
+void ReplayKeyframes::insert(const Keyframe &keyframe)
+{
+    keyframes.insert(keyframe.eventIndex, keyframe);
+}
+
+const ReplayKeyframes::Keyframe *ReplayKeyframes::closest(int eventIndex) const
+{
+    auto it = keyframes.upperBound(eventIndex);
+    if (it == keyframes.constBegin()) {
+        return nullptr;
+    }
+    return &(--it).value();
+}
+
+void ReplayKeyframes::clear()
+{
+    keyframes.clear();
+}
@@ -0,0 +1,50 @@
+#ifndef REPLAY_KEYFRAMES_H
+#define REPLAY_KEYFRAMES_H
+
+#include "pb/event_game_state_changed.pb.h"
+
+#include <QMap>
+
+/**
+ * Snapshots of the game state taken while a replay plays, so that seeking backwards can restore the closest one and
+ * only apply the events after it instead of every event since the start of the game.
+ *
+ * The game state is kept as the Event_GameStateChanged a spectator joining at that point would have received.
+ */
+class ReplayKeyframes
+{
+public:
+    struct Keyframe
+    {
+        // index of the first event that isn't part of the snapshot yet
+        int eventIndex = 0;
+        int eventTime = 0;
+        Event_GameStateChanged state;
+        // the message log up to this point, see ChatView::truncateChat()
+        int logLength = 0;
+        bool logEvenNumber = true;
+    };
+
+    static constexpr int DEFAULT_EVENT_INTERVAL = 250;
+    static constexpr int DEFAULT_TIME_INTERVAL_MS = 60000;
+
+    explicit ReplayKeyframes(int _eventInterval = DEFAULT_EVENT_INTERVAL,
+                             int _timeIntervalMs = DEFAULT_TIME_INTERVAL_MS);
+
+    // True when enough events or time passed since the closest earlier keyframe that eventIndex should get one
+    bool isDue(int eventIndex, int eventTime) const;
+    void insert(const Keyframe &keyframe);
+    // The latest keyframe at or before eventIndex, nullptr if there is none
+    const Keyframe *closest(int eventIndex) const;
+    void clear();
+    int size() const
+    {
+        return keyframes.size();
+    }
+
+private:
+    int eventInterval, timeIntervalMs;
+    QMap<int, Keyframe> keyframes;
+};
+
+#endif
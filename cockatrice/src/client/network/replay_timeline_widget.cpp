@@ -4,6 +4,7 @@
 #include <QPainterPath>
 #include <QPalette>
 #include <QTimer>
+#include <algorithm>
 
 ReplayTimelineWidget::ReplayTimelineWidget(QWidget *parent)
     : QWidget(parent), maxBinValue(1), maxTime(1), timeScaleFactor(1.0), currentVisualTime(0), currentProcessedTime(0),
@@ -120,8 +121,11 @@ void ReplayTimelineWidget::processRewind()
     rewindBufferingTimer->stop();
 
     // process the rewind
+    const int targetEvent = static_cast<int>(
+        std::lower_bound(replayTimeline.constBegin(), replayTimeline.constEnd(), currentVisualTime) -
+        replayTimeline.constBegin());
     currentEvent = 0;
-    emit rewound();
+    emit rewound(targetEvent);
     processNewEvents(BACKWARD_SKIP);
 }
 
@@ -150,7 +154,23 @@ void ReplayTimelineWidget::processNewEvents(PlaybackMode playbackMode)
 {
     currentProcessedTime = currentVisualTime;
 
+    // skips => the events more than a big skip before the target aren't worth showing one by one
+    int hiddenEvents = 0;
+    if (playbackMode != NORMAL_PLAYBACK) {
+        hiddenEvents = static_cast<int>(std::lower_bound(replayTimeline.constBegin(), replayTimeline.constEnd(),
+                                                         currentProcessedTime - BIG_SKIP_MS) -
+                                        replayTimeline.constBegin());
+    }
+
     while ((currentEvent < replayTimeline.size()) && (replayTimeline[currentEvent] < currentProcessedTime)) {
+        if (currentEvent < hiddenEvents) {
+            const int previousEvent = currentEvent;
+            emit fastForward(hiddenEvents);
+            if (currentEvent != previousEvent) {
+                continue;
+            }
+        }
+
         Player::EventProcessingOptions options;
 
         // backwards skip => always skip reveal windows
@@ -16,7 +16,13 @@ class ReplayTimelineWidget : public QWidget
 signals:
     void processNextEvent(Player::EventProcessingOptions options);
     void replayFinished();
-    void rewound();
+    // Emitted with the events rewound to the start. Receivers restoring the game state up to some event before
+    // targetEvent move the timeline there with setCurrentEvent(), the events after it are then applied again.
+    void rewound(int targetEvent);
+    // Emitted before each event of a skip that is too far back to be shown. Receivers applying some of the events
+    // before targetEvent all at once move the timeline past them with setCurrentEvent(), the event at the current
+    // position is processed as usual otherwise.
+    void fastForward(int targetEvent);
 
 private:
     enum PlaybackMode
@@ -61,6 +67,10 @@ public:
     {
         return currentEvent;
     }
+    void setCurrentEvent(int _currentEvent)
+    {
+        currentEvent = _currentEvent;
+    }
 public slots:
     void startReplay();
     void stopReplay();
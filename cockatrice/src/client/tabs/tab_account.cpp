@@ -16,6 +16,7 @@
 
 #include <QHBoxLayout>
 #include <QPushButton>
+#include <QSet>
 #include <QVBoxLayout>
 
 TabUserLists::TabUserLists(TabSupervisor *_tabSupervisor,
@@ -41,12 +42,7 @@ TabUserLists::TabUserLists(TabSupervisor *_tabSupervisor,
     connect(client, &AbstractClient::addToListEventReceived, this, &TabUserLists::processAddToListEvent);
     connect(client, &AbstractClient::removeFromListEventReceived, this, &TabUserLists::processRemoveFromListEvent);
 
-    PendingCommand *pend = client->prepareSessionCommand(Command_ListUsers());
-    connect(pend,
-            static_cast<void (PendingCommand::*)(const Response &, const CommandContainer &, const QVariant &)>(
-                &PendingCommand::finished),
-            this, &TabUserLists::processListUsersResponse);
-    client->sendCommand(pend);
+    requestUserList();
 
     QVBoxLayout *vbox = new QVBoxLayout;
     vbox->addWidget(userInfoBox);
@@ -131,19 +127,40 @@ void TabUserLists::retranslateUi()
     userInfoBox->retranslateUi();
 }
 
+void TabUserLists::requestUserList()
+{
+    PendingCommand *pend = client->prepareSessionCommand(Command_ListUsers());
+    connect(pend,
+            static_cast<void (PendingCommand::*)(const Response &, const CommandContainer &, const QVariant &)>(
+                &PendingCommand::finished),
+            this, &TabUserLists::processListUsersResponse);
+    client->sendCommand(pend);
+}
+
 void TabUserLists::processListUsersResponse(const Response &response)
 {
     const Response_ListUsers &resp = response.GetExtension(Response_ListUsers::ext);
 
+    QSet<QString> onlineUsers;
     const int userListSize = resp.user_list_size();
     for (int i = 0; i < userListSize; ++i) {
         const ServerInfo_User &info = resp.user_list(i);
         const QString userName = QString::fromStdString(info.name());
+        onlineUsers.insert(userName);
         allUsersList->processUserInfo(info, true);
         ignoreList->setUserOnline(userName, true);
         buddyList->setUserOnline(userName, true);
     }
 
+    // Only differs from the list shown when refreshing after the session was resumed
+    for (const QString &userName : allUsersList->getUserNames()) {
+        if (!onlineUsers.contains(userName) && allUsersList->deleteUser(userName)) {
+            ignoreList->setUserOnline(userName, false);
+            buddyList->setUserOnline(userName, false);
+            emit userLeft(userName);
+        }
+    }
+
     allUsersList->sortItems();
     ignoreList->sortItems();
     buddyList->sortItems();
@@ -162,7 +179,7 @@ void TabUserLists::processUserJoinedEvent(const Event_UserJoined &event)
     ignoreList->sortItems();
     buddyList->sortItems();
 
-    if (buddyList->getUsers().keys().contains(userName))
+    if (buddyList->contains(userName))
         soundEngine->playSound("buddy_join");
 
     emit userJoined(info);
@@ -172,7 +189,7 @@ void TabUserLists::processUserLeftEvent(const Event_UserLeft &event)
 {
     QString userName = QString::fromStdString(event.name());
 
-    if (buddyList->getUsers().keys().contains(userName))
+    if (buddyList->contains(userName))
         soundEngine->playSound("buddy_leave");
 
     if (allUsersList->deleteUser(userName)) {
@@ -202,7 +219,7 @@ void TabUserLists::ignoreListReceived(const QList<ServerInfo_User> &_ignoreList)
 void TabUserLists::processAddToListEvent(const Event_AddToList &event)
 {
     const ServerInfo_User &info = event.user_info();
-    bool online = allUsersList->getUsers().contains(QString::fromStdString(info.name()));
+    bool online = allUsersList->contains(QString::fromStdString(info.name()));
     QString list = QString::fromStdString(event.list_name());
     UserList *userList = 0;
     if (list == "buddy")
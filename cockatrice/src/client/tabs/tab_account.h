@@ -51,6 +51,8 @@ public:
                  const ServerInfo_User &userInfo,
                  QWidget *parent = nullptr);
     void retranslateUi();
+    // Replaces the list of online users with a fresh snapshot from the server
+    void requestUserList();
     QString getTabText() const
     {
         return tr("Account");
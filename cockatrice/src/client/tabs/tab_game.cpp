@@ -12,15 +12,18 @@
 #include "../../game/cards/card_item.h"
 #include "../../game/game_scene.h"
 #include "../../game/game_view.h"
+#include "../../game/headless_game_state.h"
 #include "../../game/player/player.h"
 #include "../../game/player/player_list_widget.h"
 #include "../../game/zones/view_zone.h"
 #include "../../game/zones/view_zone_widget.h"
+#include "../../game/zones/zone_layout_batch.h"
 #include "../../main.h"
 #include "../../server/message_log_widget.h"
 #include "../../server/pending_command.h"
 #include "../../settings/cache_settings.h"
 #include "../game_logic/abstract_client.h"
+#include "../network/replay_keyframes.h"
 #include "../network/replay_timeline_widget.h"
 #include "../ui/line_edit_completer.h"
 #include "../ui/phases_toolbar.h"
@@ -398,7 +401,7 @@ TabGame::TabGame(TabSupervisor *_tabSupervisor, GameReplay *_replay)
     : Tab(_tabSupervisor), secondsElapsed(0), hostId(-1), localPlayerId(-1),
       isLocalGame(_tabSupervisor->getIsLocalGame()), spectator(true), judge(false), gameStateKnown(false),
       resuming(false), currentPhase(-1), activeCard(nullptr), gameClosed(false), replay(_replay), currentReplayStep(0),
-      sayLabel(nullptr), sayEdit(nullptr)
+      replayKeyframes(new ReplayKeyframes), sayLabel(nullptr), sayEdit(nullptr)
 {
     // THIS CTOR IS USED ON REPLAY
     gameInfo.CopyFrom(replay->game_info());
@@ -458,9 +461,9 @@ TabGame::TabGame(TabSupervisor *_tabSupervisor,
     : Tab(_tabSupervisor), clients(_clients), gameInfo(event.game_info()), roomGameTypes(_roomGameTypes),
       hostId(event.host_id()), localPlayerId(event.player_id()), isLocalGame(_tabSupervisor->getIsLocalGame()),
       spectator(event.spectator()), judge(event.judge()), gameStateKnown(false), resuming(event.resuming()),
-      currentPhase(-1), activeCard(nullptr), gameClosed(false), replay(nullptr), replayPlayButton(nullptr),
-      replayFastForwardButton(nullptr), aReplaySkipForward(nullptr), aReplaySkipBackward(nullptr),
-      aReplaySkipForwardBig(nullptr), aReplaySkipBackwardBig(nullptr), replayDock(nullptr)
+      currentPhase(-1), activeCard(nullptr), gameClosed(false), replay(nullptr), replayKeyframes(nullptr),
+      replayPlayButton(nullptr), replayFastForwardButton(nullptr), aReplaySkipForward(nullptr),
+      aReplaySkipBackward(nullptr), aReplaySkipForwardBig(nullptr), aReplaySkipBackwardBig(nullptr), replayDock(nullptr)
 {
     // THIS CTOR IS USED ON GAMES
     gameInfo.set_started(false);
@@ -517,6 +520,7 @@ void TabGame::emitUserEvent()
 TabGame::~TabGame()
 {
     delete replay;
+    delete replayKeyframes;
 
     QMapIterator<int, Player *> i(players);
     while (i.hasNext()) {
@@ -643,7 +647,42 @@ void TabGame::closeRequest()
 
 void TabGame::replayNextEvent(Player::EventProcessingOptions options)
 {
-    processGameEventContainer(replay->event_list(timelineWidget->getCurrentEvent()), nullptr, options);
+    const int eventIndex = timelineWidget->getCurrentEvent();
+    if (replayKeyframes->isDue(eventIndex, replayTimeline.at(eventIndex))) {
+        captureReplayKeyframe(eventIndex);
+    }
+    processGameEventContainer(replay->event_list(eventIndex), nullptr, options);
+}
+
+/**
+ * @brief The state of the game as shown, in the form a spectator joining now would receive it.
+ */
+Event_GameStateChanged TabGame::currentGameState() const
+{
+    Event_GameStateChanged state;
+    for (const Player *player : players) {
+        player->writePlayerInfo(state.add_player_list());
+    }
+    state.set_game_started(gameInfo.started());
+    state.set_active_player_id(activePlayer);
+    state.set_active_phase(currentPhase);
+    state.set_seconds_elapsed(secondsElapsed);
+    return state;
+}
+
+/**
+ * @brief Remembers the state of the game before the event at eventIndex, so rewinding can start from there.
+ */
+void TabGame::captureReplayKeyframe(int eventIndex)
+{
+    ReplayKeyframes::Keyframe keyframe;
+    keyframe.eventIndex = eventIndex;
+    keyframe.eventTime = replayTimeline.at(eventIndex);
+    keyframe.state = currentGameState();
+    keyframe.logLength = messageLog->getLength();
+    keyframe.logEvenNumber = messageLog->getEvenNumber();
+
+    replayKeyframes->insert(keyframe);
 }
 
 void TabGame::replayFinished()
@@ -667,14 +706,79 @@ void TabGame::replayFastForwardButtonToggled(bool checked)
 
 /**
  * @brief Handles everything that needs to be reset when doing a replay rewind.
+ *
+ * Restores the closest keyframe before targetEvent, so that only the events after it have to be applied again.
  */
-void TabGame::replayRewind()
+void TabGame::replayRewind(int targetEvent)
 {
-    // reset chat log
-    messageLog->clearChat();
-
     // reset phase markers
     setActivePhase(-1);
+
+    const ReplayKeyframes::Keyframe *keyframe = replayKeyframes->closest(targetEvent);
+    if (!keyframe) {
+        // reset chat log
+        messageLog->clearChat();
+        return;
+    }
+
+    messageLog->truncateChat(keyframe->logLength, keyframe->logEvenNumber);
+    restoreReplayState(keyframe->state);
+    timelineWidget->setCurrentEvent(keyframe->eventIndex);
+}
+
+/**
+ * @brief Applies the events up to targetEvent without showing them one by one.
+ *
+ * The events are folded into a HeadlessGameState, which is then shown in one go. Stops early at events that change
+ * who is in the game, the timeline processes those as usual and asks again afterwards.
+ */
+void TabGame::replayFastForward(int targetEvent)
+{
+    // below this many folded events, setting up the scene again takes longer than just applying them
+    const int minEventCount = 20;
+    const int firstEvent = timelineWidget->getCurrentEvent();
+    int foldedEnd = firstEvent;
+    while (foldedEnd < targetEvent && HeadlessGameState::canApply(replay->event_list(foldedEnd))) {
+        ++foldedEnd;
+    }
+    if (foldedEnd - firstEvent < minEventCount) {
+        return;
+    }
+
+    QSet<HeadlessGameState::ZoneKey> hiddenZones;
+    for (const Player *player : players) {
+        for (const CardZone *zone : player->getZones()) {
+            if (!zone->contentsKnown()) {
+                hiddenZones.insert(HeadlessGameState::ZoneKey(player->getId(), zone->getName()));
+            }
+        }
+    }
+    HeadlessGameState state(currentGameState(), hiddenZones, [](const QString &cardName) {
+        CardInfoPtr info = CardDatabaseManager::getInstance()->getCard(cardName);
+        return info ? info->getPowTough() : QString();
+    });
+
+    for (int eventIndex = firstEvent; eventIndex < foldedEnd; ++eventIndex) {
+        state.apply(replay->event_list(eventIndex));
+    }
+
+    restoreReplayState(state.getState());
+    messageLog->appendHtmlServerMessage(tr("%n event(s) skipped.", "", foldedEnd - firstEvent));
+    timelineWidget->setCurrentEvent(foldedEnd);
+}
+
+/**
+ * @brief Shows a game state that was put together during the replay, see replayRewind() and replayFastForward().
+ */
+void TabGame::restoreReplayState(const Event_GameStateChanged &state)
+{
+    ZoneLayoutBatch layoutBatch;
+    eventGameStateChanged(state, -1, GameEventContext());
+    for (const ServerInfo_Player &playerInfo : state.player_list()) {
+        playerListWidget->updatePlayerProperties(playerInfo.properties());
+    }
+    setActivePlayer(state.active_player_id());
+    setActivePhase(state.active_phase());
 }
 
 void TabGame::incrementGameTime()
@@ -896,6 +1000,8 @@ void TabGame::processGameEventContainer(const GameEventContainer &cont,
                                         Player::EventProcessingOptions options)
 {
     const GameEventContext &context = cont.context();
+    // lay out each zone once after all the events instead of after every card that moved
+    ZoneLayoutBatch layoutBatch;
     messageLog->containerProcessingStarted(context);
     const int eventListSize = cont.event_list_size();
     for (int i = 0; i < eventListSize; ++i) {
@@ -1766,6 +1872,7 @@ void TabGame::createReplayDock()
             SLOT(replayNextEvent(Player::EventProcessingOptions)));
     connect(timelineWidget, SIGNAL(replayFinished()), this, SLOT(replayFinished()));
     connect(timelineWidget, &ReplayTimelineWidget::rewound, this, &TabGame::replayRewind);
+    connect(timelineWidget, &ReplayTimelineWidget::fastForward, this, &TabGame::replayFastForward);
 
     // timeline skip shortcuts
     aReplaySkipForward = new QAction(timelineWidget);
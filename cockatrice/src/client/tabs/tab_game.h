@@ -28,6 +28,7 @@ class ZoneViewLayout;
 class ZoneViewWidget;
 class PhasesToolbar;
 class PlayerListWidget;
+class ReplayKeyframes;
 class ReplayTimelineWidget;
 class Response;
 class GameEventContainer;
@@ -146,6 +147,7 @@ private:
     GameReplay *replay;
     int currentReplayStep;
     QList<int> replayTimeline;
+    ReplayKeyframes *replayKeyframes;
     ReplayTimelineWidget *timelineWidget;
     QToolButton *replayPlayButton, *replayFastForwardButton;
     QAction *aReplaySkipForward, *aReplaySkipBackward, *aReplaySkipForwardBig, *aReplaySkipBackwardBig;
@@ -211,6 +213,9 @@ private:
     void createPlayAreaWidget(bool bReplay = false);
     void createDeckViewContainerWidget(bool bReplay = false);
     void createReplayDock();
+    Event_GameStateChanged currentGameState() const;
+    void captureReplayKeyframe(int eventIndex);
+    void restoreReplayState(const Event_GameStateChanged &state);
     QString getLeaveReason(Event_Leave::LeaveReason reason);
 signals:
     void gameClosing(TabGame *tab);
@@ -226,7 +231,8 @@ private slots:
     void replayFinished();
     void replayPlayButtonToggled(bool checked);
     void replayFastForwardButtonToggled(bool checked);
-    void replayRewind();
+    void replayRewind(int targetEvent);
+    void replayFastForward(int targetEvent);
 
     void incrementGameTime();
     void adminLockChanged(bool lock);
@@ -17,6 +17,7 @@
 #include <QApplication>
 #include <QDesktopServices>
 #include <QFileSystemModel>
+#include <QFutureWatcher>
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QHeaderView>
@@ -26,6 +27,7 @@
 #include <QTreeView>
 #include <QUrl>
 #include <QVBoxLayout>
+#include <QtConcurrent>
 
 TabReplays::TabReplays(TabSupervisor *_tabSupervisor, AbstractClient *_client) : Tab(_tabSupervisor), client(_client)
 {
@@ -149,6 +151,15 @@ TabReplays::TabReplays(TabSupervisor *_tabSupervisor, AbstractClient *_client) :
             SLOT(replayAddedEventReceived(const Event_ReplayAdded &)));
 }
 
+TabReplays::~TabReplays()
+{
+    // nobody is going to open these anymore, the parsing can't be stopped so wait for it to let go of the replay
+    for (QFutureWatcher<GameReplay *> *watcher : parsingReplays) {
+        watcher->waitForFinished();
+        delete watcher->result();
+    }
+}
+
 void TabReplays::retranslateUi()
 {
     leftGroupBox->setTitle(tr("Local file system"));
@@ -300,11 +311,20 @@ void TabReplays::openRemoteReplayFinished(const Response &r)
     if (r.response_code() != Response::RespOk)
         return;
 
-    const Response_ReplayDownload &resp = r.GetExtension(Response_ReplayDownload::ext);
-    GameReplay *replay = new GameReplay;
-    replay->ParseFromString(resp.replay_data());
-
-    emit openReplay(replay);
+    // long replays take a while to parse, don't block the gui for that
+    const std::string replayData = r.GetExtension(Response_ReplayDownload::ext).replay_data();
+    auto *watcher = new QFutureWatcher<GameReplay *>(this);
+    parsingReplays.append(watcher);
+    connect(watcher, &QFutureWatcher<GameReplay *>::finished, this, [this, watcher]() {
+        parsingReplays.removeOne(watcher);
+        emit openReplay(watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run([replayData]() {
+        GameReplay *replay = new GameReplay;
+        replay->ParseFromString(replayData);
+        return replay;
+    }));
 }
 
 void TabReplays::actDownload()
@@ -13,6 +13,7 @@ class RemoteReplayList_TreeWidget;
 class GameReplay;
 class Event_ReplayAdded;
 class CommandContainer;
+template <typename T> class QFutureWatcher;
 
 class TabReplays : public Tab
 {
@@ -28,6 +29,8 @@ private:
     QAction *aOpenLocalReplay, *aRenameLocal, *aNewLocalFolder, *aDeleteLocalReplay;
     QAction *aOpenReplaysFolder;
     QAction *aOpenRemoteReplay, *aDownload, *aKeep, *aDeleteRemoteReplay;
+    // Downloaded replays still being parsed, the replay of each is owned by the tab until it's opened
+    QList<QFutureWatcher<GameReplay *> *> parsingReplays;
 
     void downloadNodeAtIndex(const QModelIndex &curLeft, const QModelIndex &curRight);
 
@@ -59,6 +62,7 @@ signals:
 
 public:
     TabReplays(TabSupervisor *_tabSupervisor, AbstractClient *_client);
+    ~TabReplays() override;
     void retranslateUi();
     QString getTabText() const
     {
@@ -114,9 +114,7 @@ TabRoom::TabRoom(TabSupervisor *_tabSupervisor,
     }
     userList->sortItems();
 
-    const int gameListSize = info.game_list_size();
-    for (int i = 0; i < gameListSize; ++i)
-        gameSelector->processGameInfo(info.game_list(i));
+    gameSelector->processGameList(info.game_list());
 
     completer = new QCompleter(autocompleteUserList, sayEdit);
     completer->setCaseSensitivity(Qt::CaseInsensitive);
@@ -264,9 +262,7 @@ void TabRoom::processRoomEvent(const RoomEvent &event)
 
 void TabRoom::processListGamesEvent(const Event_ListGames &event)
 {
-    const int gameListSize = event.game_list_size();
-    for (int i = 0; i < gameListSize; ++i)
-        gameSelector->processGameInfo(event.game_list(i));
+    gameSelector->processGameList(event.game_list());
 }
 
 void TabRoom::processJoinRoomEvent(const Event_JoinRoom &event)
@@ -291,15 +287,15 @@ void TabRoom::processRoomSayEvent(const Event_RoomSay &event)
     QString senderName = QString::fromStdString(event.name());
     QString message = QString::fromStdString(event.message());
 
-    if (tabSupervisor->getUserListsTab()->getIgnoreList()->getUsers().contains(senderName))
+    if (tabSupervisor->getUserListsTab()->getIgnoreList()->contains(senderName))
         return;
 
-    UserListTWI *twi = userList->getUsers().value(senderName);
+    const ServerInfo_User *user = userList->getUser(senderName);
     UserLevelFlags userLevel;
     QString userPrivLevel;
-    if (twi) {
-        userLevel = UserLevelFlags(twi->getUserInfo().user_level());
-        userPrivLevel = QString::fromStdString(twi->getUserInfo().privlevel());
+    if (user) {
+        userLevel = UserLevelFlags(user->user_level());
+        userPrivLevel = QString::fromStdString(user->privlevel());
         if (SettingsCache::instance().getIgnoreUnregisteredUsers() &&
             !userLevel.testFlag(ServerInfo_User::IsRegistered))
             return;
@@ -47,6 +47,11 @@ RoomSelector::RoomSelector(AbstractClient *_client, QWidget *parent) : QGroupBox
     connect(client, SIGNAL(listRoomsEventReceived(const Event_ListRooms &)), this,
             SLOT(processListRoomsEvent(const Event_ListRooms &)));
     connect(roomList, SIGNAL(activated(const QModelIndex &)), this, SLOT(joinClicked()));
+    requestRoomList();
+}
+
+void RoomSelector::requestRoomList()
+{
     client->sendCommand(client->prepareSessionCommand(Command_ListRooms()));
 }
 
@@ -72,22 +77,27 @@ void RoomSelector::processListRoomsEvent(const Event_ListRooms &event)
     for (int i = 0; i < roomListSize; ++i) {
         const ServerInfo_Room &room = event.room_list(i);
 
+        QTreeWidgetItem *existing = nullptr;
         for (int j = 0; j < roomList->topLevelItemCount(); ++j) {
-            QTreeWidgetItem *twi = roomList->topLevelItem(j);
-            if (twi->data(0, Qt::UserRole).toInt() == room.room_id()) {
-                if (room.has_name())
-                    twi->setData(0, Qt::DisplayRole, QString::fromStdString(room.name()));
-                if (room.has_description())
-                    twi->setData(1, Qt::DisplayRole, QString::fromStdString(room.description()));
-                if (room.has_permissionlevel())
-                    twi->setData(2, Qt::DisplayRole, getRoomPermissionDisplay(room));
-                if (room.has_player_count())
-                    twi->setData(3, Qt::DisplayRole, room.player_count());
-                if (room.has_game_count())
-                    twi->setData(4, Qt::DisplayRole, room.game_count());
-                return;
+            if (roomList->topLevelItem(j)->data(0, Qt::UserRole).toInt() == room.room_id()) {
+                existing = roomList->topLevelItem(j);
+                break;
             }
         }
+        // A full list is received again after resuming a session, so keep going after an update
+        if (existing) {
+            if (room.has_name())
+                existing->setData(0, Qt::DisplayRole, QString::fromStdString(room.name()));
+            if (room.has_description())
+                existing->setData(1, Qt::DisplayRole, QString::fromStdString(room.description()));
+            if (room.has_permissionlevel())
+                existing->setData(2, Qt::DisplayRole, getRoomPermissionDisplay(room));
+            if (room.has_player_count())
+                existing->setData(3, Qt::DisplayRole, room.player_count());
+            if (room.has_game_count())
+                existing->setData(4, Qt::DisplayRole, room.game_count());
+            continue;
+        }
         QTreeWidgetItem *twi = new QTreeWidgetItem;
         twi->setData(0, Qt::UserRole, room.room_id());
         if (room.has_name())
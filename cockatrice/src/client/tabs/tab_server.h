@@ -36,6 +36,7 @@ signals:
 public:
     RoomSelector(AbstractClient *_client, QWidget *parent = nullptr);
     void retranslateUi();
+    void requestRoomList();
 };
 
 class TabServer : public Tab
@@ -45,8 +46,9 @@ signals:
     void roomJoined(const ServerInfo_Room &info, bool setCurrent);
 private slots:
     void processServerMessageEvent(const Event_ServerMessage &event);
-    void joinRoom(int id, bool setCurrent);
     void joinRoomFinished(const Response &resp, const CommandContainer &commandContainer, const QVariant &extraData);
+public slots:
+    void joinRoom(int id, bool setCurrent);
 
 private:
     AbstractClient *client;
@@ -57,6 +59,10 @@ private:
 public:
     TabServer(TabSupervisor *_tabSupervisor, AbstractClient *_client, QWidget *parent = nullptr);
     void retranslateUi();
+    void refreshRoomList()
+    {
+        roomSelector->requestRoomList();
+    }
     QString getTabText() const
     {
         return tr("Server");
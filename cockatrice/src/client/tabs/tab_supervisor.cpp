@@ -114,9 +114,10 @@ TabSupervisor::TabSupervisor(AbstractClient *_client, QWidget *parent)
 
     connect(this, SIGNAL(currentChanged(int)), this, SLOT(updateCurrent(int)));
 
-    connect(client, SIGNAL(roomEventReceived(const RoomEvent &)), this, SLOT(processRoomEvent(const RoomEvent &)));
-    connect(client, SIGNAL(gameEventContainerReceived(const GameEventContainer &)), this,
-            SLOT(processGameEventContainer(const GameEventContainer &)));
+    connect(client, SIGNAL(roomEventReceived(const RoomEventPtr &)), this,
+            SLOT(processRoomEvent(const RoomEventPtr &)));
+    connect(client, SIGNAL(gameEventContainerReceived(const GameEventContainerPtr &)), this,
+            SLOT(processGameEventContainer(const GameEventContainerPtr &)));
     connect(client, SIGNAL(gameJoinedEventReceived(const Event_GameJoined &)), this,
             SLOT(gameJoined(const Event_GameJoined &)));
     connect(client, SIGNAL(userMessageEventReceived(const Event_UserMessage &)), this,
@@ -272,8 +273,8 @@ void TabSupervisor::startLocal(const QList<AbstractClient *> &_clients)
     userInfo = new ServerInfo_User;
     localClients = _clients;
     for (int i = 0; i < localClients.size(); ++i)
-        connect(localClients[i], SIGNAL(gameEventContainerReceived(const GameEventContainer &)), this,
-                SLOT(processGameEventContainer(const GameEventContainer &)));
+        connect(localClients[i], SIGNAL(gameEventContainerReceived(const GameEventContainerPtr &)), this,
+                SLOT(processGameEventContainer(const GameEventContainerPtr &)));
     connect(localClients.first(), SIGNAL(gameJoinedEventReceived(const Event_GameJoined &)), this,
             SLOT(localGameJoined(const Event_GameJoined &)));
 }
@@ -418,6 +419,32 @@ void TabSupervisor::addRoomTab(const ServerInfo_Room &info, bool setCurrent)
         setCurrentWidget(tab);
 }
 
+/**
+ * The server only replays game events to a resumed session. Room and user lists are requested again, and the rooms
+ * are joined again to get their current games and users.
+ */
+void TabSupervisor::resumeSession()
+{
+    if (!tabServer)
+        return;
+
+    tabServer->refreshRoomList();
+    if (tabUserLists)
+        tabUserLists->requestUserList();
+
+    const QList<int> roomIds = roomTabs.keys();
+    for (TabRoom *room : roomTabs.values()) {
+        if (room == currentWidget())
+            emit setMenu();
+        removeTab(indexOf(room));
+        room->deleteLater();
+    }
+    roomTabs.clear();
+
+    for (int roomId : roomIds)
+        tabServer->joinRoom(roomId, false);
+}
+
 void TabSupervisor::roomLeft(TabRoom *tab)
 {
     if (tab == currentWidget())
@@ -451,9 +478,9 @@ TabMessage *TabSupervisor::addMessageTab(const QString &receiverName, bool focus
         return nullptr;
 
     ServerInfo_User otherUser;
-    UserListTWI *twi = tabUserLists->getAllUsersList()->getUsers().value(receiverName);
-    if (twi)
-        otherUser = twi->getUserInfo();
+    const ServerInfo_User *user = tabUserLists->getAllUsersList()->getUser(receiverName);
+    if (user)
+        otherUser = *user;
     else
         otherUser.set_name(receiverName.toStdString());
 
@@ -531,18 +558,18 @@ void TabSupervisor::updateTabText(Tab *tab, const QString &newTabText)
     setTabToolTip(idx, sanitizeHtml(newTabText));
 }
 
-void TabSupervisor::processRoomEvent(const RoomEvent &event)
+void TabSupervisor::processRoomEvent(const RoomEventPtr &event)
 {
-    TabRoom *tab = roomTabs.value(event.room_id(), 0);
+    TabRoom *tab = roomTabs.value(event->room_id(), 0);
     if (tab)
-        tab->processRoomEvent(event);
+        tab->processRoomEvent(*event);
 }
 
-void TabSupervisor::processGameEventContainer(const GameEventContainer &cont)
+void TabSupervisor::processGameEventContainer(const GameEventContainerPtr &cont)
 {
-    TabGame *tab = gameTabs.value(cont.game_id());
+    TabGame *tab = gameTabs.value(cont->game_id());
     if (tab)
-        tab->processGameEventContainer(cont, qobject_cast<AbstractClient *>(sender()), {});
+        tab->processGameEventContainer(*cont, qobject_cast<AbstractClient *>(sender()), {});
     else
         qDebug() << "gameEvent: invalid gameId";
 }
@@ -554,9 +581,9 @@ void TabSupervisor::processUserMessageEvent(const Event_UserMessage &event)
     if (!tab)
         tab = messageTabs.value(QString::fromStdString(event.receiver_name()));
     if (!tab) {
-        UserListTWI *twi = tabUserLists->getAllUsersList()->getUsers().value(senderName);
-        if (twi) {
-            UserLevelFlags userLevel = UserLevelFlags(twi->getUserInfo().user_level());
+        const ServerInfo_User *user = tabUserLists->getAllUsersList()->getUser(senderName);
+        if (user) {
+            UserLevelFlags userLevel = UserLevelFlags(user->user_level());
             if (SettingsCache::instance().getIgnoreUnregisteredUserMessages() &&
                 !userLevel.testFlag(ServerInfo_User::IsRegistered))
                 // Flags are additive, so reg/mod/admin are all IsRegistered
@@ -702,9 +729,7 @@ bool TabSupervisor::isUserBuddy(const QString &userName) const
         return false;
     if (!getUserListsTab()->getBuddyList())
         return false;
-    QMap<QString, UserListTWI *> buddyList = getUserListsTab()->getBuddyList()->getUsers();
-    bool senderIsBuddy = buddyList.contains(userName);
-    return senderIsBuddy;
+    return getUserListsTab()->getBuddyList()->contains(userName);
 }
 
 bool TabSupervisor::isUserIgnored(const QString &userName) const
@@ -713,9 +738,7 @@ bool TabSupervisor::isUserIgnored(const QString &userName) const
         return false;
     if (!getUserListsTab()->getIgnoreList())
         return false;
-    QMap<QString, UserListTWI *> buddyList = getUserListsTab()->getIgnoreList()->getUsers();
-    bool senderIsBuddy = buddyList.contains(userName);
-    return senderIsBuddy;
+    return getUserListsTab()->getIgnoreList()->contains(userName);
 }
 
 const ServerInfo_User *TabSupervisor::getOnlineUser(const QString &userName) const
@@ -724,17 +747,7 @@ const ServerInfo_User *TabSupervisor::getOnlineUser(const QString &userName) con
         return nullptr;
     if (!getUserListsTab()->getAllUsersList())
         return nullptr;
-    QMap<QString, UserListTWI *> userList = getUserListsTab()->getAllUsersList()->getUsers();
-    const QString &userNameToMatchLower = userName.toLower();
-    QMap<QString, UserListTWI *>::iterator i;
-
-    for (i = userList.begin(); i != userList.end(); ++i)
-        if (i.key().toLower() == userNameToMatchLower) {
-            const ServerInfo_User &_userInfo = i.value()->getUserInfo();
-            return &_userInfo;
-        }
-
-    return nullptr;
+    return getUserListsTab()->getAllUsersList()->getUser(userName, Qt::CaseInsensitive);
 };
 
 bool TabSupervisor::switchToGameTabIfAlreadyExists(const int gameId)
@@ -3,6 +3,7 @@
 
 #include "../../deck/deck_loader.h"
 #include "../../server/chat_view/user_list_proxy.h"
+#include "../game_logic/abstract_client.h"
 
 #include <QAbstractButton>
 #include <QCommonStyle>
@@ -11,7 +12,6 @@
 #include <QTabWidget>
 
 class QMenu;
-class AbstractClient;
 class Tab;
 class TabServer;
 class TabRoom;
@@ -23,8 +23,6 @@ class TabMessage;
 class TabUserLists;
 class TabDeckEditor;
 class TabLog;
-class RoomEvent;
-class GameEventContainer;
 class Event_GameJoined;
 class Event_UserMessage;
 class Event_NotifyUser;
@@ -132,6 +130,7 @@ public slots:
     TabDeckEditor *addDeckEditorTab(const DeckLoader *deckToOpen);
     void openReplay(GameReplay *replay);
     void maximizeMainWindow();
+    void resumeSession();
 private slots:
     void closeButtonPressed();
     void updateCurrent(int index);
@@ -149,8 +148,8 @@ private slots:
     void deckEditorClosed(TabDeckEditor *tab);
     void tabUserEvent(bool globalEvent);
     void updateTabText(Tab *tab, const QString &newTabText);
-    void processRoomEvent(const RoomEvent &event);
-    void processGameEventContainer(const GameEventContainer &cont);
+    void processRoomEvent(const RoomEventPtr &event);
+    void processGameEventContainer(const GameEventContainerPtr &cont);
     void processUserMessageEvent(const Event_UserMessage &event);
     void processNotifyUserEvent(const Event_NotifyUser &event);
 };
@@ -0,0 +1,85 @@
+#include "card_picture_scaler.h"
+
+#include "card_thumbnail_cache.h"
+
+#include <QtConcurrent>
+
+CardPictureScaler::CardPictureScaler(const QString &thumbnailCachePath, QObject *parent)
+    : QObject(parent), thumbnailCache(new CardThumbnailCache(thumbnailCachePath))
+{
+    // results are emitted from the pool, and handed out on the thread owning the scaler
+    connect(this, SIGNAL(jobFinished(const QString &, const QImage &, int)), this,
+            SLOT(publish(const QString &, const QImage &, int)), Qt::QueuedConnection);
+}
+
+CardPictureScaler::~CardPictureScaler()
+{
+    pool.waitForDone();
+    delete thumbnailCache;
+}
+
+void CardPictureScaler::scale(const QString &pixmapKey,
+                              const QString &sizeKey,
+                              const QSize &pixelSize,
+                              const QImage &source,
+                              const QString &cardName,
+                              const QString &sourcePath)
+{
+    if (pending.contains(sizeKey)) {
+        return;
+    }
+    pending.insert(sizeKey);
+
+    CardThumbnailCache *cache = thumbnailCache;
+    const int generation = cache->getGeneration();
+    QtConcurrent::run(&pool, [this, cache, pixmapKey, sizeKey, pixelSize, source, cardName, sourcePath, generation]() {
+        QImage result;
+        if (source.isNull()) {
+            result = cache->load(pixmapKey, pixelSize);
+        } else {
+            result = source.scaled(pixelSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            cache->store(pixmapKey, pixelSize, result, generation, cardName, sourcePath);
+        }
+        emit jobFinished(sizeKey, toPixmapFormat(result), generation);
+    });
+}
+
+void CardPictureScaler::publish(const QString &sizeKey, const QImage &image, int generation)
+{
+    if (generation != thumbnailCache->getGeneration() || !pending.remove(sizeKey)) {
+        return;
+    }
+    emit scaled(sizeKey, image);
+}
+
+void CardPictureScaler::clear()
+{
+    pending.clear();
+    thumbnailCache->clear();
+}
+
+void CardPictureScaler::invalidateCards(const QStringList &cardNames)
+{
+    pending.clear();
+    thumbnailCache->invalidateCards(cardNames);
+}
+
+void CardPictureScaler::saveThumbnails()
+{
+    thumbnailCache->saveIndex();
+}
+
+void CardPictureScaler::waitForDone()
+{
+    pool.waitForDone();
+}
+
+QImage CardPictureScaler::toPixmapFormat(const QImage &image)
+{
+    if (image.isNull()) {
+        return image;
+    }
+
+    const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32;
+    return image.format() == format ? image : image.convertToFormat(format);
+}
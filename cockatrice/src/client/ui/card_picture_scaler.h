@@ -0,0 +1,66 @@
+#ifndef CARD_PICTURE_SCALER_H
+#define CARD_PICTURE_SCALER_H
+
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QSize>
+#include <QStringList>
+#include <QThreadPool>
+
+class CardThumbnailCache;
+
+/**
+ * Scales card pictures to the sizes they are shown at on a thread pool, so painting never has to wait for a smooth
+ * scale. Every scaled picture is kept in a CardThumbnailCache, which is also where a picture is looked for first when
+ * the full size one isn't in memory.
+ */
+class CardPictureScaler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CardPictureScaler(const QString &thumbnailCachePath, QObject *parent = nullptr);
+    ~CardPictureScaler() override;
+
+    /**
+     * Scales source to pixelSize in the background, or looks for a thumbnail of that size if source is null.
+     * The result is announced with scaled(); a size that is already being worked on isn't scaled twice.
+     * The thumbnail remembers the card and the local picture file it was scaled from, so it can be dropped once that
+     * picture changes.
+     */
+    void scale(const QString &pixmapKey,
+               const QString &sizeKey,
+               const QSize &pixelSize,
+               const QImage &source,
+               const QString &cardName = QString(),
+               const QString &sourcePath = QString());
+    // Drops the results that are still being worked on and wipes the thumbnails
+    void clear();
+    // Drops the results that are still being worked on and the thumbnails of these cards
+    void invalidateCards(const QStringList &cardNames);
+    void saveThumbnails();
+    void waitForDone();
+
+    int getPendingCount() const
+    {
+        return pending.size();
+    }
+
+    // Converts to the format QPixmap stores images in, so turning it into a pixmap on the gui thread is only a copy
+    static QImage toPixmapFormat(const QImage &image);
+
+signals:
+    // A null image means there was no thumbnail of that size on disk
+    void scaled(const QString &sizeKey, const QImage &image);
+    void jobFinished(const QString &sizeKey, const QImage &image, int generation);
+
+private:
+    CardThumbnailCache *thumbnailCache;
+    QThreadPool pool;
+    QSet<QString> pending;
+
+private slots:
+    void publish(const QString &sizeKey, const QImage &image, int generation);
+};
+
+#endif
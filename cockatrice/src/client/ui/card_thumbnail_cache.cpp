@@ -0,0 +1,298 @@
+#include "card_thumbnail_cache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QSet>
+#include <algorithm>
+
+#define THUMBNAIL_INDEX_FILENAME "index.dat"
+#define THUMBNAIL_FILE_SUFFIX ".thumb"
+
+static const quint32 indexMagic = 0x43545443; // "CTTC"
+static const quint32 indexFormatVersion = 2;
+
+CardThumbnailCache::CardThumbnailCache(const QString &_path, qint64 _maxSizeInMB)
+    : path(_path), maxSize(_maxSizeInMB * 1024 * 1024), indexLoaded(false), indexDirty(false), generation(0),
+      nextFileId(0), totalSize(0)
+{
+}
+
+CardThumbnailCache::~CardThumbnailCache()
+{
+    saveIndex();
+}
+
+QString CardThumbnailCache::entryKey(const QString &pixmapKey, const QSize &size)
+{
+    return pixmapKey + QLatin1Char('@') + QString::number(size.width()) + QLatin1Char('x') +
+           QString::number(size.height());
+}
+
+QString CardThumbnailCache::filePath(quint32 fileId) const
+{
+    return path + "/" + QString::number(fileId) + THUMBNAIL_FILE_SUFFIX;
+}
+
+void CardThumbnailCache::ensureIndexLoaded()
+{
+    if (indexLoaded) {
+        return;
+    }
+    indexLoaded = true;
+
+    QFile file(path + "/" + THUMBNAIL_INDEX_FILENAME);
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream in(&file);
+        in.setVersion(QDataStream::Qt_5_8);
+        quint32 magic = 0, formatVersion = 0, count = 0;
+        in >> magic >> formatVersion;
+        if (magic == indexMagic && formatVersion == indexFormatVersion) {
+            in >> nextFileId >> count;
+            for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+                QString key;
+                Entry entry;
+                in >> key >> entry.fileId >> entry.bytes >> entry.lastUsed >> entry.cardName >> entry.sourcePath >>
+                    entry.sourceModified;
+                entries.insert(key, entry);
+                totalSize += entry.bytes;
+            }
+        }
+        if (in.status() != QDataStream::Ok) {
+            qDebug() << "[CardThumbnailCache] Dropping unreadable index" << file.fileName();
+            entries.clear();
+            totalSize = 0;
+        }
+    }
+
+    // thumbnails written after the index was last saved are unknown, don't let them pile up
+    QSet<quint32> knownFiles;
+    for (const Entry &entry : entries) {
+        knownFiles.insert(entry.fileId);
+    }
+    for (const QString &fileName : QDir(path).entryList({"*" THUMBNAIL_FILE_SUFFIX}, QDir::Files)) {
+        bool ok = false;
+        const quint32 fileId = fileName.left(fileName.indexOf('.')).toUInt(&ok);
+        if (!ok || !knownFiles.contains(fileId)) {
+            QFile::remove(path + "/" + fileName);
+        }
+        if (ok) {
+            nextFileId = qMax(nextFileId, fileId + 1);
+        }
+    }
+}
+
+// The modification time of a local picture, or -1 if it is gone
+static qint64 sourceModifiedTime(const QString &sourcePath)
+{
+    const QFileInfo info(sourcePath);
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+QImage CardThumbnailCache::load(const QString &pixmapKey, const QSize &size)
+{
+    const QString key = entryKey(pixmapKey, size);
+    quint32 fileId;
+    QString sourcePath;
+    qint64 sourceModified;
+    {
+        QMutexLocker locker(&mutex);
+        ensureIndexLoaded();
+        auto entry = entries.find(key);
+        if (entry == entries.end()) {
+            return {};
+        }
+        entry->lastUsed = QDateTime::currentSecsSinceEpoch();
+        indexDirty = true;
+        fileId = entry->fileId;
+        sourcePath = entry->sourcePath;
+        sourceModified = entry->sourceModified;
+    }
+
+    // a custom picture that was edited or replaced since, possibly while the client wasn't running
+    if (!sourcePath.isEmpty() && sourceModifiedTime(sourcePath) != sourceModified) {
+        QMutexLocker locker(&mutex);
+        remove(key, fileId);
+        return {};
+    }
+
+    QImage image;
+    QImageReader reader(filePath(fileId));
+    reader.setDecideFormatFromContent(true);
+    if (reader.read(&image)) {
+        return image;
+    }
+
+    // the file went missing or got corrupted
+    QMutexLocker locker(&mutex);
+    remove(key, fileId);
+    return {};
+}
+
+void CardThumbnailCache::remove(const QString &key, quint32 fileId)
+{
+    auto entry = entries.find(key);
+    if (entry != entries.end() && entry->fileId == fileId) {
+        totalSize -= entry->bytes;
+        entries.erase(entry);
+        indexDirty = true;
+        QFile::remove(filePath(fileId));
+    }
+}
+
+void CardThumbnailCache::store(const QString &pixmapKey,
+                               const QSize &size,
+                               const QImage &image,
+                               int _generation,
+                               const QString &cardName,
+                               const QString &sourcePath)
+{
+    if (image.isNull()) {
+        return;
+    }
+    const qint64 sourceModified = sourcePath.isEmpty() ? 0 : sourceModifiedTime(sourcePath);
+
+    quint32 fileId;
+    {
+        QMutexLocker locker(&mutex);
+        ensureIndexLoaded();
+        if (_generation != generation) {
+            return;
+        }
+        fileId = nextFileId++;
+        QDir().mkpath(path);
+    }
+
+    // photos compress a lot better as jpeg, but the jpeg plugin is optional
+    const QString fileName = filePath(fileId);
+    const bool saved = (!image.hasAlphaChannel() && image.save(fileName, "JPG", 90)) || image.save(fileName, "PNG");
+    if (!saved) {
+        qDebug() << "[CardThumbnailCache] Could not write" << fileName;
+        return;
+    }
+
+    QMutexLocker locker(&mutex);
+    if (_generation != generation) {
+        QFile::remove(fileName);
+        return;
+    }
+
+    const QString key = entryKey(pixmapKey, size);
+    auto previous = entries.find(key);
+    if (previous != entries.end()) {
+        totalSize -= previous->bytes;
+        QFile::remove(filePath(previous->fileId));
+    }
+    const qint64 bytes = QFileInfo(fileName).size();
+    entries.insert(key, {fileId, bytes, QDateTime::currentSecsSinceEpoch(), cardName, sourcePath, sourceModified});
+    totalSize += bytes;
+    indexDirty = true;
+    evict();
+}
+
+void CardThumbnailCache::evict()
+{
+    if (totalSize <= maxSize) {
+        return;
+    }
+
+    // drop the least recently used thumbnails until there is some room again, rather than one per store
+    QList<QPair<qint64, QString>> byLastUse;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        byLastUse << qMakePair(it.value().lastUsed, it.key());
+    }
+    std::sort(byLastUse.begin(), byLastUse.end());
+
+    const qint64 target = maxSize * 9 / 10;
+    for (const auto &lastUse : byLastUse) {
+        if (totalSize <= target) {
+            break;
+        }
+        const Entry entry = entries.take(lastUse.second);
+        QFile::remove(filePath(entry.fileId));
+        totalSize -= entry.bytes;
+    }
+}
+
+void CardThumbnailCache::invalidateCards(const QStringList &cardNames)
+{
+    const QSet<QString> names(cardNames.begin(), cardNames.end());
+    QMutexLocker locker(&mutex);
+    ensureIndexLoaded();
+    // thumbnails of these cards that are being scaled right now may be from the old picture
+    ++generation;
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (names.contains(it->cardName)) {
+            totalSize -= it->bytes;
+            QFile::remove(filePath(it->fileId));
+            it = entries.erase(it);
+            indexDirty = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void CardThumbnailCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    ++generation;
+    entries.clear();
+    totalSize = 0;
+    indexLoaded = true;
+    indexDirty = true;
+    for (const QString &fileName : QDir(path).entryList({"*" THUMBNAIL_FILE_SUFFIX}, QDir::Files)) {
+        QFile::remove(path + "/" + fileName);
+    }
+}
+
+void CardThumbnailCache::saveIndex()
+{
+    QMutexLocker locker(&mutex);
+    if (!indexDirty) {
+        return;
+    }
+
+    QDir().mkpath(path);
+    QSaveFile file(path + "/" + THUMBNAIL_INDEX_FILENAME);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "[CardThumbnailCache] Could not write" << file.fileName();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_8);
+    out << indexMagic << indexFormatVersion << nextFileId << static_cast<quint32>(entries.size());
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        out << it.key() << it.value().fileId << it.value().bytes << it.value().lastUsed << it.value().cardName
+            << it.value().sourcePath << it.value().sourceModified;
+    }
+    if (file.commit()) {
+        indexDirty = false;
+    }
+}
+
+int CardThumbnailCache::getGeneration() const
+{
+    QMutexLocker locker(&mutex);
+    return generation;
+}
+
+qint64 CardThumbnailCache::getSize()
+{
+    QMutexLocker locker(&mutex);
+    ensureIndexLoaded();
+    return totalSize;
+}
+
+int CardThumbnailCache::getCount()
+{
+    QMutexLocker locker(&mutex);
+    ensureIndexLoaded();
+    return entries.size();
+}
@@ -0,0 +1,77 @@
+#ifndef CARD_THUMBNAIL_CACHE_H
+#define CARD_THUMBNAIL_CACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+// In MB
+#define THUMBNAIL_CACHE_SIZE_DEFAULT 256
+
+/**
+ * On-disk cache of card pictures that were already scaled to the sizes they are shown at, so that after a restart the
+ * hand or the table doesn't have to decode and scale every full size picture again.
+ *
+ * Every thumbnail is a small image file; a compact index file maps the pixmap cache key and size of a card to it and
+ * remembers when it was last used, so the least recently used thumbnails can be dropped once the cache is full.
+ * Thread safe, thumbnails are meant to be read and written from worker threads.
+ */
+class CardThumbnailCache
+{
+public:
+    explicit CardThumbnailCache(const QString &_path, qint64 _maxSizeInMB = THUMBNAIL_CACHE_SIZE_DEFAULT);
+    ~CardThumbnailCache();
+
+    // Returns a null image if there is no thumbnail of that size, or if the local picture it was scaled from changed
+    QImage load(const QString &pixmapKey, const QSize &size);
+    /**
+     * Thumbnails scaled before the last clear() or invalidateCards() are dropped, pass the generation they were
+     * started in. sourcePath is the local picture file the thumbnail was scaled from, if any.
+     */
+    void store(const QString &pixmapKey,
+               const QSize &size,
+               const QImage &image,
+               int generation,
+               const QString &cardName = QString(),
+               const QString &sourcePath = QString());
+    // Drops the thumbnails of the cards with these (corrected) names, e.g. after their custom pictures changed
+    void invalidateCards(const QStringList &cardNames);
+    void clear();
+    void saveIndex();
+
+    int getGeneration() const;
+    qint64 getSize();
+    int getCount();
+
+private:
+    struct Entry
+    {
+        quint32 fileId;
+        qint64 bytes;
+        qint64 lastUsed;
+        QString cardName;
+        QString sourcePath;
+        qint64 sourceModified;
+    };
+
+    QString path;
+    qint64 maxSize;
+    mutable QMutex mutex;
+    bool indexLoaded, indexDirty;
+    int generation;
+    quint32 nextFileId;
+    qint64 totalSize;
+    // by "pixmap key@WxH"
+    QHash<QString, Entry> entries;
+
+    static QString entryKey(const QString &pixmapKey, const QSize &size);
+    QString filePath(quint32 fileId) const;
+    void ensureIndexLoaded();
+    void remove(const QString &key, quint32 fileId);
+    void evict();
+};
+
+#endif
@@ -1,5 +1,8 @@
 #include "line_edit_completer.h"
 
+#include "../../game/cards/card_database_manager.h"
+#include "../../game/cards/card_search_index.h"
+
 #include <QAbstractItemView>
 #include <QCompleter>
 #include <QFocusEvent>
@@ -9,8 +12,16 @@
 #include <QTextCursor>
 #include <QWidget>
 
+#define MAX_CARD_NAME_COMPLETIONS 50
+
 LineEditCompleter::LineEditCompleter(QWidget *parent) : LineEditUnfocusable(parent), c(nullptr)
 {
+    cardNames = new QStringListModel(this);
+    cardCompleter = new QCompleter(cardNames, this);
+    // the names are already looked up by prefix, they only have to be shown
+    cardCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    cardCompleter->setWidget(this);
+    connect(cardCompleter, SIGNAL(activated(QString)), this, SLOT(insertCardName(QString)));
 }
 
 void LineEditCompleter::focusOutEvent(QFocusEvent *e)
@@ -34,6 +45,19 @@ void LineEditCompleter::focusOutEvent(QFocusEvent *e)
 
 void LineEditCompleter::keyPressEvent(QKeyEvent *event)
 {
+    if (cardCompleter->popup()->isVisible()) {
+        switch (event->key()) {
+            case Qt::Key_Return:
+            case Qt::Key_Enter:
+            case Qt::Key_Tab:
+                // leave it to the completer, it activates the highlighted name
+                event->ignore();
+                return;
+            default:
+                break;
+        }
+    }
+
     switch (event->key()) {
         case Qt::Key_Return:
         case Qt::Key_Enter:
@@ -74,6 +98,10 @@ void LineEditCompleter::keyPressEvent(QKeyEvent *event)
     }
 
     LineEditUnfocusable::keyPressEvent(event);
+    if (completeCardName()) {
+        return;
+    }
+
     // return if the completer is null or if the most recently typed char was '@'.
     // Only want the popup AFTER typing the first char of the mention.
     if (!c || text().right(1).contains("@")) {
@@ -100,6 +128,55 @@ void LineEditCompleter::keyPressEvent(QKeyEvent *event)
     sm->setCurrentIndex(c->completionModel()->index(0, 0), QItemSelectionModel::NoUpdate);
 }
 
+int LineEditCompleter::cardLinkStart() const
+{
+    const QString beforeCursor = text().left(cursorPosition());
+    const int open = beforeCursor.lastIndexOf("[[");
+    if (open < 0 || beforeCursor.indexOf("]]", open) >= 0) {
+        return -1;
+    }
+    return open + 2;
+}
+
+bool LineEditCompleter::completeCardName()
+{
+    const int start = cardLinkStart();
+    const QString prefix = start < 0 ? QString() : text().mid(start, cursorPosition() - start);
+    const CardSearchIndexPtr searchIndex = CardDatabaseManager::getInstance()->getSearchIndex();
+    if (prefix.trimmed().isEmpty() || !searchIndex) {
+        cardCompleter->popup()->hide();
+        return start >= 0;
+    }
+
+    const QStringList names = searchIndex->namesWithPrefix(prefix, MAX_CARD_NAME_COMPLETIONS);
+    if (names.isEmpty()) {
+        cardCompleter->popup()->hide();
+        return true;
+    }
+
+    if (c) {
+        c->popup()->hide();
+    }
+    cardNames->setStringList(names);
+    QRect cr = cursorRect();
+    cr.setWidth(cardCompleter->popup()->sizeHintForColumn(0) +
+                cardCompleter->popup()->verticalScrollBar()->sizeHint().width());
+    cardCompleter->complete(cr);
+    cardCompleter->popup()->setCurrentIndex(cardCompleter->completionModel()->index(0, 0));
+    return true;
+}
+
+void LineEditCompleter::insertCardName(QString name)
+{
+    const int start = cardLinkStart();
+    if (start < 0) {
+        return;
+    }
+    const QString link = name + "]] ";
+    setText(text().replace(start, cursorPosition() - start, link));
+    setCursorPosition(start + link.length());
+}
+
 QString LineEditCompleter::cursorWord(const QString &line) const
 {
     return line.mid(line.left(cursorPosition()).lastIndexOf(" ") + 1,
@@ -7,14 +7,22 @@
 #include <QKeyEvent>
 #include <QStringList>
 
+class QStringListModel;
+
 class LineEditCompleter : public LineEditUnfocusable
 {
     Q_OBJECT
 private:
     QString cursorWord(const QString &line) const;
+    int cardLinkStart() const;
+    bool completeCardName();
     QCompleter *c;
+    // completes card names inside [[card links]], from the prefix index of the card database
+    QCompleter *cardCompleter;
+    QStringListModel *cardNames;
 private slots:
     void insertCompletion(QString);
+    void insertCardName(QString);
 
 protected:
     void keyPressEvent(QKeyEvent *event);
@@ -0,0 +1,210 @@
+#include "picture_download_scheduler.h"
+
+#include <QDebug>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QTimer>
+
+#define DEFAULT_MAX_RETRIES 3
+#define DEFAULT_RETRY_DELAY_MS 1000
+
+PictureDownloadScheduler::PictureDownloadScheduler(QNetworkAccessManager *_networkManager,
+                                                   int _maxConnectionsPerHost,
+                                                   QObject *parent)
+    : QObject(parent), networkManager(_networkManager), maxConnectionsPerHost(qMax(1, _maxConnectionsPerHost)),
+      maxRetries(DEFAULT_MAX_RETRIES), retryDelayMs(DEFAULT_RETRY_DELAY_MS)
+{
+}
+
+void PictureDownloadScheduler::enqueue(const QNetworkRequest &request, Priority priority)
+{
+    const QUrl url = request.url();
+    if (runningReplyFor(url) != nullptr || waitingForRetry.contains(url) || queueIndexOf(url) != -1) {
+        raisePriority(url, priority);
+        return;
+    }
+
+    insertIntoQueue({request, priority, 0});
+    startDownloads();
+}
+
+void PictureDownloadScheduler::raisePriority(const QUrl &url, Priority priority)
+{
+    // running downloads can't go any faster, but a retry should keep the raised priority
+    auto retrying = waitingForRetry.find(url);
+    if (retrying != waitingForRetry.end()) {
+        retrying->priority = qMax(retrying->priority, priority);
+        return;
+    }
+
+    const int index = queueIndexOf(url);
+    if (index == -1 || queue.at(index).priority >= priority) {
+        return;
+    }
+
+    Download download = queue.takeAt(index);
+    download.priority = priority;
+    insertIntoQueue(download);
+}
+
+void PictureDownloadScheduler::lowerPriority(const QUrl &url, Priority priority)
+{
+    auto retrying = waitingForRetry.find(url);
+    if (retrying != waitingForRetry.end()) {
+        retrying->priority = qMin(retrying->priority, priority);
+        return;
+    }
+
+    const int index = queueIndexOf(url);
+    if (index == -1 || queue.at(index).priority <= priority) {
+        return;
+    }
+
+    Download download = queue.takeAt(index);
+    download.priority = priority;
+    insertIntoQueue(download);
+}
+
+void PictureDownloadScheduler::cancel(const QUrl &url)
+{
+    const int index = queueIndexOf(url);
+    if (index != -1) {
+        queue.removeAt(index);
+    }
+    waitingForRetry.remove(url);
+
+    QNetworkReply *reply = runningReplyFor(url);
+    if (reply != nullptr) {
+        // forget the reply first, so replyFinished ignores the abort
+        running.remove(reply);
+        --connectionsPerHost[url.host()];
+        reply->abort();
+        reply->deleteLater();
+        startDownloads();
+    }
+}
+
+void PictureDownloadScheduler::setMaxConnectionsPerHost(int _maxConnectionsPerHost)
+{
+    maxConnectionsPerHost = qMax(1, _maxConnectionsPerHost);
+    startDownloads();
+}
+
+void PictureDownloadScheduler::setRetryPolicy(int _maxRetries, int _retryDelayMs)
+{
+    maxRetries = _maxRetries;
+    retryDelayMs = _retryDelayMs;
+}
+
+int PictureDownloadScheduler::queueIndexOf(const QUrl &url) const
+{
+    for (int i = 0; i < queue.size(); ++i) {
+        if (queue.at(i).request.url() == url) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QNetworkReply *PictureDownloadScheduler::runningReplyFor(const QUrl &url) const
+{
+    for (auto it = running.constBegin(); it != running.constEnd(); ++it) {
+        if (it.value().request.url() == url) {
+            return it.key();
+        }
+    }
+    return nullptr;
+}
+
+void PictureDownloadScheduler::insertIntoQueue(const Download &download)
+{
+    int index = queue.size();
+    while (index > 0 && queue.at(index - 1).priority < download.priority) {
+        --index;
+    }
+    queue.insert(index, download);
+}
+
+void PictureDownloadScheduler::startDownloads()
+{
+    for (int i = 0; i < queue.size();) {
+        const QString host = queue.at(i).request.url().host();
+        if (connectionsPerHost.value(host) >= maxConnectionsPerHost) {
+            // a download for another host may still be able to start
+            ++i;
+            continue;
+        }
+
+        const Download download = queue.takeAt(i);
+        ++connectionsPerHost[host];
+        QNetworkReply *reply = networkManager->get(download.request);
+        running.insert(reply, download);
+        connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    }
+}
+
+void PictureDownloadScheduler::retry(const QUrl &url)
+{
+    if (!waitingForRetry.contains(url)) {
+        // cancelled in the meantime
+        return;
+    }
+
+    insertIntoQueue(waitingForRetry.take(url));
+    startDownloads();
+}
+
+bool PictureDownloadScheduler::isTransientError(QNetworkReply *reply)
+{
+    // a broken cache entry won't fix itself by waiting
+    if (reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool()) {
+        return false;
+    }
+
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (statusCode == 429 || statusCode >= 500) {
+        return true;
+    }
+
+    switch (reply->error()) {
+        case QNetworkReply::RemoteHostClosedError:
+        case QNetworkReply::TimeoutError:
+        case QNetworkReply::OperationCanceledError: // what the transfer timeout of the network manager reports
+        case QNetworkReply::TemporaryNetworkFailureError:
+        case QNetworkReply::NetworkSessionFailedError:
+        case QNetworkReply::ProxyTimeoutError:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void PictureDownloadScheduler::replyFinished()
+{
+    auto *reply = qobject_cast<QNetworkReply *>(sender());
+    if (reply == nullptr) {
+        return;
+    }
+    if (!running.contains(reply)) {
+        // cancelled
+        return;
+    }
+
+    Download download = running.take(reply);
+    const QUrl url = download.request.url();
+    --connectionsPerHost[url.host()];
+
+    if (reply->error() != QNetworkReply::NoError && download.retries < maxRetries && isTransientError(reply)) {
+        const int delay = retryDelayMs * (1 << download.retries);
+        qDebug().nospace() << "PictureDownloadScheduler: retrying " << url.toDisplayString() << " in " << delay
+                           << "ms (" << reply->errorString() << ")";
+        ++download.retries;
+        waitingForRetry.insert(url, download);
+        QTimer::singleShot(delay, this, [this, url]() { retry(url); });
+    } else {
+        emit downloadFinished(url, reply);
+    }
+
+    reply->deleteLater();
+    startDownloads();
+}
@@ -0,0 +1,90 @@
+#ifndef PICTURE_DOWNLOAD_SCHEDULER_H
+#define PICTURE_DOWNLOAD_SCHEDULER_H
+
+#include <QHash>
+#include <QList>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QUrl>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+/**
+ * Runs the picture downloads, several of them at once.
+ *
+ * Queued downloads are started highest priority first, with at most maxConnectionsPerHost of them running against the
+ * same host. A url that is already queued or running is only downloaded once. Downloads that fail for a reason that
+ * might go away on its own (timeouts, overloaded servers, ...) are retried after a growing delay. Only to be used from
+ * the thread that owns it.
+ */
+class PictureDownloadScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum Priority
+    {
+        PriorityPrefetch, // cards of a deck that was just loaded
+        PriorityVisible,  // cards that are on screen
+        PriorityHovered   // the card the user is looking at
+    };
+
+    PictureDownloadScheduler(QNetworkAccessManager *_networkManager,
+                             int _maxConnectionsPerHost,
+                             QObject *parent = nullptr);
+
+    // Queues a download, or raises the priority of the download that is already queued for the url
+    void enqueue(const QNetworkRequest &request, Priority priority);
+    // Never lowers the priority of a download
+    void raisePriority(const QUrl &url, Priority priority);
+    // Never raises the priority of a download
+    void lowerPriority(const QUrl &url, Priority priority);
+    // Drops a queued download or aborts a running one; downloadFinished is not emitted for it
+    void cancel(const QUrl &url);
+
+    void setMaxConnectionsPerHost(int _maxConnectionsPerHost);
+    // The n-th retry of a download waits retryDelayMs * 2^(n-1)
+    void setRetryPolicy(int _maxRetries, int _retryDelayMs);
+
+    int getQueuedCount() const
+    {
+        return queue.size() + waitingForRetry.size();
+    }
+    int getRunningCount() const
+    {
+        return running.size();
+    }
+
+signals:
+    // Emitted once for every download, with its last reply. The reply is deleted after the signal was handled, so it
+    // has to be connected directly.
+    void downloadFinished(const QUrl &url, QNetworkReply *reply);
+
+private:
+    struct Download
+    {
+        QNetworkRequest request;
+        Priority priority;
+        int retries;
+    };
+
+    QNetworkAccessManager *networkManager;
+    int maxConnectionsPerHost, maxRetries, retryDelayMs;
+    // highest priority first, first come first served within a priority
+    QList<Download> queue;
+    QHash<QNetworkReply *, Download> running;
+    QHash<QUrl, Download> waitingForRetry;
+    QHash<QString, int> connectionsPerHost;
+
+    int queueIndexOf(const QUrl &url) const;
+    QNetworkReply *runningReplyFor(const QUrl &url) const;
+    void insertIntoQueue(const Download &download);
+    void startDownloads();
+    void retry(const QUrl &url);
+    static bool isTransientError(QNetworkReply *reply);
+
+private slots:
+    void replyFinished();
+};
+
+#endif
@@ -0,0 +1,223 @@
+#include "picture_file_index.h"
+
+#include <QDir>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QtConcurrent>
+
+#define DOWNLOADED_PICS_DIRECTORY "downloadedPics"
+
+// The names a picture can be looked up by: its file name and its name without the last or without any extensions
+static QStringList fileNameKeys(const QString &fileName, bool withBaseName)
+{
+    QStringList keys;
+    keys << fileName;
+    const int lastDot = fileName.lastIndexOf('.');
+    if (lastDot > 0)
+        keys << fileName.left(lastDot);
+    const int firstDot = fileName.indexOf('.');
+    if (withBaseName && firstDot > 0)
+        keys << fileName.left(firstDot);
+    keys.removeDuplicates();
+    return keys;
+}
+
+PictureFileIndex::PictureFileIndex(QObject *parent) : QObject(parent), scanPending(false), watcher(nullptr)
+{
+}
+
+void PictureFileIndex::reset(const QString &_customPicsPath, const QString &_picsPath)
+{
+    customPicsPath = QDir::cleanPath(_customPicsPath);
+    picsPath = QDir::cleanPath(_picsPath);
+
+    delete watcher;
+    watcher = nullptr;
+    directoryFiles.clear();
+    customPathsByName.clear();
+    pathsByDirectoryAndName.clear();
+
+    pendingScan = QtConcurrent::run(&PictureFileIndex::scan, customPicsPath, picsPath);
+    scanPending = true;
+}
+
+void PictureFileIndex::ensureScanned()
+{
+    if (!scanPending)
+        return;
+    scanPending = false;
+
+    // the watcher is created here rather than in reset(), as it has to live on the thread doing the lookups
+    const DirectoryListing listing = pendingScan.result();
+    for (auto it = listing.constBegin(); it != listing.constEnd(); ++it)
+        addDirectory(it.key(), it.value());
+
+    watcher = new QFileSystemWatcher(this);
+    connect(watcher, SIGNAL(directoryChanged(const QString &)), this, SLOT(directoryChanged(const QString &)));
+    if (!listing.isEmpty())
+        watcher->addPaths(listing.keys());
+}
+
+PictureFileIndex::DirectoryListing PictureFileIndex::scan(const QString &customPicsPath, const QString &picsPath)
+{
+    DirectoryListing listing;
+    if (!customPicsPath.isEmpty())
+        scanDirectory(customPicsPath, true, listing);
+
+    if (!picsPath.isEmpty()) {
+        // only the set directories, and the ones older versions downloaded pictures to
+        const QString downloadedPicsPath = picsPath + "/" + DOWNLOADED_PICS_DIRECTORY;
+        for (const QString &root : {picsPath, downloadedPicsPath}) {
+            scanDirectory(root, false, listing);
+            for (const QString &setDirectory : QDir(root).entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+                const QString path = root + "/" + setDirectory;
+                if (!listing.contains(path))
+                    scanDirectory(path, false, listing);
+            }
+        }
+    }
+
+    return listing;
+}
+
+void PictureFileIndex::scanDirectory(const QString &path, bool recursive, DirectoryListing &listing)
+{
+    QSet<QString> visited;
+    QStringList pending = {path};
+    while (!pending.isEmpty()) {
+        const QString current = pending.takeLast();
+        const QDir dir(current);
+        // symlinks are followed, so guard against loops
+        if (!dir.exists() || visited.contains(dir.canonicalPath()))
+            continue;
+        visited.insert(dir.canonicalPath());
+
+        listing.insert(current, dir.entryList(QDir::Files));
+        if (recursive) {
+            for (const QString &subDirectory : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+                pending << current + "/" + subDirectory;
+        }
+    }
+}
+
+bool PictureFileIndex::isCustomDirectory(const QString &path) const
+{
+    return !customPicsPath.isEmpty() && (path == customPicsPath || path.startsWith(customPicsPath + "/"));
+}
+
+void PictureFileIndex::addDirectory(const QString &path, const QStringList &fileNames)
+{
+    const bool custom = isCustomDirectory(path);
+    directoryFiles.insert(path, fileNames);
+    for (const QString &fileName : fileNames) {
+        const QString filePath = path + "/" + fileName;
+        for (const QString &key : fileNameKeys(fileName, false))
+            pathsByDirectoryAndName[path + "/" + key] << filePath;
+        if (custom) {
+            for (const QString &key : fileNameKeys(fileName, true))
+                customPathsByName[key] << filePath;
+        }
+    }
+}
+
+void PictureFileIndex::removeDirectory(const QString &path)
+{
+    const bool custom = isCustomDirectory(path);
+    const QStringList fileNames = directoryFiles.take(path);
+    for (const QString &fileName : fileNames) {
+        const QString filePath = path + "/" + fileName;
+        for (const QString &key : fileNameKeys(fileName, false)) {
+            QStringList &paths = pathsByDirectoryAndName[path + "/" + key];
+            paths.removeOne(filePath);
+            if (paths.isEmpty())
+                pathsByDirectoryAndName.remove(path + "/" + key);
+        }
+        if (custom) {
+            for (const QString &key : fileNameKeys(fileName, true)) {
+                QStringList &paths = customPathsByName[key];
+                paths.removeOne(filePath);
+                if (paths.isEmpty())
+                    customPathsByName.remove(key);
+            }
+        }
+    }
+}
+
+QStringList PictureFileIndex::customNames(const QString &path) const
+{
+    QStringList names;
+    for (const QString &fileName : directoryFiles.value(path))
+        names << fileNameKeys(fileName, true);
+    return names;
+}
+
+void PictureFileIndex::directoryChanged(const QString &path)
+{
+    // the watcher can't tell which file changed, so every picture in a changed custom directory counts as changed
+    const bool custom = isCustomDirectory(path);
+    QStringList changedNames;
+    if (custom)
+        changedNames << customNames(path);
+    removeDirectory(path);
+
+    const QDir dir(path);
+    if (!dir.exists()) {
+        for (const QString &indexed : directoryFiles.keys()) {
+            if (indexed.startsWith(path + "/")) {
+                if (custom)
+                    changedNames << customNames(indexed);
+                removeDirectory(indexed);
+            }
+        }
+        if (!changedNames.isEmpty())
+            emit customPicturesChanged(changedNames);
+        return;
+    }
+
+    addDirectory(path, dir.entryList(QDir::Files));
+    if (custom)
+        changedNames << customNames(path);
+
+    // pick up directories that were created since the scan
+    const bool setRoot = path == picsPath || path == picsPath + "/" + DOWNLOADED_PICS_DIRECTORY;
+    if (custom || setRoot) {
+        DirectoryListing added;
+        for (const QString &subDirectory : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+            const QString subPath = path + "/" + subDirectory;
+            if (!directoryFiles.contains(subPath) && (custom || !isCustomDirectory(subPath)))
+                scanDirectory(subPath, custom, added);
+        }
+        for (auto it = added.constBegin(); it != added.constEnd(); ++it) {
+            addDirectory(it.key(), it.value());
+            if (custom)
+                changedNames << customNames(it.key());
+        }
+        if (!added.isEmpty())
+            watcher->addPaths(added.keys());
+    }
+
+    if (!changedNames.isEmpty()) {
+        changedNames.removeDuplicates();
+        emit customPicturesChanged(changedNames);
+    }
+}
+
+QStringList PictureFileIndex::findCustomPictures(const QString &cardName)
+{
+    ensureScanned();
+    return customPathsByName.value(cardName);
+}
+
+QStringList PictureFileIndex::findSetPictures(const QString &setName, const QString &cardName)
+{
+    ensureScanned();
+    const QString setPath = picsPath + "/" + setName;
+    const QString downloadedSetPath = picsPath + "/" + DOWNLOADED_PICS_DIRECTORY + "/" + setName;
+
+    QStringList result;
+    for (const QString &directory : {setPath, downloadedSetPath}) {
+        for (const QString &suffix : {QString(), QString(".full"), QString(".xlhq")})
+            result << pathsByDirectoryAndName.value(directory + "/" + cardName + suffix);
+    }
+    return result;
+}
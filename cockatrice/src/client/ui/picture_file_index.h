@@ -0,0 +1,63 @@
+#ifndef PICTURE_FILE_INDEX_H
+#define PICTURE_FILE_INDEX_H
+
+#include <QFuture>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+
+class QFileSystemWatcher;
+
+/**
+ * Index of the picture files on disk, so looking up the pictures of a card doesn't touch the disk.
+ *
+ * Covers the whole custom pictures directory and the per set directories in the pictures directory. The initial scan
+ * runs in the background; afterwards the index is kept fresh with a QFileSystemWatcher. Only to be used from the
+ * thread that owns it.
+ */
+class PictureFileIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PictureFileIndex(QObject *parent = nullptr);
+
+    // Drops the index and starts scanning the given directories in the background
+    void reset(const QString &_customPicsPath, const QString &_picsPath);
+
+    // Pictures anywhere in the custom pictures directory named after the card, with or without extension
+    QStringList findCustomPictures(const QString &cardName);
+    // Pictures stored for a set in the pictures directory, in the order they should be tried
+    QStringList findSetPictures(const QString &setName, const QString &cardName);
+
+signals:
+    // Files in the custom pictures directory were added, removed or replaced; lists the names they are looked up by
+    void customPicturesChanged(const QStringList &cardNames);
+
+private:
+    // file names, indexed by the absolute path of their directory
+    typedef QHash<QString, QStringList> DirectoryListing;
+
+    QString customPicsPath, picsPath;
+    QFuture<DirectoryListing> pendingScan;
+    bool scanPending;
+    QFileSystemWatcher *watcher;
+
+    DirectoryListing directoryFiles;
+    // custom pictures by file name, complete base name and base name
+    QHash<QString, QStringList> customPathsByName;
+    // every indexed file by "directory/file name" and "directory/complete base name"
+    QHash<QString, QStringList> pathsByDirectoryAndName;
+
+    void ensureScanned();
+    static DirectoryListing scan(const QString &customPicsPath, const QString &picsPath);
+    static void scanDirectory(const QString &path, bool recursive, DirectoryListing &listing);
+    bool isCustomDirectory(const QString &path) const;
+    QStringList customNames(const QString &path) const;
+    void addDirectory(const QString &path, const QStringList &fileNames);
+    void removeDirectory(const QString &path);
+
+private slots:
+    void directoryChanged(const QString &path);
+};
+
+#endif
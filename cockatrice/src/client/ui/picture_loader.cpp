@@ -2,13 +2,13 @@
 
 #include "../../game/cards/card_database_manager.h"
 #include "../../settings/cache_settings.h"
+#include "card_picture_scaler.h"
+#include "picture_file_index.h"
 
 #include <QApplication>
 #include <QBuffer>
 #include <QCryptographicHash>
 #include <QDebug>
-#include <QDirIterator>
-#include <QFileInfo>
 #include <QImageReader>
 #include <QMovie>
 #include <QNetworkAccessManager>
@@ -27,9 +27,12 @@
 
 // never cache more than 300 cards at once for a single deck
 #define CACHED_CARD_PER_DECK_MAX 300
+// when more pictures than this are waiting to be scaled, e.g. because a whole board just appeared, don't spend any
+// time painting quick stand-ins for them
+#define QUICK_SCALE_PENDING_MAX 16
 
-PictureToLoad::PictureToLoad(CardInfoPtr _card)
-    : card(std::move(_card)), urlTemplates(SettingsCache::instance().downloads().getAllURLs())
+PictureToLoad::PictureToLoad(CardInfoPtr _card, PictureDownloadScheduler::Priority _priority)
+    : card(std::move(_card)), urlTemplates(SettingsCache::instance().downloads().getAllURLs()), priority(_priority)
 {
     if (card) {
         for (const auto &cardInfoPerSetList : card->getSets()) {
@@ -125,7 +128,7 @@ QStringList PictureLoaderWorker::md5Blacklist = QStringList() << "db0c48db407a90
 PictureLoaderWorker::PictureLoaderWorker()
     : QObject(nullptr), picsPath(SettingsCache::instance().getPicsPath()),
       customPicsPath(SettingsCache::instance().getCustomPicsPath()),
-      picDownload(SettingsCache::instance().getPicDownload()), downloadRunning(false), loadQueueRunning(false)
+      picDownload(SettingsCache::instance().getPicDownload()), loadQueueRunning(false)
 {
     connect(this, SIGNAL(startLoadQueue()), this, SLOT(processLoadQueue()), Qt::QueuedConnection);
     connect(&SettingsCache::instance(), SIGNAL(picsPathChanged()), this, SLOT(picsPathChanged()));
@@ -149,7 +152,13 @@ PictureLoaderWorker::PictureLoaderWorker()
     // Use a ManualRedirectPolicy since we keep track of redirects in picDownloadFinished
     // We can't use NoLessSafeRedirectPolicy because it is not applied with AlwaysCache
     networkManager->setRedirectPolicy(QNetworkRequest::ManualRedirectPolicy);
-    connect(networkManager, SIGNAL(finished(QNetworkReply *)), this, SLOT(picDownloadFinished(QNetworkReply *)));
+
+    const int connectionsPerHost = SettingsCache::instance().getPicDownloadConnectionsPerHost();
+    downloadScheduler = new PictureDownloadScheduler(networkManager, connectionsPerHost, this);
+    connect(&SettingsCache::instance(), &SettingsCache::picDownloadConnectionsPerHostChanged, downloadScheduler,
+            &PictureDownloadScheduler::setMaxConnectionsPerHost);
+    connect(downloadScheduler, SIGNAL(downloadFinished(const QUrl &, QNetworkReply *)), this,
+            SLOT(picDownloadFinished(const QUrl &, QNetworkReply *)), Qt::DirectConnection);
 
     cacheFilePath = SettingsCache::instance().getRedirectCachePath() + REDIRECT_CACHE_FILENAME;
     loadRedirectCache();
@@ -158,6 +167,11 @@ PictureLoaderWorker::PictureLoaderWorker()
     connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this,
             &PictureLoaderWorker::saveRedirectCache);
 
+    pictureIndex = new PictureFileIndex(this);
+    pictureIndex->reset(customPicsPath, picsPath);
+    connect(pictureIndex, SIGNAL(customPicturesChanged(const QStringList &)), this,
+            SIGNAL(customPicturesChanged(const QStringList &)));
+
     pictureLoaderThread = new QThread;
     pictureLoaderThread->start(QThread::LowPriority);
     moveToThread(pictureLoaderThread);
@@ -201,11 +215,7 @@ void PictureLoaderWorker::processLoadQueue()
 
         qDebug().nospace() << "PictureLoader: [card: " << cardName << " set: " << setName
                            << "]: No custom picture, trying to download";
-        cardsToDownload.append(cardBeingLoaded);
-        cardBeingLoaded.clear();
-        if (!downloadRunning) {
-            startNextPicDownload();
-        }
+        startPicDownload(cardBeingLoaded);
     }
 }
 
@@ -214,51 +224,22 @@ bool PictureLoaderWorker::cardImageExistsOnDisk(QString &setName, QString &corre
     QImage image;
     QImageReader imgReader;
     imgReader.setDecideFormatFromContent(true);
-    QList<QString> picsPaths = QList<QString>();
-    QDirIterator it(customPicsPath, QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
-
-    // Recursively check all subdirectories of the CUSTOM folder
-    while (it.hasNext()) {
-        QString thisPath(it.next());
-        QFileInfo thisFileInfo(thisPath);
-
-        if (thisFileInfo.isFile() &&
-            (thisFileInfo.fileName() == correctedCardname || thisFileInfo.completeBaseName() == correctedCardname ||
-             thisFileInfo.baseName() == correctedCardname)) {
-            picsPaths << thisPath; // Card found in the CUSTOM directory, somewhere
-        }
-    }
+    // Custom pictures anywhere in the CUSTOM folder come first
+    QStringList picsPaths = pictureIndex->findCustomPictures(correctedCardname);
 
     if (!setName.isEmpty()) {
-        picsPaths << picsPath + "/" + setName + "/" + correctedCardname
-                  // We no longer store downloaded images there, but don't just ignore
-                  // stuff that old versions have put there.
-                  << picsPath + "/downloadedPics/" + setName + "/" + correctedCardname;
+        // We no longer store downloaded images in the set folders, but don't just ignore
+        // stuff that old versions have put there.
+        picsPaths << pictureIndex->findSetPictures(setName, correctedCardname);
     }
 
-    // Iterates through the list of paths, searching for images with the desired
-    // name with any QImageReader-supported
-    // extension
+    // Only files that exist are in the index, so every candidate is a real file to decode
     for (const auto &_picsPath : picsPaths) {
         imgReader.setFileName(_picsPath);
         if (imgReader.read(&image)) {
             qDebug().nospace() << "PictureLoader: [card: " << correctedCardname << " set: " << setName
-                               << "]: Picture found on disk.";
-            imageLoaded(cardBeingLoaded.getCard(), image);
-            return true;
-        }
-        imgReader.setFileName(_picsPath + ".full");
-        if (imgReader.read(&image)) {
-            qDebug().nospace() << "PictureLoader: [card: " << correctedCardname << " set: " << setName
-                               << "]: Picture.full found on disk.";
-            imageLoaded(cardBeingLoaded.getCard(), image);
-            return true;
-        }
-        imgReader.setFileName(_picsPath + ".xlhq");
-        if (imgReader.read(&image)) {
-            qDebug().nospace() << "PictureLoader: [card: " << correctedCardname << " set: " << setName
-                               << "]: Picture.xlhq found on disk.";
-            imageLoaded(cardBeingLoaded.getCard(), image);
+                               << "]: Picture found on disk (" << _picsPath << ").";
+            pictureLoaded(cardBeingLoaded.getCard(), image, _picsPath);
             return true;
         }
     }
@@ -405,97 +386,91 @@ QString PictureToLoad::transformUrl(const QString &urlTemplate) const
     return transformedUrl;
 }
 
-void PictureLoaderWorker::startNextPicDownload()
+void PictureLoaderWorker::startPicDownload(const PictureToLoad &pic)
 {
-    if (cardsToDownload.isEmpty()) {
-        cardBeingDownloaded.clear();
-        downloadRunning = false;
-        return;
-    }
-
-    downloadRunning = true;
-
-    cardBeingDownloaded = cardsToDownload.takeFirst();
-
-    QString picUrl = cardBeingDownloaded.getCurrentUrl();
+    QString picUrl = pic.getCurrentUrl();
 
     if (picUrl.isEmpty()) {
-        downloadRunning = false;
-        picDownloadFailed();
+        picDownloadFailed(pic);
     } else {
         QUrl url(picUrl);
-        qDebug().nospace() << "PictureLoader: [card: " << cardBeingDownloaded.getCard()->getCorrectedName()
-                           << " set: " << cardBeingDownloaded.getSetName() << "]: Trying to fetch picture from url "
+        qDebug().nospace() << "PictureLoader: [card: " << pic.getCard()->getCorrectedName()
+                           << " set: " << pic.getSetName() << "]: Trying to fetch picture from url "
                            << url.toDisplayString();
-        makeRequest(url);
+        makeRequest(url, {pic});
     }
 }
 
-void PictureLoaderWorker::picDownloadFailed()
+void PictureLoaderWorker::picDownloadFailed(PictureToLoad pic)
 {
     /* Take advantage of short circuiting here to call the nextUrl until one
        is not available.  Only once nextUrl evaluates to false will this move
        on to nextSet.  If the Urls for a particular card are empty, this will
        effectively go through the sets for that card. */
-    if (cardBeingDownloaded.nextUrl() || cardBeingDownloaded.nextSet()) {
+    if (pic.nextUrl() || pic.nextSet()) {
         mutex.lock();
-        loadQueue.prepend(cardBeingDownloaded);
+        downloadingCards.remove(pic.getCard().data());
+        loadQueue.prepend(pic);
         mutex.unlock();
     } else {
-        qDebug().nospace() << "PictureLoader: [card: " << cardBeingDownloaded.getCard()->getCorrectedName()
-                           << " set: " << cardBeingDownloaded.getSetName() << "]: Picture NOT found, "
+        qDebug().nospace() << "PictureLoader: [card: " << pic.getCard()->getCorrectedName()
+                           << " set: " << pic.getSetName() << "]: Picture NOT found, "
                            << (picDownload ? "download failed" : "downloads disabled")
                            << ", no more url combinations to try: BAILING OUT";
-        imageLoaded(cardBeingDownloaded.getCard(), QImage());
-        cardBeingDownloaded.clear();
+        mutex.lock();
+        downloadingCards.remove(pic.getCard().data());
+        mutex.unlock();
+        pictureLoaded(pic.getCard(), QImage());
     }
     emit startLoadQueue();
 }
 
+void PictureLoaderWorker::pictureLoaded(const CardInfoPtr &card, const QImage &image, const QString &sourcePath)
+{
+    // get the picture ready to be shown while still on this thread
+    if (card->getUpsideDownArt()) {
+        emit imageLoaded(card, CardPictureScaler::toPixmapFormat(image.mirrored(true, true)), sourcePath);
+    } else {
+        emit imageLoaded(card, CardPictureScaler::toPixmapFormat(image), sourcePath);
+    }
+}
+
 bool PictureLoaderWorker::imageIsBlackListed(const QByteArray &picData)
 {
     QString md5sum = QCryptographicHash::hash(picData, QCryptographicHash::Md5).toHex();
     return md5Blacklist.contains(md5sum);
 }
 
-QNetworkReply *PictureLoaderWorker::makeRequest(const QUrl &url)
+void PictureLoaderWorker::makeRequest(const QUrl &url, const QList<PictureToLoad> &pics)
 {
     // Check if the redirect is cached
     QUrl cachedRedirect = getCachedRedirect(url);
     if (!cachedRedirect.isEmpty()) {
-        qDebug().nospace() << "PictureLoader: [card: " << cardBeingDownloaded.getCard()->getCorrectedName()
-                           << " set: " << cardBeingDownloaded.getSetName() << "]: Using cached redirect for "
+        qDebug().nospace() << "PictureLoader: [card: " << pics.first().getCard()->getCorrectedName()
+                           << " set: " << pics.first().getSetName() << "]: Using cached redirect for "
                            << url.toDisplayString() << " to " << cachedRedirect.toDisplayString();
-        return makeRequest(cachedRedirect); // Use the cached redirect
+        makeRequest(cachedRedirect, pics); // Use the cached redirect
+        return;
     }
 
+    // cards showing the same printing share one download
+    auto priority = PictureDownloadScheduler::PriorityPrefetch;
+    QList<PictureToLoad> &waiting = downloadsByUrl[url];
+    mutex.lock();
+    for (const PictureToLoad &pic : pics) {
+        priority = qMax(priority, pic.getPriority());
+        waiting << pic;
+        downloadingCards.insert(pic.getCard().data(), url);
+    }
+    mutex.unlock();
+
     QNetworkRequest req(url);
 
     if (!picDownload) {
         req.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysCache);
     }
 
-    QNetworkReply *reply = networkManager->get(req);
-
-    connect(reply, &QNetworkReply::finished, this, [this, reply, url]() {
-        QVariant redirectTarget = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-
-        if (redirectTarget.isValid()) {
-            QUrl redirectUrl = redirectTarget.toUrl();
-            if (redirectUrl.isRelative()) {
-                redirectUrl = url.resolved(redirectUrl);
-            }
-
-            cacheRedirect(url, redirectUrl);
-            qDebug().nospace() << "PictureLoader: [card: " << cardBeingDownloaded.getCard()->getCorrectedName()
-                               << " set: " << cardBeingDownloaded.getSetName() << "]: Caching redirect from "
-                               << url.toDisplayString() << " to " << redirectUrl.toDisplayString();
-        }
-
-        reply->deleteLater();
-    });
-
-    return reply;
+    downloadScheduler->enqueue(req, priority);
 }
 
 void PictureLoaderWorker::cacheRedirect(const QUrl &originalUrl, const QUrl &redirectUrl)
@@ -560,31 +535,36 @@ void PictureLoaderWorker::cleanStaleEntries()
     }
 }
 
-void PictureLoaderWorker::picDownloadFinished(QNetworkReply *reply)
+void PictureLoaderWorker::picDownloadFinished(const QUrl &url, QNetworkReply *reply)
 {
+    const QList<PictureToLoad> pics = downloadsByUrl.take(url);
+    if (pics.isEmpty()) {
+        // every card waiting for it was cancelled
+        return;
+    }
+    const PictureToLoad &firstPic = pics.first();
+
     bool isFromCache = reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
 
     if (reply->error()) {
         if (isFromCache) {
-            qDebug().nospace() << "PictureLoader: [card: " << cardBeingDownloaded.getCard()->getName()
-                               << " set: " << cardBeingDownloaded.getSetName()
-                               << "]: Removing corrupted cache file for url " << reply->url().toDisplayString()
-                               << " and retrying (" << reply->errorString() << ")";
+            qDebug().nospace() << "PictureLoader: [card: " << firstPic.getCard()->getName()
+                               << " set: " << firstPic.getSetName() << "]: Removing corrupted cache file for url "
+                               << url.toDisplayString() << " and retrying (" << reply->errorString() << ")";
 
-            networkManager->cache()->remove(reply->url());
+            networkManager->cache()->remove(url);
 
-            makeRequest(reply->url());
+            makeRequest(url, pics);
         } else {
-            qDebug().nospace() << "PictureLoader: [card: " << cardBeingDownloaded.getCard()->getName()
-                               << " set: " << cardBeingDownloaded.getSetName()
+            qDebug().nospace() << "PictureLoader: [card: " << firstPic.getCard()->getName()
+                               << " set: " << firstPic.getSetName()
                                << "]: " << (picDownload ? "Download" : "Cache search") << " failed for url "
-                               << reply->url().toDisplayString() << " (" << reply->errorString() << ")";
+                               << url.toDisplayString() << " (" << reply->errorString() << ")";
 
-            picDownloadFailed();
-            startNextPicDownload();
+            for (const PictureToLoad &pic : pics) {
+                picDownloadFailed(pic);
+            }
         }
-
-        reply->deleteLater();
         return;
     }
 
@@ -593,11 +573,14 @@ void PictureLoaderWorker::picDownloadFinished(QNetworkReply *reply)
     if (statusCode == 301 || statusCode == 302 || statusCode == 303 || statusCode == 305 || statusCode == 307 ||
         statusCode == 308) {
         QUrl redirectUrl = reply->header(QNetworkRequest::LocationHeader).toUrl();
-        qDebug().nospace() << "PictureLoader: [card: " << cardBeingDownloaded.getCard()->getName()
-                           << " set: " << cardBeingDownloaded.getSetName() << "]: following "
+        if (redirectUrl.isRelative()) {
+            redirectUrl = url.resolved(redirectUrl);
+        }
+        cacheRedirect(url, redirectUrl);
+        qDebug().nospace() << "PictureLoader: [card: " << firstPic.getCard()->getName()
+                           << " set: " << firstPic.getSetName() << "]: following "
                            << (isFromCache ? "cached redirect" : "redirect") << " to " << redirectUrl.toDisplayString();
-        makeRequest(redirectUrl);
-        reply->deleteLater();
+        makeRequest(redirectUrl, pics);
         return;
     }
 
@@ -605,13 +588,13 @@ void PictureLoaderWorker::picDownloadFinished(QNetworkReply *reply)
     const QByteArray &picData = reply->peek(reply->size());
 
     if (imageIsBlackListed(picData)) {
-        qDebug().nospace() << "PictureLoader: [card: " << cardBeingDownloaded.getCard()->getName()
-                           << " set: " << cardBeingDownloaded.getSetName()
+        qDebug().nospace() << "PictureLoader: [card: " << firstPic.getCard()->getName()
+                           << " set: " << firstPic.getSetName()
                            << "]: Picture found, but blacklisted, will consider it as not found";
 
-        picDownloadFailed();
-        reply->deleteLater();
-        startNextPicDownload();
+        for (const PictureToLoad &pic : pics) {
+            picDownloadFailed(pic);
+        }
         return;
     }
 
@@ -621,7 +604,7 @@ void PictureLoaderWorker::picDownloadFinished(QNetworkReply *reply)
     imgReader.setDecideFormatFromContent(true);
     imgReader.setDevice(reply);
 
-    bool logSuccessMessage = false;
+    bool imageRead = false;
 
     static const int riffHeaderSize = 12; // RIFF_HEADER_SIZE from webp/format_constants.h
     auto replyHeader = reply->peek(riffHeaderSize);
@@ -634,52 +617,170 @@ void PictureLoaderWorker::picDownloadFinished(QNetworkReply *reply)
         movie.start();
         movie.stop();
 
-        imageLoaded(cardBeingDownloaded.getCard(), movie.currentImage());
-        logSuccessMessage = true;
+        testImage = movie.currentImage();
+        imageRead = true;
     } else if (imgReader.read(&testImage)) {
-        imageLoaded(cardBeingDownloaded.getCard(), testImage);
-        logSuccessMessage = true;
-    } else {
-        qDebug().nospace() << "PictureLoader: [card: " << cardBeingDownloaded.getCard()->getName()
-                           << " set: " << cardBeingDownloaded.getSetName() << "]: Possible "
-                           << (isFromCache ? "cached" : "downloaded") << " picture at "
-                           << reply->url().toDisplayString() << " could not be loaded: " << reply->errorString();
+        imageRead = true;
+    }
+
+    if (!imageRead) {
+        qDebug().nospace() << "PictureLoader: [card: " << firstPic.getCard()->getName()
+                           << " set: " << firstPic.getSetName() << "]: Possible "
+                           << (isFromCache ? "cached" : "downloaded") << " picture at " << url.toDisplayString()
+                           << " could not be loaded: " << reply->errorString();
 
-        picDownloadFailed();
+        for (const PictureToLoad &pic : pics) {
+            picDownloadFailed(pic);
+        }
+        return;
     }
 
-    if (logSuccessMessage) {
-        qDebug().nospace() << "PictureLoader: [card: " << cardBeingDownloaded.getCard()->getName()
-                           << " set: " << cardBeingDownloaded.getSetName() << "]: Image successfully "
-                           << (isFromCache ? "loaded from cached" : "downloaded from") << " url "
-                           << reply->url().toDisplayString();
+    qDebug().nospace() << "PictureLoader: [card: " << firstPic.getCard()->getName()
+                       << " set: " << firstPic.getSetName() << "]: Image successfully "
+                       << (isFromCache ? "loaded from cached" : "downloaded from") << " url " << url.toDisplayString();
+
+    // the picture is decoded once, no matter how many cards were waiting for it
+    mutex.lock();
+    for (const PictureToLoad &pic : pics) {
+        downloadingCards.remove(pic.getCard().data());
     }
+    mutex.unlock();
+    for (const PictureToLoad &pic : pics) {
+        pictureLoaded(pic.getCard(), testImage);
+    }
+}
+
+void PictureLoaderWorker::raiseDownloadPriority(const QUrl &url, int priority)
+{
+    auto waiting = downloadsByUrl.find(url);
+    if (waiting == downloadsByUrl.end()) {
+        return;
+    }
+
+    const auto newPriority = static_cast<PictureDownloadScheduler::Priority>(priority);
+    for (PictureToLoad &pic : *waiting) {
+        pic.raisePriority(newPriority);
+    }
+    downloadScheduler->raisePriority(url, newPriority);
+}
 
-    reply->deleteLater();
-    startNextPicDownload();
+void PictureLoaderWorker::lowerDownloadPriority(CardInfoPtr card)
+{
+    mutex.lock();
+    const QUrl url = downloadingCards.value(card.data());
+    mutex.unlock();
+
+    auto waiting = downloadsByUrl.find(url);
+    if (url.isEmpty() || waiting == downloadsByUrl.end()) {
+        return;
+    }
+
+    // other cards waiting for the same picture keep it where they need it
+    auto priority = PictureDownloadScheduler::PriorityPrefetch;
+    for (PictureToLoad &pic : *waiting) {
+        if (pic.getCard() == card) {
+            pic.lowerPriority(PictureDownloadScheduler::PriorityPrefetch);
+        }
+        priority = qMax(priority, pic.getPriority());
+    }
+    downloadScheduler->lowerPriority(url, priority);
+}
+
+void PictureLoaderWorker::cancelDownload(CardInfoPtr card)
+{
+    mutex.lock();
+    const QUrl url = downloadingCards.take(card.data());
+    mutex.unlock();
+
+    auto waiting = downloadsByUrl.find(url);
+    if (url.isEmpty() || waiting == downloadsByUrl.end()) {
+        return;
+    }
+
+    for (int i = 0; i < waiting->size(); ++i) {
+        if (waiting->at(i).getCard() == card) {
+            waiting->removeAt(i);
+            break;
+        }
+    }
+
+    // other cards may still want the same picture
+    if (waiting->isEmpty()) {
+        downloadsByUrl.erase(waiting);
+        downloadScheduler->cancel(url);
+    }
 }
 
-void PictureLoaderWorker::enqueueImageLoad(CardInfoPtr card)
+void PictureLoaderWorker::enqueueImageLoad(CardInfoPtr card, PictureDownloadScheduler::Priority priority)
 {
     QMutexLocker locker(&mutex);
 
+    if (!card) {
+        return;
+    }
+
+    // a card that is already being downloaded only gets its download moved up
+    auto download = downloadingCards.constFind(card.data());
+    if (download != downloadingCards.constEnd()) {
+        QMetaObject::invokeMethod(this, "raiseDownloadPriority", Qt::QueuedConnection, Q_ARG(QUrl, download.value()),
+                                  Q_ARG(int, priority));
+        return;
+    }
+
     // avoid queueing the same card more than once
-    if (!card || card == cardBeingLoaded.getCard() || card == cardBeingDownloaded.getCard()) {
+    if (card == cardBeingLoaded.getCard()) {
         return;
     }
 
-    for (const PictureToLoad &pic : loadQueue) {
-        if (pic.getCard() == card)
+    for (PictureToLoad &pic : loadQueue) {
+        if (pic.getCard() == card) {
+            pic.raisePriority(priority);
             return;
+        }
     }
 
-    for (const PictureToLoad &pic : cardsToDownload) {
-        if (pic.getCard() == card)
+    loadQueue.append(PictureToLoad(card, priority));
+    emit startLoadQueue();
+}
+
+void PictureLoaderWorker::lowerImageLoadPriority(CardInfoPtr card)
+{
+    QMutexLocker locker(&mutex);
+
+    if (!card) {
+        return;
+    }
+
+    for (PictureToLoad &pic : loadQueue) {
+        if (pic.getCard() == card) {
+            pic.lowerPriority(PictureDownloadScheduler::PriorityPrefetch);
             return;
+        }
     }
 
-    loadQueue.append(PictureToLoad(card));
-    emit startLoadQueue();
+    if (downloadingCards.contains(card.data())) {
+        QMetaObject::invokeMethod(this, "lowerDownloadPriority", Qt::QueuedConnection, Q_ARG(CardInfoPtr, card));
+    }
+}
+
+void PictureLoaderWorker::cancelImageLoad(CardInfoPtr card)
+{
+    QMutexLocker locker(&mutex);
+
+    if (!card) {
+        return;
+    }
+
+    for (int i = 0; i < loadQueue.size(); ++i) {
+        if (loadQueue.at(i).getCard() == card) {
+            loadQueue.removeAt(i);
+            return;
+        }
+    }
+
+    if (downloadingCards.contains(card.data())) {
+        QMetaObject::invokeMethod(this, "cancelDownload", Qt::QueuedConnection, Q_ARG(CardInfoPtr, card));
+    }
 }
 
 void PictureLoaderWorker::picDownloadChanged()
@@ -693,6 +794,7 @@ void PictureLoaderWorker::picsPathChanged()
     QMutexLocker locker(&mutex);
     picsPath = SettingsCache::instance().getPicsPath();
     customPicsPath = SettingsCache::instance().getCustomPicsPath();
+    pictureIndex->reset(customPicsPath, picsPath);
 }
 
 void PictureLoaderWorker::clearNetworkCache()
@@ -706,8 +808,15 @@ PictureLoader::PictureLoader() : QObject(nullptr)
     connect(&SettingsCache::instance(), SIGNAL(picsPathChanged()), this, SLOT(picsPathChanged()));
     connect(&SettingsCache::instance(), SIGNAL(picDownloadChanged()), this, SLOT(picDownloadChanged()));
 
-    connect(worker, SIGNAL(imageLoaded(CardInfoPtr, const QImage &)), this,
-            SLOT(imageLoaded(CardInfoPtr, const QImage &)));
+    connect(worker, SIGNAL(imageLoaded(CardInfoPtr, const QImage &, const QString &)), this,
+            SLOT(imageLoaded(CardInfoPtr, const QImage &, const QString &)));
+    connect(worker, SIGNAL(customPicturesChanged(const QStringList &)), this,
+            SLOT(customPicturesChanged(const QStringList &)));
+
+    scaler = new CardPictureScaler(SettingsCache::instance().getCachePath() + "/thumbnails", this);
+    connect(scaler, SIGNAL(scaled(const QString &, const QImage &)), this,
+            SLOT(thumbnailLoaded(const QString &, const QImage &)));
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, scaler, &CardPictureScaler::saveThumbnails);
 }
 
 PictureLoader::~PictureLoader()
@@ -745,7 +854,10 @@ void PictureLoader::getCardBackLoadingFailedPixmap(QPixmap &pixmap, QSize size)
     }
 }
 
-void PictureLoader::getPixmap(QPixmap &pixmap, CardInfoPtr card, QSize size)
+void PictureLoader::getPixmap(QPixmap &pixmap,
+                              CardInfoPtr card,
+                              QSize size,
+                              PictureDownloadScheduler::Priority priority)
 {
     if (card == nullptr) {
         return;
@@ -757,32 +869,109 @@ void PictureLoader::getPixmap(QPixmap &pixmap, CardInfoPtr card, QSize size)
     if (QPixmapCache::find(sizeKey, &pixmap))
         return;
 
-    // load the image and create a copy of the correct size
+    QScreen *screen = qApp->primaryScreen();
+    qreal dpr = screen->devicePixelRatio();
+    QSize pixelSize = size * dpr;
+
+    // have a copy of the correct size made in the background, and make do with a quick and ugly one meanwhile
     QPixmap bigPixmap;
     if (QPixmapCache::find(key, &bigPixmap)) {
-        QScreen *screen = qApp->primaryScreen();
-        qreal dpr = screen->devicePixelRatio();
-        pixmap = bigPixmap.scaled(size * dpr, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        pixmap.setDevicePixelRatio(dpr);
-        QPixmapCache::insert(sizeKey, pixmap);
+        if (bigPixmap.isNull()) {
+            pixmap = bigPixmap;
+            return;
+        }
+        if (getInstance().scaler->getPendingCount() < QUICK_SCALE_PENDING_MAX) {
+            pixmap = bigPixmap.scaled(pixelSize, Qt::KeepAspectRatio, Qt::FastTransformation);
+            pixmap.setDevicePixelRatio(dpr);
+        }
+        getInstance().requestThumbnail(card, sizeKey, pixelSize, dpr, bigPixmap, priority);
         return;
     }
 
-    // add the card to the load queue
-    getInstance().worker->enqueueImageLoad(card);
+    // a thumbnail from an earlier session saves loading the whole picture
+    getInstance().requestThumbnail(card, sizeKey, pixelSize, dpr, QPixmap(), priority);
 }
 
-void PictureLoader::imageLoaded(CardInfoPtr card, const QImage &image)
+void PictureLoader::requestThumbnail(const CardInfoPtr &card,
+                                     const QString &sizeKey,
+                                     const QSize &pixelSize,
+                                     qreal devicePixelRatio,
+                                     const QPixmap &source,
+                                     PictureDownloadScheduler::Priority priority)
 {
+    auto pending = pendingThumbnails.find(sizeKey);
+    if (pending != pendingThumbnails.end()) {
+        if (!pending->cards.contains(card)) {
+            pending->cards << card;
+        }
+        pending->priority = qMax(pending->priority, priority);
+        return;
+    }
+    pendingThumbnails.insert(sizeKey, {{card}, priority, devicePixelRatio});
+
+    // converting the picture copies it, so that only happens once the size is actually queued
+    const QString key = card->getPixmapCacheKey();
+    const QImage sourceImage = source.isNull() ? QImage() : source.toImage();
+    scaler->scale(key, sizeKey, pixelSize, sourceImage, card->getCorrectedName(), localPictures.value(key));
+}
+
+void PictureLoader::thumbnailLoaded(const QString &sizeKey, const QImage &image)
+{
+    if (!pendingThumbnails.contains(sizeKey)) {
+        return;
+    }
+    const PendingThumbnail pending = pendingThumbnails.take(sizeKey);
+
     if (image.isNull()) {
-        QPixmapCache::insert(card->getPixmapCacheKey(), QPixmap());
-    } else {
-        if (card->getUpsideDownArt()) {
-            QImage mirrorImage = image.mirrored(true, true);
-            QPixmapCache::insert(card->getPixmapCacheKey(), QPixmap::fromImage(mirrorImage));
-        } else {
-            QPixmapCache::insert(card->getPixmapCacheKey(), QPixmap::fromImage(image));
+        // nothing on disk, the whole picture has to be loaded; scaling it is requested again once it is there
+        for (const CardInfoPtr &card : pending.cards) {
+            worker->enqueueImageLoad(card, pending.priority);
         }
+        return;
+    }
+
+    // the image is already in the pixmap format, this is only an upload
+    QPixmap pixmap = QPixmap::fromImage(image);
+    pixmap.setDevicePixelRatio(pending.devicePixelRatio);
+    QPixmapCache::insert(sizeKey, pixmap);
+    for (const CardInfoPtr &card : pending.cards) {
+        card->emitPixmapUpdated();
+    }
+}
+
+void PictureLoader::clearThumbnails()
+{
+    pendingThumbnails.clear();
+    scaler->clear();
+}
+
+void PictureLoader::customPicturesChanged(const QStringList &cardNames)
+{
+    // the scaled copies in memory can't be told apart by card, so all of them are made again
+    QPixmapCache::clear();
+
+    QList<CardInfoPtr> waitingCards;
+    for (const PendingThumbnail &pending : pendingThumbnails) {
+        waitingCards << pending.cards;
+    }
+    pendingThumbnails.clear();
+    scaler->invalidateCards(cardNames);
+
+    // the thumbnails they were waiting for were dropped, have them ask again
+    for (const CardInfoPtr &card : waitingCards) {
+        card->emitPixmapUpdated();
+    }
+}
+
+void PictureLoader::imageLoaded(CardInfoPtr card, const QImage &image, const QString &sourcePath)
+{
+    // the worker already mirrored upside down art and converted the picture to the pixmap format
+    const QString key = card->getPixmapCacheKey();
+    QPixmapCache::insert(key, QPixmap::fromImage(image));
+    if (sourcePath.isEmpty()) {
+        localPictures.remove(key);
+    } else {
+        localPictures.insert(key, sourcePath);
     }
 
     card->emitPixmapUpdated();
@@ -798,11 +987,14 @@ void PictureLoader::clearPixmapCache(CardInfoPtr card)
 void PictureLoader::clearPixmapCache()
 {
     QPixmapCache::clear();
+    // e.g. the set priorities changed, so the preferred printing of a card may have a different picture now
+    getInstance().clearThumbnails();
 }
 
 void PictureLoader::clearNetworkCache()
 {
     getInstance().worker->clearNetworkCache();
+    getInstance().clearThumbnails();
 }
 
 void PictureLoader::cacheCardPixmaps(QList<CardInfoPtr> cards)
@@ -820,10 +1012,20 @@ void PictureLoader::cacheCardPixmaps(QList<CardInfoPtr> cards)
             continue;
         }
 
-        getInstance().worker->enqueueImageLoad(card);
+        getInstance().worker->enqueueImageLoad(card, PictureDownloadScheduler::PriorityPrefetch);
     }
 }
 
+void PictureLoader::lowerImageLoadPriority(CardInfoPtr card)
+{
+    getInstance().worker->lowerImageLoadPriority(card);
+}
+
+void PictureLoader::cancelImageLoad(CardInfoPtr card)
+{
+    getInstance().worker->cancelImageLoad(card);
+}
+
 void PictureLoader::picDownloadChanged()
 {
     QPixmapCache::clear();
@@ -832,4 +1034,5 @@ void PictureLoader::picDownloadChanged()
 void PictureLoader::picsPathChanged()
 {
     QPixmapCache::clear();
+    clearThumbnails();
 }
@@ -2,11 +2,14 @@
 #define PICTURELOADER_H
 
 #include "../../game/cards/card_database.h"
+#include "picture_download_scheduler.h"
 
 #include <QList>
 #include <QMap>
 #include <QMutex>
 #include <QNetworkRequest>
+class CardPictureScaler;
+class PictureFileIndex;
 class QNetworkAccessManager;
 class QNetworkReply;
 class QThread;
@@ -44,9 +47,11 @@ private:
     QList<QString> currentSetUrls;
     QString currentUrl;
     CardSetPtr currentSet;
+    PictureDownloadScheduler::Priority priority;
 
 public:
-    explicit PictureToLoad(CardInfoPtr _card = CardInfoPtr());
+    explicit PictureToLoad(CardInfoPtr _card = CardInfoPtr(),
+                           PictureDownloadScheduler::Priority _priority = PictureDownloadScheduler::PriorityPrefetch);
 
     CardInfoPtr getCard() const
     {
@@ -64,6 +69,18 @@ public:
     {
         return currentSet;
     }
+    PictureDownloadScheduler::Priority getPriority() const
+    {
+        return priority;
+    }
+    void raisePriority(PictureDownloadScheduler::Priority _priority)
+    {
+        priority = qMax(priority, _priority);
+    }
+    void lowerPriority(PictureDownloadScheduler::Priority _priority)
+    {
+        priority = qMin(priority, _priority);
+    }
     QString getSetName() const;
     QString transformUrl(const QString &urlTemplate) const;
     bool nextSet();
@@ -78,7 +95,9 @@ public:
     explicit PictureLoaderWorker();
     ~PictureLoaderWorker() override;
 
-    void enqueueImageLoad(CardInfoPtr card);
+    void enqueueImageLoad(CardInfoPtr card, PictureDownloadScheduler::Priority priority);
+    void lowerImageLoadPriority(CardInfoPtr card);
+    void cancelImageLoad(CardInfoPtr card);
     void clearNetworkCache();
 
 private:
@@ -86,20 +105,26 @@ private:
 
     QThread *pictureLoaderThread;
     QString picsPath, customPicsPath;
+    PictureFileIndex *pictureIndex;
     QList<PictureToLoad> loadQueue;
     QMutex mutex;
     QNetworkAccessManager *networkManager;
     QHash<QUrl, QPair<QUrl, QDateTime>> redirectCache; // Stores redirect and timestamp
     QString cacheFilePath;                             // Path to persistent storage
     static constexpr int CacheTTLInDays = 30;          // TODO: Make user configurable
-    QList<PictureToLoad> cardsToDownload;
+    PictureDownloadScheduler *downloadScheduler;
+    // the cards waiting for each url that is being downloaded
+    QHash<QUrl, QList<PictureToLoad>> downloadsByUrl;
+    // the url each card is being downloaded from, guarded by the mutex
+    QHash<CardInfo *, QUrl> downloadingCards;
     PictureToLoad cardBeingLoaded;
-    PictureToLoad cardBeingDownloaded;
-    bool picDownload, downloadRunning, loadQueueRunning;
-    void startNextPicDownload();
+    bool picDownload, loadQueueRunning;
+    void startPicDownload(const PictureToLoad &pic);
     bool cardImageExistsOnDisk(QString &setName, QString &correctedCardName);
     bool imageIsBlackListed(const QByteArray &);
-    QNetworkReply *makeRequest(const QUrl &url);
+    void pictureLoaded(const CardInfoPtr &card, const QImage &image, const QString &sourcePath = QString());
+    void makeRequest(const QUrl &url, const QList<PictureToLoad> &pics);
+    void picDownloadFailed(PictureToLoad pic);
     void cacheRedirect(const QUrl &originalUrl, const QUrl &redirectUrl);
     QUrl getCachedRedirect(const QUrl &originalUrl) const;
     void loadRedirectCache();
@@ -107,8 +132,10 @@ private:
     void cleanStaleEntries();
 
 private slots:
-    void picDownloadFinished(QNetworkReply *reply);
-    void picDownloadFailed();
+    void picDownloadFinished(const QUrl &url, QNetworkReply *reply);
+    void raiseDownloadPriority(const QUrl &url, int priority);
+    void lowerDownloadPriority(CardInfoPtr card);
+    void cancelDownload(CardInfoPtr card);
 
     void picDownloadChanged();
     void picsPathChanged();
@@ -117,7 +144,9 @@ public slots:
 
 signals:
     void startLoadQueue();
-    void imageLoaded(CardInfoPtr card, const QImage &image);
+    // sourcePath is the local file the picture was read from, empty for downloaded pictures
+    void imageLoaded(CardInfoPtr card, const QImage &image, const QString &sourcePath);
+    void customPicturesChanged(const QStringList &cardNames);
 };
 
 class PictureLoader : public QObject
@@ -139,14 +168,41 @@ private:
 
     PictureLoaderWorker *worker;
 
+    // scaled pictures that are being loaded from disk or scaled, by pixmap cache key with size
+    struct PendingThumbnail
+    {
+        QList<CardInfoPtr> cards;
+        PictureDownloadScheduler::Priority priority;
+        qreal devicePixelRatio;
+    };
+    QHash<QString, PendingThumbnail> pendingThumbnails;
+    // the local file each loaded picture was read from, by pixmap cache key
+    QHash<QString, QString> localPictures;
+    CardPictureScaler *scaler;
+
+    void requestThumbnail(const CardInfoPtr &card,
+                          const QString &sizeKey,
+                          const QSize &pixelSize,
+                          qreal devicePixelRatio,
+                          const QPixmap &source,
+                          PictureDownloadScheduler::Priority priority);
+    void clearThumbnails();
+
 public:
-    static void getPixmap(QPixmap &pixmap, CardInfoPtr card, QSize size);
+    // Pictures are fetched as a prefetch unless the caller knows the card is on screen
+    static void getPixmap(QPixmap &pixmap,
+                          CardInfoPtr card,
+                          QSize size,
+                          PictureDownloadScheduler::Priority priority = PictureDownloadScheduler::PriorityPrefetch);
     static void getCardBackPixmap(QPixmap &pixmap, QSize size);
     static void getCardBackLoadingInProgressPixmap(QPixmap &pixmap, QSize size);
     static void getCardBackLoadingFailedPixmap(QPixmap &pixmap, QSize size);
     static void clearPixmapCache(CardInfoPtr card);
     static void clearPixmapCache();
     static void cacheCardPixmaps(QList<CardInfoPtr> cards);
+    // For a card that went out of view, its picture is still fetched once the visible ones are
+    static void lowerImageLoadPriority(CardInfoPtr card);
+    static void cancelImageLoad(CardInfoPtr card);
 
 public slots:
     static void clearNetworkCache();
@@ -154,8 +210,10 @@ public slots:
 private slots:
     void picDownloadChanged();
     void picsPathChanged();
+    void thumbnailLoaded(const QString &sizeKey, const QImage &image);
+    void customPicturesChanged(const QStringList &cardNames);
 
 public slots:
-    void imageLoaded(CardInfoPtr card, const QImage &image);
+    void imageLoaded(CardInfoPtr card, const QImage &image, const QString &sourcePath);
 };
 #endif
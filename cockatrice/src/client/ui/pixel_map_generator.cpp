@@ -4,55 +4,189 @@
 
 #include <QApplication>
 #include <QDebug>
+#include <QDir>
+#include <QFuture>
+#include <QImageReader>
 #include <QPainter>
 #include <QPalette>
+#include <QSet>
+#include <QtConcurrent>
 
-QMap<QString, QPixmap> PhasePixmapGenerator::pmCache;
+QMutex PixmapGeneratorCache::mutex;
+QHash<QString, quint32> PixmapGeneratorCache::nameIds;
+QCache<quint64, QPixmap> PixmapGeneratorCache::pixmaps(PIXMAP_GENERATOR_CACHE_LIMIT);
+QCache<quint64, QImage> PixmapGeneratorCache::sources(PIXMAP_GENERATOR_CACHE_LIMIT);
+
+// In KB
+static int cacheCost(const QSize &size, int depth)
+{
+    return qMax(1, size.width() * size.height() * depth / 8 / 1024);
+}
+
+quint32 PixmapGeneratorCache::nameId(const QString &name)
+{
+    QMutexLocker locker(&mutex);
+    auto it = nameIds.constFind(name);
+    if (it != nameIds.constEnd())
+        return it.value();
+
+    const quint32 id = nameIds.size();
+    nameIds.insert(name, id);
+    return id;
+}
+
+int PixmapGeneratorCache::bucketHeight(int height)
+{
+    int bucket = 16;
+    while (bucket < height)
+        bucket += bucket / 2;
+    return bucket;
+}
+
+bool PixmapGeneratorCache::find(quint64 key, QPixmap &pixmap)
+{
+    QMutexLocker locker(&mutex);
+    const QPixmap *cached = pixmaps.object(key);
+    if (!cached)
+        return false;
+
+    pixmap = *cached;
+    return true;
+}
+
+void PixmapGeneratorCache::insert(quint64 key, const QPixmap &pixmap)
+{
+    QMutexLocker locker(&mutex);
+    pixmaps.insert(key, new QPixmap(pixmap), cacheCost(pixmap.size(), pixmap.depth()));
+}
+
+QImage PixmapGeneratorCache::renderSource(Generator generator, const QString &path, const QSize &bucketSize)
+{
+    const quint64 sourceKey = key(generator, bucketSize.height(), nameId(path));
+    {
+        QMutexLocker locker(&mutex);
+        if (const QImage *cached = sources.object(sourceKey))
+            return *cached;
+    }
+
+    // svgs are rendered at the size asked for instead of being scaled afterwards
+    QImageReader reader(path);
+    QSize size = reader.size();
+    if (size.isValid()) {
+        size.scale(bucketSize, Qt::KeepAspectRatio);
+        reader.setScaledSize(size);
+    }
+    QImage image = reader.read();
+    if (!image.isNull() && image.width() > bucketSize.width() && image.height() > bucketSize.height())
+        image = image.scaled(bucketSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    QMutexLocker locker(&mutex);
+    sources.insert(sourceKey, new QImage(image), cacheCost(image.size(), image.depth()));
+    return image;
+}
+
+QPixmap PixmapGeneratorCache::themePixmap(Generator generator, const QString &path, const QSize &size)
+{
+    if (size.isEmpty())
+        return QPixmap();
+
+    const int bucket = bucketHeight(size.height());
+    const QImage source = renderSource(generator, path, QSize(size.width() * bucket / size.height(), bucket));
+    if (source.isNull())
+        return QPixmap();
+    return QPixmap::fromImage(source.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+}
+
+void PixmapGeneratorCache::clear(Generator generator)
+{
+    QMutexLocker locker(&mutex);
+    for (const quint64 key : pixmaps.keys()) {
+        if ((key >> 56) == generator)
+            pixmaps.remove(key);
+    }
+    for (const quint64 key : sources.keys()) {
+        if ((key >> 56) == generator)
+            sources.remove(key);
+    }
+}
+
+void PixmapGeneratorCache::prerenderInBackground()
+{
+    struct Picture
+    {
+        Generator generator;
+        QString path;
+        QSize size;
+    };
+    // generator, directory in the theme, size of the pictures for the height of a user list row
+    const QList<Picture> themeDirs = {{UserLevel, "userlevels", QSize(16, 16)}, {Country, "countries", QSize(32, 16)}};
+
+    QList<Picture> pictures;
+    for (const Picture &themeDir : themeDirs) {
+        QSet<QString> names;
+        for (const QString &searchPath : QDir::searchPaths("theme")) {
+            for (const QFileInfo &file : QDir(searchPath + "/" + themeDir.path).entryInfoList(QDir::Files))
+                names.insert(file.completeBaseName());
+        }
+        for (const QString &name : names)
+            pictures.append({themeDir.generator, "theme:" + themeDir.path + "/" + name, themeDir.size});
+    }
+
+    static QFuture<void> prerendering;
+    prerendering = QtConcurrent::run([pictures]() {
+        for (const Picture &picture : pictures)
+            renderSource(picture.generator, picture.path, picture.size);
+    });
+}
 
 QPixmap PhasePixmapGenerator::generatePixmap(int height, QString name)
 {
-    QString key = name + QString::number(height);
-    if (pmCache.contains(key))
-        return pmCache.value(key);
+    const quint64 key = PixmapGeneratorCache::key(PixmapGeneratorCache::Phase, height,
+                                                  PixmapGeneratorCache::nameId(name));
+    QPixmap pixmap;
+    if (PixmapGeneratorCache::find(key, pixmap))
+        return pixmap;
 
-    QPixmap pixmap =
-        QPixmap("theme:phases/" + name).scaled(height, height, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    pixmap = PixmapGeneratorCache::themePixmap(PixmapGeneratorCache::Phase, "theme:phases/" + name,
+                                               QSize(height, height));
 
-    pmCache.insert(key, pixmap);
+    PixmapGeneratorCache::insert(key, pixmap);
     return pixmap;
 }
 
-QMap<QString, QPixmap> CounterPixmapGenerator::pmCache;
-
 QPixmap CounterPixmapGenerator::generatePixmap(int height, QString name, bool highlight)
 {
+    const quint64 key = PixmapGeneratorCache::key(PixmapGeneratorCache::Counter, height,
+                                                  PixmapGeneratorCache::nameId(name) << 1 | (highlight ? 1 : 0));
+    QPixmap pixmap;
+    if (PixmapGeneratorCache::find(key, pixmap))
+        return pixmap;
+
     if (highlight)
         name.append("_highlight");
-    QString key = name + QString::number(height);
-    if (pmCache.contains(key))
-        return pmCache.value(key);
-
-    QPixmap pixmap =
-        QPixmap("theme:counters/" + name).scaled(height, height, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    pixmap = PixmapGeneratorCache::themePixmap(PixmapGeneratorCache::Counter, "theme:counters/" + name,
+                                               QSize(height, height));
     if (pixmap.isNull()) {
         name = "general";
         if (highlight)
             name.append("_highlight");
-        pixmap =
-            QPixmap("theme:counters/" + name).scaled(height, height, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        pixmap = PixmapGeneratorCache::themePixmap(PixmapGeneratorCache::Counter, "theme:counters/" + name,
+                                                   QSize(height, height));
     }
 
-    pmCache.insert(key, pixmap);
+    PixmapGeneratorCache::insert(key, pixmap);
     return pixmap;
 }
 
 QPixmap PingPixmapGenerator::generatePixmap(int size, int value, int max)
 {
-    int key = size * 1000000 + max * 1000 + value;
-    if (pmCache.contains(key))
-        return pmCache.value(key);
+    const quint64 key = PixmapGeneratorCache::key(PixmapGeneratorCache::Ping, size,
+                                                  quint32(max + 1) << 16 | quint16(value + 1));
+    QPixmap pixmap;
+    if (PixmapGeneratorCache::find(key, pixmap))
+        return pixmap;
 
-    QPixmap pixmap(size, size);
+    pixmap = QPixmap(size, size);
     pixmap.fill(Qt::transparent);
     QPainter painter(&pixmap);
     QColor color;
@@ -66,42 +200,47 @@ QPixmap PingPixmapGenerator::generatePixmap(int size, int value, int max)
     g.setColorAt(0, color);
     g.setColorAt(1, Qt::transparent);
     painter.fillRect(0, 0, pixmap.width(), pixmap.height(), QBrush(g));
+    painter.end();
 
-    pmCache.insert(key, pixmap);
+    PixmapGeneratorCache::insert(key, pixmap);
 
     return pixmap;
 }
 
-QMap<int, QPixmap> PingPixmapGenerator::pmCache;
-
 QPixmap CountryPixmapGenerator::generatePixmap(int height, const QString &countryCode)
 {
     if (countryCode.size() != 2)
         return QPixmap();
-    QString key = countryCode + QString::number(height);
-    if (pmCache.contains(key))
-        return pmCache.value(key);
+    const quint64 key = PixmapGeneratorCache::key(PixmapGeneratorCache::Country, height,
+                                                  quint32(countryCode.at(0).unicode()) << 16 |
+                                                      countryCode.at(1).unicode());
+    QPixmap pixmap;
+    if (PixmapGeneratorCache::find(key, pixmap))
+        return pixmap;
 
     int width = height * 2;
-    QPixmap pixmap = QPixmap("theme:countries/" + countryCode.toLower())
-                         .scaled(width, height, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    pixmap = PixmapGeneratorCache::themePixmap(PixmapGeneratorCache::Country,
+                                               "theme:countries/" + countryCode.toLower(), QSize(width, height));
 
-    QPainter painter(&pixmap);
-    painter.setPen(Qt::black);
-    painter.drawRect(0, 0, pixmap.width() - 1, pixmap.height() - 1);
+    if (!pixmap.isNull()) {
+        QPainter painter(&pixmap);
+        painter.setPen(Qt::black);
+        painter.drawRect(0, 0, pixmap.width() - 1, pixmap.height() - 1);
+    }
 
-    pmCache.insert(key, pixmap);
+    PixmapGeneratorCache::insert(key, pixmap);
     return pixmap;
 }
 
-QMap<QString, QPixmap> CountryPixmapGenerator::pmCache;
-
 QPixmap UserLevelPixmapGenerator::generatePixmap(int height, UserLevelFlags userLevel, bool isBuddy, QString privLevel)
 {
-
-    QString key = QString::number(height * 10000) + ":" + (short)userLevel + ":" + (short)isBuddy + ":" + privLevel;
-    if (pmCache.contains(key))
-        return pmCache.value(key);
+    const quint64 key =
+        PixmapGeneratorCache::key(PixmapGeneratorCache::UserLevel, height,
+                                  PixmapGeneratorCache::nameId(privLevel) << 9 | (isBuddy ? 1 : 0) << 8 |
+                                      (static_cast<quint32>(userLevel) & 0xff));
+    QPixmap pixmap;
+    if (PixmapGeneratorCache::find(key, pixmap))
+        return pixmap;
 
     QString levelString;
     if (userLevel.testFlag(ServerInfo_User::IsAdmin)) {
@@ -122,29 +261,25 @@ QPixmap UserLevelPixmapGenerator::generatePixmap(int height, UserLevelFlags user
     if (isBuddy)
         levelString.append("_buddy");
 
-    QPixmap pixmap = QPixmap("theme:userlevels/" + levelString)
-                         .scaled(height, height, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    pixmap = PixmapGeneratorCache::themePixmap(PixmapGeneratorCache::UserLevel, "theme:userlevels/" + levelString,
+                                               QSize(height, height));
 
-    pmCache.insert(key, pixmap);
+    PixmapGeneratorCache::insert(key, pixmap);
     return pixmap;
 }
 
-QMap<QString, QPixmap> UserLevelPixmapGenerator::pmCache;
-
 QPixmap LockPixmapGenerator::generatePixmap(int height)
 {
+    const quint64 key = PixmapGeneratorCache::key(PixmapGeneratorCache::Lock, height, 0);
+    QPixmap pixmap;
+    if (PixmapGeneratorCache::find(key, pixmap))
+        return pixmap;
 
-    int key = height;
-    if (pmCache.contains(key))
-        return pmCache.value(key);
-
-    QPixmap pixmap = QPixmap("theme:icons/lock").scaled(height, height, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    pmCache.insert(key, pixmap);
+    pixmap = PixmapGeneratorCache::themePixmap(PixmapGeneratorCache::Lock, "theme:icons/lock", QSize(height, height));
+    PixmapGeneratorCache::insert(key, pixmap);
     return pixmap;
 }
 
-QMap<int, QPixmap> LockPixmapGenerator::pmCache;
-
 const QPixmap loadColorAdjustedPixmap(QString name)
 {
     if (qApp->palette().windowText().color().lightness() > 200) {
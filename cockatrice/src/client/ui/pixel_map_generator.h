@@ -3,84 +3,120 @@
 
 #include "user_level.h"
 
-#include <QMap>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
 #include <QPixmap>
 
-class PhasePixmapGenerator
+// In KB, for the pixmaps of all generators together and again for the pictures they are scaled from
+constexpr int PIXMAP_GENERATOR_CACHE_LIMIT = 8 * 1024;
+
+/**
+ * The pixmaps of all generators below, in one cache that drops the least recently used ones above its limit.
+ *
+ * Theme pictures are rendered once for a range of sizes, at the largest of them, and the exact sizes asked for are
+ * scaled down from that. Resizing a view a pixel at a time doesn't render the svg again for every height.
+ *
+ * All functions can be called from any thread, except that pixmaps are only made in the gui thread as always.
+ */
+class PixmapGeneratorCache
 {
+public:
+    enum Generator : quint8
+    {
+        Phase,
+        Counter,
+        Ping,
+        Country,
+        UserLevel,
+        Lock
+    };
+
+    static quint64 key(Generator generator, int size, quint32 id)
+    {
+        return (quint64(generator) << 56) | (quint64(size & 0xffffff) << 32) | id;
+    }
+    // A small number that stays the same for the name until the program ends
+    static quint32 nameId(const QString &name);
+    static int bucketHeight(int height);
+
+    static bool find(quint64 key, QPixmap &pixmap);
+    static void insert(quint64 key, const QPixmap &pixmap);
+    // Returns the theme picture at path scaled to fit into size, the picture it is scaled from belongs to generator
+    static QPixmap themePixmap(Generator generator, const QString &path, const QSize &size);
+    // Drops the pixmaps of generator and the pictures they were scaled from
+    static void clear(Generator generator);
+
+    // Renders the user level and country pictures for the sizes the user lists use in another thread
+    static void prerenderInBackground();
+
 private:
-    static QMap<QString, QPixmap> pmCache;
+    static QMutex mutex;
+    static QHash<QString, quint32> nameIds;
+    static QCache<quint64, QPixmap> pixmaps;
+    static QCache<quint64, QImage> sources;
 
+    static QImage renderSource(Generator generator, const QString &path, const QSize &bucketSize);
+};
+
+class PhasePixmapGenerator
+{
 public:
     static QPixmap generatePixmap(int size, QString name);
     static void clear()
     {
-        pmCache.clear();
+        PixmapGeneratorCache::clear(PixmapGeneratorCache::Phase);
     }
 };
 
 class CounterPixmapGenerator
 {
-private:
-    static QMap<QString, QPixmap> pmCache;
-
 public:
     static QPixmap generatePixmap(int size, QString name, bool highlight);
     static void clear()
     {
-        pmCache.clear();
+        PixmapGeneratorCache::clear(PixmapGeneratorCache::Counter);
     }
 };
 
 class PingPixmapGenerator
 {
-private:
-    static QMap<int, QPixmap> pmCache;
-
 public:
     static QPixmap generatePixmap(int size, int value, int max);
     static void clear()
     {
-        pmCache.clear();
+        PixmapGeneratorCache::clear(PixmapGeneratorCache::Ping);
     }
 };
 
 class CountryPixmapGenerator
 {
-private:
-    static QMap<QString, QPixmap> pmCache;
-
 public:
     static QPixmap generatePixmap(int height, const QString &countryCode);
     static void clear()
     {
-        pmCache.clear();
+        PixmapGeneratorCache::clear(PixmapGeneratorCache::Country);
     }
 };
 
 class UserLevelPixmapGenerator
 {
-private:
-    static QMap<QString, QPixmap> pmCache;
-
 public:
     static QPixmap generatePixmap(int height, UserLevelFlags userLevel, bool isBuddy, QString privLevel = "NONE");
     static void clear()
     {
-        pmCache.clear();
+        PixmapGeneratorCache::clear(PixmapGeneratorCache::UserLevel);
     }
 };
 
 class LockPixmapGenerator
 {
-private:
-    static QMap<int, QPixmap> pmCache;
-
 public:
     static QPixmap generatePixmap(int height);
     static void clear()
     {
-        pmCache.clear();
+        PixmapGeneratorCache::clear(PixmapGeneratorCache::Lock);
     }
 };
 
@@ -16,6 +16,8 @@ CardInfoFrameWidget::CardInfoFrameWidget(const QString &cardName, QWidget *paren
     setContentsMargins(3, 3, 3, 3);
     pic = new CardInfoPictureWidget();
     pic->setObjectName("pic");
+    // shows the card the user is hovering
+    pic->setDownloadPriority(PictureDownloadScheduler::PriorityHovered);
     text = new CardInfoTextWidget();
     text->setObjectName("text");
     connect(text, SIGNAL(linkActivated(const QString &)), this, SLOT(setCard(const QString &)));
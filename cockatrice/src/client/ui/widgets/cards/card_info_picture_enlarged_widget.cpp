@@ -29,7 +29,7 @@ CardInfoPictureEnlargedWidget::CardInfoPictureEnlargedWidget(QWidget *parent)
 void CardInfoPictureEnlargedWidget::loadPixmap(const QSize &size)
 {
     if (info) {
-        PictureLoader::getPixmap(enlargedPixmap, info, size);
+        PictureLoader::getPixmap(enlargedPixmap, info, size, PictureDownloadScheduler::PriorityHovered);
     } else {
         PictureLoader::getCardBackPixmap(enlargedPixmap, size);
     }
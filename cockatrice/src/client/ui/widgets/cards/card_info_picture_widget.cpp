@@ -124,7 +124,7 @@ void CardInfoPictureWidget::loadPixmap()
 {
     PictureLoader::getCardBackLoadingInProgressPixmap(resizedPixmap, size());
     if (info) {
-        PictureLoader::getPixmap(resizedPixmap, info, size());
+        PictureLoader::getPixmap(resizedPixmap, info, size(), downloadPriority);
     } else {
         PictureLoader::getCardBackLoadingFailedPixmap(resizedPixmap, size());
     }
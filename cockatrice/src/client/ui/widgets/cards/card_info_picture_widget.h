@@ -2,6 +2,7 @@
 #define CARD_INFO_PICTURE_H
 
 #include "../../../../game/cards/card_database.h"
+#include "../../picture_download_scheduler.h"
 #include "card_info_picture_enlarged_widget.h"
 
 #include <QTimer>
@@ -21,6 +22,11 @@ public:
     }
     [[nodiscard]] QSize sizeHint() const override;
     void setHoverToZoomEnabled(bool enabled);
+    // How urgently a picture missing on disk gets downloaded
+    void setDownloadPriority(PictureDownloadScheduler::Priority priority)
+    {
+        downloadPriority = priority;
+    }
 
 public slots:
     void setCard(CardInfoPtr card);
@@ -63,6 +69,7 @@ private:
     CardInfoPictureEnlargedWidget *enlargedPixmapWidget;
     int enlargedPixmapOffset = 10;
     QTimer *hoverTimer;
+    PictureDownloadScheduler::Priority downloadPriority = PictureDownloadScheduler::PriorityVisible;
 };
 
 #endif
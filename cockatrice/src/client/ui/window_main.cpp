@@ -618,6 +618,9 @@ void MainWindow::setClientStatusTitle()
         case StatusLoggedIn:
             setWindowTitle(client->getUserName() + "@" + client->peerName());
             break;
+        case StatusResuming:
+            setWindowTitle(appName + " - " + tr("Connection lost, reconnecting..."));
+            break;
         case StatusRequestingForgotPassword:
             setWindowTitle(
                 appName + " - " +
@@ -847,6 +850,7 @@ MainWindow::MainWindow(QWidget *parent)
     connect(tabSupervisor, SIGNAL(setMenu(QList<QMenu *>)), this, SLOT(updateTabMenu(QList<QMenu *>)));
     connect(tabSupervisor, SIGNAL(localGameEnded()), this, SLOT(localGameEnded()));
     connect(tabSupervisor, SIGNAL(showWindowIfHidden()), this, SLOT(showWindowIfHidden()));
+    connect(client, SIGNAL(sessionResumed()), tabSupervisor, SLOT(resumeSession()));
     tabSupervisor->addDeckEditorTab(nullptr);
 
     setCentralWidget(tabSupervisor);
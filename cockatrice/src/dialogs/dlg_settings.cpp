@@ -709,6 +709,11 @@ DeckEditorSettingsPage::DeckEditorSettingsPage()
     networkRedirectCacheTtlEdit.setSingleStep(1);
     networkRedirectCacheTtlEdit.setValue(SettingsCache::instance().getRedirectCacheTtl());
 
+    picDownloadConnectionsEdit.setMinimum(PIC_DOWNLOAD_CONNECTIONS_PER_HOST_MIN);
+    picDownloadConnectionsEdit.setMaximum(PIC_DOWNLOAD_CONNECTIONS_PER_HOST_MAX);
+    picDownloadConnectionsEdit.setSingleStep(1);
+    picDownloadConnectionsEdit.setValue(SettingsCache::instance().getPicDownloadConnectionsPerHost());
+
     auto networkCacheLayout = new QHBoxLayout;
     networkCacheLayout->addStretch();
     networkCacheLayout->addWidget(&networkCacheLabel);
@@ -719,6 +724,11 @@ DeckEditorSettingsPage::DeckEditorSettingsPage()
     networkRedirectCacheLayout->addWidget(&networkRedirectCacheTtlLabel);
     networkRedirectCacheLayout->addWidget(&networkRedirectCacheTtlEdit);
 
+    auto picDownloadConnectionsLayout = new QHBoxLayout;
+    picDownloadConnectionsLayout->addStretch();
+    picDownloadConnectionsLayout->addWidget(&picDownloadConnectionsLabel);
+    picDownloadConnectionsLayout->addWidget(&picDownloadConnectionsEdit);
+
     auto pixmapCacheLayout = new QHBoxLayout;
     pixmapCacheLayout->addStretch();
     pixmapCacheLayout->addWidget(&pixmapCacheLabel);
@@ -728,6 +738,7 @@ DeckEditorSettingsPage::DeckEditorSettingsPage()
     lpGeneralGrid->addWidget(&picDownloadCheckBox, 0, 0);
     lpGeneralGrid->addWidget(&resetDownloadURLs, 0, 1);
     lpGeneralGrid->addLayout(urlListLayout, 1, 0, 1, 2);
+    lpGeneralGrid->addLayout(picDownloadConnectionsLayout, 2, 0);
     lpGeneralGrid->addLayout(networkCacheLayout, 2, 1);
     lpGeneralGrid->addLayout(networkRedirectCacheLayout, 3, 0);
     lpGeneralGrid->addLayout(pixmapCacheLayout, 3, 1);
@@ -752,6 +763,8 @@ DeckEditorSettingsPage::DeckEditorSettingsPage()
             SLOT(setNetworkCacheSizeInMB(int)));
     connect(&networkRedirectCacheTtlEdit, SIGNAL(valueChanged(int)), &SettingsCache::instance(),
             SLOT(setNetworkRedirectCacheTtl(int)));
+    connect(&picDownloadConnectionsEdit, SIGNAL(valueChanged(int)), &SettingsCache::instance(),
+            SLOT(setPicDownloadConnectionsPerHost(int)));
 
     mpGeneralGroupBox = new QGroupBox;
     mpGeneralGroupBox->setLayout(lpGeneralGrid);
@@ -938,6 +951,8 @@ void DeckEditorSettingsPage::retranslateUi()
     networkCacheEdit.setToolTip(tr("On-disk cache for downloaded pictures"));
     networkRedirectCacheTtlLabel.setText(tr("Redirect Cache TTL:"));
     networkRedirectCacheTtlEdit.setToolTip(tr("How long cached redirects for urls are valid for."));
+    picDownloadConnectionsLabel.setText(tr("Parallel Downloads:"));
+    picDownloadConnectionsEdit.setToolTip(tr("How many pictures are downloaded at once from the same server"));
     pixmapCacheLabel.setText(tr("Picture Cache Size:"));
     pixmapCacheEdit.setToolTip(tr("In-memory cache for pictures not currently on screen"));
     updateNowButton->setText(tr("Update Spoilers"));
@@ -990,6 +1005,14 @@ MessagesSettingsPage::MessagesSettingsPage()
     roomHistory.setChecked(SettingsCache::instance().getRoomHistory());
     connect(&roomHistory, &QCheckBox::QT_STATE_CHANGED, &SettingsCache::instance(), &SettingsCache::setRoomHistory);
 
+    chatScrollbackEdit.setMinimum(CHAT_SCROLLBACK_MIN);
+    chatScrollbackEdit.setMaximum(CHAT_SCROLLBACK_MAX);
+    chatScrollbackEdit.setSingleStep(1000);
+    chatScrollbackEdit.setValue(SettingsCache::instance().getChatScrollback());
+    // Every open chat is trimmed to the new limit, so only apply it once the user is done typing
+    chatScrollbackEdit.setKeyboardTracking(false);
+    connect(&chatScrollbackEdit, SIGNAL(valueChanged(int)), &SettingsCache::instance(), SLOT(setChatScrollback(int)));
+
     customAlertString = new QLineEdit();
     customAlertString->setText(SettingsCache::instance().getHighlightWords());
     connect(customAlertString, SIGNAL(textChanged(QString)), &SettingsCache::instance(),
@@ -1006,6 +1029,8 @@ MessagesSettingsPage::MessagesSettingsPage()
     chatGrid->addWidget(&messagePopups, 4, 0);
     chatGrid->addWidget(&mentionPopups, 5, 0);
     chatGrid->addWidget(&roomHistory, 6, 0);
+    chatGrid->addWidget(&chatScrollbackLabel, 7, 0);
+    chatGrid->addWidget(&chatScrollbackEdit, 7, 1);
     chatGroupBox = new QGroupBox;
     chatGroupBox->setLayout(chatGrid);
 
@@ -1180,6 +1205,8 @@ void MessagesSettingsPage::retranslateUi()
     messagePopups.setText(tr("Enable desktop notifications for private messages"));
     mentionPopups.setText(tr("Enable desktop notification for mentions"));
     roomHistory.setText(tr("Enable room message history on join"));
+    chatScrollbackLabel.setText(tr("Messages kept in chats and game logs:"));
+    chatScrollbackEdit.setToolTip(tr("Older messages are removed once a chat or game log has this many"));
     hexLabel.setText(tr("(Color is hexadecimal)"));
     hexHighlightLabel.setText(tr("(Color is hexadecimal)"));
     customAlertStringLabel.setText(tr("Separate words with a space, alphanumeric characters only"));
@@ -191,6 +191,8 @@ private:
     QSpinBox networkCacheEdit;
     QLabel networkRedirectCacheTtlLabel;
     QSpinBox networkRedirectCacheTtlEdit;
+    QLabel picDownloadConnectionsLabel;
+    QSpinBox picDownloadConnectionsEdit;
     QSpinBox pixmapCacheEdit;
     QLabel pixmapCacheLabel;
 };
@@ -225,6 +227,8 @@ private:
     QCheckBox messagePopups;
     QCheckBox mentionPopups;
     QCheckBox roomHistory;
+    QLabel chatScrollbackLabel;
+    QSpinBox chatScrollbackEdit;
     QGroupBox *chatGroupBox;
     QGroupBox *highlightGroupBox;
     QGroupBox *messageGroupBox;
@@ -49,6 +49,10 @@ public:
     {
         return player;
     }
+    QColor getColor() const
+    {
+        return color;
+    }
     void setStartItem(ArrowTarget *_item)
     {
         startItem = _item;
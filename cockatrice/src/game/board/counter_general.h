@@ -20,6 +20,14 @@ public:
                    bool useNameForShortcut = false,
                    QGraphicsItem *parent = nullptr,
                    QWidget *game = nullptr);
+    QColor getColor() const
+    {
+        return color;
+    }
+    int getRadius() const
+    {
+        return radius;
+    }
     QRectF boundingRect() const;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 };
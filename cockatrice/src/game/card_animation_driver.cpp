@@ -0,0 +1,102 @@
+#include "card_animation_driver.h"
+
+#include "cards/card_item.h"
+
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QScreen>
+#include <QWindow>
+
+CardAnimationDriver::CardAnimationDriver(QGraphicsScene *_scene)
+    : QAbstractAnimation(_scene), scene(_scene), lastFrameTime(0)
+{
+}
+
+void CardAnimationDriver::registerCard(CardItem *card)
+{
+    cards.insert(card);
+    if (!isSceneVisible()) {
+        finishAll();
+        return;
+    }
+    if (state() != Running) {
+        start();
+    }
+}
+
+void CardAnimationDriver::unregisterCard(CardItem *card)
+{
+    cards.remove(card);
+    if (cards.isEmpty()) {
+        stop();
+    }
+}
+
+void CardAnimationDriver::updateState(State newState, State /*oldState*/)
+{
+    if (newState == Running) {
+        lastFrameTime = 0;
+    }
+}
+
+void CardAnimationDriver::updateCurrentTime(int currentTime)
+{
+    const int frameMs = currentTime - lastFrameTime;
+    lastFrameTime = currentTime;
+    if (frameMs <= 0) {
+        return;
+    }
+
+    if (!isSceneVisible()) {
+        finishAll();
+        return;
+    }
+
+    ++frameStatistics.frames;
+    frameStatistics.totalFrameMs += frameMs;
+    frameStatistics.longestFrameMs = qMax(frameStatistics.longestFrameMs, frameMs);
+    if (frameMs > 2 * refreshIntervalMs()) {
+        ++frameStatistics.slowFrames;
+    }
+
+    QMutableSetIterator<CardItem *> i(cards);
+    while (i.hasNext()) {
+        if (!i.next()->animationEvent(frameMs)) {
+            i.remove();
+        }
+    }
+    if (cards.isEmpty()) {
+        stop();
+    }
+}
+
+bool CardAnimationDriver::isSceneVisible() const
+{
+    for (const QGraphicsView *view : scene->views()) {
+        if (view->isVisible() && !view->window()->isMinimized()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int CardAnimationDriver::refreshIntervalMs() const
+{
+    for (const QGraphicsView *view : scene->views()) {
+        const QWindow *window = view->window()->windowHandle();
+        if (window && window->screen() && window->screen()->refreshRate() > 0) {
+            return qMax(1, qRound(1000 / window->screen()->refreshRate()));
+        }
+    }
+    return 16;
+}
+
+// Jumps every running animation to its end, nobody would see the frames in between
+void CardAnimationDriver::finishAll()
+{
+    for (CardItem *card : cards) {
+        card->animationEvent(TAP_ANIMATION_MS);
+    }
+    cards.clear();
+    stop();
+}
@@ -0,0 +1,71 @@
+#ifndef CARD_ANIMATION_DRIVER_H
+#define CARD_ANIMATION_DRIVER_H
+
+#include <QAbstractAnimation>
+#include <QSet>
+
+class CardItem;
+class QGraphicsScene;
+
+/**
+ * Runs the tap animations of the cards in a GameScene.
+ *
+ * Ticks on Qt's animation clock, which advances all running animations of the application together once per frame,
+ * in sync with the display where the platform provides a frame clock. Every animating card is advanced in the same
+ * tick by the time that actually passed, so the scene repaints all of them at once per frame.
+ *
+ * Nothing ticks while none of the views of the scene can be seen; running animations jump to their end then.
+ */
+class CardAnimationDriver : public QAbstractAnimation
+{
+    Q_OBJECT
+public:
+    struct FrameStatistics
+    {
+        int frames = 0;
+        qint64 totalFrameMs = 0;
+        int longestFrameMs = 0;
+        // frames that took more than two display refreshes, so at least one was skipped
+        int slowFrames = 0;
+
+        qreal averageFrameMs() const
+        {
+            return frames ? static_cast<qreal>(totalFrameMs) / frames : 0;
+        }
+    };
+
+    explicit CardAnimationDriver(QGraphicsScene *_scene);
+
+    int duration() const override
+    {
+        return -1;
+    }
+
+    void registerCard(CardItem *card);
+    void unregisterCard(CardItem *card);
+
+    const FrameStatistics &getFrameStatistics() const
+    {
+        return frameStatistics;
+    }
+    void resetFrameStatistics()
+    {
+        frameStatistics = FrameStatistics();
+    }
+
+protected:
+    void updateCurrentTime(int currentTime) override;
+    void updateState(State newState, State oldState) override;
+
+private:
+    QGraphicsScene *scene;
+    QSet<CardItem *> cards;
+    int lastFrameTime;
+    FrameStatistics frameStatistics;
+
+    bool isSceneVisible() const;
+    int refreshIntervalMs() const;
+    void finishAll();
+};
+
+#endif
@@ -18,21 +18,38 @@ AbstractCardItem::AbstractCardItem(QGraphicsItem *parent,
                                    Player *_owner,
                                    int _id)
     : ArrowTarget(_owner, parent), id(_id), name(_name), providerId(_providerId), tapped(false), facedown(false),
-      tapAngle(0), bgColor(Qt::transparent), isHovered(false), realZValue(0)
+      tapAngle(0), bgColor(Qt::transparent), isHovered(false), realZValue(0), faceCacheValid(false)
 {
     setCursor(Qt::OpenHandCursor);
     setFlag(ItemIsSelectable);
-    setCacheMode(DeviceCoordinateCache);
+    // no item cache, paint() keeps the face itself and tapping, hovering or selecting the card doesn't change it
 
     connect(&SettingsCache::instance(), SIGNAL(displayCardNamesChanged()), this, SLOT(callUpdate()));
+    connect(&SettingsCache::instance(), SIGNAL(maxFontSizeChanged()), this, SLOT(callUpdate()));
     cardInfoUpdated();
 }
 
 AbstractCardItem::~AbstractCardItem()
 {
+    releasePicture();
     emit deleteCardInfoPopup(name);
 }
 
+void AbstractCardItem::releasePicture()
+{
+    if (!info) {
+        return;
+    }
+
+    // nobody else shows a printing we got our own copy of, so its picture isn't needed anymore. Other cards showing
+    // a shared one raise it again when they are painted.
+    if (info != CardDatabaseManager::getInstance()->getCard(name)) {
+        PictureLoader::cancelImageLoad(info);
+    } else {
+        PictureLoader::lowerImageLoadPriority(info);
+    }
+}
+
 QRectF AbstractCardItem::boundingRect() const
 {
     return QRectF(0, 0, CARD_WIDTH, CARD_HEIGHT);
@@ -47,7 +64,7 @@ QPainterPath AbstractCardItem::shape() const
 
 void AbstractCardItem::pixmapUpdated()
 {
-    update();
+    invalidateFaceCache();
     emit sigPixmapUpdated();
 }
 
@@ -66,7 +83,7 @@ void AbstractCardItem::cardInfoUpdated()
     }
 
     cacheBgColor();
-    update();
+    invalidateFaceCache();
 }
 
 void AbstractCardItem::setRealZValue(qreal _zValue)
@@ -112,7 +129,9 @@ void AbstractCardItem::paintPicture(QPainter *painter, const QSizeF &translatedS
     } else {
         // don't even spend time trying to load the picture if our size is too small
         if (translatedSize.width() > 10) {
-            PictureLoader::getPixmap(translatedPixmap, info, translatedSize.toSize());
+            // being painted, so the card is on screen
+            PictureLoader::getPixmap(translatedPixmap, info, translatedSize.toSize(),
+                                     PictureDownloadScheduler::PriorityVisible);
             if (translatedPixmap.isNull())
                 paintImage = false;
         } else {
@@ -152,12 +171,43 @@ void AbstractCardItem::paintPicture(QPainter *painter, const QSizeF &translatedS
     painter->restore();
 }
 
+void AbstractCardItem::paintFace(QPainter *painter, const QSizeF &translatedSize, int angle)
+{
+    paintPicture(painter, translatedSize, angle);
+}
+
+void AbstractCardItem::invalidateFaceCache()
+{
+    faceCacheValid = false;
+    update();
+}
+
 void AbstractCardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem * /*option*/, QWidget * /*widget*/)
 {
     painter->save();
 
-    QSizeF translatedSize = getTranslatedSize(painter);
-    paintPicture(painter, translatedSize, tapAngle);
+    // The face is painted upright at the size the card is shown at, the painter rotates it along with the card
+    const QSizeF translatedSize = getTranslatedSize(painter);
+    const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+    const QSize faceSize = (translatedSize * devicePixelRatio).toSize();
+    if (!faceCacheValid || faceCache.size() != faceSize) {
+        faceCache = QPixmap();
+        if (!faceSize.isEmpty()) {
+            faceCache = QPixmap(faceSize);
+            faceCache.setDevicePixelRatio(devicePixelRatio);
+            faceCache.fill(Qt::transparent);
+
+            QPainter facePainter(&faceCache);
+            facePainter.setRenderHints(painter->renderHints());
+            facePainter.scale(translatedSize.width() / CARD_WIDTH, translatedSize.height() / CARD_HEIGHT);
+            paintFace(&facePainter, translatedSize, 0);
+        }
+        faceCacheValid = true;
+    }
+    if (!faceCache.isNull()) {
+        painter->setRenderHint(QPainter::SmoothPixmapTransform, tapAngle % 90 != 0);
+        painter->drawPixmap(boundingRect(), faceCache, QRectF(faceCache.rect()));
+    }
 
     painter->setRenderHint(QPainter::Antialiasing, false);
 
@@ -221,7 +271,7 @@ void AbstractCardItem::setColor(const QString &_color)
 {
     color = _color;
     cacheBgColor();
-    update();
+    invalidateFaceCache();
 }
 
 void AbstractCardItem::cacheBgColor()
@@ -280,7 +330,7 @@ void AbstractCardItem::setTapped(bool _tapped, bool canAnimate)
 void AbstractCardItem::setFaceDown(bool _facedown)
 {
     facedown = _facedown;
-    update();
+    invalidateFaceCache();
 }
 
 void AbstractCardItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
@@ -319,6 +369,10 @@ QVariant AbstractCardItem::itemChange(QGraphicsItem::GraphicsItemChange change,
     if (change == ItemSelectedHasChanged) {
         update();
         return value;
-    } else
-        return QGraphicsItem::itemChange(change, value);
+    } else if ((change == ItemVisibleHasChanged && !value.toBool()) ||
+               (change == ItemSceneHasChanged && !value.value<QGraphicsScene *>())) {
+        // out of view, the picture is requested again when the card is painted next
+        releasePicture();
+    }
+    return QGraphicsItem::itemChange(change, value);
 }
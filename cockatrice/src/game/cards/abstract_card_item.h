@@ -4,6 +4,8 @@
 #include "../board/arrow_target.h"
 #include "card_database.h"
 
+#include <QPixmap>
+
 class Player;
 
 const int CARD_WIDTH = 72;
@@ -26,12 +28,14 @@ protected:
 private:
     bool isHovered;
     qreal realZValue;
+    QPixmap faceCache;
+    bool faceCacheValid;
 private slots:
     void pixmapUpdated();
     void cardInfoUpdated();
     void callUpdate()
     {
-        update();
+        invalidateFaceCache();
     }
 signals:
     void hovered(AbstractCardItem *card);
@@ -71,6 +75,9 @@ public:
     void setId(int _id)
     {
         id = _id;
+        if (facedown) {
+            invalidateFaceCache();
+        }
     }
     QString getName() const
     {
@@ -111,10 +118,16 @@ public:
 
 protected:
     void transformPainter(QPainter *painter, const QSizeF &translatedSize, int angle);
+    // Paints everything that only changes with the attributes of the card, the result is cached by paint()
+    virtual void paintFace(QPainter *painter, const QSizeF &translatedSize, int angle);
+    // Call instead of update() when something paintFace() shows has changed
+    void invalidateFaceCache();
     void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
     QVariant itemChange(QGraphicsItem::GraphicsItemChange change, const QVariant &value) override;
     void cacheBgColor();
+    // Lowers or cancels the picture download of a card that can't be seen anymore
+    void releasePicture();
 };
 
 #endif
@@ -5,8 +5,11 @@
 #include "../../settings/cache_settings.h"
 #include "../../utility/card_set_comparator.h"
 #include "../game_specific_terms.h"
+#include "./card_database_cache.h"
 #include "./card_database_parser/cockatrice_xml_3.h"
 #include "./card_database_parser/cockatrice_xml_4.h"
+#include "./card_database_stage.h"
+#include "./card_search_index.h"
 
 #include <QCryptographicHash>
 #include <QDebug>
@@ -15,6 +18,8 @@
 #include <QFile>
 #include <QMessageBox>
 #include <QRegularExpression>
+#include <QSet>
+#include <QtConcurrent>
 #include <algorithm>
 #include <utility>
 
@@ -237,7 +242,7 @@ CardInfo::CardInfo(const QString &_name,
                    bool _landscapeOrientation,
                    int _tableRow,
                    bool _upsideDownArt)
-    : name(_name), text(_text), isToken(_isToken), properties(std::move(_properties)), relatedCards(_relatedCards),
+    : name(_name), text(_text), isToken(_isToken), properties(_properties), relatedCards(_relatedCards),
       reverseRelatedCards(_reverseRelatedCards), sets(std::move(_sets)), cipt(_cipt),
       landscapeOrientation(_landscapeOrientation), tableRow(_tableRow), upsideDownArt(_upsideDownArt)
 {
@@ -304,6 +309,16 @@ void CardInfo::addToSet(const CardSetPtr &_set, const CardInfoPerSet _info)
     refreshCachedSetNames();
 }
 
+void CardInfo::rebindSet(const CardSetPtr &_set)
+{
+    auto printings = sets.find(_set->getShortName());
+    if (printings == sets.end())
+        return;
+
+    for (CardInfoPerSet &printing : *printings)
+        printing.setPtr(_set);
+}
+
 void CardInfo::refreshCachedSetNames()
 {
     QStringList setList;
@@ -373,6 +388,7 @@ CardDatabase::CardDatabase(QObject *parent) : QObject(parent), loadStatus(NotLoa
 
 CardDatabase::~CardDatabase()
 {
+    searchIndexBuild.waitForFinished();
     clear();
     qDeleteAll(availableParsers);
 }
@@ -391,6 +407,16 @@ void CardDatabase::clear()
 
     cards.clear();
     simpleNameCards.clear();
+    printingIndexLock.lockForWrite();
+    preferredPrintings.clear();
+    printingsByProviderId.clear();
+    printingIndexLock.unlock();
+    indexedSetOrder.clear();
+
+    searchIndexMutex.lock();
+    searchIndex.clear();
+    ++searchIndexGeneration;
+    searchIndexMutex.unlock();
 
     sets.clear();
     ICardDatabaseParser::clearSetlist();
@@ -407,6 +433,7 @@ void CardDatabase::addCard(CardInfoPtr card)
         return;
     }
 
+    addCardMutex->lock();
     // if card already exists just add the new set property
     if (cards.contains(card->getName())) {
         CardInfoPtr sameCard = cards[card->getName()];
@@ -415,12 +442,14 @@ void CardDatabase::addCard(CardInfoPtr card)
                 sameCard->addToSet(set.getPtr(), set);
             }
         }
+        indexPrintings(sameCard);
+        addCardMutex->unlock();
         return;
     }
 
-    addCardMutex->lock();
     cards.insert(card->getName(), card);
     simpleNameCards.insert(card->getSimpleName(), card);
+    indexPrintings(card);
     addCardMutex->unlock();
     emit cardAdded(card);
 }
@@ -444,6 +473,16 @@ void CardDatabase::removeCard(CardInfoPtr card)
     removeCardMutex->lock();
     cards.remove(card->getName());
     simpleNameCards.remove(card->getSimpleName());
+    printingIndexLock.lockForWrite();
+    preferredPrintings.remove(card->getName());
+    for (const auto &cardInfoPerSetList : card->getSets()) {
+        for (const CardInfoPerSet &set : cardInfoPerSetList) {
+            auto printing = printingsByProviderId.find(set.getProperty("uuid"));
+            if (printing != printingsByProviderId.end() && printing->first == card)
+                printingsByProviderId.erase(printing);
+        }
+    }
+    printingIndexLock.unlock();
     removeCardMutex->unlock();
     emit cardRemoved(card);
 }
@@ -472,17 +511,13 @@ CardInfoPtr CardDatabase::getCardByNameAndProviderId(const QString &cardName, co
         return info;
     }
 
-    for (const auto &cardInfoPerSetList : info->getSets()) {
-        for (const auto &set : cardInfoPerSetList) {
-            if (set.getProperty("uuid") == providerId) {
-                CardInfoPtr cardFromSpecificSet = info->clone();
-                cardFromSpecificSet->setPixmapCacheKey(QLatin1String("card_") + QString(info->getName()) +
-                                                       QString("_") + QString(set.getProperty("uuid")));
-                return cardFromSpecificSet;
-            }
-        }
+    if (getSpecificSetForCard(cardName, providerId).getPtr().isNull()) {
+        return {};
     }
-    return {};
+
+    CardInfoPtr cardFromSpecificSet = info->clone();
+    cardFromSpecificSet->setPixmapCacheKey(QLatin1String("card_") + info->getName() + QString("_") + providerId);
+    return cardFromSpecificSet;
 }
 
 CardInfoPtr CardDatabase::getCardBySimpleName(const QString &cardName) const
@@ -539,6 +574,11 @@ CardInfoPtr CardDatabase::getCardFromMap(const CardNameMap &cardMap, const QStri
 }
 
 LoadStatus CardDatabase::loadFromFile(const QString &fileName)
+{
+    return loadFromFile(fileName, availableParsers);
+}
+
+LoadStatus CardDatabase::loadFromFile(const QString &fileName, const QVector<ICardDatabaseParser *> &parsers)
 {
     QFile file(fileName);
     file.open(QIODevice::ReadOnly);
@@ -546,7 +586,7 @@ LoadStatus CardDatabase::loadFromFile(const QString &fileName)
         return FileError;
     }
 
-    for (auto parser : availableParsers) {
+    for (auto parser : parsers) {
         file.reset();
         if (parser->getCanParseFile(fileName, file)) {
             file.reset();
@@ -575,6 +615,54 @@ LoadStatus CardDatabase::loadCardDatabase(const QString &path)
     return tempLoadStatus;
 }
 
+void CardDatabase::mergeStage(const CardDatabaseStage &stage)
+{
+    // an earlier file that already introduced a set keeps its definition, the printings are moved over to it
+    SetNameMap replacedSets;
+    for (const CardSetPtr &set : stage.getSets()) {
+        const CardSetPtr knownSet = sets.value(set->getShortName());
+        if (knownSet) {
+            replacedSets.insert(set->getShortName(), knownSet);
+        } else {
+            addSet(set);
+            ICardDatabaseParser::addToSetlist(set);
+        }
+    }
+
+    QList<CardInfoPtr> newCards;
+    addCardMutex->lock();
+    for (const CardInfoPtr &card : stage.getCards()) {
+        const QStringList setNames = card->getSets().keys();
+        for (const QString &setName : setNames) {
+            if (replacedSets.contains(setName))
+                card->rebindSet(replacedSets.value(setName));
+        }
+
+        // if card already exists just add the new set property
+        const CardInfoPtr sameCard = cards.value(card->getName());
+        if (sameCard) {
+            for (const auto &cardInfoPerSetList : card->getSets()) {
+                for (const CardInfoPerSet &set : cardInfoPerSetList) {
+                    sameCard->addToSet(set.getPtr(), set);
+                }
+            }
+            continue;
+        }
+
+        cards.insert(card->getName(), card);
+        simpleNameCards.insert(card->getSimpleName(), card);
+        for (const QString &setName : setNames) {
+            if (replacedSets.contains(setName))
+                replacedSets.value(setName)->append(card);
+        }
+        newCards << card;
+    }
+    addCardMutex->unlock();
+
+    for (const CardInfoPtr &card : newCards)
+        emit cardAdded(card);
+}
+
 LoadStatus CardDatabase::loadCardDatabases()
 {
     reloadDatabaseMutex->lock();
@@ -583,10 +671,6 @@ LoadStatus CardDatabase::loadCardDatabases()
 
     clear(); // remove old db
 
-    loadStatus = loadCardDatabase(SettingsCache::instance().getCardDatabasePath()); // load main card database
-    loadCardDatabase(SettingsCache::instance().getTokenDatabasePath());             // load tokens database
-    loadCardDatabase(SettingsCache::instance().getSpoilerCardDatabasePath());       // load spoilers database
-
     // find all custom card databases, recursively & following symlinks
     // then load them alphabetically
     QDirIterator customDatabaseIterator(SettingsCache::instance().getCustomCardDatabasePath(), QStringList() << "*.xml",
@@ -598,15 +682,47 @@ LoadStatus CardDatabase::loadCardDatabases()
     }
     databasePaths.sort();
 
-    for (auto i = 0; i < databasePaths.size(); ++i) {
-        const auto &databasePath = databasePaths.at(i);
-        qDebug() << "Loading Custom Set" << i << "(" << databasePath << ")";
-        loadCardDatabase(databasePath);
+    const QStringList sourcePaths = QStringList() << SettingsCache::instance().getCardDatabasePath()
+                                                  << SettingsCache::instance().getTokenDatabasePath()
+                                                  << SettingsCache::instance().getSpoilerCardDatabasePath()
+                                                  << databasePaths;
+    CardDatabaseCache cache(SettingsCache::instance().getCachePath() + "/cards.cache");
+
+    auto startTime = QTime::currentTime();
+    const bool loadedFromCache = cache.load(*this, sourcePaths);
+    if (loadedFromCache) {
+        loadStatus = Ok;
+        qDebug() << "[CardDatabase] loadCardDatabases(): Snapshot =" << cache.getFileName() << "Cards =" << cards.size()
+                 << "Sets =" << sets.size() << QString("%1ms").arg(startTime.msecsTo(QTime::currentTime()));
+    } else {
+        // parse all files concurrently, then merge them in load order so that earlier files keep precedence
+        QList<CardDatabaseStage *> stages;
+        for (const QString &path : sourcePaths)
+            stages << new CardDatabaseStage(path);
+        QtConcurrent::blockingMap(stages, [](CardDatabaseStage *stage) { stage->parse(); });
+
+        loadStatus = stages.first()->getLoadStatus(); // the main card database decides whether loading succeeded
+        for (CardDatabaseStage *stage : stages) {
+            auto mergeStartTime = QTime::currentTime();
+            mergeStage(*stage);
+            qDebug() << "[CardDatabase] loadCardDatabases(): Path =" << stage->getPath()
+                     << "Status =" << stage->getLoadStatus() << "Cards =" << cards.size() << "Sets =" << sets.size()
+                     << QString("parsed in %1ms, merged in %2ms")
+                            .arg(stage->getParseTime())
+                            .arg(mergeStartTime.msecsTo(QTime::currentTime()));
+        }
+        qDeleteAll(stages);
+        qDebug() << "[CardDatabase] loadCardDatabases(): Parsed" << sourcePaths.size() << "files"
+                 << QString("%1ms").arg(startTime.msecsTo(QTime::currentTime()));
+
+        // the next start can skip parsing as long as none of the files change
+        if (loadStatus == Ok)
+            cache.save(*this, sourcePaths);
     }
 
     // AFTER all the cards have been loaded
 
-    // Refresh the pixmap cache keys for all cards by setting them to the UUID of the preferred printing
+    // index the preferred printing of every card, which also refreshes their pixmap cache keys
     refreshPreferredPrintings();
     // resolve the reverse-related tags
     refreshCachedReverseRelatedCards();
@@ -614,6 +730,9 @@ LoadStatus CardDatabase::loadCardDatabases()
     if (loadStatus == Ok) {
         checkUnknownSets(); // update deck editors, etc
         qDebug() << "CardDatabase::loadCardDatabases success";
+        qDebug() << "[CardDatabase] Card properties use" << CardProperties::internedKeyCount() << "names and"
+                 << CardProperties::internedValueCount() << "shared values";
+        rebuildSearchIndex();
         emit cardDatabaseLoadingFinished();
     } else {
         qDebug() << "CardDatabase::loadCardDatabases failed";
@@ -624,61 +743,144 @@ LoadStatus CardDatabase::loadCardDatabases()
     return loadStatus;
 }
 
+void CardDatabase::rebuildSearchIndex()
+{
+    searchIndexMutex.lock();
+    const int generation = ++searchIndexGeneration;
+    searchIndexMutex.unlock();
+
+    // the index is only needed once somebody searches, don't hold up the end of loading for it
+    const QList<CardInfoPtr> snapshot = cards.values();
+    searchIndexBuild.waitForFinished();
+    searchIndexBuild = QtConcurrent::run([this, snapshot, generation]() {
+        auto startTime = QTime::currentTime();
+        QSharedPointer<const CardSearchIndex> index(new CardSearchIndex(snapshot));
+
+        QMutexLocker locker(&searchIndexMutex);
+        if (generation != searchIndexGeneration) {
+            return; // the cards changed again while building
+        }
+        searchIndex = index;
+        locker.unlock();
+
+        qDebug() << "[CardDatabase] Search index of" << snapshot.size() << "cards built in"
+                 << QString("%1ms").arg(startTime.msecsTo(QTime::currentTime()));
+        emit searchIndexChanged();
+    });
+}
+
+QSharedPointer<const CardSearchIndex> CardDatabase::getSearchIndex() const
+{
+    QMutexLocker locker(&searchIndexMutex);
+    return searchIndex;
+}
+
 void CardDatabase::refreshPreferredPrintings()
 {
-    for (const CardInfoPtr &card : cards) {
-        card->setPixmapCacheKey(QLatin1String("card_") + QString(card->getName()) + QString("_") +
-                                QString(getPreferredPrintingProviderIdForCard(card->getName())));
-    }
+    indexedSetOrder.clear();
+    for (const CardSetPtr &set : sets)
+        indexedSetOrder.insert(set->getShortName(), qMakePair(set->getEnabled(), set->getSortKey()));
+
+    printingIndexLock.lockForWrite();
+    preferredPrintings.clear();
+    printingsByProviderId.clear();
+    printingIndexLock.unlock();
+    for (const CardInfoPtr &card : cards)
+        indexPrintings(card);
 }
 
-CardInfoPerSet CardDatabase::getPreferredSetForCard(const QString &cardName) const
+void CardDatabase::indexPrintings(const CardInfoPtr &card)
 {
-    CardInfoPtr cardInfo = getCard(cardName);
-    if (!cardInfo) {
-        return CardInfoPerSet(nullptr);
+    printingIndexLock.lockForWrite();
+    for (const auto &cardInfoPerSetList : card->getSets()) {
+        for (const CardInfoPerSet &set : cardInfoPerSetList) {
+            const QString providerId = set.getProperty("uuid");
+            if (!providerId.isEmpty())
+                printingsByProviderId.insert(providerId, qMakePair(card, set));
+        }
     }
+    printingIndexLock.unlock();
 
-    CardInfoPerSetMap setMap = cardInfo->getSets();
-    if (setMap.empty()) {
-        return CardInfoPerSet(nullptr);
-    }
+    refreshPreferredPrinting(card);
+}
 
+void CardDatabase::refreshPreferredPrinting(const CardInfoPtr &card)
+{
     CardSetPtr preferredSet = nullptr;
-    CardInfoPerSet preferredCard;
+    const CardInfoPerSet *preferredCard = nullptr;
     SetPriorityComparator comparator;
 
-    for (const auto &cardInfoPerSetList : setMap) {
-        for (auto &cardInfoForSet : cardInfoPerSetList) {
+    for (const auto &cardInfoPerSetList : card->getSets()) {
+        for (const auto &cardInfoForSet : cardInfoPerSetList) {
             CardSetPtr currentSet = cardInfoForSet.getPtr();
             if (!preferredSet || comparator(currentSet, preferredSet)) {
                 preferredSet = currentSet;
-                preferredCard = cardInfoForSet;
+                preferredCard = &cardInfoForSet;
             }
         }
     }
 
-    if (preferredSet) {
-        return preferredCard;
+    QString preferredProviderId;
+    printingIndexLock.lockForWrite();
+    if (preferredCard) {
+        preferredPrintings.insert(card->getName(), *preferredCard);
+        preferredProviderId = preferredCard->getProperty("uuid");
+    } else {
+        preferredPrintings.remove(card->getName());
     }
+    printingIndexLock.unlock();
 
-    return CardInfoPerSet(nullptr);
+    // Refresh the pixmap cache key by setting it to the UUID of the preferred printing
+    if (preferredProviderId.isEmpty())
+        preferredProviderId = card->getName();
+    card->setPixmapCacheKey(QLatin1String("card_") + card->getName() + QString("_") + preferredProviderId);
+}
+
+void CardDatabase::updatePreferredPrintings()
+{
+    // only cards printed in a set that was moved, enabled or disabled can have a different preferred printing now
+    QSet<CardInfoPtr> affectedCards;
+    for (const CardSetPtr &set : sets) {
+        const QPair<bool, unsigned int> order = qMakePair(set->getEnabled(), set->getSortKey());
+        auto indexedOrder = indexedSetOrder.find(set->getShortName());
+        if (indexedOrder != indexedSetOrder.end() && *indexedOrder == order)
+            continue;
+
+        indexedSetOrder.insert(set->getShortName(), order);
+        for (const CardInfoPtr &card : *set)
+            affectedCards.insert(card);
+    }
+
+    for (const CardInfoPtr &card : affectedCards) {
+        if (cards.value(card->getName()) == card)
+            refreshPreferredPrinting(card);
+    }
+}
+
+CardInfoPerSet CardDatabase::getPreferredSetForCard(const QString &cardName) const
+{
+    QReadLocker locker(&printingIndexLock);
+    return preferredPrintings.value(cardName, CardInfoPerSet(nullptr));
 }
 
 CardInfoPerSet CardDatabase::getSpecificSetForCard(const QString &cardName, const QString &providerId) const
 {
-    CardInfoPtr cardInfo = getCard(cardName);
-    if (!cardInfo) {
-        return CardInfoPerSet(nullptr);
+    {
+        QReadLocker locker(&printingIndexLock);
+        auto printing = printingsByProviderId.constFind(providerId);
+        if (printing != printingsByProviderId.constEnd() && printing->first->getName() == cardName) {
+            return printing->second;
+        }
     }
 
-    CardInfoPerSetMap setMap = cardInfo->getSets();
-    if (setMap.empty()) {
+    // provider ids aren't guaranteed to be unique across cards, fall back to looking at the printings of this card
+    CardInfoPtr cardInfo = getCard(cardName);
+    if (!cardInfo) {
         return CardInfoPerSet(nullptr);
     }
 
-    for (const auto &cardInfoPerSetList : setMap) {
-        for (auto &cardInfoForSet : cardInfoPerSetList) {
+    for (const auto &cardInfoPerSetList : cardInfo->getSets()) {
+        for (const auto &cardInfoForSet : cardInfoPerSetList) {
             if (cardInfoForSet.getProperty("uuid") == providerId) {
                 return cardInfoForSet;
             }
@@ -709,8 +911,12 @@ QString CardDatabase::getPreferredPrintingProviderIdForCard(const QString &cardN
 bool CardDatabase::isProviderIdForPreferredPrinting(const QString &cardName, const QString &providerId)
 {
     if (providerId.startsWith("card_")) {
-        return providerId ==
-               QLatin1String("card_") + cardName + QString("_") + getPreferredPrintingProviderIdForCard(cardName);
+        // the pixmap cache key of a card is built from its preferred printing already
+        CardInfoPtr cardInfo = getCard(cardName);
+        if (cardInfo) {
+            return providerId == cardInfo->getPixmapCacheKey();
+        }
+        return providerId == QLatin1String("card_") + cardName + QString("_") + cardName;
     }
     return providerId == getPreferredPrintingProviderIdForCard(cardName);
 }
@@ -810,6 +1016,8 @@ void CardDatabase::notifyEnabledSetsChanged()
     for (const CardInfoPtr &card : cards)
         card->refreshCachedSetNames();
 
+    updatePreferredPrintings();
+
     // inform the carddatabasemodels that they need to re-check their list of cards
     emit cardDatabaseEnabledSetsChanged();
 }
@@ -1,12 +1,17 @@
 #ifndef CARDDATABASE_H
 #define CARDDATABASE_H
 
+#include "card_properties.h"
+
 #include <QBasicMutex>
 #include <QDate>
+#include <QFuture>
 #include <QHash>
 #include <QList>
 #include <QMap>
 #include <QMetaType>
+#include <QMutex>
+#include <QReadWriteLock>
 #include <QSharedPointer>
 #include <QStringList>
 #include <QVariant>
@@ -14,10 +19,12 @@
 #include <utility>
 
 class CardDatabase;
+class CardDatabaseStage;
 class CardInfo;
 class CardInfoPerSet;
 class CardSet;
 class CardRelation;
+class CardSearchIndex;
 class ICardDatabaseParser;
 
 typedef QMap<QString, QString> QStringMap;
@@ -147,20 +154,24 @@ public:
 private:
     CardSetPtr set;
     // per-set card properties;
-    QVariantHash properties;
+    CardProperties properties;
 
 public:
     const CardSetPtr getPtr() const
     {
         return set;
     }
+    void setPtr(const CardSetPtr &_set)
+    {
+        set = _set;
+    }
     const QStringList getProperties() const
     {
         return properties.keys();
     }
     const QString getProperty(const QString &propertyName) const
     {
-        return properties.value(propertyName).toString();
+        return properties.value(propertyName);
     }
     void setProperty(const QString &_name, const QString &_value)
     {
@@ -184,7 +195,7 @@ private:
     // whether this is not a "real" card but a token
     bool isToken;
     // basic card properties; common for all the sets
-    QVariantHash properties;
+    CardProperties properties;
     // the cards i'm related to
     QList<CardRelation *> relatedCards;
     // the card i'm reverse-related to
@@ -288,7 +299,7 @@ public:
     }
     const QString getProperty(const QString &propertyName) const
     {
-        return properties.value(propertyName).toString();
+        return properties.value(propertyName);
     }
     void setProperty(const QString &_name, const QString &_value)
     {
@@ -390,6 +401,8 @@ public:
     }
     QString getCorrectedName() const;
     void addToSet(const CardSetPtr &_set, CardInfoPerSet _info = CardInfoPerSet());
+    // Points the printings from the set with the same short name at _set instead
+    void rebindSet(const CardSetPtr &_set);
     void emitPixmapUpdated()
     {
         emit pixmapUpdated();
@@ -439,14 +452,48 @@ protected:
      */
     SetNameMap sets;
 
+    /*
+     * The preferred printing of every card, indexed by card name.
+     * Kept up to date with the set order, so that lookups don't have to compare all printings again.
+     */
+    QHash<QString, CardInfoPerSet> preferredPrintings;
+
+    /*
+     * Every printing with a provider id (uuid), together with its card.
+     */
+    QHash<QString, QPair<CardInfoPtr, CardInfoPerSet>> printingsByProviderId;
+
+    /*
+     * Guards preferredPrintings and printingsByProviderId, which parse workers write while the gui reads them.
+     */
+    mutable QReadWriteLock printingIndexLock;
+
+    /*
+     * Enabled state and sort key of every set when the preferred printings were last computed.
+     */
+    QHash<QString, QPair<bool, unsigned int>> indexedSetOrder;
+
     LoadStatus loadStatus;
 
     QVector<ICardDatabaseParser *> availableParsers;
 
+    /*
+     * Search index over the loaded cards, rebuilt in the background after every load.
+     */
+    QSharedPointer<const CardSearchIndex> searchIndex;
+    mutable QMutex searchIndexMutex;
+    QFuture<void> searchIndexBuild;
+    int searchIndexGeneration = 0;
+
 private:
     CardInfoPtr getCardFromMap(const CardNameMap &cardMap, const QString &cardName) const;
     void checkUnknownSets();
     void refreshCachedReverseRelatedCards();
+    void mergeStage(const CardDatabaseStage &stage);
+    void indexPrintings(const CardInfoPtr &card);
+    void refreshPreferredPrinting(const CardInfoPtr &card);
+    void updatePreferredPrintings();
+    void rebuildSearchIndex();
 
     QBasicMutex *reloadDatabaseMutex = new QBasicMutex(), *clearDatabaseMutex = new QBasicMutex(),
                 *loadFromFileMutex = new QBasicMutex(), *addCardMutex = new QBasicMutex(),
@@ -482,12 +529,17 @@ public:
     }
     SetList getSetList() const;
     LoadStatus loadFromFile(const QString &fileName);
+    static LoadStatus loadFromFile(const QString &fileName, const QVector<ICardDatabaseParser *> &parsers);
     bool saveCustomTokensToFile();
     QStringList getAllMainCardTypes() const;
     LoadStatus getLoadStatus() const
     {
         return loadStatus;
     }
+    /*
+     * Null until the index of the current cards is built. Cards added afterwards aren't in it.
+     */
+    QSharedPointer<const CardSearchIndex> getSearchIndex() const;
     void enableAllUnknownSets();
     void markAllSetsAsKnown();
     void notifyEnabledSetsChanged();
@@ -505,6 +557,7 @@ signals:
     void cardDatabaseNewSetsFound(int numUnknownSets, QStringList unknownSetsNames);
     void cardDatabaseAllNewSetsEnabled();
     void cardDatabaseEnabledSetsChanged();
+    void searchIndexChanged();
     void cardAdded(CardInfoPtr card);
     void cardRemoved(CardInfoPtr card);
 };
@@ -0,0 +1,249 @@
+#include "card_database_cache.h"
+
+#include "card_database_parser/card_database_parser.h"
+#include "version_string.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+static const quint32 cacheMagic = 0x43544443; // "CTDC"
+static const quint32 cacheFormatVersion = 1;
+
+CardDatabaseCache::CardDatabaseCache(const QString &_fileName) : fileName(_fileName)
+{
+}
+
+QByteArray CardDatabaseCache::hashFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return hash.result();
+}
+
+CardDatabaseCache::SourceFile CardDatabaseCache::describeSource(const QString &path, bool withHash)
+{
+    QFileInfo info(path);
+    SourceFile source;
+    source.path = path;
+    // Files that don't exist are recorded too, creating one later makes the snapshot stale
+    source.size = info.exists() ? info.size() : -1;
+    source.lastModified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+    if (withHash && info.exists())
+        source.hash = hashFile(path);
+    return source;
+}
+
+bool CardDatabaseCache::isSourceUnchanged(const SourceFile &cached)
+{
+    const SourceFile current = describeSource(cached.path, false);
+    if (current.size != cached.size)
+        return false;
+    if (current.lastModified == cached.lastModified)
+        return true;
+
+    // Updaters rewrite files that didn't change, only the contents matter then
+    return current.size == -1 || hashFile(cached.path) == cached.hash;
+}
+
+void CardDatabaseCache::writeRelations(QDataStream &out, const QList<CardRelation *> &relations)
+{
+    out << static_cast<quint32>(relations.size());
+    for (const CardRelation *relation : relations) {
+        out << relation->getName() << static_cast<qint32>(relation->getAttachType())
+            << relation->getIsCreateAllExclusion() << relation->getIsVariable()
+            << static_cast<qint32>(relation->getDefaultCount()) << relation->getIsPersistent();
+    }
+}
+
+QList<CardRelation *> CardDatabaseCache::readRelations(QDataStream &in)
+{
+    QList<CardRelation *> relations;
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString name;
+        qint32 attachType = 0, defaultCount = 1;
+        bool isCreateAllExclusion = false, isVariable = false, isPersistent = false;
+        in >> name >> attachType >> isCreateAllExclusion >> isVariable >> defaultCount >> isPersistent;
+        relations << new CardRelation(name, static_cast<CardRelation::AttachType>(attachType), isCreateAllExclusion,
+                                      isVariable, defaultCount, isPersistent);
+    }
+    return relations;
+}
+
+bool CardDatabaseCache::save(const CardDatabase &database, const QStringList &sourcePaths) const
+{
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "[CardDatabaseCache] Could not write" << fileName;
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_8);
+    out << cacheMagic << cacheFormatVersion << QString(VERSION_STRING);
+
+    out << static_cast<quint32>(sourcePaths.size());
+    for (const QString &path : sourcePaths) {
+        const SourceFile source = describeSource(path, true);
+        out << source.path << source.size << source.lastModified << source.hash;
+    }
+
+    const SetList sets = database.getSetList();
+    out << static_cast<quint32>(sets.size());
+    for (const CardSetPtr &set : sets) {
+        out << set->getShortName() << set->getLongName() << set->getSetType() << set->getReleaseDate()
+            << static_cast<qint32>(set->getPriority()) << set->getEnabled();
+    }
+
+    const QList<CardInfoPtr> cards = database.getCardList();
+    out << static_cast<quint32>(cards.size());
+    for (const CardInfoPtr &card : cards) {
+        QStringMap properties;
+        for (const QString &property : card->getProperties())
+            properties.insert(property, card->getProperty(property));
+
+        out << card->getName() << card->getText() << card->getIsToken() << properties << card->getCipt()
+            << card->getLandscapeOrientation() << static_cast<qint32>(card->getTableRow())
+            << card->getUpsideDownArt();
+        writeRelations(out, card->getRelatedCards());
+        writeRelations(out, card->getReverseRelatedCards());
+
+        const CardInfoPerSetMap &cardSets = card->getSets();
+        out << static_cast<quint32>(cardSets.size());
+        for (auto it = cardSets.constBegin(); it != cardSets.constEnd(); ++it) {
+            out << it.key() << static_cast<quint32>(it.value().size());
+            for (const CardInfoPerSet &printing : it.value()) {
+                QStringMap printingProperties;
+                for (const QString &property : printing.getProperties())
+                    printingProperties.insert(property, printing.getProperty(property));
+                out << printingProperties;
+            }
+        }
+    }
+
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qDebug() << "[CardDatabaseCache] Could not write" << fileName;
+        return false;
+    }
+    return true;
+}
+
+bool CardDatabaseCache::load(CardDatabase &database, const QStringList &sourcePaths) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    // Strings are decoded straight from the mapped pages, without copying the file into memory first
+    const qint64 fileSize = file.size();
+    uchar *mapped = file.map(0, fileSize);
+    if (!mapped)
+        return false;
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), static_cast<int>(fileSize));
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_8);
+
+    quint32 magic = 0, formatVersion = 0;
+    QString version;
+    in >> magic >> formatVersion >> version;
+    if (magic != cacheMagic || formatVersion != cacheFormatVersion || version != QString(VERSION_STRING))
+        return false;
+
+    quint32 sourceCount = 0;
+    in >> sourceCount;
+    if (sourceCount != static_cast<quint32>(sourcePaths.size()))
+        return false;
+    for (quint32 i = 0; i < sourceCount; ++i) {
+        SourceFile source;
+        in >> source.path >> source.size >> source.lastModified >> source.hash;
+        if (in.status() != QDataStream::Ok || source.path != sourcePaths.at(static_cast<int>(i)) ||
+            !isSourceUnchanged(source))
+            return false;
+    }
+
+    SetNameMap sets;
+    quint32 setCount = 0;
+    in >> setCount;
+    for (quint32 i = 0; i < setCount && in.status() == QDataStream::Ok; ++i) {
+        QString shortName, longName, setType;
+        QDate releaseDate;
+        qint32 priority = 0;
+        bool enabled = false;
+        in >> shortName >> longName >> setType >> releaseDate >> priority >> enabled;
+        const CardSetPtr set = CardSet::newInstance(shortName, longName, setType, releaseDate,
+                                                    static_cast<CardSet::Priority>(priority));
+        // The parsers skip printings from disabled sets, so the snapshot only fits the same selection of sets
+        if (set->getEnabled() != enabled)
+            return false;
+        sets.insert(shortName, set);
+    }
+
+    QList<CardInfoPtr> cards;
+    quint32 cardCount = 0;
+    in >> cardCount;
+    for (quint32 i = 0; i < cardCount && in.status() == QDataStream::Ok; ++i) {
+        QString name, text;
+        bool isToken = false, cipt = false, landscapeOrientation = false, upsideDownArt = false;
+        QStringMap properties;
+        qint32 tableRow = 0;
+        in >> name >> text >> isToken >> properties >> cipt >> landscapeOrientation >> tableRow >> upsideDownArt;
+        const QList<CardRelation *> relatedCards = readRelations(in);
+        const QList<CardRelation *> reverseRelatedCards = readRelations(in);
+
+        CardInfoPerSetMap cardSets;
+        quint32 cardSetCount = 0;
+        in >> cardSetCount;
+        for (quint32 j = 0; j < cardSetCount && in.status() == QDataStream::Ok; ++j) {
+            QString setName;
+            quint32 printingCount = 0;
+            in >> setName >> printingCount;
+            const CardSetPtr set = sets.value(setName);
+            for (quint32 k = 0; k < printingCount && in.status() == QDataStream::Ok; ++k) {
+                QStringMap printingProperties;
+                in >> printingProperties;
+                CardInfoPerSet printing(set);
+                for (auto it = printingProperties.constBegin(); it != printingProperties.constEnd(); ++it)
+                    printing.setProperty(it.key(), it.value());
+                cardSets[setName].append(printing);
+            }
+            if (!set)
+                in.setStatus(QDataStream::ReadCorruptData);
+        }
+
+        QVariantHash propertyHash;
+        for (auto it = properties.constBegin(); it != properties.constEnd(); ++it)
+            propertyHash.insert(it.key(), it.value());
+
+        cards << CardInfo::newInstance(name, text, isToken, propertyHash, relatedCards, reverseRelatedCards, cardSets,
+                                       cipt, landscapeOrientation, tableRow, upsideDownArt);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qDebug() << "[CardDatabaseCache] Ignoring unreadable snapshot" << fileName;
+        for (const CardInfoPtr &card : cards) {
+            qDeleteAll(card->getRelatedCards());
+            qDeleteAll(card->getReverseRelatedCards());
+        }
+        return false;
+    }
+
+    for (const CardSetPtr &set : sets) {
+        database.addSet(set);
+        ICardDatabaseParser::addToSetlist(set);
+    }
+    for (const CardInfoPtr &card : cards)
+        database.addCard(card);
+    return true;
+}
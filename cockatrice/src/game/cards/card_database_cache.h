@@ -0,0 +1,56 @@
+#ifndef CARD_DATABASE_CACHE_H
+#define CARD_DATABASE_CACHE_H
+
+#include "card_database.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+class QDataStream;
+
+/**
+ * Binary snapshot of a fully loaded card database.
+ *
+ * The snapshot is written after the card databases have been parsed, together with the size, modification time and
+ * hash of every source file. On the next start it is memory mapped and read back instead of parsing the XML files,
+ * as long as the source files are unchanged. A file that was only touched but still has the same contents doesn't
+ * invalidate it.
+ */
+class CardDatabaseCache
+{
+public:
+    explicit CardDatabaseCache(const QString &_fileName);
+
+    /**
+     * Adds the cards and sets of the snapshot to database, if it was written from the same source files.
+     * Nothing is added if the snapshot is missing, stale or unreadable.
+     */
+    bool load(CardDatabase &database, const QStringList &sourcePaths) const;
+    bool save(const CardDatabase &database, const QStringList &sourcePaths) const;
+
+    const QString &getFileName() const
+    {
+        return fileName;
+    }
+
+private:
+    struct SourceFile
+    {
+        QString path;
+        qint64 size;
+        qint64 lastModified;
+        QByteArray hash;
+    };
+
+    QString fileName;
+
+    static SourceFile describeSource(const QString &path, bool withHash);
+    static bool isSourceUnchanged(const SourceFile &cached);
+    static QByteArray hashFile(const QString &path);
+    static void writeRelations(QDataStream &out, const QList<CardRelation *> &relations);
+    static QList<CardRelation *> readRelations(QDataStream &in);
+};
+
+#endif
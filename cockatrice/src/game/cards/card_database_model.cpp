@@ -2,9 +2,24 @@
 
 #include "../filters/filter_tree.h"
 
+#include <QCollator>
 #include <QMap>
+#include <QtConcurrent>
+#include <algorithm>
+#include <numeric>
 
 #define CARDDBMODEL_COLUMNS 6
+#define SORT_KEY_PARALLEL_THRESHOLD 1024
+
+static QList<CardInfoPtr> cardsInRows(QAbstractItemModel *model, int first, int last)
+{
+    auto *cardModel = static_cast<CardDatabaseModel *>(model);
+    QList<CardInfoPtr> cards;
+    for (int row = first; row <= last; ++row) {
+        cards << cardModel->getCard(row);
+    }
+    return cards;
+}
 
 CardDatabaseModel::CardDatabaseModel(CardDatabase *_db, bool _showOnlyCardsFromEnabledSets, QObject *parent)
     : QAbstractListModel(parent), db(_db), showOnlyCardsFromEnabledSets(_showOnlyCardsFromEnabledSets)
@@ -40,22 +55,28 @@ QVariant CardDatabaseModel::data(const QModelIndex &index, int role) const
         return QVariant();
 
     CardInfoPtr card = cardList.at(index.row());
-    switch (index.column()) {
+    if (role == Qt::DisplayRole && index.column() == ManaCostColumn)
+        return card->getManaCost();
+    return sortString(*card, index.column());
+}
+
+QString CardDatabaseModel::sortString(const CardInfo &card, int column)
+{
+    switch (column) {
         case NameColumn:
-            return card->getName();
+            return card.getName();
         case SetListColumn:
-            return card->getSetsNames();
+            return card.getSetsNames();
         case ManaCostColumn:
-            return role == SortRole ? QString("%1%2").arg(card->getCmc(), 4, QChar('0')).arg(card->getManaCost())
-                                    : card->getManaCost();
+            return QString("%1%2").arg(card.getCmc(), 4, QChar('0')).arg(card.getManaCost());
         case CardTypeColumn:
-            return card->getCardType();
+            return card.getCardType();
         case PTColumn:
-            return card->getPowTough();
+            return card.getPowTough();
         case ColorColumn:
-            return card->getColors();
+            return card.getColors();
         default:
-            return QVariant();
+            return QString();
     }
 }
 
@@ -152,14 +173,16 @@ void CardDatabaseModel::cardRemoved(CardInfoPtr card)
 }
 
 CardDatabaseDisplayModel::CardDatabaseDisplayModel(QObject *parent)
-    : QSortFilterProxyModel(parent), isToken(ShowAll), filterString(nullptr)
+    : QSortFilterProxyModel(parent), acceptedRowsGeneration(0), filterRunGeneration(0), sortKeyColumn(-1),
+      cardAcceptor(&CardDatabaseDisplayModel::acceptsCard)
 {
     filterTree = nullptr;
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     setSortCaseSensitivity(Qt::CaseInsensitive);
 
     dirtyTimer.setSingleShot(true);
-    connect(&dirtyTimer, &QTimer::timeout, this, &CardDatabaseDisplayModel::invalidate);
+    connect(&dirtyTimer, &QTimer::timeout, this, &CardDatabaseDisplayModel::refilter);
+    connect(&filterWatcher, &QFutureWatcher<QBitArray>::finished, this, &CardDatabaseDisplayModel::filterFinished);
 
     loadedRowCount = 0;
 }
@@ -185,94 +208,151 @@ int CardDatabaseDisplayModel::rowCount(const QModelIndex &parent) const
     return QSortFilterProxyModel::rowCount(parent);
 }
 
-bool CardDatabaseDisplayModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+void CardDatabaseDisplayModel::sort(int column, Qt::SortOrder order)
 {
+    if (column != sortKeyColumn) {
+        sortKeyColumn = column;
+        sortKeys = column < 0 ? QVector<CardSortKey>() : makeSortKeys(cardFields, column);
+    }
+    QSortFilterProxyModel::sort(column, order);
+}
 
-    QString leftString = sourceModel()->data(left, CardDatabaseModel::SortRole).toString();
-    QString rightString = sourceModel()->data(right, CardDatabaseModel::SortRole).toString();
+bool CardDatabaseDisplayModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    CardSortKey leftUnprepared, rightUnprepared;
+    const CardSortKey &leftKey = sortKeyOf(left, leftUnprepared);
+    const CardSortKey &rightKey = sortKeyOf(right, rightUnprepared);
 
-    if (!cardName.isEmpty() && left.column() == CardDatabaseModel::NameColumn) {
-        bool isLeftType = leftString.startsWith(cardName, Qt::CaseInsensitive);
-        bool isRightType = rightString.startsWith(cardName, Qt::CaseInsensitive);
+    const QString &foldedCardName = filter.foldedCardName;
+    if (!foldedCardName.isEmpty() && left.column() == CardDatabaseModel::NameColumn) {
+        bool isLeftType = leftKey.foldedName.startsWith(foldedCardName);
+        bool isRightType = rightKey.foldedName.startsWith(foldedCardName);
 
         // test for an exact match: isLeftType && leftString.size() == cardName.size()
         // or an exclusive start match: isLeftType && !isRightType
-        if (isLeftType && (!isRightType || leftString.size() == cardName.size()))
+        if (isLeftType && (!isRightType || leftKey.foldedName.size() == foldedCardName.size()))
             return true;
 
         // same checks for the right string
-        if (isRightType && (!isLeftType || rightString.size() == cardName.size()))
+        if (isRightType && (!isLeftType || rightKey.foldedName.size() == foldedCardName.size()))
             return false;
-    } else if (right.column() == CardDatabaseModel::PTColumn && left.column() == CardDatabaseModel::PTColumn) {
-        QStringList leftList = leftString.split("/");
-        QStringList rightList = rightString.split("/");
+    } else if (leftKey.isPowTough && rightKey.isPowTough) {
+        int lessThanNum = compareNumerically(leftKey.power, rightKey.power);
+        if (lessThanNum != 0) {
+            return lessThanNum < 0;
+        } else {
+            // power equal, check toughness
+            return compareNumerically(leftKey.toughness, rightKey.toughness) < 0;
+        }
+    }
+    return leftKey.text->compare(*rightKey.text) < 0;
+}
 
-        if (leftList.size() == 2 && rightList.size() == 2) {
+const CardDatabaseDisplayModel::CardSortKey &CardDatabaseDisplayModel::sortKeyOf(const QModelIndex &index,
+                                                                                  CardSortKey &unprepared) const
+{
+    if (index.column() == sortKeyColumn && index.row() < sortKeys.size()) {
+        return sortKeys.at(index.row());
+    }
 
-            // cool, have both P/T in list now
-            int lessThanNum = lessThanNumerically(leftList.at(0), rightList.at(0));
-            if (lessThanNum != 0) {
-                return lessThanNum < 0;
-            } else {
-                // power equal, check toughness
-                return lessThanNumerically(leftList.at(1), rightList.at(1)) < 0;
-            }
+    // a row the source model didn't announce yet
+    const CardInfoPtr card = static_cast<CardDatabaseModel *>(sourceModel())->getCard(index.row());
+    unprepared = makeSortKey(*card, index.column());
+    return unprepared;
+}
+
+static const QCollator &threadCollator()
+{
+    // collators aren't thread safe, and expensive to create for every card
+    static thread_local QCollator collator;
+    return collator;
+}
+
+CardDatabaseDisplayModel::CardSortKey CardDatabaseDisplayModel::makeSortKey(const CardInfo &card, int column)
+{
+    const QString text = CardDatabaseModel::sortString(card, column);
+    CardSortKey key;
+    key.text = threadCollator().sortKey(text);
+    if (column == CardDatabaseModel::NameColumn) {
+        key.foldedName = text.toCaseFolded();
+    } else if (column == CardDatabaseModel::PTColumn) {
+        const QStringList powTough = text.split("/");
+        if (powTough.size() == 2) {
+            key.isPowTough = true;
+            key.power = numericSortKey(powTough.at(0));
+            key.toughness = numericSortKey(powTough.at(1));
         }
     }
-    return QString::localeAwareCompare(leftString, rightString) < 0;
+    return key;
 }
 
-int CardDatabaseDisplayModel::lessThanNumerically(const QString &left, const QString &right)
+QVector<CardDatabaseDisplayModel::CardSortKey> CardDatabaseDisplayModel::makeSortKeys(
+    const QVector<CardFilterFields> &cards,
+    int column)
 {
-    if (left == right) {
-        return 0;
+    QVector<CardSortKey> keys(cards.size());
+    if (cards.size() <= SORT_KEY_PARALLEL_THRESHOLD) {
+        for (int i = 0; i < cards.size(); ++i) {
+            keys[i] = makeSortKey(*cards.at(i).card, column);
+        }
+        return keys;
     }
 
-    bool okLeft, okRight;
-    float leftNum = left.toFloat(&okLeft);
-    float rightNum = right.toFloat(&okRight);
+    QVector<int> rows(cards.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    CardSortKey *results = keys.data();
+    QtConcurrent::blockingMap(rows, [&cards, column, results](int row) {
+        results[row] = makeSortKey(*cards.at(row).card, column);
+    });
+    return keys;
+}
 
-    if (okLeft && okRight) {
-        if (leftNum < rightNum) {
-            return -1;
-        } else if (leftNum > rightNum) {
-            return 1;
-        } else {
-            return 0;
-        }
+CardDatabaseDisplayModel::NumericSortKey CardDatabaseDisplayModel::numericSortKey(const QString &text)
+{
+    NumericSortKey key;
+    key.text = text;
+    key.value = text.toFloat(&key.isNumber);
+    if (key.isNumber) {
+        return key;
     }
+
     // try and parsing again, for weird ones like "1+*"
-    QString leftAfterNum = "";
-    QString rightAfterNum = "";
-    if (!okLeft) {
-        int leftNumIndex = 0;
-        for (; leftNumIndex < left.length(); leftNumIndex++) {
-            if (!left.at(leftNumIndex).isDigit()) {
-                break;
-            }
-        }
-        if (leftNumIndex != 0) {
-            leftNum = left.left(leftNumIndex).toFloat(&okLeft);
-            leftAfterNum = left.right(leftNumIndex);
+    int numIndex = 0;
+    for (; numIndex < text.length(); numIndex++) {
+        if (!text.at(numIndex).isDigit()) {
+            break;
         }
     }
-    if (!okRight) {
-        int rightNumIndex = 0;
-        for (; rightNumIndex < right.length(); rightNumIndex++) {
-            if (!right.at(rightNumIndex).isDigit()) {
-                break;
-            }
-        }
-        if (rightNumIndex != 0) {
-            rightNum = right.left(rightNumIndex).toFloat(&okRight);
-            rightAfterNum = right.right(rightNumIndex);
+    if (numIndex != 0) {
+        key.value = text.left(numIndex).toFloat(&key.startsWithNumber);
+        key.afterNumber = text.right(numIndex);
+    }
+    return key;
+}
+
+int CardDatabaseDisplayModel::compareNumerically(const NumericSortKey &left, const NumericSortKey &right)
+{
+    if (left.text == right.text) {
+        return 0;
+    }
+
+    if (left.isNumber && right.isNumber) {
+        if (left.value < right.value) {
+            return -1;
+        } else if (left.value > right.value) {
+            return 1;
+        } else {
+            return 0;
         }
     }
+
+    const bool okLeft = left.isNumber || left.startsWithNumber;
+    const bool okRight = right.isNumber || right.startsWithNumber;
     if (okLeft && okRight) {
 
-        if (leftNum != rightNum) {
+        if (left.value != right.value) {
             // both parsed as numbers, but different number
-            if (leftNum < rightNum) {
+            if (left.value < right.value) {
                 return -1;
             } else {
                 return 1;
@@ -280,7 +360,7 @@ int CardDatabaseDisplayModel::lessThanNumerically(const QString &left, const QSt
         } else {
             // both parsed, same number, but at least one has something else
             // so compare the part after the number - prefer nothing
-            return QString::localeAwareCompare(leftAfterNum, rightAfterNum);
+            return QString::localeAwareCompare(left.afterNumber, right.afterNumber);
         }
     } else if (okLeft) {
         return -1;
@@ -288,47 +368,246 @@ int CardDatabaseDisplayModel::lessThanNumerically(const QString &left, const QSt
         return 1;
     }
     // couldn't parse it, just return String comparison
-    return QString::localeAwareCompare(left, right);
+    return QString::localeAwareCompare(left.text, right.text);
 }
+
 bool CardDatabaseDisplayModel::filterAcceptsRow(int sourceRow, const QModelIndex & /*sourceParent*/) const
 {
-    CardInfoPtr info = static_cast<CardDatabaseModel *>(sourceModel())->getCard(sourceRow);
+    if (sourceRow < acceptedRows.size()) {
+        return acceptedRows.testBit(sourceRow);
+    }
 
-    if (((isToken == ShowTrue) && !info->getIsToken()) || ((isToken == ShowFalse) && info->getIsToken()))
+    // a row the source model didn't announce yet
+    return cardAcceptor(filter, CardFilterFields(static_cast<CardDatabaseModel *>(sourceModel())->getCard(sourceRow)));
+}
+
+bool CardDatabaseDisplayModel::acceptsCard(const FilterState &filter, const CardFilterFields &card)
+{
+    if (((filter.isToken == ShowTrue) && !card.isToken) || ((filter.isToken == ShowFalse) && card.isToken))
         return false;
 
-    if (filterString != nullptr) {
-        if (filterTree != nullptr && !filterTree->acceptsCard(info)) {
+    if (filter.filterString) {
+        if (!filter.filterPlan.accepts(card)) {
             return false;
         }
-        return filterString->check(info);
+        return filter.filterString->check(card.card);
     }
 
-    return rowMatchesCardName(info);
+    return rowMatchesCardName(filter, card);
 }
 
-bool CardDatabaseDisplayModel::rowMatchesCardName(CardInfoPtr info) const
+bool CardDatabaseDisplayModel::rowMatchesCardName(const FilterState &filter, const CardFilterFields &card)
 {
-    if (!cardName.isEmpty() && !info->getName().contains(cardName, Qt::CaseInsensitive))
+    if (!filter.foldedCardName.isEmpty() && (!CardSearchIndex::isCandidate(filter.nameCandidates, card.searchId) ||
+                                             !card.name.contains(filter.foldedCardName)))
         return false;
 
-    if (!cardNameSet.isEmpty() && !cardNameSet.contains(info->getName()))
+    if (!filter.cardNameSet.isEmpty() && !filter.cardNameSet.contains(card.card->getName()))
         return false;
 
-    if (filterTree != nullptr)
-        return filterTree->acceptsCard(info);
+    return filter.filterPlan.accepts(card);
+}
 
-    return true;
+QBitArray CardDatabaseDisplayModel::acceptedRowsOf(const QVector<CardFilterFields> &cards,
+                                                   CardAcceptor acceptor,
+                                                   const FilterState &filter)
+{
+    return FilterPlan::run(cards, [acceptor, &filter](const CardFilterFields &card) { return acceptor(filter, card); });
+}
+
+void CardDatabaseDisplayModel::updateAcceptedRows()
+{
+    filter.filterPlan = FilterPlan(filterTree, searchIndex);
+    acceptedRows = acceptedRowsOf(cardFields, cardAcceptor, filter);
+    ++acceptedRowsGeneration;
+}
+
+void CardDatabaseDisplayModel::updateNameCandidates()
+{
+    filter.nameCandidates = searchIndex ? searchIndex->nameCandidates(filter.foldedCardName) : QBitArray();
+}
+
+void CardDatabaseDisplayModel::refilter()
+{
+    filter.filterPlan = FilterPlan(filterTree, searchIndex);
+
+    // the cards and the filters are copied, the gui keeps going while they are checked
+    const QVector<CardFilterFields> cards = cardFields;
+    const FilterState state = filter;
+    const CardAcceptor acceptor = cardAcceptor;
+    filterRunGeneration = acceptedRowsGeneration;
+    filterWatcher.setFuture(
+        QtConcurrent::run([cards, state, acceptor]() { return acceptedRowsOf(cards, acceptor, state); }));
+}
+
+void CardDatabaseDisplayModel::filterFinished()
+{
+    if (filterRunGeneration != acceptedRowsGeneration) {
+        // rows were added, removed or changed while filtering, the result doesn't fit anymore
+        refilter();
+        return;
+    }
+
+    acceptedRows = filterWatcher.result();
+    ++acceptedRowsGeneration;
+    invalidate();
+}
+
+void CardDatabaseDisplayModel::setSourceModel(QAbstractItemModel *newSourceModel)
+{
+    if (sourceModel() != nullptr) {
+        disconnect(sourceModel(), SIGNAL(rowsInserted(const QModelIndex &, int, int)), this,
+                   SLOT(sourceRowsInserted(const QModelIndex &, int, int)));
+        disconnect(sourceModel(), SIGNAL(rowsRemoved(const QModelIndex &, int, int)), this,
+                   SLOT(sourceRowsRemoved(const QModelIndex &, int, int)));
+        disconnect(sourceModel(), SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)), this,
+                   SLOT(sourceDataChanged(const QModelIndex &, const QModelIndex &)));
+        disconnect(sourceModel(), SIGNAL(modelReset()), this, SLOT(sourceModelReset()));
+        disconnect(static_cast<CardDatabaseModel *>(sourceModel())->getDatabase(), SIGNAL(searchIndexChanged()), this,
+                   SLOT(databaseSearchIndexChanged()));
+    }
+
+    cardFields.clear();
+    searchIndex.clear();
+    if (newSourceModel != nullptr) {
+        CardDatabase *db = static_cast<CardDatabaseModel *>(newSourceModel)->getDatabase();
+        connect(db, SIGNAL(searchIndexChanged()), this, SLOT(databaseSearchIndexChanged()));
+        searchIndex = db->getSearchIndex();
+
+        // connected before the proxy's own handlers, so the changed rows are checked by the time it looks at them
+        connect(newSourceModel, SIGNAL(rowsInserted(const QModelIndex &, int, int)), this,
+                SLOT(sourceRowsInserted(const QModelIndex &, int, int)));
+        connect(newSourceModel, SIGNAL(rowsRemoved(const QModelIndex &, int, int)), this,
+                SLOT(sourceRowsRemoved(const QModelIndex &, int, int)));
+        connect(newSourceModel, SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)), this,
+                SLOT(sourceDataChanged(const QModelIndex &, const QModelIndex &)));
+        connect(newSourceModel, SIGNAL(modelReset()), this, SLOT(sourceModelReset()));
+
+        cardFields = FilterPlan::extractFields(cardsInRows(newSourceModel, 0, newSourceModel->rowCount() - 1),
+                                               searchIndex.data());
+    }
+    updateNameCandidates();
+    updateAcceptedRows();
+    sortKeys = sortKeyColumn < 0 ? QVector<CardSortKey>() : makeSortKeys(cardFields, sortKeyColumn);
+
+    QSortFilterProxyModel::setSourceModel(newSourceModel);
+}
+
+void CardDatabaseDisplayModel::sourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    const int count = last - first + 1;
+    const QVector<CardFilterFields> inserted =
+        FilterPlan::extractFields(cardsInRows(sourceModel(), first, last), searchIndex.data());
+    const QBitArray insertedRows = acceptedRowsOf(inserted, cardAcceptor, filter);
+
+    cardFields.insert(first, count, CardFilterFields());
+    std::copy(inserted.constBegin(), inserted.constEnd(), cardFields.begin() + first);
+    if (sortKeyColumn >= 0) {
+        const QVector<CardSortKey> insertedKeys = makeSortKeys(inserted, sortKeyColumn);
+        sortKeys.insert(first, count, CardSortKey());
+        std::copy(insertedKeys.constBegin(), insertedKeys.constEnd(), sortKeys.begin() + first);
+    }
+    ++acceptedRowsGeneration;
+
+    // cards are appended while a database loads, keep that cheap
+    const int oldSize = acceptedRows.size();
+    if (first == oldSize) {
+        acceptedRows.resize(oldSize + count);
+        for (int i = 0; i < count; ++i) {
+            acceptedRows.setBit(first + i, insertedRows.testBit(i));
+        }
+        return;
+    }
+
+    QBitArray rows(oldSize + count);
+    for (int i = 0; i < rows.size(); ++i) {
+        if (i < first) {
+            rows.setBit(i, acceptedRows.testBit(i));
+        } else if (i < first + count) {
+            rows.setBit(i, insertedRows.testBit(i - first));
+        } else {
+            rows.setBit(i, acceptedRows.testBit(i - count));
+        }
+    }
+    acceptedRows = rows;
+}
+
+void CardDatabaseDisplayModel::sourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    const int count = last - first + 1;
+    cardFields.remove(first, count);
+    if (sortKeyColumn >= 0) {
+        sortKeys.remove(first, count);
+    }
+    ++acceptedRowsGeneration;
+
+    QBitArray rows(acceptedRows.size() - count);
+    for (int i = 0; i < rows.size(); ++i) {
+        rows.setBit(i, acceptedRows.testBit(i < first ? i : i + count));
+    }
+    acceptedRows = rows;
+}
+
+void CardDatabaseDisplayModel::sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (topLeft.parent().isValid()) {
+        return;
+    }
+
+    const QVector<CardFilterFields> changed =
+        FilterPlan::extractFields(cardsInRows(sourceModel(), topLeft.row(), bottomRight.row()), searchIndex.data());
+    const QBitArray changedRows = acceptedRowsOf(changed, cardAcceptor, filter);
+    const QVector<CardSortKey> changedKeys =
+        sortKeyColumn < 0 ? QVector<CardSortKey>() : makeSortKeys(changed, sortKeyColumn);
+    for (int i = 0; i < changed.size(); ++i) {
+        cardFields[topLeft.row() + i] = changed.at(i);
+        acceptedRows.setBit(topLeft.row() + i, changedRows.testBit(i));
+        if (sortKeyColumn >= 0) {
+            sortKeys[topLeft.row() + i] = changedKeys.at(i);
+        }
+    }
+    ++acceptedRowsGeneration;
+}
+
+void CardDatabaseDisplayModel::sourceModelReset()
+{
+    cardFields =
+        FilterPlan::extractFields(cardsInRows(sourceModel(), 0, sourceModel()->rowCount() - 1), searchIndex.data());
+    acceptedRows = acceptedRowsOf(cardFields, cardAcceptor, filter);
+    ++acceptedRowsGeneration;
+    sortKeys = sortKeyColumn < 0 ? QVector<CardSortKey>() : makeSortKeys(cardFields, sortKeyColumn);
+}
+
+void CardDatabaseDisplayModel::databaseSearchIndexChanged()
+{
+    // the index only narrows down which cards have to be matched, the accepted rows stay the same
+    searchIndex = static_cast<CardDatabaseModel *>(sourceModel())->getDatabase()->getSearchIndex();
+    for (CardFilterFields &card : cardFields) {
+        card.searchId = searchIndex ? searchIndex->idOf(card.card.data()) : -1;
+    }
+    updateNameCandidates();
+    filter.filterPlan = FilterPlan(filterTree, searchIndex);
 }
 
 void CardDatabaseDisplayModel::clearFilterAll()
 {
     cardName.clear();
+    filter.foldedCardName.clear();
     cardText.clear();
     cardTypes.clear();
     cardColors.clear();
     if (filterTree != nullptr)
         filterTree->clear();
+    // the view is expected to show everything right away, a filter still running notices the change and runs again
+    updateAcceptedRows();
     invalidateFilter();
 }
 
@@ -339,12 +618,12 @@ void CardDatabaseDisplayModel::setFilterTree(FilterTree *_filterTree)
 
     this->filterTree = _filterTree;
     connect(this->filterTree, SIGNAL(changed()), this, SLOT(filterTreeChanged()));
-    invalidate();
+    refilter();
 }
 
 void CardDatabaseDisplayModel::filterTreeChanged()
 {
-    invalidate();
+    refilter();
 }
 
 const QString CardDatabaseDisplayModel::sanitizeCardName(const QString &dirtyName, const QMap<wchar_t, wchar_t> &table)
@@ -360,12 +639,12 @@ const QString CardDatabaseDisplayModel::sanitizeCardName(const QString &dirtyNam
 
 TokenDisplayModel::TokenDisplayModel(QObject *parent) : CardDatabaseDisplayModel(parent)
 {
+    cardAcceptor = &TokenDisplayModel::acceptsCard;
 }
 
-bool TokenDisplayModel::filterAcceptsRow(int sourceRow, const QModelIndex & /*sourceParent*/) const
+bool TokenDisplayModel::acceptsCard(const FilterState &filter, const CardFilterFields &card)
 {
-    CardInfoPtr info = static_cast<CardDatabaseModel *>(sourceModel())->getCard(sourceRow);
-    return info->getIsToken() && rowMatchesCardName(info);
+    return card.isToken && rowMatchesCardName(filter, card);
 }
 
 int TokenDisplayModel::rowCount(const QModelIndex &parent) const
@@ -376,12 +655,13 @@ int TokenDisplayModel::rowCount(const QModelIndex &parent) const
 
 TokenEditModel::TokenEditModel(QObject *parent) : CardDatabaseDisplayModel(parent)
 {
+    cardAcceptor = &TokenEditModel::acceptsCard;
 }
 
-bool TokenEditModel::filterAcceptsRow(int sourceRow, const QModelIndex & /*sourceParent*/) const
+bool TokenEditModel::acceptsCard(const FilterState &filter, const CardFilterFields &card)
 {
-    CardInfoPtr info = static_cast<CardDatabaseModel *>(sourceModel())->getCard(sourceRow);
-    return info->getIsToken() && info->getSets().contains(CardDatabase::TOKENS_SETNAME) && rowMatchesCardName(info);
+    return card.isToken && card.card->getSets().contains(CardDatabase::TOKENS_SETNAME) &&
+           rowMatchesCardName(filter, card);
 }
 
 int TokenEditModel::rowCount(const QModelIndex &parent) const
@@ -1,14 +1,19 @@
 #ifndef CARDDATABASEMODEL_H
 #define CARDDATABASEMODEL_H
 
+#include "../filters/filter_plan.h"
 #include "../filters/filter_string.h"
 #include "card_database.h"
 
 #include <QAbstractListModel>
+#include <QBitArray>
+#include <QCollatorSortKey>
+#include <QFutureWatcher>
 #include <QList>
 #include <QSet>
 #include <QSortFilterProxyModel>
 #include <QTimer>
+#include <optional>
 
 class FilterTree;
 
@@ -43,6 +48,8 @@ public:
     {
         return cardList[index];
     }
+    // What the column is sorted by, thread safe
+    static QString sortString(const CardInfo &card, int column);
 
 private:
     QList<CardInfoPtr> cardList;
@@ -69,15 +76,64 @@ public:
         ShowAll
     };
 
+    /** What the cards are filtered by, copied for every run on the worker threads. */
+    struct FilterState
+    {
+        FilterBool isToken = ShowAll;
+        QString foldedCardName;
+        QSet<QString> cardNameSet;
+        QSharedPointer<const FilterString> filterString;
+        FilterPlan filterPlan;
+        QBitArray nameCandidates;
+    };
+
+protected:
+    // a power or toughness
+    struct NumericSortKey
+    {
+        QString text;
+        bool isNumber = false;
+        // a number followed by something else, like "1+*"
+        bool startsWithNumber = false;
+        float value = 0;
+        QString afterNumber;
+    };
+
 private:
-    FilterBool isToken;
+    /**
+     * A cell of the sorted column, prepared once per card so that comparing two rows doesn't fetch, split and parse
+     * their strings again.
+     */
+    struct CardSortKey
+    {
+        std::optional<QCollatorSortKey> text;
+        // case folded, name column only
+        QString foldedName;
+        // P/T column only
+        bool isPowTough = false;
+        NumericSortKey power, toughness;
+    };
+
     QString cardName, cardText;
-    QSet<QString> cardNameSet, cardTypes, cardColors;
+    QSet<QString> cardTypes, cardColors;
     FilterTree *filterTree;
-    FilterString *filterString;
+    FilterState filter;
     int loadedRowCount;
     QTimer dirtyTimer;
 
+    // The filters are evaluated for all rows at once whenever they change, filterAcceptsRow only looks up the result
+    QVector<CardFilterFields> cardFields;
+    QBitArray acceptedRows;
+    CardSearchIndexPtr searchIndex;
+    // Filters run on worker threads. When they are done the accepted rows are replaced at once, unless the rows
+    // changed in the meantime.
+    QFutureWatcher<QBitArray> filterWatcher;
+    int acceptedRowsGeneration, filterRunGeneration;
+
+    // in source rows, for sortKeyColumn
+    QVector<CardSortKey> sortKeys;
+    int sortKeyColumn;
+
     /** The translation table that will be used for sanitizeCardName. */
     static QMap<wchar_t, wchar_t> characterTranslation;
 
@@ -86,28 +142,26 @@ public:
     void setFilterTree(FilterTree *_filterTree);
     void setIsToken(FilterBool _isToken)
     {
-        isToken = _isToken;
+        filter.isToken = _isToken;
         dirty();
     }
 
     void setCardName(const QString &_cardName)
     {
-        if (filterString != nullptr) {
-            delete filterString;
-            filterString = nullptr;
-        }
+        filter.filterString.clear();
         cardName = sanitizeCardName(_cardName, characterTranslation);
+        filter.foldedCardName = cardName.toCaseFolded();
+        updateNameCandidates();
         dirty();
     }
     void setStringFilter(const QString &_src)
     {
-        delete filterString;
-        filterString = new FilterString(_src);
+        filter.filterString.reset(new FilterString(_src, searchIndex));
         dirty();
     }
     void setCardNameSet(const QSet<QString> &_cardNameSet)
     {
-        cardNameSet = _cardNameSet;
+        filter.cardNameSet = _cardNameSet;
         dirty();
     }
 
@@ -117,16 +171,41 @@ public:
     }
     void clearFilterAll();
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    void setSourceModel(QAbstractItemModel *newSourceModel) override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
 
 protected:
+    typedef bool (*CardAcceptor)(const FilterState &filter, const CardFilterFields &card);
+    /** Set by the constructors, called for many cards at once on worker threads. */
+    CardAcceptor cardAcceptor;
+
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
-    static int lessThanNumerically(const QString &left, const QString &right);
     bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
-    bool rowMatchesCardName(CardInfoPtr info) const;
+    static bool acceptsCard(const FilterState &filter, const CardFilterFields &card);
+    static bool rowMatchesCardName(const FilterState &filter, const CardFilterFields &card);
     bool canFetchMore(const QModelIndex &parent) const override;
     void fetchMore(const QModelIndex &parent) override;
+    void updateAcceptedRows();
+    void updateNameCandidates();
+    static NumericSortKey numericSortKey(const QString &text);
+    static int compareNumerically(const NumericSortKey &left, const NumericSortKey &right);
+
+private:
+    static CardSortKey makeSortKey(const CardInfo &card, int column);
+    static QVector<CardSortKey> makeSortKeys(const QVector<CardFilterFields> &cards, int column);
+    const CardSortKey &sortKeyOf(const QModelIndex &index, CardSortKey &unprepared) const;
+    static QBitArray
+    acceptedRowsOf(const QVector<CardFilterFields> &cards, CardAcceptor acceptor, const FilterState &filter);
+
 private slots:
     void filterTreeChanged();
+    void refilter();
+    void filterFinished();
+    void sourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void sourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void sourceModelReset();
+    void databaseSearchIndexChanged();
     /** Will translate all undesirable characters in DIRTYNAME according to the TABLE. */
     const QString sanitizeCardName(const QString &dirtyName, const QMap<wchar_t, wchar_t> &table);
 };
@@ -139,7 +218,7 @@ public:
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
 
 protected:
-    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    static bool acceptsCard(const FilterState &filter, const CardFilterFields &card);
 };
 
 class TokenEditModel : public CardDatabaseDisplayModel
@@ -150,7 +229,7 @@ public:
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
 
 protected:
-    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    static bool acceptsCard(const FilterState &filter, const CardFilterFields &card);
 };
 
 #endif
@@ -1,5 +1,7 @@
 #include "card_database_parser.h"
 
+#include <QMutex>
+
 SetNameMap ICardDatabaseParser::sets;
 
 void ICardDatabaseParser::clearSetlist()
@@ -7,23 +9,32 @@ void ICardDatabaseParser::clearSetlist()
     sets.clear();
 }
 
+void ICardDatabaseParser::addToSetlist(const CardSetPtr &set)
+{
+    sets.insert(set->getShortName(), set);
+}
+
 CardSetPtr ICardDatabaseParser::internalAddSet(const QString &setName,
                                                const QString &longName,
                                                const QString &setType,
                                                const QDate &releaseDate,
                                                const CardSet::Priority priority)
 {
-    if (sets.contains(setName)) {
-        return sets.value(setName);
+    if (knownSets->contains(setName)) {
+        return knownSets->value(setName);
     }
 
+    // new sets read their options from the settings, which can't be accessed by several threads at once
+    static QMutex newSetMutex;
+    newSetMutex.lock();
     CardSetPtr newSet = CardSet::newInstance(setName);
+    newSetMutex.unlock();
     newSet->setLongName(longName);
     newSet->setSetType(setType);
     newSet->setReleaseDate(releaseDate);
     newSet->setPriority(priority);
 
-    sets.insert(setName, newSet);
+    knownSets->insert(setName, newSet);
     emit addSet(newSet);
     return newSet;
 }
@@ -21,6 +21,13 @@ public:
                             const QString &sourceUrl = "unknown",
                             const QString &sourceVersion = "unknown") = 0;
     static void clearSetlist();
+    // Makes a set that was loaded without a parser known to the parsers, so later files reuse it
+    static void addToSetlist(const CardSetPtr &set);
+    // Resolves set names against _setList instead of the shared list, so that files can be parsed concurrently
+    void usePrivateSetlist(SetNameMap *_setList)
+    {
+        knownSets = _setList;
+    }
 
 protected:
     /*
@@ -28,6 +35,7 @@ protected:
      * Shared between all parsers
      */
     static SetNameMap sets;
+    SetNameMap *knownSets = &sets;
 
     CardSetPtr internalAddSet(const QString &setName,
                               const QString &longName = "",
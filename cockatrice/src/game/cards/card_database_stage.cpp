@@ -0,0 +1,48 @@
+#include "card_database_stage.h"
+
+#include "card_database_parser/cockatrice_xml_3.h"
+#include "card_database_parser/cockatrice_xml_4.h"
+
+#include <QTime>
+
+CardDatabaseStage::CardDatabaseStage(const QString &_path) : path(_path), loadStatus(NotLoaded), parseTime(0)
+{
+}
+
+void CardDatabaseStage::parse()
+{
+    auto startTime = QTime::currentTime();
+
+    CockatriceXml4Parser xml4Parser;
+    CockatriceXml3Parser xml3Parser;
+    const QVector<ICardDatabaseParser *> parsers = {&xml4Parser, &xml3Parser};
+    for (auto &parser : parsers) {
+        parser->usePrivateSetlist(&sets);
+        connect(parser, SIGNAL(addCard(CardInfoPtr)), this, SLOT(addCard(CardInfoPtr)), Qt::DirectConnection);
+    }
+
+    if (!path.isEmpty())
+        loadStatus = CardDatabase::loadFromFile(path, parsers);
+
+    parseTime = startTime.msecsTo(QTime::currentTime());
+}
+
+void CardDatabaseStage::addCard(CardInfoPtr card)
+{
+    if (card == nullptr)
+        return;
+
+    // same as CardDatabase::addCard, a card that is already known only gets the new printings
+    const CardInfoPtr sameCard = cardsByName.value(card->getName());
+    if (sameCard) {
+        for (const auto &cardInfoPerSetList : card->getSets()) {
+            for (const CardInfoPerSet &set : cardInfoPerSetList) {
+                sameCard->addToSet(set.getPtr(), set);
+            }
+        }
+        return;
+    }
+
+    cardsByName.insert(card->getName(), card);
+    cards.append(card);
+}
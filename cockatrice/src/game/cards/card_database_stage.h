@@ -0,0 +1,59 @@
+#ifndef CARD_DATABASE_STAGE_H
+#define CARD_DATABASE_STAGE_H
+
+#include "card_database.h"
+
+#include <QList>
+#include <QObject>
+#include <QString>
+
+/**
+ * The cards and sets of a single card database file, parsed apart from the card database.
+ *
+ * Every file gets its own parsers and set list, so several files can be parsed on worker threads at the same time.
+ * CardDatabase merges the results afterwards, in the order the files would have been loaded one by one.
+ */
+class CardDatabaseStage : public QObject
+{
+    Q_OBJECT
+private:
+    QString path;
+    LoadStatus loadStatus;
+    int parseTime;
+    SetNameMap sets;
+    // in the order the parsers produced them, duplicates only add their printings to the first card
+    QList<CardInfoPtr> cards;
+    CardNameMap cardsByName;
+
+private slots:
+    void addCard(CardInfoPtr card);
+
+public:
+    explicit CardDatabaseStage(const QString &_path);
+
+    // Can run on any thread, but only once per stage
+    void parse();
+
+    const QString &getPath() const
+    {
+        return path;
+    }
+    LoadStatus getLoadStatus() const
+    {
+        return loadStatus;
+    }
+    int getParseTime() const
+    {
+        return parseTime;
+    }
+    const SetNameMap &getSets() const
+    {
+        return sets;
+    }
+    const QList<CardInfoPtr> &getCards() const
+    {
+        return cards;
+    }
+};
+
+#endif
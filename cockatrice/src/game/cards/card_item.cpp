@@ -88,10 +88,10 @@ void CardItem::retranslateUi()
     ptMenu->setTitle(tr("&Power / toughness"));
 }
 
-void CardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+void CardItem::paintFace(QPainter *painter, const QSizeF &translatedSize, int angle)
 {
     painter->save();
-    AbstractCardItem::paint(painter, option, widget);
+    AbstractCardItem::paintFace(painter, translatedSize, angle);
 
     int i = 0;
     QMapIterator<int, int> counterIterator(counters);
@@ -104,12 +104,11 @@ void CardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
         ++i;
     }
 
-    QSizeF translatedSize = getTranslatedSize(painter);
     qreal scaleFactor = translatedSize.width() / boundingRect().width();
 
     if (!pt.isEmpty()) {
         painter->save();
-        transformPainter(painter, translatedSize, tapAngle);
+        transformPainter(painter, translatedSize, angle);
 
         if (!getFaceDown() && info && pt == info->getPowTough()) {
             painter->setPen(Qt::white);
@@ -129,7 +128,7 @@ void CardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
     if (!annotation.isEmpty()) {
         painter->save();
 
-        transformPainter(painter, translatedSize, tapAngle);
+        transformPainter(painter, translatedSize, angle);
         painter->setBackground(Qt::black);
         painter->setBackgroundMode(Qt::OpaqueMode);
         painter->setPen(Qt::white);
@@ -140,10 +139,6 @@ void CardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
         painter->restore();
     }
 
-    if (getBeingPointedAt()) {
-        painter->fillPath(shape(), QBrush(QColor(255, 0, 0, 100)));
-    }
-
     if (doesntUntap) {
         painter->save();
 
@@ -161,6 +156,15 @@ void CardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
     painter->restore();
 }
 
+void CardItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    AbstractCardItem::paint(painter, option, widget);
+
+    if (getBeingPointedAt()) {
+        painter->fillPath(shape(), QBrush(QColor(255, 0, 0, 100)));
+    }
+}
+
 void CardItem::setAttacking(bool _attacking)
 {
     attacking = _attacking;
@@ -173,25 +177,25 @@ void CardItem::setCounter(int _id, int _value)
         counters.insert(_id, _value);
     else
         counters.remove(_id);
-    update();
+    invalidateFaceCache();
 }
 
 void CardItem::setAnnotation(const QString &_annotation)
 {
     annotation = _annotation;
-    update();
+    invalidateFaceCache();
 }
 
 void CardItem::setDoesntUntap(bool _doesntUntap)
 {
     doesntUntap = _doesntUntap;
-    update();
+    invalidateFaceCache();
 }
 
 void CardItem::setPT(const QString &_pt)
 {
     pt = _pt;
-    update();
+    invalidateFaceCache();
 }
 
 void CardItem::setAttachedTo(CardItem *_attachedTo)
@@ -230,7 +234,7 @@ void CardItem::resetState()
     setDoesntUntap(false);
     if (scene())
         static_cast<GameScene *>(scene())->unregisterAnimationItem(this);
-    update();
+    invalidateFaceCache();
 }
 
 void CardItem::processCardInfo(const ServerInfo_Card &_info)
@@ -255,6 +259,39 @@ void CardItem::processCardInfo(const ServerInfo_Card &_info)
     setDoesntUntap(_info.doesnt_untap());
 }
 
+void CardItem::writeCardInfo(ServerInfo_Card *info) const
+{
+    info->set_id(id);
+    info->set_provider_id(providerId.toStdString());
+    info->set_name(name.toStdString());
+    if (zone && zone->getName() == "table") {
+        info->set_x(gridPoint.x());
+        info->set_y(gridPoint.y());
+    }
+    info->set_attacking(attacking);
+    info->set_face_down(facedown);
+    info->set_pt(pt.toStdString());
+    info->set_annotation(annotation.toStdString());
+    info->set_color(color.toStdString());
+    info->set_tapped(tapped);
+    info->set_destroy_on_zone_change(destroyOnZoneChange);
+    info->set_doesnt_untap(doesntUntap);
+
+    QMapIterator<int, int> counterIterator(counters);
+    while (counterIterator.hasNext()) {
+        counterIterator.next();
+        ServerInfo_CardCounter *counterInfo = info->add_counter_list();
+        counterInfo->set_id(counterIterator.key());
+        counterInfo->set_value(counterIterator.value());
+    }
+
+    if (attachedTo && attachedTo->getZone()) {
+        info->set_attach_player_id(attachedTo->getZone()->getPlayer()->getId());
+        info->set_attach_zone(attachedTo->getZone()->getName().toStdString());
+        info->set_attach_card_id(attachedTo->getId());
+    }
+}
+
 CardDragItem *CardItem::createDragItem(int _id, const QPointF &_pos, const QPointF &_scenePos, bool faceDown)
 {
     deleteDragItem();
@@ -452,9 +489,9 @@ void CardItem::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
     event->accept();
 }
 
-bool CardItem::animationEvent()
+bool CardItem::animationEvent(int elapsedMs)
 {
-    int rotation = ROTATION_DEGREES_PER_FRAME;
+    int rotation = qMax(1, 90 * elapsedMs / TAP_ANIMATION_MS);
     bool animationIncomplete = true;
     if (!tapped)
         rotation *= -1;
@@ -473,8 +510,8 @@ bool CardItem::animationEvent()
                      .translate(CARD_WIDTH_HALF, CARD_HEIGHT_HALF)
                      .rotate(tapAngle)
                      .translate(-CARD_WIDTH_HALF, -CARD_HEIGHT_HALF));
+    // no update() needed, changing the transform already repaints the old and new area along with the rest of the frame
     setHovered(false);
-    update();
 
     return animationIncomplete;
 }
@@ -490,5 +527,5 @@ QVariant CardItem::itemChange(GraphicsItemChange change, const QVariant &value)
             owner->getGame()->setActiveCard(nullptr);
         }
     }
-    return QGraphicsItem::itemChange(change, value);
+    return AbstractCardItem::itemChange(change, value);
 }
@@ -15,7 +15,7 @@ class QColor;
 const int MAX_COUNTERS_ON_CARD = 999;
 const float CARD_WIDTH_HALF = CARD_WIDTH / 2;
 const float CARD_HEIGHT_HALF = CARD_HEIGHT / 2;
-const int ROTATION_DEGREES_PER_FRAME = 10;
+const int TAP_ANIMATION_MS = 90;
 
 class CardItem : public AbstractCardItem
 {
@@ -141,6 +141,8 @@ public:
     }
     void resetState();
     void processCardInfo(const ServerInfo_Card &_info);
+    // The inverse of processCardInfo(), including the position and what the card is attached to
+    void writeCardInfo(ServerInfo_Card *info) const;
 
     QMenu *getCardMenu() const
     {
@@ -155,7 +157,8 @@ public:
         return moveMenu;
     }
 
-    bool animationEvent();
+    // Advances the tap animation by elapsedMs, returns false once it is done
+    bool animationEvent(int elapsedMs);
     CardDragItem *createDragItem(int _id, const QPointF &_pos, const QPointF &_scenePos, bool faceDown);
     void deleteDragItem();
     void drawArrow(const QColor &arrowColor);
@@ -163,6 +166,7 @@ public:
     void playCard(bool faceDown);
 
 protected:
+    void paintFace(QPainter *painter, const QSizeF &translatedSize, int angle) override;
     void mouseMoveEvent(QGraphicsSceneMouseEvent *event);
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
     void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event);
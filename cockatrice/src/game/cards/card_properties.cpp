@@ -0,0 +1,338 @@
+#include "card_properties.h"
+
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QDebug>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <algorithm>
+
+namespace
+{
+/**
+ * Strings interned into ids. Card databases are parsed on several threads at once, so looking up a string, or the
+ * string of an id, doesn't lock. Only interning a string that wasn't seen before does, which happens a few thousand
+ * times per database.
+ */
+class InternPool
+{
+public:
+    using TagFunction = int (*)(const QString &);
+
+    InternPool() : index(new Index(initialCapacity))
+    {
+    }
+    ~InternPool()
+    {
+        for (QAtomicPointer<Item> &chunk : chunks)
+            delete[] chunk.loadAcquire();
+        qDeleteAll(retiredIndexes);
+        delete index.loadAcquire();
+    }
+
+    // Returns -1 for a string that was never interned
+    int find(const QString &string) const
+    {
+        return findIn(index.loadAcquire(), string, qHash(string));
+    }
+
+    // The tag of a new string is worked out once, when it is interned. Returns -1 once the pool is full.
+    int intern(const QString &string, TagFunction tagOf)
+    {
+        const size_t hash = qHash(string);
+        int id = findIn(index.loadAcquire(), string, hash);
+        if (id != -1)
+            return id;
+
+        QMutexLocker locker(&mutex);
+        Index *current = index.loadAcquire();
+        id = findIn(current, string, hash);
+        if (id != -1)
+            return id;
+
+        id = count.loadAcquire();
+        if (id >> chunkBits >= maxChunks)
+            return -1;
+        Item *chunk = chunks[id >> chunkBits].loadAcquire();
+        if (!chunk) {
+            chunk = new Item[chunkSize];
+            chunks[id >> chunkBits].storeRelease(chunk);
+        }
+        chunk[id & (chunkSize - 1)] = {string, tagOf(string)};
+        count.storeRelease(id + 1);
+
+        // the index stays at most half full, so probing ends quickly
+        if (2 * (id + 1) > current->capacity) {
+            auto *grown = new Index(2 * current->capacity);
+            for (int i = 0; i <= id; ++i)
+                insertInto(grown, i, qHash(at(i)));
+            retiredIndexes.append(current);
+            index.storeRelease(grown);
+        } else {
+            insertInto(current, id, hash);
+        }
+        return id;
+    }
+
+    const QString &at(int id) const
+    {
+        return item(id).string;
+    }
+
+    int tag(int id) const
+    {
+        return item(id).tag;
+    }
+
+    int size() const
+    {
+        return count.loadAcquire();
+    }
+
+private:
+    struct Item
+    {
+        QString string;
+        int tag = 0;
+    };
+
+    // Open addressing over the ids, a slot holds id + 1 or 0 while it's empty
+    struct Index
+    {
+        explicit Index(int _capacity) : capacity(_capacity), slots(new QAtomicInt[_capacity])
+        {
+        }
+        ~Index()
+        {
+            delete[] slots;
+        }
+        Q_DISABLE_COPY(Index)
+
+        const int capacity; // a power of two
+        QAtomicInt *const slots;
+    };
+
+    // The items are kept in chunks that never move, so an id can be read while more strings are interned
+    static constexpr int chunkBits = 10;
+    static constexpr int chunkSize = 1 << chunkBits;
+    static constexpr int maxChunks = 4096;
+    static constexpr int initialCapacity = 64;
+
+    QAtomicPointer<Item> chunks[maxChunks];
+    QAtomicInt count;
+    QAtomicPointer<Index> index;
+    QMutex mutex;
+    // Replaced indexes are kept on purpose, readers may still be probing them. The index doubles every time it
+    // grows, so all of them together are smaller than the current one. They go away with the pool.
+    QVector<Index *> retiredIndexes;
+
+    const Item &item(int id) const
+    {
+        return chunks[id >> chunkBits].loadAcquire()[id & (chunkSize - 1)];
+    }
+
+    int findIn(const Index *_index, const QString &string, size_t hash) const
+    {
+        const int mask = _index->capacity - 1;
+        for (int slot = static_cast<int>(hash & mask);; slot = (slot + 1) & mask) {
+            const int used = _index->slots[slot].loadAcquire();
+            if (used == 0)
+                return -1;
+            if (at(used - 1) == string)
+                return used - 1;
+        }
+    }
+
+    static void insertInto(Index *_index, int id, size_t hash)
+    {
+        const int mask = _index->capacity - 1;
+        int slot = static_cast<int>(hash & mask);
+        while (_index->slots[slot].loadAcquire() != 0)
+            slot = (slot + 1) & mask;
+        _index->slots[slot].storeRelease(id + 1);
+    }
+};
+
+enum ColumnType
+{
+    StringColumn,
+    EnumColumn,
+    ColorColumn
+};
+
+InternPool keyPool;
+InternPool valuePool;
+
+int columnType(const QString &name)
+{
+    static const QSet<QString> enumProperties = {"cmc",      "layout", "loyalty", "maintype", "manacost",
+                                                 "pt",       "rarity", "side",    "type"};
+    if (name == "colors" || name == "coloridentity")
+        return ColorColumn;
+    if (name.startsWith("format-") || enumProperties.contains(name))
+        return EnumColumn;
+    return StringColumn;
+}
+
+// Color codes with this bit set are a bitset of WUBRG, the others are the id of an interned value
+const quint32 colorBitset = 0x80000000u;
+const char colorOrder[] = "WUBRG";
+const int colorCount = 5;
+
+int colorIndex(QChar c)
+{
+    for (int color = 0; color < colorCount; ++color)
+        if (c == QLatin1Char(colorOrder[color]))
+            return color;
+    return -1;
+}
+
+// Only sets of colors written in WUBRG order fit a bitset, since the string is rebuilt from it
+bool encodeColors(const QString &value, quint32 &code)
+{
+    if (value.isEmpty())
+        return false;
+
+    quint32 mask = 0;
+    int last = -1;
+    for (const QChar c : value) {
+        const int color = colorIndex(c);
+        if (color <= last)
+            return false;
+        mask |= 1u << color;
+        last = color;
+    }
+    code = colorBitset | mask;
+    return true;
+}
+
+const QString &decodeColors(quint32 code)
+{
+    static const QVector<QString> colorSets = []() {
+        QVector<QString> sets(1 << colorCount);
+        for (int mask = 0; mask < sets.size(); ++mask)
+            for (int color = 0; color < colorCount; ++color)
+                if (mask & (1 << color))
+                    sets[mask].append(QLatin1Char(colorOrder[color]));
+        return sets;
+    }();
+    return colorSets.at(static_cast<int>(code & ~colorBitset));
+}
+
+QString decode(quint32 code)
+{
+    return (code & colorBitset) ? decodeColors(code) : valuePool.at(static_cast<int>(code));
+}
+
+int noTag(const QString & /* value */)
+{
+    return 0;
+}
+
+// Returns false for values that are stored as strings
+bool encode(int type, const QString &value, quint32 &code)
+{
+    if (type == StringColumn)
+        return false;
+    if (type == ColorColumn && encodeColors(value, code))
+        return true;
+
+    // the values of enum columns, and colors that don't fit a bitset
+    const int id = valuePool.intern(value, noTag);
+    code = static_cast<quint32>(id);
+    return id != -1;
+}
+
+template <typename T> typename QVector<T>::const_iterator findKey(const QVector<T> &items, int key)
+{
+    auto it = std::lower_bound(items.constBegin(), items.constEnd(), key,
+                               [](const T &item, int _key) { return item.key < _key; });
+    return (it != items.constEnd() && it->key == key) ? it : items.constEnd();
+}
+
+template <typename T> void setKey(QVector<T> &items, const T &item)
+{
+    auto it = std::lower_bound(items.begin(), items.end(), item.key,
+                               [](const T &other, int _key) { return other.key < _key; });
+    if (it != items.end() && it->key == item.key)
+        *it = item;
+    else
+        items.insert(it, item);
+}
+
+template <typename T> void removeKey(QVector<T> &items, int key)
+{
+    auto it = findKey(items, key);
+    if (it != items.constEnd())
+        items.remove(static_cast<int>(it - items.constBegin()));
+}
+} // namespace
+
+CardProperties::CardProperties(const QVariantHash &hash)
+{
+    for (auto it = hash.constBegin(); it != hash.constEnd(); ++it)
+        insert(it.key(), it.value().toString());
+}
+
+QStringList CardProperties::keys() const
+{
+    // in the order of the keys, like the names were interned
+    QStringList result;
+    auto entry = entries.constBegin();
+    auto code = codes.constBegin();
+    while (entry != entries.constEnd() || code != codes.constEnd()) {
+        if (code == codes.constEnd() || (entry != entries.constEnd() && entry->key < code->key))
+            result << keyPool.at((entry++)->key);
+        else
+            result << keyPool.at((code++)->key);
+    }
+    return result;
+}
+
+QString CardProperties::value(const QString &name) const
+{
+    const int key = keyPool.find(name);
+    if (key == -1)
+        return {};
+
+    auto code = findKey(codes, key);
+    if (code != codes.constEnd())
+        return decode(code->code);
+    auto entry = findKey(entries, key);
+    return entry != entries.constEnd() ? entry->value : QString();
+}
+
+bool CardProperties::contains(const QString &name) const
+{
+    const int key = keyPool.find(name);
+    return key != -1 && (findKey(codes, key) != codes.constEnd() || findKey(entries, key) != entries.constEnd());
+}
+
+void CardProperties::insert(const QString &name, const QString &value)
+{
+    const int key = keyPool.intern(name, columnType);
+    if (key == -1) {
+        qWarning() << "[CardProperties] Too many property names, dropping" << name;
+        return;
+    }
+
+    quint32 code;
+    if (encode(keyPool.tag(key), value, code)) {
+        removeKey(entries, key);
+        setKey(codes, {key, code});
+    } else {
+        removeKey(codes, key);
+        setKey(entries, {key, value});
+    }
+}
+
+int CardProperties::internedKeyCount()
+{
+    return keyPool.size();
+}
+
+int CardProperties::internedValueCount()
+{
+    return valuePool.size();
+}
@@ -0,0 +1,53 @@
+#ifndef CARD_PROPERTIES_H
+#define CARD_PROPERTIES_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariantHash>
+#include <QVector>
+
+/**
+ * The free-form properties of a card or printing, like "manacost", "rarity" or "format-modern".
+ *
+ * Property names are interned into small integer keys shared by all cards. Properties that only take a few distinct
+ * values (types, rarities, legalities, ...) are enum columns: each distinct value is interned once and cards only
+ * keep its id. Colors and color identities are bitset columns of WUBRG. Values unique to a card, like its uuid, are
+ * stored as strings of their own.
+ */
+class CardProperties
+{
+public:
+    CardProperties() = default;
+    explicit CardProperties(const QVariantHash &hash);
+
+    QStringList keys() const;
+    QString value(const QString &name) const;
+    bool contains(const QString &name) const;
+    void insert(const QString &name, const QString &value);
+    int size() const
+    {
+        return entries.size() + codes.size();
+    }
+
+    // Sizes of the shared pools, for memory diagnostics
+    static int internedKeyCount();
+    static int internedValueCount();
+
+private:
+    struct Entry
+    {
+        int key;
+        QString value;
+    };
+    // The value of an enum or bitset column
+    struct Code
+    {
+        int key;
+        quint32 code;
+    };
+    // Both sorted by key, a key is only ever in one of them
+    QVector<Entry> entries;
+    QVector<Code> codes;
+};
+
+#endif
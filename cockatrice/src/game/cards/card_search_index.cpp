@@ -0,0 +1,100 @@
+#include "card_search_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+static inline quint64 trigramAt(const QString &string, int i)
+{
+    return (quint64(string.at(i).unicode()) << 32) | (quint64(string.at(i + 1).unicode()) << 16) |
+           string.at(i + 2).unicode();
+}
+
+CardSearchIndex::CardSearchIndex(const QList<CardInfoPtr> &_cards)
+{
+    cards.reserve(_cards.size());
+    simpleNames.reserve(_cards.size());
+    for (const CardInfoPtr &card : _cards) {
+        const int id = cards.size();
+        cards << card;
+        ids.insert(card.data(), id);
+        simpleNames << qMakePair(card->getSimpleName(), id);
+
+        addTrigrams(nameTrigrams, card->getName().toCaseFolded(), id);
+        addTrigrams(textTrigrams, card->getText().toCaseFolded(), id);
+    }
+
+    std::sort(simpleNames.begin(), simpleNames.end());
+}
+
+void CardSearchIndex::addTrigrams(Postings &postings, const QString &folded, int id)
+{
+    for (int i = 0; i + 2 < folded.size(); ++i) {
+        QVector<int> &list = postings[trigramAt(folded, i)];
+        // ids are added in increasing order, so every list stays sorted and a repeated trigram is always the last id
+        if (list.isEmpty() || list.last() != id) {
+            list << id;
+        }
+    }
+}
+
+QBitArray CardSearchIndex::candidates(const Postings &postings, const QString &foldedNeedle) const
+{
+    if (foldedNeedle.size() < 3) {
+        return QBitArray();
+    }
+
+    QVector<const QVector<int> *> lists;
+    for (int i = 0; i + 2 < foldedNeedle.size(); ++i) {
+        auto it = postings.constFind(trigramAt(foldedNeedle, i));
+        if (it == postings.constEnd()) {
+            // no card contains this trigram
+            return QBitArray(cards.size());
+        }
+        lists << &it.value();
+    }
+
+    // intersect starting with the rarest trigram, so the intermediate results stay small
+    std::sort(lists.begin(), lists.end(),
+              [](const QVector<int> *a, const QVector<int> *b) { return a->size() < b->size(); });
+
+    QVector<int> result = *lists.first();
+    QVector<int> intersection;
+    for (int i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+        intersection.clear();
+        std::set_intersection(result.constBegin(), result.constEnd(), lists.at(i)->constBegin(),
+                              lists.at(i)->constEnd(), std::back_inserter(intersection));
+        result.swap(intersection);
+    }
+
+    QBitArray bits(cards.size());
+    for (int id : result) {
+        bits.setBit(id);
+    }
+    return bits;
+}
+
+QBitArray CardSearchIndex::nameCandidates(const QString &foldedNeedle) const
+{
+    return candidates(nameTrigrams, foldedNeedle);
+}
+
+QBitArray CardSearchIndex::textCandidates(const QString &foldedNeedle) const
+{
+    return candidates(textTrigrams, foldedNeedle);
+}
+
+QStringList CardSearchIndex::namesWithPrefix(const QString &prefix, int limit) const
+{
+    const QString simplePrefix = CardInfo::simplifyName(prefix);
+    auto it = std::lower_bound(simpleNames.constBegin(), simpleNames.constEnd(), simplePrefix,
+                               [](const QPair<QString, int> &entry, const QString &key) { return entry.first < key; });
+
+    QStringList names;
+    for (; it != simpleNames.constEnd() && it->first.startsWith(simplePrefix); ++it) {
+        if (limit >= 0 && names.size() >= limit) {
+            break;
+        }
+        names << cards.at(it->second)->getName();
+    }
+    return names;
+}
@@ -0,0 +1,65 @@
+#ifndef CARD_SEARCH_INDEX_H
+#define CARD_SEARCH_INDEX_H
+
+#include "card_database.h"
+
+#include <QBitArray>
+#include <QHash>
+#include <QPair>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+class CardSearchIndex;
+typedef QSharedPointer<const CardSearchIndex> CardSearchIndexPtr;
+
+/**
+ * Inverted trigram index over the case folded names and oracle texts of the cards, plus their simple names in sorted
+ * order. A substring search only has to match the cards containing every trigram of the needle exactly, a prefix
+ * search is a binary search.
+ *
+ * Built once for a snapshot of the database and never changed afterwards, so it can be read from any thread.
+ */
+class CardSearchIndex
+{
+public:
+    explicit CardSearchIndex(const QList<CardInfoPtr> &_cards);
+
+    int size() const
+    {
+        return cards.size();
+    }
+    // Returns -1 for cards that aren't in the index, like cards added after it was built or private copies of cards
+    int idOf(const CardInfo *card) const
+    {
+        return ids.value(card, -1);
+    }
+
+    // Cards whose case folded name or oracle text may contain the case folded needle, by id. A null array means the
+    // needle is too short to rule out anything.
+    QBitArray nameCandidates(const QString &foldedNeedle) const;
+    QBitArray textCandidates(const QString &foldedNeedle) const;
+    // Names of the cards whose simple name starts with the simplified prefix, ordered by simple name
+    QStringList namesWithPrefix(const QString &prefix, int limit = -1) const;
+
+    // True unless the candidates rule out the card with that id
+    static bool isCandidate(const QBitArray &candidates, int id)
+    {
+        return candidates.isNull() || id < 0 || candidates.testBit(id);
+    }
+
+private:
+    typedef QHash<quint64, QVector<int>> Postings;
+
+    // keeps the cards alive, so that no other card can take over the address of an indexed one
+    QVector<CardInfoPtr> cards;
+    QHash<const CardInfo *, int> ids;
+    Postings nameTrigrams, textTrigrams;
+    // sorted by simple name
+    QVector<QPair<QString, int>> simpleNames;
+
+    static void addTrigrams(Postings &postings, const QString &folded, int id);
+    QBitArray candidates(const Postings &postings, const QString &foldedNeedle) const;
+};
+
+#endif
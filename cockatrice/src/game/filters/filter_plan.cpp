@@ -0,0 +1,416 @@
+#include "filter_plan.h"
+
+#include "filter_tree.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QtConcurrent>
+#include <algorithm>
+#include <numeric>
+
+// Cards checked by one task when running a plan
+#define FILTER_PLAN_CHUNK_SIZE 1024
+
+namespace
+{
+// Legality bits are shared by all cards and plans, fields are extracted on several threads at once
+QReadWriteLock formatLock;
+QHash<QString, int> formatBits;
+
+quint32 letterMask(const QString &string)
+{
+    quint32 mask = 0;
+    for (const QChar &c : string) {
+        const ushort letter = c.toLower().unicode();
+        if (letter >= 'a' && letter <= 'z') {
+            mask |= 1u << (letter - 'a');
+        }
+    }
+    return mask;
+}
+} // namespace
+
+CardFilterFields::CardFilterFields(const CardInfoPtr &_card, const CardSearchIndex *searchIndex) : card(_card)
+{
+    if (searchIndex != nullptr) {
+        searchId = searchIndex->idOf(card.data());
+    }
+    isToken = card->getIsToken();
+    name = card->getName().toCaseFolded();
+    type = card->getCardType().toCaseFolded();
+    text = card->getText().toCaseFolded();
+
+    colors = card->getColors();
+    colorLetters = letterMask(colors);
+
+    const QString cmcString = card->getCmc();
+    cmc = cmcString.toInt(&cmcIsNumber);
+    if (!cmcIsNumber) {
+        for (const QString &part : cmcString.split("//")) {
+            cmcParts << part.toInt();
+            cmcSum += cmcParts.last();
+        }
+    }
+
+    for (QString manaCost : card->getManaCost().split("//")) {
+        std::sort(manaCost.begin(), manaCost.end());
+        sortedManaCosts << manaCost;
+    }
+
+    const QString powTough = card->getPowTough();
+    const int slash = powTough.indexOf("/");
+    hasPowTough = slash != -1;
+    if (hasPowTough) {
+        power = powTough.left(slash);
+        toughness = powTough.mid(slash + 1);
+        powerValue = power.toInt(&powerIsNumber);
+        toughnessValue = toughness.toInt(&toughnessIsNumber);
+    }
+
+    loyalty = card->getLoyalty();
+    loyaltyValue = loyalty.toInt(&loyaltyIsNumber);
+
+    for (const auto &cardInfoPerSetList : card->getSets()) {
+        for (const auto &set : cardInfoPerSetList) {
+            setNames << set.getPtr()->getShortName().toCaseFolded() << set.getPtr()->getLongName().toCaseFolded();
+            rarities << set.getProperty("rarity").toCaseFolded();
+        }
+    }
+
+    for (const QString &property : card->getProperties()) {
+        if (!property.startsWith("format-") || card->getProperty(property) != "legal") {
+            continue;
+        }
+        const QString format = property.mid(7);
+        const int bit = FilterPlan::formatBit(format);
+        if (bit == -1) {
+            otherLegalFormats << format;
+        } else {
+            legalFormats |= Q_UINT64_C(1) << bit;
+        }
+    }
+}
+
+FilterPlan::FilterPlan(const FilterTree *tree, const CardSearchIndexPtr &searchIndex)
+{
+    if (tree == nullptr) {
+        return;
+    }
+
+    for (int i = 0; i < tree->childCount(); ++i) {
+        const auto *logicMap = static_cast<const LogicMap *>(tree->nodeAt(i));
+        if (!logicMap->isEnabled()) {
+            continue;
+        }
+
+        AttrGroup group;
+        for (int type = 0; type < CardFilter::TypeEnd; ++type) {
+            const FilterItemList *itemList = logicMap->findTypeList(static_cast<CardFilter::Type>(type));
+            if (itemList == nullptr || !itemList->isEnabled()) {
+                continue;
+            }
+
+            TermList &list = group.lists[type];
+            list.present = true;
+            for (int j = 0; j < itemList->childCount(); ++j) {
+                const auto *item = static_cast<const FilterItem *>(itemList->nodeAt(j));
+                if (item->isEnabled()) {
+                    list.terms << compileTerm(item->term, logicMap->attr, searchIndex);
+                }
+            }
+        }
+        groups << group;
+    }
+}
+
+bool FilterPlan::accepts(const CardFilterFields &card) const
+{
+    for (const AttrGroup &group : groups) {
+        if (!testGroup(group, card)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FilterPlan::testAll(const TermList &list, const CardFilterFields &card)
+{
+    for (const Predicate &term : list.terms) {
+        if (!term(card)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FilterPlan::testAny(const TermList &list, const CardFilterFields &card)
+{
+    // a list without enabled terms is true, like FilterItemList::testTypeOr
+    if (list.terms.isEmpty()) {
+        return true;
+    }
+
+    for (const Predicate &term : list.terms) {
+        if (term(card)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Same logic as FilterTree::testAttr
+bool FilterPlan::testGroup(const AttrGroup &group, const CardFilterFields &card)
+{
+    const TermList &andList = group.lists[CardFilter::TypeAnd];
+    if (andList.present && !testAll(andList, card)) {
+        return false;
+    }
+
+    const TermList &andNotList = group.lists[CardFilter::TypeAndNot];
+    if (andNotList.present && testAny(andNotList, card)) {
+        return false;
+    }
+
+    bool status = true;
+    const TermList &orList = group.lists[CardFilter::TypeOr];
+    if (orList.present) {
+        status = false;
+        if (testAny(orList, card)) {
+            return true;
+        }
+    }
+
+    const TermList &orNotList = group.lists[CardFilter::TypeOrNot];
+    if (orNotList.present && !testAll(orNotList, card)) {
+        return true;
+    }
+
+    return status;
+}
+
+// Same relations as FilterItem::relationCheck
+std::function<bool(int)> FilterPlan::compileRelation(const QString &term)
+{
+    bool conversion;
+    const int value = term.toInt(&conversion);
+    if (conversion) {
+        return [value](int x) { return x == value; };
+    }
+
+    const QString trimmedTerm = term.trimmed();
+    if (trimmedTerm.length() > 1 && trimmedTerm[1] == '=') {
+        const int termInt = trimmedTerm.mid(2).toInt();
+        if (trimmedTerm.startsWith('<')) {
+            return [termInt](int x) { return x <= termInt; };
+        } else if (trimmedTerm.startsWith('>')) {
+            return [termInt](int x) { return x >= termInt; };
+        }
+        return [termInt](int x) { return x == termInt; };
+    }
+
+    const int termInt = trimmedTerm.mid(1).toInt();
+    if (trimmedTerm.startsWith('<')) {
+        return [termInt](int x) { return x < termInt; };
+    } else if (trimmedTerm.startsWith('>')) {
+        return [termInt](int x) { return x > termInt; };
+    } else if (trimmedTerm.startsWith('=')) {
+        return [termInt](int x) { return x == termInt; };
+    }
+    return [](int) { return false; };
+}
+
+// Each case matches the FilterItem::accept function of that attribute
+FilterPlan::Predicate
+FilterPlan::compileTerm(const QString &term, CardFilter::Attr attr, const CardSearchIndexPtr &searchIndex)
+{
+    switch (attr) {
+        case CardFilter::AttrName: {
+            const QString folded = term.toCaseFolded();
+            const QBitArray candidates = searchIndex ? searchIndex->nameCandidates(folded) : QBitArray();
+            return [folded, candidates](const CardFilterFields &card) {
+                return CardSearchIndex::isCandidate(candidates, card.searchId) && card.name.contains(folded);
+            };
+        }
+        case CardFilter::AttrType: {
+            const QString folded = term.toCaseFolded();
+            return [folded](const CardFilterFields &card) { return card.type.contains(folded); };
+        }
+        case CardFilter::AttrText: {
+            const QString folded = term.toCaseFolded();
+            const QBitArray candidates = searchIndex ? searchIndex->textCandidates(folded) : QBitArray();
+            return [folded, candidates](const CardFilterFields &card) {
+                return CardSearchIndex::isCandidate(candidates, card.searchId) && card.text.contains(folded);
+            };
+        }
+        case CardFilter::AttrColor: {
+            const QString color = FilterItem::normalizeColorTerm(term);
+            const bool colorless = color.toLower() == "c";
+            const quint32 letters = letterMask(color);
+            QString others;
+            for (const QChar &c : color) {
+                if (letterMask(c) == 0) {
+                    others += c;
+                }
+            }
+            return [colorless, letters, others](const CardFilterFields &card) {
+                if (colorless && card.colors.isEmpty()) {
+                    return true;
+                }
+                if ((card.colorLetters & letters) != letters) {
+                    return false;
+                }
+                for (const QChar &c : others) {
+                    if (!card.colors.contains(c, Qt::CaseInsensitive)) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+        }
+        case CardFilter::AttrSet: {
+            const QString folded = term.toCaseFolded();
+            return [folded](const CardFilterFields &card) { return card.setNames.contains(folded); };
+        }
+        case CardFilter::AttrManaCost: {
+            QString partialCost = term.toUpper();
+            std::sort(partialCost.begin(), partialCost.end());
+            return [partialCost](const CardFilterFields &card) {
+                for (const QString &fullManaCost : card.sortedManaCosts) {
+                    if (fullManaCost.contains(partialCost)) {
+                        return true;
+                    }
+                }
+                return false;
+            };
+        }
+        case CardFilter::AttrCmc: {
+            const auto relation = compileRelation(term);
+            return [relation](const CardFilterFields &card) {
+                if (card.cmcIsNumber) {
+                    return relation(card.cmc);
+                }
+                for (int part : card.cmcParts) {
+                    if (relation(part)) {
+                        return true;
+                    }
+                }
+                return relation(card.cmcSum);
+            };
+        }
+        case CardFilter::AttrRarity: {
+            const QString folded = FilterItem::normalizeRarityTerm(term).toCaseFolded();
+            return [folded](const CardFilterFields &card) { return card.rarities.contains(folded); };
+        }
+        case CardFilter::AttrPow: {
+            const auto relation = compileRelation(term);
+            return [term, relation](const CardFilterFields &card) {
+                if (!card.hasPowTough) {
+                    return false;
+                }
+                return term == card.power || (card.powerIsNumber && relation(card.powerValue));
+            };
+        }
+        case CardFilter::AttrTough: {
+            const auto relation = compileRelation(term);
+            return [term, relation](const CardFilterFields &card) {
+                if (!card.hasPowTough) {
+                    return false;
+                }
+                return term == card.toughness || (card.toughnessIsNumber && relation(card.toughnessValue));
+            };
+        }
+        case CardFilter::AttrLoyalty: {
+            const auto relation = compileRelation(term);
+            const QString upper = term.trimmed().toUpper();
+            return [relation, upper](const CardFilterFields &card) {
+                if (card.loyalty.isEmpty()) {
+                    return false;
+                }
+                return card.loyaltyIsNumber ? relation(card.loyaltyValue) : upper == card.loyalty;
+            };
+        }
+        case CardFilter::AttrFormat: {
+            const QString format = term.toLower();
+            const int bit = formatBit(format);
+            if (bit == -1) {
+                return [format](const CardFilterFields &card) { return card.otherLegalFormats.contains(format); };
+            }
+            const quint64 mask = Q_UINT64_C(1) << bit;
+            return [mask](const CardFilterFields &card) { return (card.legalFormats & mask) != 0; };
+        }
+        default:
+            return [](const CardFilterFields &) { return true; }; /* ignore this attribute */
+    }
+}
+
+int FilterPlan::formatBit(const QString &format)
+{
+    {
+        QReadLocker locker(&formatLock);
+        auto it = formatBits.constFind(format);
+        if (it != formatBits.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QWriteLocker locker(&formatLock);
+    auto it = formatBits.constFind(format);
+    if (it != formatBits.constEnd()) {
+        return it.value();
+    }
+    const int bit = formatBits.size() < 64 ? formatBits.size() : -1;
+    formatBits.insert(format, bit);
+    return bit;
+}
+
+QVector<CardFilterFields> FilterPlan::extractFields(const QList<CardInfoPtr> &cards,
+                                                    const CardSearchIndex *searchIndex)
+{
+    QVector<CardFilterFields> fields(cards.size());
+    if (cards.size() <= FILTER_PLAN_CHUNK_SIZE) {
+        for (int i = 0; i < cards.size(); ++i) {
+            fields[i] = CardFilterFields(cards.at(i), searchIndex);
+        }
+        return fields;
+    }
+
+    QVector<int> rows(cards.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    CardFilterFields *results = fields.data();
+    QtConcurrent::blockingMap(rows, [&cards, searchIndex, results](int row) {
+        results[row] = CardFilterFields(cards.at(row), searchIndex);
+    });
+    return fields;
+}
+
+QBitArray FilterPlan::run(const QVector<CardFilterFields> &cards, const Predicate &predicate)
+{
+    const int count = cards.size();
+    // every task writes its own bytes, they are packed into bits afterwards
+    QVector<char> accepted(count);
+    char *results = accepted.data();
+
+    QVector<int> chunks;
+    for (int begin = 0; begin < count; begin += FILTER_PLAN_CHUNK_SIZE) {
+        chunks << begin;
+    }
+    auto runChunk = [&cards, &predicate, results, count](int begin) {
+        const int end = qMin(begin + FILTER_PLAN_CHUNK_SIZE, count);
+        for (int i = begin; i < end; ++i) {
+            results[i] = predicate(cards.at(i)) ? 1 : 0;
+        }
+    };
+    if (chunks.size() > 1) {
+        QtConcurrent::blockingMap(chunks, runChunk);
+    } else if (!chunks.isEmpty()) {
+        runChunk(0);
+    }
+
+    QBitArray bits(count);
+    for (int i = 0; i < count; ++i) {
+        if (results[i]) {
+            bits.setBit(i);
+        }
+    }
+    return bits;
+}
@@ -0,0 +1,109 @@
+#ifndef FILTER_PLAN_H
+#define FILTER_PLAN_H
+
+#include "../cards/card_database.h"
+#include "../cards/card_search_index.h"
+#include "filter_card.h"
+
+#include <QBitArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+class FilterTree;
+
+/**
+ * The fields of a card the filters look at, extracted once so that filtering doesn't have to parse, split and case
+ * fold the same properties again for every card on every keystroke.
+ */
+struct CardFilterFields
+{
+    CardFilterFields() = default;
+    explicit CardFilterFields(const CardInfoPtr &_card, const CardSearchIndex *searchIndex = nullptr);
+
+    CardInfoPtr card;
+    // id of the card in the search index the fields were extracted with, -1 if it isn't in there
+    int searchId = -1;
+    bool isToken = false;
+
+    // case folded
+    QString name, type, text;
+
+    QString colors;
+    // one bit per letter in colors, 'a' is the lowest bit
+    quint32 colorLetters = 0;
+
+    bool cmcIsNumber = false;
+    int cmc = 0;
+    // the halves of split cards, when cmc isn't a plain number
+    QVector<int> cmcParts;
+    int cmcSum = 0;
+
+    // the characters of each half of the mana cost, sorted
+    QStringList sortedManaCosts;
+
+    bool hasPowTough = false;
+    QString power, toughness;
+    bool powerIsNumber = false, toughnessIsNumber = false;
+    int powerValue = 0, toughnessValue = 0;
+
+    QString loyalty;
+    bool loyaltyIsNumber = false;
+    int loyaltyValue = 0;
+
+    // case folded short and long names of every set, and the rarities of all printings
+    QStringList setNames;
+    QStringList rarities;
+
+    // bit FilterPlan::formatBit(format) is set when the card is legal in it
+    quint64 legalFormats = 0;
+    // formats that didn't get a bit
+    QStringList otherLegalFormats;
+};
+
+/**
+ * A FilterTree compiled into predicates over CardFilterFields. Terms are parsed and normalized once when the plan is
+ * built instead of once per card, so checking a card only compares prepared values.
+ */
+class FilterPlan
+{
+public:
+    typedef std::function<bool(const CardFilterFields &)> Predicate;
+
+    // A plan without a tree accepts every card
+    FilterPlan() = default;
+    // Name and text terms are narrowed down with the search index, if the fields were extracted with the same one
+    explicit FilterPlan(const FilterTree *tree, const CardSearchIndexPtr &searchIndex = CardSearchIndexPtr());
+
+    bool accepts(const CardFilterFields &card) const;
+
+    // Extracts the fields of all cards, in parallel
+    static QVector<CardFilterFields> extractFields(const QList<CardInfoPtr> &cards,
+                                                   const CardSearchIndex *searchIndex = nullptr);
+    // Checks all cards in parallel chunks; bit i is set when cards[i] is accepted. The predicate must be thread safe.
+    static QBitArray run(const QVector<CardFilterFields> &cards, const Predicate &predicate);
+    // Returns -1 for formats beyond the first 64 seen
+    static int formatBit(const QString &format);
+
+private:
+    struct TermList
+    {
+        bool present = false;
+        QVector<Predicate> terms;
+    };
+    struct AttrGroup
+    {
+        TermList lists[CardFilter::TypeEnd];
+    };
+    QVector<AttrGroup> groups;
+
+    static bool testAll(const TermList &list, const CardFilterFields &card);
+    static bool testAny(const TermList &list, const CardFilterFields &card);
+    static bool testGroup(const AttrGroup &group, const CardFilterFields &card);
+    static Predicate compileTerm(const QString &term, CardFilter::Attr attr, const CardSearchIndexPtr &searchIndex);
+    static std::function<bool(int)> compileRelation(const QString &term);
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include <QByteArray>
 #include <QDebug>
 #include <QString>
+#include <QVector>
 #include <functional>
 
 peg::parser search(R"(
@@ -65,6 +66,13 @@ NumericValue <- [0-9]+
 
 std::once_flag init;
 
+// The search index is handed to the semantic actions as the parser's user data
+static CardSearchIndexPtr searchIndexOf(const std::any &dt)
+{
+    const auto *searchIndex = std::any_cast<CardSearchIndexPtr>(&dt);
+    return searchIndex != nullptr ? *searchIndex : CardSearchIndexPtr();
+}
+
 static void setupParserRules()
 {
     auto passthru = [](const peg::SemanticValues &sv) -> Filter {
@@ -72,16 +80,26 @@ static void setupParserRules()
     };
 
     search["Start"] = passthru;
-    search["QueryPartList"] = [](const peg::SemanticValues &sv) -> Filter {
+    // unpack the parts once, instead of copying them out of the semantic values for every card
+    auto filters = [](const peg::SemanticValues &sv) {
+        QVector<Filter> result;
+        for (const auto &query : sv) {
+            result.append(std::any_cast<Filter>(query));
+        }
+        return result;
+    };
+    search["QueryPartList"] = [filters](const peg::SemanticValues &sv) -> Filter {
+        const QVector<Filter> parts = filters(sv);
         return [=](const CardData &x) {
-            auto matchesFilter = [&x](const std::any &query) { return std::any_cast<Filter>(query)(x); };
-            return std::all_of(sv.begin(), sv.end(), matchesFilter);
+            auto matchesFilter = [&x](const Filter &query) { return query(x); };
+            return std::all_of(parts.begin(), parts.end(), matchesFilter);
         };
     };
-    search["ComplexQueryPart"] = [](const peg::SemanticValues &sv) -> Filter {
+    search["ComplexQueryPart"] = [filters](const peg::SemanticValues &sv) -> Filter {
+        const QVector<Filter> parts = filters(sv);
         return [=](const CardData &x) {
-            auto matchesFilter = [&x](const std::any &query) { return std::any_cast<Filter>(query)(x); };
-            return std::any_of(sv.begin(), sv.end(), matchesFilter);
+            auto matchesFilter = [&x](const Filter &query) { return query(x); };
+            return std::any_of(parts.begin(), parts.end(), matchesFilter);
         };
     };
     search["SomewhatComplexQueryPart"] = passthru;
@@ -122,28 +140,26 @@ static void setupParserRules()
     search["RarityQuery"] = [](const peg::SemanticValues &sv) -> Filter {
         const auto rarity = std::any_cast<QString>(sv[0]);
         return [=](const CardData &x) -> bool {
-            QList<CardInfoPerSet> infos;
-            for (const auto &setsValue : x->getSets().values()) {
+            for (const auto &setsValue : x->getSets()) {
                 for (const auto &cardInfoPerSet : setsValue) {
-                    infos.append(cardInfoPerSet);
+                    if (rarity == cardInfoPerSet.getProperty("rarity")) {
+                        return true;
+                    }
                 }
             }
-
-            auto matchesRarity = [&rarity](const CardInfoPerSet &info) { return rarity == info.getProperty("rarity"); };
-            return std::any_of(infos.begin(), infos.end(), matchesRarity);
+            return false;
         };
     };
 
     search["FormatQuery"] = [](const peg::SemanticValues &sv) -> Filter {
         if (sv.choice() == 0) {
-            const auto format = std::any_cast<QString>(sv[0]);
-            return
-                [=](const CardData &x) -> bool { return x->getProperty(QString("format-%1").arg(format)) == "legal"; };
+            const QString formatKey = QString("format-%1").arg(std::any_cast<QString>(sv[0]));
+            return [=](const CardData &x) -> bool { return x->getProperty(formatKey) == "legal"; };
         }
 
-        const auto format = std::any_cast<QString>(sv[1]);
+        const QString formatKey = QString("format-%1").arg(std::any_cast<QString>(sv[1]));
         const auto legality = std::any_cast<QString>(sv[0]);
-        return [=](const CardData &x) -> bool { return x->getProperty(QString("format-%1").arg(format)) == legality; };
+        return [=](const CardData &x) -> bool { return x->getProperty(formatKey) == legality; };
     };
     search["Legality"] = [](const peg::SemanticValues &sv) -> QString {
         switch (tolower(std::string(sv.sv())[0])) {
@@ -261,19 +277,25 @@ static void setupParserRules()
         return QString::fromStdString(std::string(sv.sv()));
     };
 
-    search["RegexString"] = [](const peg::SemanticValues &sv) -> StringMatcher {
-        auto target = std::any_cast<QString>(sv[0]);
-        return [=](const QString &s) {
-            auto sanitizedTarget = QString(target);
-            sanitizedTarget.replace("\\\"", "\"");
-            sanitizedTarget.replace("\\'", "'");
-            return s.contains(sanitizedTarget, Qt::CaseInsensitive);
-        };
+    // the unescaped text to look for, case insensitively
+    search["RegexString"] = [](const peg::SemanticValues &sv) -> QString {
+        auto sanitizedTarget = std::any_cast<QString>(sv[0]);
+        sanitizedTarget.replace("\\\"", "\"");
+        sanitizedTarget.replace("\\'", "'");
+        return sanitizedTarget;
     };
 
-    search["OracleQuery"] = [](const peg::SemanticValues &sv) -> Filter {
-        const auto matcher = std::any_cast<StringMatcher>(sv[0]);
-        return [=](const CardData &x) { return matcher(x->getText()); };
+    search["OracleQuery"] = [](const peg::SemanticValues &sv, std::any &dt) -> Filter {
+        const auto target = std::any_cast<QString>(sv[0]);
+        const CardSearchIndexPtr searchIndex = searchIndexOf(dt);
+        const QBitArray candidates = searchIndex ? searchIndex->textCandidates(target.toCaseFolded()) : QBitArray();
+        if (candidates.isNull()) {
+            return [=](const CardData &x) { return x->getText().contains(target, Qt::CaseInsensitive); };
+        }
+        return [=](const CardData &x) {
+            return CardSearchIndex::isCandidate(candidates, searchIndex->idOf(x.data())) &&
+                   x->getText().contains(target, Qt::CaseInsensitive);
+        };
     };
 
     search["ColorQuery"] = [](const peg::SemanticValues &sv) -> Filter {
@@ -339,17 +361,27 @@ static void setupParserRules()
     search["FieldQuery"] = [](const peg::SemanticValues &sv) -> Filter {
         const auto field = std::any_cast<QString>(sv[0]);
         if (sv.choice() == 0) {
-            const auto matcher = std::any_cast<StringMatcher>(sv[1]);
-            return [=](const CardData &x) -> bool { return x->hasProperty(field) && matcher(x->getProperty(field)); };
+            const auto target = std::any_cast<QString>(sv[1]);
+            return [=](const CardData &x) -> bool {
+                return x->hasProperty(field) && x->getProperty(field).contains(target, Qt::CaseInsensitive);
+            };
         }
 
         const auto matcher = std::any_cast<NumberMatcher>(sv[1]);
         return
             [=](const CardData &x) -> bool { return x->hasProperty(field) && matcher(x->getProperty(field).toInt()); };
     };
-    search["GenericQuery"] = [](const peg::SemanticValues &sv) -> Filter {
-        const auto matcher = std::any_cast<StringMatcher>(sv[0]);
-        return [=](const CardData &x) { return matcher(x->getName()); };
+    search["GenericQuery"] = [](const peg::SemanticValues &sv, std::any &dt) -> Filter {
+        const auto target = std::any_cast<QString>(sv[0]);
+        const CardSearchIndexPtr searchIndex = searchIndexOf(dt);
+        const QBitArray candidates = searchIndex ? searchIndex->nameCandidates(target.toCaseFolded()) : QBitArray();
+        if (candidates.isNull()) {
+            return [=](const CardData &x) { return x->getName().contains(target, Qt::CaseInsensitive); };
+        }
+        return [=](const CardData &x) {
+            return CardSearchIndex::isCandidate(candidates, searchIndex->idOf(x.data())) &&
+                   x->getName().contains(target, Qt::CaseInsensitive);
+        };
     };
 
     search["Color"] = [](const peg::SemanticValues &sv) -> char { return "WUBRGU"[sv.choice()]; };
@@ -364,7 +396,7 @@ FilterString::FilterString()
     _error = "Not initialized";
 }
 
-FilterString::FilterString(const QString &expr)
+FilterString::FilterString(const QString &expr, const CardSearchIndexPtr &searchIndex)
 {
     QByteArray ba = expr.simplified().toUtf8();
 
@@ -381,7 +413,8 @@ FilterString::FilterString(const QString &expr)
         _error = QString("Error at position %1: %2").arg(col).arg(QString::fromStdString(msg));
     });
 
-    if (!search.parse(ba.data(), result)) {
+    std::any dt = searchIndex;
+    if (!search.parse(ba.data(), dt, result)) {
         qDebug().nospace() << "FilterString error for " << expr << "; " << qPrintable(_error);
         result = [](const CardData &) -> bool { return false; };
     }
@@ -2,6 +2,7 @@
 #define FILTER_STRING_H
 
 #include "../cards/card_database.h"
+#include "../cards/card_search_index.h"
 #include "filter_tree.h"
 
 #include <QMap>
@@ -25,7 +26,8 @@ class FilterString
 {
 public:
     FilterString();
-    explicit FilterString(const QString &exp);
+    // Name and oracle text searches are narrowed down with the search index, when there is one
+    explicit FilterString(const QString &exp, const CardSearchIndexPtr &searchIndex = CardSearchIndexPtr());
     bool check(const CardData &card) const
     {
         return result(card);
@@ -160,22 +160,7 @@ bool FilterItem::acceptType(const CardInfoPtr info) const
 
 bool FilterItem::acceptColor(const CardInfoPtr info) const
 {
-    QString converted_term = term.trimmed();
-
-    converted_term.replace("green", "g", Qt::CaseInsensitive);
-    converted_term.replace("grn", "g", Qt::CaseInsensitive);
-    converted_term.replace("blue", "u", Qt::CaseInsensitive);
-    converted_term.replace("blu", "u", Qt::CaseInsensitive);
-    converted_term.replace("black", "b", Qt::CaseInsensitive);
-    converted_term.replace("blk", "b", Qt::CaseInsensitive);
-    converted_term.replace("red", "r", Qt::CaseInsensitive);
-    converted_term.replace("white", "w", Qt::CaseInsensitive);
-    converted_term.replace("wht", "w", Qt::CaseInsensitive);
-    converted_term.replace("colorless", "c", Qt::CaseInsensitive);
-    converted_term.replace("colourless", "c", Qt::CaseInsensitive);
-    converted_term.replace("none", "c", Qt::CaseInsensitive);
-
-    converted_term.replace(QString(" "), QString(""), Qt::CaseInsensitive);
+    QString converted_term = normalizeColorTerm(term);
 
     // Colorless card filter
     if (converted_term.toLower() == "c" && info->getColors().length() < 1) {
@@ -195,6 +180,27 @@ bool FilterItem::acceptColor(const CardInfoPtr info) const
     return match_count == converted_term.length();
 }
 
+QString FilterItem::normalizeColorTerm(const QString &term)
+{
+    QString converted_term = term.trimmed();
+
+    converted_term.replace("green", "g", Qt::CaseInsensitive);
+    converted_term.replace("grn", "g", Qt::CaseInsensitive);
+    converted_term.replace("blue", "u", Qt::CaseInsensitive);
+    converted_term.replace("blu", "u", Qt::CaseInsensitive);
+    converted_term.replace("black", "b", Qt::CaseInsensitive);
+    converted_term.replace("blk", "b", Qt::CaseInsensitive);
+    converted_term.replace("red", "r", Qt::CaseInsensitive);
+    converted_term.replace("white", "w", Qt::CaseInsensitive);
+    converted_term.replace("wht", "w", Qt::CaseInsensitive);
+    converted_term.replace("colorless", "c", Qt::CaseInsensitive);
+    converted_term.replace("colourless", "c", Qt::CaseInsensitive);
+    converted_term.replace("none", "c", Qt::CaseInsensitive);
+
+    converted_term.replace(QString(" "), QString(""), Qt::CaseInsensitive);
+    return converted_term;
+}
+
 bool FilterItem::acceptText(const CardInfoPtr info) const
 {
     return info->getText().contains(term, Qt::CaseInsensitive);
@@ -299,6 +305,20 @@ bool FilterItem::acceptPowerToughness(const CardInfoPtr info, CardFilter::Attr a
 }
 
 bool FilterItem::acceptRarity(const CardInfoPtr info) const
+{
+    const QString converted_term = normalizeRarityTerm(term);
+
+    for (const auto &cardInfoPerSetList : info->getSets()) {
+        for (const auto &set : cardInfoPerSetList) {
+            if (set.getProperty("rarity").compare(converted_term, Qt::CaseInsensitive) == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+QString FilterItem::normalizeRarityTerm(const QString &term)
 {
     QString converted_term = term.trimmed();
 
@@ -337,15 +357,7 @@ bool FilterItem::acceptRarity(const CardInfoPtr info) const
                 break;
         }
     }
-
-    for (const auto &cardInfoPerSetList : info->getSets()) {
-        for (const auto &set : cardInfoPerSetList) {
-            if (set.getProperty("rarity").compare(converted_term, Qt::CaseInsensitive) == 0) {
-                return true;
-            }
-        }
-    }
-    return false;
+    return converted_term;
 }
 
 bool FilterItem::relationCheck(int cardInfo) const
@@ -209,6 +209,10 @@ public:
     bool acceptCardAttr(CardInfoPtr info, CardFilter::Attr attr) const;
     bool acceptFormat(CardInfoPtr info) const;
     bool relationCheck(int cardInfo) const;
+
+    // Spell out the abbreviations a color or rarity term may use, the way the accept functions compare them
+    static QString normalizeColorTerm(const QString &term);
+    static QString normalizeRarityTerm(const QString &term);
 };
 
 class FilterTree : public QObject, public FilterTreeBranch<LogicMap *>
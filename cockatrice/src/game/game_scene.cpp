@@ -8,7 +8,6 @@
 #include "zones/view_zone_widget.h"
 
 #include <QAction>
-#include <QBasicTimer>
 #include <QDebug>
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsView>
@@ -18,18 +17,13 @@
 GameScene::GameScene(PhasesToolbar *_phasesToolbar, QObject *parent)
     : QGraphicsScene(parent), phasesToolbar(_phasesToolbar), viewSize(QSize()), playerRotation(0)
 {
-    animationTimer = new QBasicTimer;
+    animationDriver = new CardAnimationDriver(this);
     addItem(phasesToolbar);
     connect(&SettingsCache::instance(), SIGNAL(minPlayersForMultiColumnLayoutChanged()), this, SLOT(rearrange()));
 
     rearrange();
 }
 
-GameScene::~GameScene()
-{
-    delete animationTimer;
-}
-
 void GameScene::retranslateUi()
 {
     for (int i = 0; i < zoneViews.size(); ++i)
@@ -289,30 +283,14 @@ bool GameScene::event(QEvent *event)
     return QGraphicsScene::event(event);
 }
 
-void GameScene::timerEvent(QTimerEvent * /*event*/)
-{
-    QMutableSetIterator<CardItem *> i(cardsToAnimate);
-    while (i.hasNext()) {
-        i.next();
-        if (!i.value()->animationEvent())
-            i.remove();
-    }
-    if (cardsToAnimate.isEmpty())
-        animationTimer->stop();
-}
-
 void GameScene::registerAnimationItem(AbstractCardItem *card)
 {
-    cardsToAnimate.insert(static_cast<CardItem *>(card));
-    if (!animationTimer->isActive())
-        animationTimer->start(10, this);
+    animationDriver->registerCard(static_cast<CardItem *>(card));
 }
 
 void GameScene::unregisterAnimationItem(AbstractCardItem *card)
 {
-    cardsToAnimate.remove(static_cast<CardItem *>(card));
-    if (cardsToAnimate.isEmpty())
-        animationTimer->stop();
+    animationDriver->unregisterCard(static_cast<CardItem *>(card));
 }
 
 void GameScene::startRubberBand(const QPointF &selectionOrigin)
@@ -1,6 +1,8 @@
 #ifndef GAMESCENE_H
 #define GAMESCENE_H
 
+#include "card_animation_driver.h"
+
 #include <QGraphicsScene>
 #include <QList>
 #include <QPointer>
@@ -13,7 +15,6 @@ class AbstractCardItem;
 class CardItem;
 class ServerInfo_Card;
 class PhasesToolbar;
-class QBasicTimer;
 
 class GameScene : public QGraphicsScene
 {
@@ -27,14 +28,12 @@ private:
     QList<ZoneViewWidget *> zoneViews;
     QSize viewSize;
     QPointer<CardItem> hoveredCard;
-    QBasicTimer *animationTimer;
-    QSet<CardItem *> cardsToAnimate;
+    CardAnimationDriver *animationDriver;
     int playerRotation;
     void updateHover(const QPointF &scenePos);
 
 public:
     GameScene(PhasesToolbar *_phasesToolbar, QObject *parent = nullptr);
-    ~GameScene();
     void retranslateUi();
     void processViewSizeChange(const QSize &newSize);
     QTransform getViewTransform() const;
@@ -46,6 +45,10 @@ public:
 
     void registerAnimationItem(AbstractCardItem *item);
     void unregisterAnimationItem(AbstractCardItem *card);
+    const CardAnimationDriver::FrameStatistics &getAnimationFrameStatistics() const
+    {
+        return animationDriver->getFrameStatistics();
+    }
 public slots:
     void toggleZoneView(Player *player, const QString &zoneName, int numberCards);
     void addRevealedZoneView(Player *player,
@@ -62,7 +65,6 @@ public slots:
 
 protected:
     bool event(QEvent *event);
-    void timerEvent(QTimerEvent *event);
 signals:
     void sigStartRubberBand(const QPointF &selectionOrigin);
     void sigResizeRubberBand(const QPointF &cursorPoint);
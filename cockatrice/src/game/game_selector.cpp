@@ -328,6 +328,12 @@ void GameSelector::processGameInfo(const ServerInfo_Game &info)
     updateTitle();
 }
 
+void GameSelector::processGameList(const google::protobuf::RepeatedPtrField<ServerInfo_Game> &gameList)
+{
+    gameListModel->updateGameList(gameList);
+    updateTitle();
+}
+
 void GameSelector::actSelectedGameChanged(const QModelIndex &current, const QModelIndex & /* previous */)
 {
     enableButtonsForIndex(current);
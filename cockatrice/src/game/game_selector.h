@@ -2,6 +2,7 @@
 #define GAMESELECTOR_H
 
 #include "game_type_map.h"
+#include "pb/serverinfo_game.pb.h"
 
 #include <QGroupBox>
 #include <common/pb/event_add_to_list.pb.h>
@@ -16,7 +17,6 @@ class QLabel;
 class AbstractClient;
 class TabSupervisor;
 class TabRoom;
-class ServerInfo_Game;
 class Response;
 
 class GameSelector : public QGroupBox
@@ -64,6 +64,7 @@ public:
                  QWidget *parent = nullptr);
     void retranslateUi();
     void processGameInfo(const ServerInfo_Game &info);
+    void processGameList(const google::protobuf::RepeatedPtrField<ServerInfo_Game> &gameList);
 };
 
 #endif
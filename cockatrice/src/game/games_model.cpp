@@ -266,24 +266,68 @@ const ServerInfo_Game &GamesModel::getGame(int row)
 
 void GamesModel::updateGameList(const ServerInfo_Game &game)
 {
-    for (int i = 0; i < gameList.size(); i++) {
-        if (gameList[i].game_id() == game.game_id()) {
-            if (game.closed()) {
-                beginRemoveRows(QModelIndex(), i, i);
-                gameList.removeAt(i);
-                endRemoveRows();
-            } else {
-                gameList[i].MergeFrom(game);
-                emit dataChanged(index(i, 0), index(i, NUM_COLS - 1));
-            }
-            return;
+    auto row = gameRows.constFind(game.game_id());
+    if (row != gameRows.constEnd()) {
+        const int i = row.value();
+        if (game.closed()) {
+            beginRemoveRows(QModelIndex(), i, i);
+            gameList.removeAt(i);
+            gameRows.remove(game.game_id());
+            for (int j = i; j < gameList.size(); ++j)
+                gameRows[gameList[j].game_id()] = j;
+            endRemoveRows();
+        } else {
+            // MergeFrom appends repeated fields, but updates carry the complete list when it changes
+            if (game.game_types_size() > 0)
+                gameList[i].clear_game_types();
+            gameList[i].MergeFrom(game);
+            emit dataChanged(index(i, 0), index(i, NUM_COLS - 1));
         }
+        return;
     }
+    if (game.closed())
+        return;
+
     beginInsertRows(QModelIndex(), gameList.size(), gameList.size());
+    gameRows.insert(game.game_id(), gameList.size());
     gameList.append(game);
     endInsertRows();
 }
 
+void GamesModel::updateGameList(const google::protobuf::RepeatedPtrField<ServerInfo_Game> &games)
+{
+    QList<ServerInfo_Game> newGames;
+    QSet<int> newGameIds;
+    for (const ServerInfo_Game &game : games) {
+        if (newGameIds.contains(game.game_id())) {
+            // a later update of a game from this list has to find it in the model
+            appendGames(newGames);
+            newGames.clear();
+            newGameIds.clear();
+        }
+        if (gameRows.contains(game.game_id())) {
+            updateGameList(game);
+        } else if (!game.closed()) {
+            newGameIds.insert(game.game_id());
+            newGames.append(game);
+        }
+    }
+    appendGames(newGames);
+}
+
+void GamesModel::appendGames(const QList<ServerInfo_Game> &games)
+{
+    if (games.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), gameList.size(), gameList.size() + games.size() - 1);
+    for (const ServerInfo_Game &game : games) {
+        gameRows.insert(game.game_id(), gameList.size());
+        gameList.append(game);
+    }
+    endInsertRows();
+}
+
 GamesProxyModel::GamesProxyModel(QObject *parent, const TabSupervisor *_tabSupervisor)
     : QSortFilterProxyModel(parent), ownUserIsRegistered(_tabSupervisor->isOwnUserRegistered()),
       tabSupervisor(_tabSupervisor)
@@ -384,13 +428,8 @@ int GamesProxyModel::getNumFilteredGames() const
     if (!model)
         return 0;
 
-    int numFilteredGames = 0;
-    for (int row = 0; row < model->rowCount(); ++row) {
-        if (!filterAcceptsRow(row)) {
-            ++numFilteredGames;
-        }
-    }
-    return numFilteredGames;
+    // The proxy only maps accepted rows, no need to run the filter over every game again
+    return model->rowCount() - rowCount();
 }
 
 void GamesProxyModel::resetFilterParameters()
@@ -508,7 +547,7 @@ bool GamesProxyModel::filterAcceptsRow(int sourceRow) const
     if (!showBuddiesOnlyGames && game.only_buddies()) {
         return false;
     }
-    if (hideIgnoredUserGames && tabSupervisor->getUserListsTab()->getIgnoreList()->getUsers().contains(
+    if (hideIgnoredUserGames && tabSupervisor->getUserListsTab()->getIgnoreList()->contains(
                                     QString::fromStdString(game.creator_info().name()))) {
         return false;
     }
@@ -6,6 +6,7 @@
 #include "pb/serverinfo_game.pb.h"
 
 #include <QAbstractTableModel>
+#include <QHash>
 #include <QList>
 #include <QSet>
 #include <QSortFilterProxyModel>
@@ -17,11 +18,14 @@ class GamesModel : public QAbstractTableModel
     Q_OBJECT
 private:
     QList<ServerInfo_Game> gameList;
+    QHash<int, int> gameRows; // game id -> row in gameList
     QMap<int, QString> rooms;
     QMap<int, GameTypeMap> gameTypes;
 
     static const int NUM_COLS = 8;
 
+    void appendGames(const QList<ServerInfo_Game> &games);
+
 public:
     static const int SORT_ROLE = Qt::UserRole + 1;
 
@@ -41,8 +45,14 @@ public:
 
     /**
      * Update game list with a (possibly new) game.
+     * Updates for known games may be deltas that only carry the changed fields.
      */
     void updateGameList(const ServerInfo_Game &game);
+    /**
+     * Update game list with the games of a list event or response.
+     * The games that aren't known yet are inserted at once.
+     */
+    void updateGameList(const google::protobuf::RepeatedPtrField<ServerInfo_Game> &games);
 
     int roomColIndex()
     {
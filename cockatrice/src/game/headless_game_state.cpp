@@ -0,0 +1,664 @@
+#include "headless_game_state.h"
+
+#include "get_pb_extension.h"
+#include "pb/card_attributes.pb.h"
+#include "pb/context_concede.pb.h"
+#include "pb/context_unconcede.pb.h"
+#include "pb/event_attach_card.pb.h"
+#include "pb/event_change_zone_properties.pb.h"
+#include "pb/event_create_arrow.pb.h"
+#include "pb/event_create_counter.pb.h"
+#include "pb/event_create_token.pb.h"
+#include "pb/event_del_counter.pb.h"
+#include "pb/event_delete_arrow.pb.h"
+#include "pb/event_destroy_card.pb.h"
+#include "pb/event_draw_cards.pb.h"
+#include "pb/event_flip_card.pb.h"
+#include "pb/event_move_card.pb.h"
+#include "pb/event_player_properties_changed.pb.h"
+#include "pb/event_reveal_cards.pb.h"
+#include "pb/event_set_active_phase.pb.h"
+#include "pb/event_set_active_player.pb.h"
+#include "pb/event_set_card_attr.pb.h"
+#include "pb/event_set_card_counter.pb.h"
+#include "pb/event_set_counter.pb.h"
+#include "pb/event_shuffle.pb.h"
+#include "pb/game_event_container.pb.h"
+
+HeadlessGameState::HeadlessGameState(const Event_GameStateChanged &_state,
+                                     const QSet<ZoneKey> &_hiddenZones,
+                                     const TokenPTLookup &_tokenPTLookup)
+    : state(_state), hiddenZones(_hiddenZones), tokenPTLookup(_tokenPTLookup)
+{
+    indexState();
+}
+
+void HeadlessGameState::indexState()
+{
+    players.clear();
+    zones.clear();
+    for (ServerInfo_Player &player : *state.mutable_player_list()) {
+        const int playerId = player.properties().player_id();
+        players.insert(playerId, &player);
+        for (ServerInfo_Zone &zone : *player.mutable_zone_list()) {
+            const QString zoneName = QString::fromStdString(zone.name());
+            ZoneState zoneState;
+            zoneState.zone = &zone;
+            if (zoneName == "table") {
+                zoneState.kind = TableZoneKind;
+            } else if (zoneName == "hand" || zoneName == "stack") {
+                zoneState.kind = ListZoneKind;
+            }
+            zoneState.contentsKnown = !hiddenZones.contains(ZoneKey(playerId, zoneName));
+            zones.insert(ZoneKey(playerId, zoneName), zoneState);
+        }
+    }
+}
+
+/**
+ * @brief Whether every event in the container can be folded into the state.
+ *
+ * Changes to who is in the game need the scene to add or remove players, and a full game state replaces everything
+ * anyway; containers with those have to go through TabGame::processGameEventContainer().
+ */
+bool HeadlessGameState::canApply(const GameEventContainer &cont)
+{
+    for (const GameEvent &event : cont.event_list()) {
+        switch (static_cast<GameEvent::GameEventType>(getPbExtension(event))) {
+            case GameEvent::GAME_STATE_CHANGED:
+            case GameEvent::JOIN:
+            case GameEvent::LEAVE:
+            case GameEvent::KICKED:
+            case GameEvent::GAME_HOST_CHANGED:
+            case GameEvent::GAME_CLOSED:
+            case GameEvent::REVERSE_TURN:
+                return false;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+bool HeadlessGameState::apply(const GameEventContainer &cont)
+{
+    if (!canApply(cont)) {
+        return false;
+    }
+
+    const GameEventContext &context = cont.context();
+    for (const GameEvent &event : cont.event_list()) {
+        const auto eventType = static_cast<GameEvent::GameEventType>(getPbExtension(event));
+        switch (eventType) {
+            case GameEvent::GAME_SAY:
+                break;
+            case GameEvent::PLAYER_PROPERTIES_CHANGED: {
+                ServerInfo_Player *player = players.value(event.player_id());
+                if (!player) {
+                    break;
+                }
+                ServerInfo_PlayerProperties *properties = player->mutable_properties();
+                properties->MergeFrom(event.GetExtension(Event_PlayerPropertiesChanged::ext).player_properties());
+                switch (static_cast<GameEventContext::ContextType>(getPbExtension(context))) {
+                    case GameEventContext::CONCEDE:
+                        properties->set_conceded(true);
+                        break;
+                    case GameEventContext::UNCONCEDE:
+                        properties->set_conceded(false);
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            }
+            case GameEvent::SET_ACTIVE_PLAYER: {
+                const int activePlayerId = event.GetExtension(Event_SetActivePlayer::ext).active_player_id();
+                if (players.contains(activePlayerId)) {
+                    state.set_active_player_id(activePlayerId);
+                    state.set_active_phase(-1);
+                }
+                break;
+            }
+            case GameEvent::SET_ACTIVE_PHASE:
+                state.set_active_phase(event.GetExtension(Event_SetActivePhase::ext).phase());
+                break;
+            default: {
+                ServerInfo_Player *player = players.value(event.player_id());
+                if (player) {
+                    applyPlayerEvent(player, event, context);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+HeadlessGameState::ZoneState *HeadlessGameState::findZone(int playerId, const std::string &zoneName)
+{
+    auto it = zones.find(ZoneKey(playerId, QString::fromStdString(zoneName)));
+    return it == zones.end() ? nullptr : &it.value();
+}
+
+// See CardList::findCard()
+int HeadlessGameState::findCard(const ZoneState &zone, int cardId) const
+{
+    const int cardCount = zone.zone->card_list_size();
+    if (!zone.contentsKnown && cardCount > 0) {
+        return 0;
+    }
+    for (int i = 0; i < cardCount; ++i) {
+        if (zone.zone->card_list(i).id() == cardId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// See CardZone::getCard()
+ServerInfo_Card *HeadlessGameState::getCard(ZoneState &zone, int cardId, const std::string &cardName)
+{
+    const int index = findCard(zone, cardId);
+    if (index < 0) {
+        return nullptr;
+    }
+    ServerInfo_Card *card = zone.zone->mutable_card_list(index);
+    if (card->id() == -1 || card->name().empty()) {
+        card->set_id(cardId);
+        card->set_name(cardName);
+    }
+    return card;
+}
+
+// See CardZone::takeCard(), the card is moved into card
+bool HeadlessGameState::takeCard(ZoneState &zone, int position, int cardId, ServerInfo_Card *card, int *oldId)
+{
+    auto *cards = zone.zone->mutable_card_list();
+    if (position == -1) {
+        for (int i = 0; i < cards->size(); ++i) {
+            if (cards->Get(i).id() == cardId) {
+                position = i;
+                break;
+            }
+        }
+        if (position == -1) {
+            position = 0;
+        }
+    }
+    if (position < 0 || position >= cards->size()) {
+        return false;
+    }
+
+    card->Swap(cards->Mutable(position));
+    cards->DeleteSubrange(position, 1);
+    zone.zone->set_card_count(cards->size());
+
+    if (oldId) {
+        *oldId = card->id();
+    }
+    card->set_id(cardId);
+    return true;
+}
+
+// See the addCardImpl() of the zone kinds, the card is moved out of card
+void HeadlessGameState::addCard(ZoneState &zone, ServerInfo_Card *card, int x, int y)
+{
+    auto *cards = zone.zone->mutable_card_list();
+    if (zone.kind == TableZoneKind) {
+        ServerInfo_Card *added = cards->Add();
+        added->Swap(card);
+        added->set_x(x);
+        added->set_y(y);
+        zone.zone->set_card_count(cards->size());
+        return;
+    }
+
+    if (x < 0 || x >= cards->size()) {
+        x = cards->size();
+    }
+    ServerInfo_Card *added = cards->Add();
+    added->Swap(card);
+    for (int i = cards->size() - 1; i > x; --i) {
+        cards->SwapElements(i, i - 1);
+    }
+    added = cards->Mutable(x);
+    added->clear_x();
+    added->clear_y();
+    if (!zone.contentsKnown) {
+        added->set_id(-1);
+        added->clear_name();
+        // a card put on top of a revealed one hides it again
+        if (zone.kind == PileZoneKind && cards->size() > x + 1) {
+            cards->Mutable(x + 1)->clear_name();
+        }
+    }
+    resetCardState(added);
+    zone.zone->set_card_count(cards->size());
+}
+
+// See CardItem::resetState()
+void HeadlessGameState::resetCardState(ServerInfo_Card *card)
+{
+    card->clear_attacking();
+    card->clear_face_down();
+    card->clear_counter_list();
+    card->clear_pt();
+    card->clear_annotation();
+    card->clear_attach_player_id();
+    card->clear_attach_zone();
+    card->clear_attach_card_id();
+    card->clear_tapped();
+    card->clear_doesnt_untap();
+}
+
+void HeadlessGameState::removeArrowsOf(int playerId, const std::string &zoneName, int cardId)
+{
+    for (ServerInfo_Player *player : players) {
+        auto *arrows = player->mutable_arrow_list();
+        for (int i = arrows->size() - 1; i >= 0; --i) {
+            const ServerInfo_Arrow &arrow = arrows->Get(i);
+            const bool fromCard = arrow.start_player_id() == playerId && arrow.start_card_id() == cardId &&
+                                  arrow.start_zone() == zoneName;
+            const bool toCard = arrow.has_target_zone() && arrow.target_player_id() == playerId &&
+                                arrow.target_card_id() == cardId && arrow.target_zone() == zoneName;
+            if (fromCard || toCard) {
+                arrows->DeleteSubrange(i, 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Makes the attachments and arrows that point at a card follow it to its new place.
+ *
+ * The scene refers to cards by pointer, so it gets this for free; arrows don't survive a change of zones there.
+ * Cards can only be attached to each other on the table, so the other zones don't need to be looked at.
+ */
+void HeadlessGameState::moveReferences(int playerId,
+                                       const std::string &zoneName,
+                                       int cardId,
+                                       int newPlayerId,
+                                       const std::string &newZoneName,
+                                       int newCardId)
+{
+    for (ZoneState &zone : zones) {
+        if (zone.kind != TableZoneKind) {
+            continue;
+        }
+        for (ServerInfo_Card &card : *zone.zone->mutable_card_list()) {
+            if (card.attach_player_id() == playerId && card.attach_card_id() == cardId &&
+                card.attach_zone() == zoneName) {
+                card.set_attach_player_id(newPlayerId);
+                card.set_attach_zone(newZoneName);
+                card.set_attach_card_id(newCardId);
+            }
+        }
+    }
+
+    if (playerId != newPlayerId || zoneName != newZoneName) {
+        removeArrowsOf(playerId, zoneName, cardId);
+        return;
+    }
+    for (ServerInfo_Player *player : players) {
+        for (ServerInfo_Arrow &arrow : *player->mutable_arrow_list()) {
+            if (arrow.start_player_id() == playerId && arrow.start_card_id() == cardId &&
+                arrow.start_zone() == zoneName) {
+                arrow.set_start_card_id(newCardId);
+            }
+            if (arrow.has_target_zone() && arrow.target_player_id() == playerId && arrow.target_card_id() == cardId &&
+                arrow.target_zone() == zoneName) {
+                arrow.set_target_card_id(newCardId);
+            }
+        }
+    }
+}
+
+// See Player::setCardAttrHelper()
+void HeadlessGameState::setCardAttr(ServerInfo_Card *card, int attribute, const std::string &value, bool allCards)
+{
+    const bool enabled = value == "1";
+    switch (attribute) {
+        case AttrTapped:
+            if (!(!enabled && card->doesnt_untap() && allCards)) {
+                card->set_tapped(enabled);
+            }
+            break;
+        case AttrAttacking:
+            card->set_attacking(enabled);
+            break;
+        case AttrFaceDown:
+            card->set_face_down(enabled);
+            break;
+        case AttrColor:
+            card->set_color(value);
+            break;
+        case AttrPT:
+            card->set_pt(value);
+            break;
+        case AttrAnnotation:
+            card->set_annotation(value);
+            break;
+        case AttrDoesntUntap:
+            card->set_doesnt_untap(enabled);
+            break;
+        default:
+            break;
+    }
+}
+
+// Mirrors the Player::event*() functions
+void HeadlessGameState::applyPlayerEvent(ServerInfo_Player *player,
+                                         const GameEvent &event,
+                                         const GameEventContext & /*context*/)
+{
+    const int playerId = player->properties().player_id();
+    switch (static_cast<GameEvent::GameEventType>(getPbExtension(event))) {
+        case GameEvent::SHUFFLE: {
+            const Event_Shuffle &shuffle = event.GetExtension(Event_Shuffle::ext);
+            ZoneState *zone = findZone(playerId, shuffle.zone_name());
+            if (!zone) {
+                break;
+            }
+            int absStart = shuffle.start();
+            if (absStart < 0) {
+                absStart += zone->zone->card_list_size();
+            }
+            if (absStart == 0 && zone->zone->card_list_size() > 0) {
+                zone->zone->mutable_card_list(0)->clear_name();
+            }
+            break;
+        }
+        case GameEvent::CREATE_ARROW: {
+            const ServerInfo_Arrow &arrow = event.GetExtension(Event_CreateArrow::ext).arrow_info();
+            ZoneState *startZone = findZone(arrow.start_player_id(), arrow.start_zone());
+            if (!startZone || !players.contains(arrow.target_player_id()) ||
+                !getCard(*startZone, arrow.start_card_id(), std::string())) {
+                break;
+            }
+            if (arrow.has_target_zone()) {
+                ZoneState *targetZone = findZone(arrow.target_player_id(), arrow.target_zone());
+                if (!targetZone || !getCard(*targetZone, arrow.target_card_id(), std::string())) {
+                    break;
+                }
+            } else if (arrow.has_target_card_id()) {
+                break;
+            }
+            bool exists = false;
+            for (const ServerInfo_Arrow &other : player->arrow_list()) {
+                exists = exists || other.id() == arrow.id();
+            }
+            if (!exists) {
+                player->add_arrow_list()->CopyFrom(arrow);
+            }
+            break;
+        }
+        case GameEvent::DELETE_ARROW: {
+            const int arrowId = event.GetExtension(Event_DeleteArrow::ext).arrow_id();
+            auto *arrows = player->mutable_arrow_list();
+            for (int i = 0; i < arrows->size(); ++i) {
+                if (arrows->Get(i).id() == arrowId) {
+                    arrows->DeleteSubrange(i, 1);
+                    break;
+                }
+            }
+            break;
+        }
+        case GameEvent::CREATE_TOKEN: {
+            const Event_CreateToken &token = event.GetExtension(Event_CreateToken::ext);
+            ZoneState *zone = findZone(playerId, token.zone_name());
+            if (!zone) {
+                break;
+            }
+            ServerInfo_Card card;
+            card.set_id(token.card_id());
+            card.set_name(token.card_name());
+            card.set_provider_id(token.card_provider_id());
+            if (!token.pt().empty()) {
+                card.set_pt(token.pt());
+            } else if (tokenPTLookup) {
+                card.set_pt(tokenPTLookup(QString::fromStdString(token.card_name())).toStdString());
+            }
+            card.set_color(token.color());
+            card.set_annotation(token.annotation());
+            card.set_destroy_on_zone_change(token.destroy_on_zone_change());
+            addCard(*zone, &card, token.x(), token.y());
+            break;
+        }
+        case GameEvent::SET_CARD_ATTR: {
+            const Event_SetCardAttr &attr = event.GetExtension(Event_SetCardAttr::ext);
+            ZoneState *zone = findZone(playerId, attr.zone_name());
+            if (!zone) {
+                break;
+            }
+            if (!attr.has_card_id()) {
+                for (ServerInfo_Card &card : *zone->zone->mutable_card_list()) {
+                    setCardAttr(&card, attr.attribute(), attr.attr_value(), true);
+                }
+            } else if (ServerInfo_Card *card = getCard(*zone, attr.card_id(), std::string())) {
+                setCardAttr(card, attr.attribute(), attr.attr_value(), false);
+            }
+            break;
+        }
+        case GameEvent::SET_CARD_COUNTER: {
+            const Event_SetCardCounter &counter = event.GetExtension(Event_SetCardCounter::ext);
+            ZoneState *zone = findZone(playerId, counter.zone_name());
+            ServerInfo_Card *card = zone ? getCard(*zone, counter.card_id(), std::string()) : nullptr;
+            if (!card) {
+                break;
+            }
+            auto *counters = card->mutable_counter_list();
+            int index = 0;
+            while (index < counters->size() && counters->Get(index).id() != counter.counter_id()) {
+                ++index;
+            }
+            if (counter.counter_value() == 0) {
+                if (index < counters->size()) {
+                    counters->DeleteSubrange(index, 1);
+                }
+            } else {
+                ServerInfo_CardCounter *cardCounter =
+                    index < counters->size() ? counters->Mutable(index) : card->add_counter_list();
+                cardCounter->set_id(counter.counter_id());
+                cardCounter->set_value(counter.counter_value());
+            }
+            break;
+        }
+        case GameEvent::CREATE_COUNTER: {
+            const ServerInfo_Counter &counter = event.GetExtension(Event_CreateCounter::ext).counter_info();
+            bool exists = false;
+            for (const ServerInfo_Counter &other : player->counter_list()) {
+                exists = exists || other.id() == counter.id();
+            }
+            if (!exists) {
+                player->add_counter_list()->CopyFrom(counter);
+            }
+            break;
+        }
+        case GameEvent::SET_COUNTER: {
+            const Event_SetCounter &setCounter = event.GetExtension(Event_SetCounter::ext);
+            for (ServerInfo_Counter &counter : *player->mutable_counter_list()) {
+                if (counter.id() == setCounter.counter_id()) {
+                    counter.set_count(setCounter.value());
+                    break;
+                }
+            }
+            break;
+        }
+        case GameEvent::DEL_COUNTER: {
+            const int counterId = event.GetExtension(Event_DelCounter::ext).counter_id();
+            auto *counters = player->mutable_counter_list();
+            for (int i = 0; i < counters->size(); ++i) {
+                if (counters->Get(i).id() == counterId) {
+                    counters->DeleteSubrange(i, 1);
+                    break;
+                }
+            }
+            break;
+        }
+        case GameEvent::MOVE_CARD: {
+            const Event_MoveCard &move = event.GetExtension(Event_MoveCard::ext);
+            ZoneState *startZone = findZone(move.start_player_id(), move.start_zone());
+            const int targetPlayerId = move.target_player_id();
+            const std::string &targetZoneName = move.has_target_zone() ? move.target_zone() : move.start_zone();
+            ZoneState *targetZone = move.has_target_zone() ? findZone(targetPlayerId, targetZoneName) : startZone;
+            if (!startZone || !targetZone || !players.contains(targetPlayerId)) {
+                break;
+            }
+            const bool zoneChanged = startZone != targetZone;
+
+            ServerInfo_Card card;
+            int oldId = -1;
+            if (!takeCard(*startZone, move.position(), move.card_id(), &card, &oldId)) {
+                break;
+            }
+            if (move.has_card_name()) {
+                card.set_name(move.card_name());
+            }
+            if (move.has_new_card_provider_id()) {
+                card.set_provider_id(move.new_card_provider_id());
+            }
+            if (zoneChanged) {
+                card.clear_attach_player_id();
+                card.clear_attach_zone();
+                card.clear_attach_card_id();
+            }
+            card.set_id(move.new_card_id());
+            card.set_face_down(move.face_down());
+
+            // a card whose id wasn't known can't have been referred to
+            if (oldId != -1) {
+                moveReferences(move.start_player_id(), move.start_zone(), oldId, targetPlayerId, targetZoneName,
+                               move.new_card_id());
+            }
+            addCard(*targetZone, &card, move.x() == -1 ? 0 : move.x(), move.y());
+            break;
+        }
+        case GameEvent::FLIP_CARD: {
+            const Event_FlipCard &flip = event.GetExtension(Event_FlipCard::ext);
+            ZoneState *zone = findZone(playerId, flip.zone_name());
+            ServerInfo_Card *card = zone ? getCard(*zone, flip.card_id(), flip.card_name()) : nullptr;
+            if (card) {
+                card->set_face_down(flip.face_down());
+            }
+            break;
+        }
+        case GameEvent::DESTROY_CARD: {
+            const Event_DestroyCard &destroy = event.GetExtension(Event_DestroyCard::ext);
+            ZoneState *zone = findZone(playerId, destroy.zone_name());
+            if (!zone || !getCard(*zone, destroy.card_id(), std::string())) {
+                break;
+            }
+            for (ZoneState &other : zones) {
+                if (other.kind != TableZoneKind) {
+                    continue;
+                }
+                for (ServerInfo_Card &card : *other.zone->mutable_card_list()) {
+                    if (card.attach_player_id() == playerId && card.attach_card_id() == destroy.card_id() &&
+                        card.attach_zone() == destroy.zone_name()) {
+                        card.clear_attach_player_id();
+                        card.clear_attach_zone();
+                        card.clear_attach_card_id();
+                    }
+                }
+            }
+            removeArrowsOf(playerId, destroy.zone_name(), destroy.card_id());
+            ServerInfo_Card card;
+            takeCard(*zone, -1, destroy.card_id(), &card);
+            break;
+        }
+        case GameEvent::ATTACH_CARD: {
+            const Event_AttachCard &attach = event.GetExtension(Event_AttachCard::ext);
+            ZoneState *startZone = findZone(playerId, attach.start_zone());
+            ServerInfo_Card *startCard = startZone ? getCard(*startZone, attach.card_id(), std::string()) : nullptr;
+            if (!startCard) {
+                break;
+            }
+            ServerInfo_Card *targetCard = nullptr;
+            if (attach.has_target_player_id()) {
+                if (ZoneState *targetZone = findZone(attach.target_player_id(), attach.target_zone())) {
+                    targetCard = getCard(*targetZone, attach.target_card_id(), std::string());
+                }
+            }
+            // attaching or unattaching takes the card off the grid, see CardItem::setAttachedTo()
+            if (startZone->kind == TableZoneKind) {
+                startCard->set_x(-1);
+            }
+            if (targetCard) {
+                startCard->set_attach_player_id(attach.target_player_id());
+                startCard->set_attach_zone(attach.target_zone());
+                startCard->set_attach_card_id(targetCard->id());
+            } else {
+                startCard->clear_attach_player_id();
+                startCard->clear_attach_zone();
+                startCard->clear_attach_card_id();
+            }
+            break;
+        }
+        case GameEvent::DRAW_CARDS: {
+            const Event_DrawCards &draw = event.GetExtension(Event_DrawCards::ext);
+            ZoneState *deck = findZone(playerId, "deck");
+            ZoneState *hand = findZone(playerId, "hand");
+            if (!deck || !hand) {
+                break;
+            }
+            ServerInfo_Card card;
+            if (draw.cards_size()) {
+                for (const ServerInfo_Card &cardInfo : draw.cards()) {
+                    if (!takeCard(*deck, 0, cardInfo.id(), &card)) {
+                        break;
+                    }
+                    card.set_provider_id(cardInfo.provider_id());
+                    card.set_name(cardInfo.name());
+                    addCard(*hand, &card, -1, 0);
+                }
+            } else {
+                for (int i = 0; i < draw.number(); ++i) {
+                    if (!takeCard(*deck, 0, -1, &card)) {
+                        break;
+                    }
+                    addCard(*hand, &card, -1, 0);
+                }
+            }
+            break;
+        }
+        case GameEvent::REVEAL_CARDS: {
+            const Event_RevealCards &reveal = event.GetExtension(Event_RevealCards::ext);
+            ZoneState *zone = findZone(playerId, reveal.zone_name());
+            if (!zone) {
+                break;
+            }
+            bool peeking = false;
+            for (const ServerInfo_Card &cardInfo : reveal.cards()) {
+                peeking = peeking || cardInfo.face_down();
+            }
+            if (peeking) {
+                for (const ServerInfo_Card &cardInfo : reveal.cards()) {
+                    if (ServerInfo_Card *card = getCard(*zone, cardInfo.id(), std::string())) {
+                        card->set_name(cardInfo.name());
+                    }
+                }
+            } else if (reveal.cards_size() == 1 && reveal.card_id_size() > 0 && reveal.card_id(0) == 0 &&
+                       zone->kind == PileZoneKind && zone->zone->card_list_size() > 0) {
+                zone->zone->mutable_card_list(0)->set_name(reveal.cards(0).name());
+            }
+            break;
+        }
+        case GameEvent::CHANGE_ZONE_PROPERTIES: {
+            const Event_ChangeZoneProperties &properties = event.GetExtension(Event_ChangeZoneProperties::ext);
+            ZoneState *zone = findZone(playerId, properties.zone_name());
+            if (!zone) {
+                break;
+            }
+            // the scene keeps both in the same flag, see Player::eventChangeZoneProperties()
+            if (properties.has_always_reveal_top_card()) {
+                zone->zone->set_always_reveal_top_card(properties.always_reveal_top_card());
+            }
+            if (properties.has_always_look_at_top_card()) {
+                zone->zone->set_always_reveal_top_card(properties.always_look_at_top_card());
+            }
+            break;
+        }
+        default:
+            // rolling dice and looking at zones don't change the state
+            break;
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef HEADLESS_GAME_STATE_H
+#define HEADLESS_GAME_STATE_H
+
+#include "pb/event_game_state_changed.pb.h"
+
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <functional>
+
+class GameEvent;
+class GameEventContainer;
+class GameEventContext;
+
+/**
+ * The state of a game without any of the scene graph, for folding a large number of events quickly. Events change the
+ * state the same way Player::processGameEvent() and TabGame change the scene, but nothing gets drawn, animated or
+ * logged. The result can then be shown at once with TabGame::eventGameStateChanged().
+ *
+ * Events that change who is in the game aren't supported, apply() leaves the state alone and returns false for them.
+ */
+class HeadlessGameState
+{
+public:
+    // (player id, zone name)
+    typedef QPair<int, QString> ZoneKey;
+    // Returns the power/toughness a token is created with when the event doesn't specify one
+    typedef std::function<QString(const QString &cardName)> TokenPTLookup;
+
+    HeadlessGameState(const Event_GameStateChanged &_state,
+                      const QSet<ZoneKey> &hiddenZones,
+                      const TokenPTLookup &_tokenPTLookup = TokenPTLookup());
+    // the zones point into the state
+    HeadlessGameState(const HeadlessGameState &) = delete;
+    HeadlessGameState &operator=(const HeadlessGameState &) = delete;
+
+    static bool canApply(const GameEventContainer &cont);
+    bool apply(const GameEventContainer &cont);
+
+    const Event_GameStateChanged &getState() const
+    {
+        return state;
+    }
+
+private:
+    enum ZoneKind
+    {
+        // cards are placed on a grid and keep their state
+        TableZoneKind,
+        // ordered, cards lose their state when they enter
+        ListZoneKind,
+        // like ListZoneKind, additionally forgets the name of the card below a hidden card
+        PileZoneKind
+    };
+    struct ZoneState
+    {
+        ServerInfo_Zone *zone = nullptr;
+        ZoneKind kind = PileZoneKind;
+        bool contentsKnown = true;
+    };
+
+    Event_GameStateChanged state;
+    QSet<ZoneKey> hiddenZones;
+    TokenPTLookup tokenPTLookup;
+    QHash<int, ServerInfo_Player *> players;
+    QHash<ZoneKey, ZoneState> zones;
+
+    void indexState();
+    ZoneState *findZone(int playerId, const std::string &zoneName);
+    int findCard(const ZoneState &zone, int cardId) const;
+    ServerInfo_Card *getCard(ZoneState &zone, int cardId, const std::string &cardName);
+    bool takeCard(ZoneState &zone, int position, int cardId, ServerInfo_Card *card, int *oldId = nullptr);
+    void addCard(ZoneState &zone, ServerInfo_Card *card, int x, int y);
+    static void resetCardState(ServerInfo_Card *card);
+    void removeArrowsOf(int playerId, const std::string &zoneName, int cardId);
+    void moveReferences(int playerId,
+                        const std::string &zoneName,
+                        int cardId,
+                        int newPlayerId,
+                        const std::string &newZoneName,
+                        int newCardId);
+    static void setCardAttr(ServerInfo_Card *card, int attribute, const std::string &value, bool allCards);
+
+    void applyPlayerEvent(ServerInfo_Player *player, const GameEvent &event, const GameEventContext &context);
+};
+
+#endif
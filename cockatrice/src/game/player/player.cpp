@@ -2686,6 +2686,57 @@ void Player::processCardAttachment(const ServerInfo_Player &info)
     }
 }
 
+void Player::writePlayerInfo(ServerInfo_Player *info) const
+{
+    ServerInfo_PlayerProperties *properties = info->mutable_properties();
+    properties->set_player_id(id);
+    properties->mutable_user_info()->CopyFrom(*userInfo);
+    properties->set_conceded(conceded);
+
+    QMapIterator<QString, CardZone *> zoneIt(zones);
+    while (zoneIt.hasNext()) {
+        const CardZone *zone = zoneIt.next().value();
+        ServerInfo_Zone *zoneInfo = info->add_zone_list();
+        zoneInfo->set_name(zone->getName().toStdString());
+        zoneInfo->set_card_count(zone->getCards().size());
+        zoneInfo->set_always_reveal_top_card(zone->getAlwaysRevealTopCard());
+        for (const CardItem *card : zone->getCards()) {
+            card->writeCardInfo(zoneInfo->add_card_list());
+        }
+    }
+
+    for (const AbstractCounter *counter : counters) {
+        ServerInfo_Counter *counterInfo = info->add_counter_list();
+        counterInfo->set_id(counter->getId());
+        counterInfo->set_name(counter->getName().toStdString());
+        counterInfo->set_count(counter->getValue());
+        if (const auto *generalCounter = qobject_cast<const GeneralCounter *>(counter)) {
+            counterInfo->mutable_counter_color()->CopyFrom(convertQColorToColor(generalCounter->getColor()));
+            counterInfo->set_radius(generalCounter->getRadius());
+        }
+    }
+
+    for (const ArrowItem *arrow : arrows) {
+        const auto *startCard = qgraphicsitem_cast<CardItem *>(arrow->getStartItem());
+        if (!startCard || !startCard->getZone()) {
+            continue;
+        }
+        ServerInfo_Arrow *arrowInfo = info->add_arrow_list();
+        arrowInfo->set_id(arrow->getId());
+        arrowInfo->set_start_player_id(startCard->getZone()->getPlayer()->getId());
+        arrowInfo->set_start_zone(startCard->getZone()->getName().toStdString());
+        arrowInfo->set_start_card_id(startCard->getId());
+        if (const auto *targetCard = qgraphicsitem_cast<CardItem *>(arrow->getTargetItem())) {
+            arrowInfo->set_target_player_id(targetCard->getZone()->getPlayer()->getId());
+            arrowInfo->set_target_zone(targetCard->getZone()->getName().toStdString());
+            arrowInfo->set_target_card_id(targetCard->getId());
+        } else if (const auto *targetPlayer = qgraphicsitem_cast<PlayerTarget *>(arrow->getTargetItem())) {
+            arrowInfo->set_target_player_id(targetPlayer->getOwner()->getId());
+        }
+        arrowInfo->mutable_arrow_color()->CopyFrom(convertQColorToColor(arrow->getColor()));
+    }
+}
+
 void Player::playCard(CardItem *card, bool faceDown)
 {
     if (card == nullptr) {
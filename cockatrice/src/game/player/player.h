@@ -496,6 +496,8 @@ public:
 
     void processPlayerInfo(const ServerInfo_Player &info);
     void processCardAttachment(const ServerInfo_Player &info);
+    // The state processPlayerInfo() and processCardAttachment() would restore the player to
+    void writePlayerInfo(ServerInfo_Player *info) const;
 
     void processGameEvent(GameEvent::GameEventType type,
                           const GameEvent &event,
@@ -4,6 +4,7 @@
 #include "../../client/translation.h"
 #include "../board/abstract_graphics_item.h"
 #include "../cards/card_list.h"
+#include "zone_layout_batch.h"
 
 #include <QString>
 
@@ -19,8 +20,10 @@ class CardDragItem;
  * This class contains methods to get and modify the cards that are contained inside this zone.
  *
  * The cards are stored as a list of `CardItem*`.
+ *
+ * Laying out the cards is deferred while a ZoneLayoutBatch is active, see reorganizeCards().
  */
-class CardZone : public AbstractGraphicsItem
+class CardZone : public AbstractGraphicsItem, public ZoneLayoutBatch::Target
 {
     Q_OBJECT
 protected:
@@ -42,6 +45,11 @@ signals:
 public slots:
     void moveAllToZone();
     bool showContextMenu(const QPoint &screenPos);
+    // Lays out the cards through performLayout(), once the current ZoneLayoutBatch ends if there is one
+    void reorganizeCards()
+    {
+        requestLayout();
+    }
 
 public:
     enum
@@ -108,7 +116,6 @@ public:
     {
         return views;
     }
-    virtual void reorganizeCards() = 0;
     virtual QPointF closestGridPoint(const QPointF &point);
     bool getIsView() const
     {
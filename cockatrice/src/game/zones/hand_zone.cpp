@@ -87,7 +87,7 @@ void HandZone::paint(QPainter *painter, const QStyleOptionGraphicsItem * /*optio
     painter->fillRect(boundingRect(), brush);
 }
 
-void HandZone::reorganizeCards()
+void HandZone::performLayout()
 {
     if (!cards.isEmpty()) {
         const int cardCount = cards.size();
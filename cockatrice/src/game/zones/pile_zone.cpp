@@ -87,7 +87,7 @@ void PileZone::handleDropEvent(const QList<CardDragItem *> &dragItems,
     player->sendGameCommand(cmd);
 }
 
-void PileZone::reorganizeCards()
+void PileZone::performLayout()
 {
     update();
 }
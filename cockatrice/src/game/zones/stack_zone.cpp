@@ -88,7 +88,7 @@ void StackZone::handleDropEvent(const QList<CardDragItem *> &dragItems, CardZone
     player->sendGameCommand(cmd);
 }
 
-void StackZone::reorganizeCards()
+void StackZone::performLayout()
 {
     if (!cards.isEmpty()) {
         QSet<ArrowItem *> arrowsToUpdate;
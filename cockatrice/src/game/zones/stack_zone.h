@@ -16,9 +16,9 @@ public:
     void handleDropEvent(const QList<CardDragItem *> &dragItems, CardZone *startZone, const QPoint &dropPoint);
     QRectF boundingRect() const;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
-    void reorganizeCards();
 
 protected:
+    void performLayout() override;
     void addCardImpl(CardItem *card, int x, int y);
 };
 
@@ -154,9 +154,27 @@ void TableZone::handleDropEventByGrid(const QList<CardDragItem *> &dragItems,
     startZone->getPlayer()->sendGameCommand(cmd);
 }
 
-void TableZone::reorganizeCards()
+void TableZone::performLayout()
 {
     QSet<ArrowItem *> arrowsToUpdate;
+    const bool zoneMoved = scenePos() != lastLayoutScenePos;
+    lastLayoutScenePos = scenePos();
+
+    // Rebuilding arrow paths is what makes laying out expensive, so only do it for the cards that actually move
+    auto placeCard = [&arrowsToUpdate, zoneMoved](CardItem *card, qreal x, qreal y) {
+        const bool cardMoved = card->pos() != QPointF(x, y);
+        card->setPos(x, y);
+        card->setRealZValue((y + CARD_HEIGHT) * 100000 + (x + 1) * 100);
+        if (!cardMoved && !zoneMoved) {
+            return;
+        }
+        for (ArrowItem *item : card->getArrowsFrom()) {
+            arrowsToUpdate.insert(item);
+        }
+        for (ArrowItem *item : card->getArrowsTo()) {
+            arrowsToUpdate.insert(item);
+        }
+    };
 
     // Calculate card stack widths so mapping functions work properly
     computeCardStackWidths();
@@ -176,31 +194,14 @@ void TableZone::reorganizeCards()
         if (numberAttachedCards)
             actualY += 15;
 
-        cards[i]->setPos(actualX, actualY);
-        cards[i]->setRealZValue((actualY + CARD_HEIGHT) * 100000 + (actualX + 1) * 100);
+        placeCard(cards[i], actualX, actualY);
 
         QListIterator<CardItem *> attachedCardIterator(cards[i]->getAttachedCards());
         int j = 0;
         while (attachedCardIterator.hasNext()) {
             ++j;
             CardItem *attachedCard = attachedCardIterator.next();
-            qreal childX = actualX - j * STACKED_CARD_OFFSET_X;
-            qreal childY = y + 5;
-            attachedCard->setPos(childX, childY);
-            attachedCard->setRealZValue((childY + CARD_HEIGHT) * 100000 + (childX + 1) * 100);
-            for (ArrowItem *item : attachedCard->getArrowsFrom()) {
-                arrowsToUpdate.insert(item);
-            }
-            for (ArrowItem *item : attachedCard->getArrowsTo()) {
-                arrowsToUpdate.insert(item);
-            }
-        }
-
-        for (ArrowItem *item : cards[i]->getArrowsFrom()) {
-            arrowsToUpdate.insert(item);
-        }
-        for (ArrowItem *item : cards[i]->getArrowsTo()) {
-            arrowsToUpdate.insert(item);
+            placeCard(attachedCard, actualX - j * STACKED_CARD_OFFSET_X, y + 5);
         }
     }
     for (ArrowItem *item : arrowsToUpdate) {
@@ -9,7 +9,7 @@
  * It is the main play zone and can be customized with background images.
  *
  * TODO: Refactor methods to make more readable, extract some logic to
- * private methods (Im looking at you TableZone::reorganizeCards())
+ * private methods (Im looking at you TableZone::performLayout())
  */
 class TableZone : public SelectZone
 {
@@ -67,6 +67,12 @@ private:
     */
     QMap<int, int> cardStackWidth;
 
+    /*
+       Where the zone was in the scene when the cards were last laid out. Arrows only need to be rebuilt for the cards
+       that moved since, unless the whole zone did.
+     */
+    QPointF lastLayoutScenePos;
+
     /*
        Holds any custom background image for the TableZone
      */
@@ -85,12 +91,6 @@ private slots:
      */
     void updateBg();
 
-public slots:
-    /**
-       Reorganizes CardItems in the TableZone
-     */
-    void reorganizeCards();
-
 public:
     /**
        Constructs TableZone.
@@ -180,6 +180,11 @@ public:
 protected:
     void addCardImpl(CardItem *card, int x, int y);
 
+    /**
+       Reorganizes CardItems in the TableZone
+     */
+    void performLayout() override;
+
 private:
     void paintZoneOutline(QPainter *painter);
     void paintLandDivider(QPainter *painter);
@@ -105,7 +105,7 @@ void ZoneViewZone::zoneDumpReceived(const Response &r)
 }
 
 // Because of boundingRect(), this function must not be called before the zone was added to a scene.
-void ZoneViewZone::reorganizeCards()
+void ZoneViewZone::performLayout()
 {
     int cardCount = cards.size();
     if (!origZone->contentsKnown())
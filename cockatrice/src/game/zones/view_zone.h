@@ -53,7 +53,6 @@ public:
     ~ZoneViewZone();
     QRectF boundingRect() const;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
-    void reorganizeCards();
     void initializeCards(const QList<const ServerInfo_Card *> &cardList = QList<const ServerInfo_Card *>());
     void removeCard(int position);
     int getNumberCards() const
@@ -87,6 +86,7 @@ signals:
 
 protected:
     void addCardImpl(CardItem *card, int x, int y);
+    void performLayout() override;
     QSizeF sizeHint(Qt::SizeHint which, const QSizeF &constraint = QSizeF()) const;
     void wheelEvent(QGraphicsSceneWheelEvent *event);
 };
@@ -0,0 +1,48 @@
+#include "zone_layout_batch.h"
+
+int ZoneLayoutBatch::depth = 0;
+QList<ZoneLayoutBatch::Target *> ZoneLayoutBatch::pending;
+
+ZoneLayoutBatch::Target::~Target()
+{
+    if (layoutPending) {
+        pending.removeOne(this);
+    }
+}
+
+void ZoneLayoutBatch::Target::requestLayout()
+{
+    if (!isActive()) {
+        layOut();
+    } else if (!layoutPending) {
+        layoutPending = true;
+        pending.append(this);
+    }
+}
+
+void ZoneLayoutBatch::Target::layOut()
+{
+    ++layoutCount;
+    performLayout();
+}
+
+ZoneLayoutBatch::ZoneLayoutBatch()
+{
+    ++depth;
+}
+
+ZoneLayoutBatch::~ZoneLayoutBatch()
+{
+    if (depth > 1) {
+        --depth;
+        return;
+    }
+
+    // the batch stays active until nothing is pending, laying out a zone can ask for others to be laid out
+    while (!pending.isEmpty()) {
+        Target *target = pending.takeFirst();
+        target->layoutPending = false;
+        target->layOut();
+    }
+    --depth;
+}
@@ -0,0 +1,56 @@
+#ifndef ZONE_LAYOUT_BATCH_H
+#define ZONE_LAYOUT_BATCH_H
+
+#include <QList>
+
+/**
+ * Defers laying out zones while a batch of changes is applied, e.g. all events of one GameEventContainer. A zone
+ * asking to be laid out several times during the batch is only laid out once, when the batch ends.
+ *
+ * Batches nest, the layouts happen when the outermost one ends. Without a batch, layouts happen right away. Zones
+ * asking to be laid out while the outermost batch ends join it, and are laid out once as well.
+ * Only meant to be used from the gui thread.
+ */
+class ZoneLayoutBatch
+{
+public:
+    class Target
+    {
+        friend class ZoneLayoutBatch;
+
+    public:
+        virtual ~Target();
+        // Lays out now, or once the current batch ends
+        void requestLayout();
+        // How often the target was laid out so far, for diagnostics
+        int getLayoutCount() const
+        {
+            return layoutCount;
+        }
+
+    protected:
+        virtual void performLayout() = 0;
+
+    private:
+        bool layoutPending = false;
+        int layoutCount = 0;
+
+        void layOut();
+    };
+
+    ZoneLayoutBatch();
+    ~ZoneLayoutBatch();
+    ZoneLayoutBatch(const ZoneLayoutBatch &) = delete;
+    ZoneLayoutBatch &operator=(const ZoneLayoutBatch &) = delete;
+
+    static bool isActive()
+    {
+        return depth > 0;
+    }
+
+private:
+    static int depth;
+    static QList<Target *> pending;
+};
+
+#endif
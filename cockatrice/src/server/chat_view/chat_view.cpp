@@ -7,11 +7,14 @@
 #include "../user/user_context_menu.h"
 #include "user_level.h"
 
+#include <QAbstractTextDocumentLayout>
 #include <QApplication>
 #include <QDateTime>
 #include <QDesktopServices>
 #include <QMouseEvent>
 #include <QScrollBar>
+#include <QTextBlock>
+#include <algorithm>
 
 const QColor DEFAULT_MENTION_COLOR = QColor(194, 31, 47);
 
@@ -27,7 +30,8 @@ ChatView::ChatView(TabSupervisor *_tabSupervisor,
                    bool _showTimestamps,
                    QWidget *parent)
     : QTextBrowser(parent), tabSupervisor(_tabSupervisor), game(_game), userlistProxy(_userlistProxy), evenNumber(true),
-      showTimestamps(_showTimestamps), hoveredItemType(HoveredNothing)
+      showTimestamps(_showTimestamps), hoveredItemType(HoveredNothing),
+      scrollback(SettingsCache::instance().getChatScrollback()), trimmedLength(0)
 {
     if (palette().windowText().color().lightness() > 200) {
         document()->setDefaultStyleSheet(R"(
@@ -62,6 +66,10 @@ ChatView::ChatView(TabSupervisor *_tabSupervisor,
     setTextInteractionFlags(Qt::TextSelectableByMouse | Qt::LinksAccessibleByMouse);
     setOpenLinks(false);
     connect(this, SIGNAL(anchorClicked(const QUrl &)), this, SLOT(openLink(const QUrl &)));
+
+    updateHighlightedWords();
+    connect(&SettingsCache::instance(), SIGNAL(highlightWordsChanged()), this, SLOT(updateHighlightedWords()));
+    connect(&SettingsCache::instance(), SIGNAL(chatScrollbackChanged(int)), this, SLOT(setScrollback(int)));
 }
 
 void ChatView::retranslateUi()
@@ -69,6 +77,69 @@ void ChatView::retranslateUi()
     userContextMenu->retranslateUi();
 }
 
+void ChatView::updateHighlightedWords()
+{
+    highlightedWords.clear();
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
+    const QStringList words = SettingsCache::instance().getHighlightWords().split(' ', Qt::SkipEmptyParts);
+#else
+    const QStringList words = SettingsCache::instance().getHighlightWords().split(' ', QString::SkipEmptyParts);
+#endif
+    for (const QString &word : words) {
+        highlightedWords.insert(word.toCaseFolded());
+    }
+}
+
+void ChatView::setScrollback(int _scrollback)
+{
+    scrollback = _scrollback;
+    trimScrollback();
+}
+
+void ChatView::trimScrollback()
+{
+    // The first block of the document stays empty, every message after it starts a new block. Removing a tenth of the
+    // messages at once keeps this from happening on every message once the chat is full.
+    const int messageCount = document()->blockCount() - 1;
+    if (messageCount <= scrollback + scrollback / 10) {
+        return;
+    }
+    const int removedCount = messageCount - scrollback;
+
+    for (auto it = userMessagePositions.begin(); it != userMessagePositions.end();) {
+        QVector<UserMessagePosition> &positions = it.value();
+        positions.erase(std::remove_if(positions.begin(), positions.end(),
+                                       [=](const UserMessagePosition &position) {
+                                           return position.block.blockNumber() <= removedCount;
+                                       }),
+                        positions.end());
+        if (positions.isEmpty()) {
+            it = userMessagePositions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // the separator in front of a block holds its format, so the one in front of the first kept message has to stay
+    const QTextBlock firstRemoved = document()->findBlockByNumber(1);
+    const QTextBlock firstKept = document()->findBlockByNumber(removedCount + 1);
+    const qreal removedHeight = document()->documentLayout()->blockBoundingRect(firstKept).top() -
+                                document()->documentLayout()->blockBoundingRect(firstRemoved).top();
+    const bool atBottom = verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+    const int scrollValue = verticalScrollBar()->value();
+
+    QTextCursor cursor(document());
+    cursor.setPosition(firstRemoved.position() - 1);
+    cursor.setPosition(firstKept.position() - 1, QTextCursor::KeepAnchor);
+    trimmedLength += cursor.selectionEnd() - cursor.selectionStart();
+    cursor.removeSelectedText();
+
+    // keep showing the same messages to someone reading further up
+    if (!atBottom) {
+        verticalScrollBar()->setValue(scrollValue - qRound(removedHeight));
+    }
+}
+
 QTextCursor ChatView::prepareBlock(bool same)
 {
     lastSender.clear();
@@ -78,6 +149,8 @@ QTextCursor ChatView::prepareBlock(bool same)
     if (same) {
         cursor.insertHtml("<br>");
     } else {
+        trimScrollback();
+
         QTextBlockFormat blockFormat;
         if ((evenNumber = !evenNumber))
             blockFormat.setBackground(palette().window());
@@ -234,11 +307,6 @@ void ChatView::appendMessage(QString message,
     cursor.setCharFormat(defaultFormat);
 
     bool mentionEnabled = SettingsCache::instance().getChatMention();
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
-    highlightedWords = SettingsCache::instance().getHighlightWords().split(' ', Qt::SkipEmptyParts);
-#else
-    highlightedWords = SettingsCache::instance().getHighlightWords().split(' ', QString::SkipEmptyParts);
-#endif
 
     // parse the message
     while (message.size()) {
@@ -402,17 +470,15 @@ void ChatView::checkWord(QTextCursor &cursor, QString &message)
     }
 
     // check word mentions
-    foreach (QString word, highlightedWords) {
-        if (fullWordUpToSpaceOrEnd.compare(word, Qt::CaseInsensitive) == 0) {
-            // You have received a valid mention of custom word!!
-            highlightFormat.setBackground(QBrush(getCustomHighlightColor()));
-            highlightFormat.setForeground(SettingsCache::instance().getChatHighlightForeground() ? QBrush(Qt::white)
-                                                                                                 : QBrush(Qt::black));
-            cursor.insertText(fullWordUpToSpaceOrEnd, highlightFormat);
-            cursor.insertText(rest, defaultFormat);
-            QApplication::alert(this);
-            return;
-        }
+    if (!highlightedWords.isEmpty() && highlightedWords.contains(fullWordUpToSpaceOrEnd.toCaseFolded())) {
+        // You have received a valid mention of custom word!!
+        highlightFormat.setBackground(QBrush(getCustomHighlightColor()));
+        highlightFormat.setForeground(SettingsCache::instance().getChatHighlightForeground() ? QBrush(Qt::white)
+                                                                                             : QBrush(Qt::black));
+        cursor.insertText(fullWordUpToSpaceOrEnd, highlightFormat);
+        cursor.insertText(rest, defaultFormat);
+        QApplication::alert(this);
+        return;
     }
 
     // not a special word; just print it
@@ -495,6 +561,46 @@ void ChatView::clearChat()
     document()->clear();
     lastSender = "";
     evenNumber = true;
+    userMessagePositions.clear();
+    trimmedLength = 0;
+}
+
+void ChatView::truncateChat(int length, bool _evenNumber)
+{
+    const int totalLength = length;
+    length -= trimmedLength;
+    if (length >= document()->characterCount()) {
+        return;
+    }
+    QTextCursor cursor(document());
+    if (length < 1) {
+        // the chat was longer than the scrollback at that point, what was left of it is gone by now. All of it goes,
+        // and the empty chat counts as the length asked for.
+        length = 1;
+        trimmedLength = totalLength - length;
+    }
+
+    // forget the messages that are about to go, the blocks they point into won't exist anymore
+    const int removedFrom = length - 1;
+    for (auto it = userMessagePositions.begin(); it != userMessagePositions.end();) {
+        QVector<UserMessagePosition> &positions = it.value();
+        positions.erase(std::remove_if(positions.begin(), positions.end(),
+                                       [=](const UserMessagePosition &position) {
+                                           return position.block.position() + position.relativePosition >= removedFrom;
+                                       }),
+                        positions.end());
+        if (positions.isEmpty()) {
+            it = userMessagePositions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    cursor.setPosition(removedFrom);
+    cursor.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
+    cursor.removeSelectedText();
+    lastSender = "";
+    evenNumber = _evenNumber;
 }
 
 void ChatView::redactMessages(const QString &userName, int amount)
@@ -9,6 +9,7 @@
 
 #include <QAction>
 #include <QColor>
+#include <QSet>
 #include <QTextBrowser>
 #include <QTextCursor>
 #include <QTextFragment>
@@ -53,15 +54,21 @@ private:
     QTextCharFormat highlightFormat;
     QTextCharFormat mentionFormatOtherUser;
     QTextCharFormat defaultFormat;
-    QStringList highlightedWords;
+    // case folded
+    QSet<QString> highlightedWords;
     bool evenNumber;
     bool showTimestamps;
     HoveredItemType hoveredItemType;
     QString hoveredContent;
     QAction *messageClicked;
     QMap<QString, QVector<UserMessagePosition>> userMessagePositions;
+    // the number of messages kept, older ones are removed
+    int scrollback;
+    // the number of characters removed from the start of the chat for the scrollback
+    int trimmedLength;
 
     QTextFragment getFragmentUnderMouse(const QPoint &pos) const;
+    void trimScrollback();
     QTextCursor prepareBlock(bool same = false);
     void appendCardTag(QTextCursor &cursor, const QString &cardName);
     void appendUrlTag(QTextCursor &cursor, QString url);
@@ -81,6 +88,8 @@ private:
 private slots:
     void openLink(const QUrl &link);
     void actMessageClicked();
+    void updateHighlightedWords();
+    void setScrollback(int _scrollback);
 
 public:
     ChatView(TabSupervisor *_tabSupervisor,
@@ -100,6 +109,18 @@ public:
                        QString UserPrivLevel = "NONE",
                        bool playerBold = false);
     void clearChat();
+    // Removes everything appended after the chat was length characters long, when the next block was going to get
+    // the even or odd background
+    void truncateChat(int length, bool _evenNumber);
+    // Counts the messages removed for the scrollback as well, so it keeps growing with every message
+    int getLength() const
+    {
+        return trimmedLength + document()->characterCount();
+    }
+    bool getEvenNumber() const
+    {
+        return evenNumber;
+    }
     void redactMessages(const QString &userName, int amount);
 
 protected:
@@ -1,6 +1,7 @@
 #include "local_client.h"
 
 #include "local_server_interface.h"
+#include "pb/server_message.pb.h"
 #include "pb/session_commands.pb.h"
 
 LocalClient::LocalClient(LocalServerInterface *_lsi,
@@ -32,5 +33,6 @@ void LocalClient::sendCommandContainer(const CommandContainer &cont)
 
 void LocalClient::itemFromServer(const ServerMessage &item)
 {
-    processProtocolItem(item);
+    ServerMessage message(item);
+    processProtocolItem(message);
 }
@@ -1,7 +1,7 @@
 #include "pending_command.h"
 
 PendingCommand::PendingCommand(const CommandContainer &_commandContainer, QVariant _extraData)
-    : commandContainer(_commandContainer), extraData(_extraData), ticks(0)
+    : commandContainer(_commandContainer), extraData(_extraData), ticks(0), responseThread(nullptr)
 {
 }
 
@@ -26,6 +26,12 @@ void PendingCommand::processResponse(const Response &response)
     emit finished(response.response_code());
 }
 
+void PendingCommand::processQueuedResponse(const ResponsePtr &response)
+{
+    processResponse(*response);
+    deleteLater();
+}
+
 int PendingCommand::tick()
 {
     return ++ticks;
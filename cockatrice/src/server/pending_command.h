@@ -4,8 +4,13 @@
 #include "pb/commands.pb.h"
 #include "pb/response.pb.h"
 
+#include <QSharedPointer>
 #include <QVariant>
 
+class QThread;
+
+typedef QSharedPointer<const Response> ResponsePtr;
+
 class PendingCommand : public QObject
 {
     Q_OBJECT
@@ -17,12 +22,25 @@ private:
     CommandContainer commandContainer;
     QVariant extraData;
     int ticks;
+    // the thread the command was sent from, the response is processed there
+    QThread *responseThread;
+
+private slots:
+    void processQueuedResponse(const ResponsePtr &response);
 
 public:
     PendingCommand(const CommandContainer &_commandContainer, QVariant _extraData = QVariant());
     CommandContainer &getCommandContainer();
     void setExtraData(const QVariant &_extraData);
     QVariant getExtraData() const;
+    QThread *getResponseThread() const
+    {
+        return responseThread;
+    }
+    void setResponseThread(QThread *_responseThread)
+    {
+        responseThread = _responseThread;
+    }
     void processResponse(const Response &response);
     int tick();
 };
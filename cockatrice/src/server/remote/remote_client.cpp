@@ -11,6 +11,7 @@
 #include "pb/response_login.pb.h"
 #include "pb/response_password_salt.pb.h"
 #include "pb/response_register.pb.h"
+#include "pb/response_resume_session.pb.h"
 #include "pb/server_message.pb.h"
 #include "pb/session_commands.pb.h"
 #include "version_string.h"
@@ -20,6 +21,7 @@
 #include <QHostAddress>
 #include <QHostInfo>
 #include <QList>
+#include <QSet>
 #include <QThread>
 #include <QTimer>
 #include <QWebSocket>
@@ -28,7 +30,7 @@ static const unsigned int protocolVersion = 14;
 
 RemoteClient::RemoteClient(QObject *parent)
     : AbstractClient(parent), timeRunning(0), lastDataReceived(0), messageInProgress(false), handshakeStarted(false),
-      usingWebSocket(false), messageLength(0), hashedPassword()
+      usingWebSocket(false), messageLength(0), hashedPassword(), resumeTimeout(0)
 {
 
     clearNewClientFeatures();
@@ -38,6 +40,10 @@ RemoteClient::RemoteClient(QObject *parent)
     timer->setInterval(keepalive * 1000);
     connect(timer, SIGNAL(timeout()), this, SLOT(ping()));
 
+    resumeTimer = new QTimer(this);
+    resumeTimer->setSingleShot(true);
+    connect(resumeTimer, SIGNAL(timeout()), this, SLOT(resumeSessionTimeout()));
+
     socket = new QTcpSocket(this);
     socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
     connect(socket, SIGNAL(connected()), this, SLOT(slotConnected()));
@@ -83,6 +89,8 @@ RemoteClient::~RemoteClient()
 void RemoteClient::slotSocketError(QAbstractSocket::SocketError /*error*/)
 {
     QString errorString = socket->errorString();
+    if (tryResumeSession(errorString))
+        return;
     doDisconnectFromServer();
     emit socketError(errorString);
 }
@@ -92,6 +100,8 @@ void RemoteClient::slotWebSocketError(QAbstractSocket::SocketError /*error*/)
 
     QString errorString = websocket->errorString();
     if (getStatus() != ClientStatus::StatusDisconnected) {
+        if (tryResumeSession(errorString))
+            return;
         doDisconnectFromServer();
         emit socketError(errorString);
     }
@@ -119,6 +129,18 @@ void RemoteClient::processServerIdentificationEvent(const Event_ServerIdentifica
     }
     serverSupportsPasswordHash = event.server_options() & Event_ServerIdentification::SupportsPasswordHash;
 
+    if (getStatus() == StatusResuming) {
+        Command_ResumeSession cmdResumeSession;
+        cmdResumeSession.set_user_name(userName.toStdString());
+        cmdResumeSession.set_resume_token(resumeToken.toStdString());
+        cmdResumeSession.set_last_seq_num(lastSeqNum);
+        PendingCommand *pend = prepareSessionCommand(cmdResumeSession);
+        connect(pend, SIGNAL(finished(Response, CommandContainer, QVariant)), this,
+                SLOT(resumeSessionResponse(Response)));
+        sendCommand(pend);
+        return;
+    }
+
     if (getStatus() == StatusRequestingForgotPassword) {
         Command_ForgotPasswordRequest cmdForgotPasswordRequest;
         cmdForgotPasswordRequest.set_user_name(userName.toStdString());
@@ -296,6 +318,8 @@ void RemoteClient::loginResponse(const Response &response)
     }
 
     if (response.response_code() == Response::RespOk) {
+        resumeToken = QString::fromStdString(resp.resume_token());
+        resumeTimeout = static_cast<int>(resp.resume_timeout());
         setStatus(StatusLoggedIn);
         emit userInfoChanged(resp.user_info());
 
@@ -327,6 +351,69 @@ void RemoteClient::loginResponse(const Response &response)
     }
 }
 
+/**
+ * Reconnects to resume the session after the connection dropped, if the server offered that at login.
+ * Tabs stay open meanwhile, and commands sent in the meantime are held back until the session is resumed.
+ */
+bool RemoteClient::tryResumeSession(const QString &errorString)
+{
+    const bool retrying = getStatus() == StatusResuming;
+    if (!retrying && (getStatus() != StatusLoggedIn || resumeToken.isEmpty() || resumeTimeout <= 0))
+        return false;
+
+    // Don't wait for anything still queued on the dropped connection
+    resetConnectionState();
+    if (websocket->isValid())
+        websocket->abort();
+    socket->abort();
+
+    if (retrying) {
+        // The new connection failed too; keep trying until the server would have dropped the session
+        QTimer::singleShot(1000, this, [this] {
+            if (getStatus() == StatusResuming)
+                connectToHost(lastHostname, lastPort);
+        });
+        return true;
+    }
+
+    qDebug() << "Connection lost, trying to resume session:" << errorString;
+    resumeErrorString = errorString;
+    failPendingCommands();
+    setStatus(StatusResuming);
+    resumeTimer->start(resumeTimeout * 1000);
+    connectToHost(lastHostname, lastPort);
+    return true;
+}
+
+void RemoteClient::resumeSessionResponse(const Response &response)
+{
+    if (response.response_code() == Response::RespOk) {
+        resumeTimer->stop();
+        // The server hands out a new token with every resume, the old one is no longer accepted
+        const Response_ResumeSession &resp = response.GetExtension(Response_ResumeSession::ext);
+        resumeToken = QString::fromStdString(resp.resume_token());
+        setStatus(StatusLoggedIn);
+        for (const CommandContainer &cont : heldCommands)
+            sendCommandContainer(cont);
+        heldCommands.clear();
+        emit sessionResumed();
+    } else if (response.response_code() != Response::RespNotConnected) {
+        const QString errorString = resumeErrorString;
+        doDisconnectFromServer();
+        emit socketError(errorString);
+    }
+}
+
+void RemoteClient::resumeSessionTimeout()
+{
+    if (getStatus() != StatusResuming)
+        return;
+
+    const QString errorString = resumeErrorString;
+    doDisconnectFromServer();
+    emit socketError(errorString);
+}
+
 void RemoteClient::registerResponse(const Response &response)
 {
     const Response_Register &resp = response.GetExtension(Response_Register::ext);
@@ -362,13 +449,13 @@ void RemoteClient::activateResponse(const Response &response)
 void RemoteClient::readData()
 {
     lastDataReceived = timeRunning;
-    QByteArray data = socket->readAll();
-
-    inputBuffer.append(data);
+    inputBuffer.append(socket->readAll());
 
+    // messages are parsed where they are in the buffer, the processed ones are removed once at the end
+    int offset = 0;
     do {
         if (!messageInProgress) {
-            if (inputBuffer.size() >= 4) {
+            if (inputBuffer.size() - offset >= 4) {
                 // dirty hack to be compatible with v14 server that sends 60 bytes of garbage at the beginning
                 if (!handshakeStarted) {
                     handshakeStarted = true;
@@ -378,32 +465,36 @@ void RemoteClient::readData()
                     }
                 } else {
                     // end of hack
-                    messageLength = (((quint32)(unsigned char)inputBuffer[0]) << 24) +
-                                    (((quint32)(unsigned char)inputBuffer[1]) << 16) +
-                                    (((quint32)(unsigned char)inputBuffer[2]) << 8) +
-                                    ((quint32)(unsigned char)inputBuffer[3]);
-                    inputBuffer.remove(0, 4);
+                    const char *header = inputBuffer.constData() + offset;
+                    messageLength = (((quint32)(unsigned char)header[0]) << 24) +
+                                    (((quint32)(unsigned char)header[1]) << 16) +
+                                    (((quint32)(unsigned char)header[2]) << 8) + ((quint32)(unsigned char)header[3]);
+                    offset += 4;
                     messageInProgress = true;
                 }
             } else
-                return;
+                break;
         }
-        if (inputBuffer.size() < messageLength)
-            return;
+        if (inputBuffer.size() - offset < messageLength)
+            break;
 
         ServerMessage newServerMessage;
-        newServerMessage.ParseFromArray(inputBuffer.data(), messageLength);
+        newServerMessage.ParseFromArray(inputBuffer.constData() + offset, messageLength);
 #ifdef QT_DEBUG
         qDebug().noquote() << "IN" << getSafeDebugString(newServerMessage);
 #endif
-        inputBuffer.remove(0, messageLength);
+        offset += messageLength;
         messageInProgress = false;
 
         processProtocolItem(newServerMessage);
 
-        if (getStatus() == StatusDisconnecting) // use thread-safe getter
+        if (getStatus() == StatusDisconnecting) { // use thread-safe getter
             doDisconnectFromServer();
-    } while (!inputBuffer.isEmpty());
+            return;
+        }
+    } while (offset < inputBuffer.size());
+
+    inputBuffer.remove(0, offset);
 }
 
 void RemoteClient::websocketMessageReceived(const QByteArray &message)
@@ -419,6 +510,14 @@ void RemoteClient::websocketMessageReceived(const QByteArray &message)
 
 void RemoteClient::sendCommandContainer(const CommandContainer &cont)
 {
+    // Only the handshake, pings and the resume command itself get through before the session is resumed
+    if (getStatus() == StatusResuming && cont.has_cmd_id() &&
+        !(cont.session_command_size() == 1 && (cont.session_command(0).HasExtension(Command_ResumeSession::ext) ||
+                                               cont.session_command(0).HasExtension(Command_Ping::ext)))) {
+        heldCommands.append(cont);
+        return;
+    }
+
 #if GOOGLE_PROTOBUF_VERSION > 3001000
     auto size = static_cast<unsigned int>(cont.ByteSizeLong());
 #else
@@ -506,26 +605,50 @@ void RemoteClient::doActivateToServer(const QString &_token)
     setStatus(StatusActivating);
 }
 
-void RemoteClient::doDisconnectFromServer()
+void RemoteClient::resetConnectionState()
 {
     timer->stop();
 
     messageInProgress = false;
     handshakeStarted = false;
     messageLength = 0;
+    inputBuffer.clear();
+    incompleteMessages.clear();
+}
+
+// Commands held back while resuming were never sent, so they are kept
+void RemoteClient::failPendingCommands()
+{
+    QSet<int> heldCmdIds;
+    for (const CommandContainer &cont : heldCommands)
+        heldCmdIds.insert(static_cast<int>(cont.cmd_id()));
+
+    QMutableMapIterator<int, PendingCommand *> i(pendingCommands);
+    while (i.hasNext()) {
+        PendingCommand *pend = i.next().value();
+        if (heldCmdIds.contains(i.key()))
+            continue;
+        i.remove();
 
-    QList<PendingCommand *> pc = pendingCommands.values();
-    for (const auto &i : pc) {
         Response response;
         response.set_response_code(Response::RespNotConnected);
-        response.set_cmd_id(i->getCommandContainer().cmd_id());
-        i->processResponse(response);
+        response.set_cmd_id(pend->getCommandContainer().cmd_id());
+        pend->processResponse(response);
 
-        delete i;
+        delete pend;
     }
-    pendingCommands.clear();
+}
+
+void RemoteClient::doDisconnectFromServer()
+{
+    resumeTimer->stop();
+    resumeToken.clear();
+    lastSeqNum = 0;
+    heldCommands.clear();
+    failPendingCommands();
 
     setStatus(StatusDisconnected);
+    resetConnectionState();
     if (websocket->isValid())
         websocket->close();
     socket->close();
@@ -545,10 +668,15 @@ void RemoteClient::ping()
     int maxTime = timeRunning - lastDataReceived;
     emit maxPingTime(maxTime, maxTimeout);
     if (maxTime >= maxTimeout) {
+        if (tryResumeSession(tr("The server stopped responding.")))
+            return;
         disconnectFromServer();
         emit serverTimeout();
     } else {
-        sendCommand(prepareSessionCommand(Command_Ping()));
+        Command_Ping cmdPing;
+        // Lets the server discard game events it no longer needs to keep for resuming the session
+        cmdPing.set_last_seq_num(lastSeqNum);
+        sendCommand(prepareSessionCommand(cmdPing));
         ++timeRunning;
     }
 }
@@ -33,6 +33,7 @@ signals:
     void sigDisconnectFromServer();
     void notifyUserAboutUpdate();
     void sigRequestForgotPasswordToServer(const QString &hostname, unsigned int port, const QString &_userName);
+    void sessionResumed();
     void sigForgotPasswordSuccess();
     void sigForgotPasswordError();
     void sigPromptForForgotPasswordReset();
@@ -57,6 +58,8 @@ private slots:
     void processConnectionClosedEvent(const Event_ConnectionClosed &event);
     void passwordSaltResponse(const Response &response);
     void loginResponse(const Response &response);
+    void resumeSessionResponse(const Response &response);
+    void resumeSessionTimeout();
     void registerResponse(const Response &response);
     void activateResponse(const Response &response);
     void
@@ -102,11 +105,19 @@ private:
     QString lastHostname;
     unsigned int lastPort;
     QString hashedPassword;
+    QString resumeToken;
+    int resumeTimeout;
+    QString resumeErrorString;
+    QTimer *resumeTimer;
+    QList<CommandContainer> heldCommands;
 
     QString getSrvClientID(const QString &_hostname);
     bool newMissingFeatureFound(const QString &_serversMissingFeatures);
     void clearNewClientFeatures();
     void connectToHost(const QString &hostname, unsigned int port);
+    void resetConnectionState();
+    void failPendingCommands();
+    bool tryResumeSession(const QString &errorString);
 
 protected slots:
     void sendCommandContainer(const CommandContainer &cont) override;
@@ -27,6 +27,7 @@
 #include <QPushButton>
 #include <QRadioButton>
 #include <QSpinBox>
+#include <QTreeView>
 #include <QVBoxLayout>
 #include <QWidget>
 
@@ -333,59 +334,25 @@ bool UserListItemDelegate::editorEvent(QEvent *event,
     return QStyledItemDelegate::editorEvent(event, model, option, index);
 }
 
-UserListTWI::UserListTWI(const ServerInfo_User &_userInfo) : QTreeWidgetItem(Type)
-{
-    setUserInfo(_userInfo);
-}
-
-void UserListTWI::setUserInfo(const ServerInfo_User &_userInfo)
-{
-    userInfo = _userInfo;
-
-    setData(0, Qt::UserRole, userInfo.user_level());
-    setIcon(0, QIcon(UserLevelPixmapGenerator::generatePixmap(12, UserLevelFlags(userInfo.user_level()), false,
-                                                              QString::fromStdString(userInfo.privlevel()))));
-    setIcon(1, QIcon(CountryPixmapGenerator::generatePixmap(12, QString::fromStdString(userInfo.country()))));
-    setData(2, Qt::UserRole, QString::fromStdString(userInfo.name()));
-    setData(2, Qt::DisplayRole, QString::fromStdString(userInfo.name()));
-}
-
-void UserListTWI::setOnline(bool online)
-{
-    setData(0, Qt::UserRole + 1, online);
-    setData(2, Qt::ForegroundRole, online ? qApp->palette().brush(QPalette::WindowText) : QBrush(Qt::gray));
-}
-
-bool UserListTWI::operator<(const QTreeWidgetItem &other) const
-{
-    // Sort by online/offline
-    if (data(0, Qt::UserRole + 1) != other.data(0, Qt::UserRole + 1))
-        return data(0, Qt::UserRole + 1).toBool();
-
-    // Sort by user level
-    if ((data(0, Qt::UserRole).toInt() & 15) != (other.data(0, Qt::UserRole).toInt() & 15))
-        return (data(0, Qt::UserRole).toInt() & 15) > (other.data(0, Qt::UserRole).toInt() & 15);
-
-    // Sort by name
-    return QString::localeAwareCompare(data(2, Qt::UserRole).toString(), other.data(2, Qt::UserRole).toString()) < 0;
-}
-
 UserList::UserList(TabSupervisor *_tabSupervisor, AbstractClient *_client, UserListType _type, QWidget *parent)
-    : QGroupBox(parent), tabSupervisor(_tabSupervisor), client(_client), type(_type), onlineCount(0)
+    : QGroupBox(parent), tabSupervisor(_tabSupervisor), client(_client), type(_type)
 {
     itemDelegate = new UserListItemDelegate(this);
     userContextMenu = new UserContextMenu(tabSupervisor, this);
     connect(userContextMenu, SIGNAL(openMessageDialog(QString, bool)), this, SIGNAL(openMessageDialog(QString, bool)));
 
-    userTree = new QTreeWidget;
-    userTree->setColumnCount(3);
+    userListModel = new UserListModel(this);
+
+    userTree = new QTreeView;
+    userTree->setModel(userListModel);
+    userTree->setUniformRowHeights(true);
     userTree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
     userTree->setHeaderHidden(true);
     userTree->setRootIsDecorated(false);
     userTree->setIconSize(QSize(20, 12));
     userTree->setItemDelegate(itemDelegate);
     userTree->setAlternatingRowColors(true);
-    connect(userTree, SIGNAL(itemActivated(QTreeWidgetItem *, int)), this, SLOT(userClicked(QTreeWidgetItem *, int)));
+    connect(userTree, SIGNAL(activated(const QModelIndex &)), this, SLOT(userClicked(const QModelIndex &)));
 
     QVBoxLayout *vbox = new QVBoxLayout;
     vbox->addWidget(userTree);
@@ -417,30 +384,14 @@ void UserList::retranslateUi()
 
 void UserList::processUserInfo(const ServerInfo_User &user, bool online)
 {
-    const QString userName = QString::fromStdString(user.name());
-    UserListTWI *item = users.value(userName);
-    if (item)
-        item->setUserInfo(user);
-    else {
-        item = new UserListTWI(user);
-        users.insert(userName, item);
-        userTree->addTopLevelItem(item);
-        if (online)
-            ++onlineCount;
+    if (userListModel->processUserInfo(user, online)) {
         updateCount();
     }
-    item->setOnline(online);
 }
 
 bool UserList::deleteUser(const QString &userName)
 {
-    UserListTWI *twi = users.value(userName);
-    if (twi) {
-        users.remove(userName);
-        userTree->takeTopLevelItem(userTree->indexOfTopLevelItem(twi));
-        if (twi->data(0, Qt::UserRole + 1).toBool())
-            --onlineCount;
-        delete twi;
+    if (userListModel->removeUser(userName)) {
         updateCount();
         return true;
     }
@@ -450,35 +401,28 @@ bool UserList::deleteUser(const QString &userName)
 
 void UserList::setUserOnline(const QString &userName, bool online)
 {
-    UserListTWI *twi = users.value(userName);
-    if (!twi)
-        return;
-
-    twi->setOnline(online);
-    if (online)
-        ++onlineCount;
-    else
-        --onlineCount;
-    updateCount();
+    if (userListModel->setUserOnline(userName, online)) {
+        updateCount();
+    }
 }
 
 void UserList::updateCount()
 {
     QString str = titleStr;
     if ((type == BuddyList) || (type == IgnoreList))
-        str = str.arg(onlineCount);
-    setTitle(str.arg(userTree->topLevelItemCount()));
+        str = str.arg(userListModel->getOnlineCount());
+    setTitle(str.arg(userListModel->getUserCount()));
 }
 
-void UserList::userClicked(QTreeWidgetItem *item, int /*column*/)
+void UserList::userClicked(const QModelIndex &index)
 {
-    emit openMessageDialog(item->data(2, Qt::UserRole).toString(), true);
+    emit openMessageDialog(QString::fromStdString(userListModel->getUserAt(index.row()).name()), true);
 }
 
 void UserList::showContextMenu(const QPoint &pos, const QModelIndex &index)
 {
-    const ServerInfo_User &userInfo = static_cast<UserListTWI *>(userTree->topLevelItem(index.row()))->getUserInfo();
-    bool online = index.sibling(index.row(), 0).data(Qt::UserRole + 1).toBool();
+    const ServerInfo_User &userInfo = userListModel->getUserAt(index.row());
+    bool online = userListModel->isUserOnlineAt(index.row());
 
     userContextMenu->showContextMenu(pos, QString::fromStdString(userInfo.name()),
                                      UserLevelFlags(userInfo.user_level()), online);
@@ -486,5 +430,5 @@ void UserList::showContextMenu(const QPoint &pos, const QModelIndex &index)
 
 void UserList::sortItems()
 {
-    userTree->sortItems(1, Qt::AscendingOrder);
+    userListModel->scheduleSort();
 }
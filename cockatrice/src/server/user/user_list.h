@@ -3,15 +3,15 @@
 
 #include "pb/moderator_commands.pb.h"
 #include "user_level.h"
+#include "user_list_model.h"
 
 #include <QComboBox>
 #include <QDialog>
 #include <QGroupBox>
 #include <QStyledItemDelegate>
 #include <QTextEdit>
-#include <QTreeWidgetItem>
 
-class QTreeWidget;
+class QTreeView;
 class ServerInfo_User;
 class AbstractClient;
 class TabSupervisor;
@@ -95,22 +95,6 @@ public:
     editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option, const QModelIndex &index);
 };
 
-class UserListTWI : public QTreeWidgetItem
-{
-private:
-    ServerInfo_User userInfo;
-
-public:
-    UserListTWI(const ServerInfo_User &_userInfo);
-    const ServerInfo_User &getUserInfo() const
-    {
-        return userInfo;
-    }
-    void setUserInfo(const ServerInfo_User &_userInfo);
-    void setOnline(bool online);
-    bool operator<(const QTreeWidgetItem &other) const;
-};
-
 class UserList : public QGroupBox
 {
     Q_OBJECT
@@ -124,18 +108,17 @@ public:
     };
 
 private:
-    QMap<QString, UserListTWI *> users;
     TabSupervisor *tabSupervisor;
     AbstractClient *client;
     UserListType type;
-    QTreeWidget *userTree;
+    UserListModel *userListModel;
+    QTreeView *userTree;
     UserListItemDelegate *itemDelegate;
     UserContextMenu *userContextMenu;
-    int onlineCount;
     QString titleStr;
     void updateCount();
 private slots:
-    void userClicked(QTreeWidgetItem *item, int column);
+    void userClicked(const QModelIndex &index);
 signals:
     void openMessageDialog(const QString &userName, bool focus);
     void addBuddy(const QString &userName);
@@ -149,11 +132,20 @@ public:
     void processUserInfo(const ServerInfo_User &user, bool online);
     bool deleteUser(const QString &userName);
     void setUserOnline(const QString &userName, bool online);
-    const QMap<QString, UserListTWI *> &getUsers() const
+    bool contains(const QString &userName) const
+    {
+        return userListModel->contains(userName);
+    }
+    const ServerInfo_User *getUser(const QString &userName, Qt::CaseSensitivity cs = Qt::CaseSensitive) const
+    {
+        return userListModel->getUser(userName, cs);
+    }
+    QStringList getUserNames() const
     {
-        return users;
+        return userListModel->getUserNames();
     }
     void showContextMenu(const QPoint &pos, const QModelIndex &index);
+    // Sorting happens once the event loop runs again, so bursts of changes only sort once
     void sortItems();
 };
 
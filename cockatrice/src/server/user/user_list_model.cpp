@@ -0,0 +1,217 @@
+#include "user_list_model.h"
+
+#include "../../client/ui/pixel_map_generator.h"
+#include "user_level.h"
+
+#include <QApplication>
+#include <QPalette>
+#include <QTimer>
+#include <algorithm>
+
+UserListModel::UserListModel(QObject *parent)
+    : QAbstractTableModel(parent), onlineCount(0), sortPending(false), flushScheduled(false)
+{
+}
+
+UserListModel::~UserListModel()
+{
+    qDeleteAll(users);
+}
+
+QVariant UserListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows.size()) {
+        return QVariant();
+    }
+
+    const Entry *entry = rows.at(index.row());
+    switch (index.column()) {
+        case LevelColumn:
+            switch (role) {
+                case Qt::DecorationRole:
+                    return entry->levelPixmap;
+                case Qt::UserRole:
+                    return entry->info.user_level();
+                case ONLINE_ROLE:
+                    return entry->online;
+                default:
+                    return QVariant();
+            }
+        case CountryColumn:
+            return role == Qt::DecorationRole ? QVariant(entry->countryPixmap) : QVariant();
+        case NameColumn:
+            switch (role) {
+                case Qt::DisplayRole:
+                case Qt::UserRole:
+                    return entry->name;
+                case Qt::ForegroundRole:
+                    return entry->online ? qApp->palette().brush(QPalette::WindowText) : QBrush(Qt::gray);
+                default:
+                    return QVariant();
+            }
+        default:
+            return QVariant();
+    }
+}
+
+bool UserListModel::processUserInfo(const ServerInfo_User &user, bool online)
+{
+    const QString userName = QString::fromStdString(user.name());
+    Entry *entry = users.value(userName);
+    if (entry) {
+        setUserInfo(entry, user);
+        setOnline(entry, online);
+        entryChanged(entry);
+        return false;
+    }
+
+    entry = new Entry;
+    entry->name = userName;
+    entry->online = false;
+    entry->row = -1;
+    setUserInfo(entry, user);
+    setOnline(entry, online);
+    users.insert(userName, entry);
+    usersCaseInsensitive.insert(userName.toLower(), entry);
+    pending.append(entry);
+    sortPending = true;
+    scheduleFlush();
+    return true;
+}
+
+bool UserListModel::removeUser(const QString &userName)
+{
+    Entry *entry = users.take(userName);
+    if (!entry) {
+        return false;
+    }
+    usersCaseInsensitive.remove(userName.toLower(), entry);
+    setOnline(entry, false);
+
+    if (entry->row == -1) {
+        pending.removeOne(entry);
+    } else {
+        const int row = entry->row;
+        beginRemoveRows(QModelIndex(), row, row);
+        rows.remove(row);
+        for (int i = row; i < rows.size(); ++i) {
+            rows[i]->row = i;
+        }
+        endRemoveRows();
+    }
+    delete entry;
+    return true;
+}
+
+bool UserListModel::setUserOnline(const QString &userName, bool online)
+{
+    Entry *entry = users.value(userName);
+    if (!entry) {
+        return false;
+    }
+    if (entry->online != online) {
+        setOnline(entry, online);
+        entryChanged(entry);
+    }
+    return true;
+}
+
+const ServerInfo_User *UserListModel::getUser(const QString &userName, Qt::CaseSensitivity cs) const
+{
+    const Entry *entry =
+        cs == Qt::CaseSensitive ? users.value(userName) : usersCaseInsensitive.value(userName.toLower());
+    return entry ? &entry->info : nullptr;
+}
+
+void UserListModel::scheduleSort()
+{
+    sortPending = true;
+    scheduleFlush();
+}
+
+void UserListModel::setUserInfo(Entry *entry, const ServerInfo_User &user)
+{
+    entry->info = user;
+    entry->levelPixmap = UserLevelPixmapGenerator::generatePixmap(12, UserLevelFlags(user.user_level()), false,
+                                                                  QString::fromStdString(user.privlevel()));
+    entry->countryPixmap = CountryPixmapGenerator::generatePixmap(12, QString::fromStdString(user.country()));
+}
+
+void UserListModel::setOnline(Entry *entry, bool online)
+{
+    if (entry->online != online) {
+        onlineCount += online ? 1 : -1;
+        entry->online = online;
+    }
+}
+
+void UserListModel::entryChanged(Entry *entry)
+{
+    if (entry->row == -1) {
+        return;
+    }
+    emit dataChanged(index(entry->row, 0), index(entry->row, ColumnCount - 1));
+    // online state, level or name may have changed
+    scheduleSort();
+}
+
+void UserListModel::scheduleFlush()
+{
+    if (flushScheduled) {
+        return;
+    }
+    flushScheduled = true;
+    QTimer::singleShot(0, this, SLOT(flush()));
+}
+
+bool UserListModel::lessThan(const Entry *a, const Entry *b)
+{
+    // Sort by online/offline
+    if (a->online != b->online)
+        return a->online;
+
+    // Sort by user level
+    const int levelA = a->info.user_level() & 15;
+    const int levelB = b->info.user_level() & 15;
+    if (levelA != levelB)
+        return levelA > levelB;
+
+    // Sort by name
+    return QString::localeAwareCompare(a->name, b->name) < 0;
+}
+
+void UserListModel::flush()
+{
+    flushScheduled = false;
+
+    if (!pending.isEmpty()) {
+        beginInsertRows(QModelIndex(), rows.size(), rows.size() + pending.size() - 1);
+        for (Entry *entry : pending) {
+            entry->row = rows.size();
+            rows.append(entry);
+        }
+        pending.clear();
+        endInsertRows();
+    }
+
+    if (!sortPending) {
+        return;
+    }
+    sortPending = false;
+
+    emit layoutAboutToBeChanged();
+    const QVector<Entry *> oldRows = rows;
+    std::stable_sort(rows.begin(), rows.end(), lessThan);
+    for (int i = 0; i < rows.size(); ++i) {
+        rows[i]->row = i;
+    }
+
+    const QModelIndexList oldPersistent = persistentIndexList();
+    QModelIndexList newPersistent;
+    newPersistent.reserve(oldPersistent.size());
+    for (const QModelIndex &oldIndex : oldPersistent) {
+        newPersistent.append(index(oldRows.at(oldIndex.row())->row, oldIndex.column()));
+    }
+    changePersistentIndexList(oldPersistent, newPersistent);
+    emit layoutChanged();
+}
@@ -0,0 +1,110 @@
+#ifndef USERLISTMODEL_H
+#define USERLISTMODEL_H
+
+#include "pb/serverinfo_user.pb.h"
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QMultiHash>
+#include <QPixmap>
+#include <QVector>
+
+/**
+ * The users shown in a UserList, sorted by online state, user level and name.
+ *
+ * Users are found by name through a hash. Rooms and servers send their users in bursts (the whole list on join, then
+ * single joins and leaves), so new users and sorting are deferred until the event loop runs again: the view sees one
+ * insertion of all users added in the meantime and is sorted once.
+ */
+class UserListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Columns
+    {
+        LevelColumn,
+        CountryColumn,
+        NameColumn,
+        ColumnCount
+    };
+    static const int ONLINE_ROLE = Qt::UserRole + 1;
+
+    explicit UserListModel(QObject *parent = nullptr);
+    ~UserListModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : rows.size();
+    }
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : ColumnCount;
+    }
+    QVariant data(const QModelIndex &index, int role) const override;
+
+    // Returns true if the user wasn't in the list yet
+    bool processUserInfo(const ServerInfo_User &user, bool online);
+    bool removeUser(const QString &userName);
+    // Returns true if the user is in the list
+    bool setUserOnline(const QString &userName, bool online);
+    void scheduleSort();
+
+    bool contains(const QString &userName) const
+    {
+        return users.contains(userName);
+    }
+    const ServerInfo_User *getUser(const QString &userName, Qt::CaseSensitivity cs = Qt::CaseSensitive) const;
+    const ServerInfo_User &getUserAt(int row) const
+    {
+        return rows.at(row)->info;
+    }
+    bool isUserOnlineAt(int row) const
+    {
+        return rows.at(row)->online;
+    }
+    QStringList getUserNames() const
+    {
+        return users.keys();
+    }
+    int getUserCount() const
+    {
+        return users.size();
+    }
+    int getOnlineCount() const
+    {
+        return onlineCount;
+    }
+
+private:
+    struct Entry
+    {
+        ServerInfo_User info;
+        QString name;
+        bool online;
+        // the pixmaps of the generators are shared between all users at the same level or from the same country
+        QPixmap levelPixmap;
+        QPixmap countryPixmap;
+        // -1 while waiting to be inserted
+        int row;
+    };
+
+    QHash<QString, Entry *> users;
+    // by lower case name, names that only differ in case are possible
+    QMultiHash<QString, Entry *> usersCaseInsensitive;
+    QVector<Entry *> rows;
+    QVector<Entry *> pending;
+    int onlineCount;
+    bool sortPending;
+    bool flushScheduled;
+
+    void setUserInfo(Entry *entry, const ServerInfo_User &user);
+    void setOnline(Entry *entry, bool online);
+    void entryChanged(Entry *entry);
+    void scheduleFlush();
+    static bool lessThan(const Entry *a, const Entry *b);
+
+private slots:
+    void flush();
+};
+
+#endif
@@ -225,6 +225,8 @@ SettingsCache::SettingsCache()
 
     networkCacheSize = settings->value("personal/networkCacheSize", NETWORK_CACHE_SIZE_DEFAULT).toInt();
     redirectCacheTtl = settings->value("personal/redirectCacheTtl", NETWORK_REDIRECT_CACHE_TTL_DEFAULT).toInt();
+    picDownloadConnectionsPerHost =
+        settings->value("personal/picDownloadConnectionsPerHost", PIC_DOWNLOAD_CONNECTIONS_PER_HOST_DEFAULT).toInt();
 
     picDownload = settings->value("personal/picturedownload", true).toBool();
 
@@ -267,6 +269,8 @@ SettingsCache::SettingsCache()
     rewindBufferingMs = settings->value("replay/rewindBufferingMs", 200).toInt();
     chatMention = settings->value("chat/mention", true).toBool();
     chatMentionCompleter = settings->value("chat/mentioncompleter", true).toBool();
+    chatScrollback = qBound(CHAT_SCROLLBACK_MIN, settings->value("chat/scrollback", CHAT_SCROLLBACK_DEFAULT).toInt(),
+                            CHAT_SCROLLBACK_MAX);
     chatMentionForeground = settings->value("chat/mentionforeground", true).toBool();
     chatHighlightForeground = settings->value("chat/highlightforeground", true).toBool();
     chatMentionColor = settings->value("chat/mentioncolor", "A6120D").toString();
@@ -341,6 +345,7 @@ void SettingsCache::setHighlightWords(const QString &_highlightWords)
 {
     highlightWords = _highlightWords;
     settings->setValue("personal/highlightWords", highlightWords);
+    emit highlightWordsChanged();
 }
 
 void SettingsCache::setMasterVolume(int _masterVolume)
@@ -665,6 +670,13 @@ void SettingsCache::setChatMentionCompleter(const QT_STATE_CHANGED_T _enableMent
     emit chatMentionCompleterChanged();
 }
 
+void SettingsCache::setChatScrollback(int _chatScrollback)
+{
+    chatScrollback = _chatScrollback;
+    settings->setValue("chat/scrollback", chatScrollback);
+    emit chatScrollbackChanged(chatScrollback);
+}
+
 void SettingsCache::setChatMentionForeground(QT_STATE_CHANGED_T _chatMentionForeground)
 {
     chatMentionForeground = static_cast<bool>(_chatMentionForeground);
@@ -772,6 +784,13 @@ void SettingsCache::setNetworkRedirectCacheTtl(const int _redirectCacheTtl)
     emit redirectCacheTtlChanged(redirectCacheTtl);
 }
 
+void SettingsCache::setPicDownloadConnectionsPerHost(const int _picDownloadConnectionsPerHost)
+{
+    picDownloadConnectionsPerHost = _picDownloadConnectionsPerHost;
+    settings->setValue("personal/picDownloadConnectionsPerHost", picDownloadConnectionsPerHost);
+    emit picDownloadConnectionsPerHostChanged(picDownloadConnectionsPerHost);
+}
+
 void SettingsCache::setClientID(const QString &_clientID)
 {
     clientID = _clientID;
@@ -1142,6 +1161,7 @@ void SettingsCache::setMaxFontSize(int _max)
 {
     maxFontSize = _max;
     settings->setValue("game/maxfontsize", maxFontSize);
+    emit maxFontSizeChanged();
 }
 
 void SettingsCache::loadPaths()
@@ -23,6 +23,11 @@ class ReleaseChannel;
 #define PIXMAPCACHE_SIZE_MIN 64
 #define PIXMAPCACHE_SIZE_MAX 4096
 
+// In messages per chat or game log
+constexpr int CHAT_SCROLLBACK_DEFAULT = 5000;
+constexpr int CHAT_SCROLLBACK_MIN = 100;
+constexpr int CHAT_SCROLLBACK_MAX = 100000;
+
 // In MB
 constexpr int NETWORK_CACHE_SIZE_DEFAULT = 1024 * 4; // 4 GB
 constexpr int NETWORK_CACHE_SIZE_MIN = 1;            // 1 MB
@@ -33,6 +38,11 @@ constexpr int NETWORK_CACHE_SIZE_MAX = 1024 * 1024;  // 1 TB
 #define NETWORK_REDIRECT_CACHE_TTL_MIN 1
 #define NETWORK_REDIRECT_CACHE_TTL_MAX 90
 
+// Parallel picture downloads from the same host; Qt itself never opens more than 6 connections per host
+#define PIC_DOWNLOAD_CONNECTIONS_PER_HOST_DEFAULT 4
+#define PIC_DOWNLOAD_CONNECTIONS_PER_HOST_MIN 1
+#define PIC_DOWNLOAD_CONNECTIONS_PER_HOST_MAX 6
+
 #define DEFAULT_LANG_NAME "English"
 #define CLIENT_INFO_NOT_SET "notset"
 
@@ -50,6 +60,7 @@ signals:
     void themeChanged();
     void picDownloadChanged();
     void displayCardNamesChanged();
+    void maxFontSizeChanged();
     void overrideAllCardArtWithPersonalPreferenceChanged();
     void bumpSetsWithCardsInDeckToTopChanged();
     void printingSelectorSortOrderChanged();
@@ -69,8 +80,11 @@ signals:
     void pixmapCacheSizeChanged(int newSizeInMBs);
     void networkCacheSizeChanged(int newSizeInMBs);
     void redirectCacheTtlChanged(int newTtl);
+    void picDownloadConnectionsPerHostChanged(int newConnections);
     void masterVolumeChanged(int value);
     void chatMentionCompleterChanged();
+    void chatScrollbackChanged(int newScrollback);
+    void highlightWordsChanged();
     void downloadSpoilerTimeIndexChanged();
     void downloadSpoilerStatusChanged();
     void useTearOffMenusChanged(bool state);
@@ -129,6 +143,7 @@ private:
     int rewindBufferingMs;
     bool chatMention;
     bool chatMentionCompleter;
+    int chatScrollback;
     QString chatMentionColor;
     QString chatHighlightColor;
     bool chatMentionForeground;
@@ -149,6 +164,7 @@ private:
     int pixmapCacheSize;
     int networkCacheSize;
     int redirectCacheTtl;
+    int picDownloadConnectionsPerHost;
     bool scaleCards;
     int verticalCardOverlapPercent;
     bool showMessagePopups;
@@ -394,6 +410,10 @@ public:
     {
         return chatMentionCompleter;
     }
+    int getChatScrollback() const
+    {
+        return chatScrollback;
+    }
     bool getChatMentionForeground() const
     {
         return chatMentionForeground;
@@ -452,6 +472,10 @@ public:
     {
         return redirectCacheTtl;
     }
+    int getPicDownloadConnectionsPerHost() const
+    {
+        return picDownloadConnectionsPerHost;
+    }
     bool getScaleCards() const
     {
         return scaleCards;
@@ -671,6 +695,7 @@ public slots:
     void setRewindBufferingMs(int _rewindBufferingMs);
     void setChatMention(QT_STATE_CHANGED_T _chatMention);
     void setChatMentionCompleter(QT_STATE_CHANGED_T _chatMentionCompleter);
+    void setChatScrollback(int _chatScrollback);
     void setChatMentionForeground(QT_STATE_CHANGED_T _chatMentionForeground);
     void setChatHighlightForeground(QT_STATE_CHANGED_T _chatHighlightForeground);
     void setZoneViewGroupByIndex(const int _zoneViewGroupByIndex);
@@ -683,6 +708,7 @@ public slots:
     void setPixmapCacheSize(const int _pixmapCacheSize);
     void setNetworkCacheSizeInMB(const int _networkCacheSize);
     void setNetworkRedirectCacheTtl(const int _redirectCacheTtl);
+    void setPicDownloadConnectionsPerHost(const int _picDownloadConnectionsPerHost);
     void setCardScaling(const QT_STATE_CHANGED_T _scaleCards);
     void setStackCardOverlapPercent(const int _verticalCardOverlapPercent);
     void setShowMessagePopups(const QT_STATE_CHANGED_T _showMessagePopups);
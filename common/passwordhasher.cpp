@@ -3,6 +3,11 @@
 #include "rng_sfmt.h"
 
 #include <QCryptographicHash>
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+#include <QRandomGenerator>
+#else
+#include <random>
+#endif
 
 QString PasswordHasher::computeHash(const QString &password, const QString &salt)
 {
@@ -37,3 +42,49 @@ QString PasswordHasher::generateActivationToken()
 {
     return QCryptographicHash::hash(generateRandomSalt().toUtf8(), QCryptographicHash::Md5).toBase64().left(16);
 }
+
+/**
+ * Unlike the salts, session tokens grant access on their own, so they come from the system's secure random source
+ * instead of the game rng.
+ */
+QString PasswordHasher::generateSessionToken(const int len)
+{
+    static const char alphanum[] = "0123456789"
+                                   "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                   "abcdefghijklmnopqrstuvwxyz";
+    const int size = sizeof(alphanum) - 1;
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+    QRandomGenerator *generator = QRandomGenerator::system();
+#else
+    std::random_device device;
+    std::uniform_int_distribution<int> distribution(0, size - 1);
+#endif
+
+    QString ret;
+    for (int i = 0; i < len; ++i) {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+        ret.append(alphanum[generator->bounded(size)]);
+#else
+        ret.append(alphanum[distribution(device)]);
+#endif
+    }
+
+    return ret;
+}
+
+/**
+ * Compares two tokens in time that only depends on their lengths, so a guess can't be refined by timing the replies.
+ */
+bool PasswordHasher::tokensEqual(const QString &a, const QString &b)
+{
+    const QByteArray left = a.toUtf8();
+    const QByteArray right = b.toUtf8();
+    if (left.size() != right.size())
+        return false;
+
+    unsigned char difference = 0;
+    for (int i = 0; i < left.size(); ++i)
+        difference |= static_cast<unsigned char>(left.at(i) ^ right.at(i));
+    return difference == 0;
+}
@@ -9,6 +9,8 @@ public:
     static QString computeHash(const QString &password, const QString &salt);
     static QString generateRandomSalt(const int len = 16);
     static QString generateActivationToken();
+    static QString generateSessionToken(const int len = 32);
+    static bool tokensEqual(const QString &a, const QString &b);
 };
 
 #endif
@@ -0,0 +1,35 @@
+#include "rcu_domain.h"
+
+#include <QThread>
+
+RcuDomain::RcuDomain() : epoch(0)
+{
+}
+
+int RcuDomain::lockForRead()
+{
+    while (true) {
+        const int readEpoch = epoch.loadAcquire();
+        readers[readEpoch].ref();
+        // A writer may have flipped the epoch between the load and the increment; in that case it might already
+        // have seen our old counter as idle, so retry in the new epoch.
+        if (epoch.loadAcquire() == readEpoch)
+            return readEpoch;
+        readers[readEpoch].deref();
+    }
+}
+
+void RcuDomain::unlock(int readEpoch)
+{
+    readers[readEpoch].deref();
+}
+
+void RcuDomain::synchronize()
+{
+    QMutexLocker locker(&synchronizeMutex);
+
+    // New readers start in the other epoch, so only the read sections that were already running are waited for.
+    const int oldEpoch = epoch.fetchAndStoreOrdered(1 - epoch.loadAcquire());
+    while (readers[oldEpoch].loadAcquire() != 0)
+        QThread::yieldCurrentThread();
+}
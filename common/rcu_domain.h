@@ -0,0 +1,51 @@
+#ifndef RCU_DOMAIN_H
+#define RCU_DOMAIN_H
+
+#include <QAtomicInt>
+#include <QMutex>
+
+/**
+ * Read-copy-update style protection for objects that are read far more often than they are removed.
+ *
+ * Readers enter a read section with lockForRead()/RcuReadLocker; this never blocks and never waits for writers.
+ * Writers unpublish an object (e.g. remove it from a lookup table), then call synchronize(), which returns once
+ * every read section that might still see the object has ended. Only then may the object be destroyed.
+ *
+ * Read sections may be nested. synchronize() must not be called from inside a read section.
+ */
+class RcuDomain
+{
+private:
+    QAtomicInt epoch;
+    QAtomicInt readers[2];
+    QMutex synchronizeMutex;
+
+public:
+    RcuDomain();
+    RcuDomain(const RcuDomain &) = delete;
+    RcuDomain &operator=(const RcuDomain &) = delete;
+
+    int lockForRead();
+    void unlock(int readEpoch);
+    void synchronize();
+};
+
+class RcuReadLocker
+{
+private:
+    RcuDomain *domain;
+    int readEpoch;
+
+public:
+    explicit RcuReadLocker(RcuDomain *_domain) : domain(_domain), readEpoch(_domain->lockForRead())
+    {
+    }
+    ~RcuReadLocker()
+    {
+        domain->unlock(readEpoch);
+    }
+    RcuReadLocker(const RcuReadLocker &) = delete;
+    RcuReadLocker &operator=(const RcuReadLocker &) = delete;
+};
+
+#endif
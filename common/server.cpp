@@ -21,6 +21,7 @@
 
 #include "debug_pb_message.h"
 #include "featureset.h"
+#include "passwordhasher.h"
 #include "pb/event_connection_closed.pb.h"
 #include "pb/event_list_rooms.pb.h"
 #include "pb/event_user_joined.pb.h"
@@ -33,13 +34,16 @@
 #include "server_player.h"
 #include "server_protocolhandler.h"
 #include "server_remoteuserinterface.h"
+#include "server_resumable_session.h"
 #include "server_room.h"
 
 #include <QCoreApplication>
 #include <QDebug>
 #include <QThread>
 
-Server::Server(QObject *parent) : QObject(parent), nextLocalGameId(0), tcpUserCount(0), webSocketUserCount(0)
+Server::Server(QObject *parent)
+    : QObject(parent), nextLocalGameId(0), usersCount(0), moderatorsCount(0), gamesCount(0), tcpUserCount(0),
+      webSocketUserCount(0)
 {
     qRegisterMetaType<ServerInfo_Ban>("ServerInfo_Ban");
     qRegisterMetaType<ServerInfo_Game>("ServerInfo_Game");
@@ -53,10 +57,18 @@ Server::Server(QObject *parent) : QObject(parent), nextLocalGameId(0), tcpUserCo
 
     connect(this, SIGNAL(sigSendIslMessage(IslMessage, int)), this, SLOT(doSendIslMessage(IslMessage, int)),
             Qt::QueuedConnection);
+    connect(this, SIGNAL(pingClockTimeout()), this, SLOT(expireSuspendedSessions()));
 }
 
 void Server::prepareDestroy()
 {
+    suspendedSessionsMutex.lock();
+    const QList<Server_SuspendedSession *> remainingSessions = suspendedSessions.values();
+    suspendedSessions.clear();
+    suspendedSessionsMutex.unlock();
+    for (Server_SuspendedSession *suspendedSession : remainingSessions)
+        releaseSuspendedSession(suspendedSession);
+
     roomsLock.lockForWrite();
     QMapIterator<int, Server_Room *> roomIterator(rooms);
     while (roomIterator.hasNext())
@@ -111,19 +123,21 @@ AuthenticationResult Server::loginUser(Server_ProtocolHandler *session,
     name = QString::fromStdString(data.name()); // Compensate for case indifference
 
     if (authState == PasswordRight) {
-        if (users.contains(name) || databaseInterface->userSessionExists(name)) {
-            if (users.contains(name)) {
+        discardSuspendedSession(name);
+        Server_ProtocolHandler *oldSession = users.value(name);
+        if (oldSession || databaseInterface->userSessionExists(name)) {
+            if (oldSession) {
                 qDebug("Session already logged in, logging old session out");
                 Event_ConnectionClosed event;
                 event.set_reason(Event_ConnectionClosed::LOGGEDINELSEWERE);
                 event.set_reason_str("You have been logged out due to logging in at another location.");
                 event.set_end_time(QDateTime::currentDateTime().toSecsSinceEpoch());
 
-                SessionEvent *se = users.value(name)->prepareSessionEvent(event);
-                users.value(name)->sendProtocolItem(*se);
+                SessionEvent *se = oldSession->prepareSessionEvent(event);
+                oldSession->sendProtocolItem(*se);
                 delete se;
 
-                users.value(name)->prepareDestroy();
+                oldSession->prepareDestroy();
             } else {
                 qDebug() << "Active session and sessions table inconsistent, please validate session table information "
                             "for user "
@@ -149,41 +163,121 @@ AuthenticationResult Server::loginUser(Server_ProtocolHandler *session,
         data.set_name(name.toStdString());
     }
 
-    QWriteLocker locker(&clientsLock);
     databaseInterface->lockSessionTables();
-    users.insert(name, session);
     qDebug() << "Server::loginUser:" << session << "name=" << name;
 
     data.set_session_id(static_cast<google::protobuf::uint64>(
         databaseInterface->startSession(name, session->getAddress(), clientid, session->getConnectionType())));
     databaseInterface->unlockSessionTables();
 
-    usersBySessionId.insert(data.session_id(), session);
-
     qDebug() << "session id:" << data.session_id();
     session->setUserInfo(data);
 
+    if (hasClientId) {
+        // update users database table with client id
+        databaseInterface->updateUsersClientID(name, clientid);
+    }
+    databaseInterface->updateUsersLastLoginData(name, clientVersion);
+
+    publishUser(session);
+
+    return authState;
+}
+
+void Server::publishUser(Server_ProtocolHandler *session)
+{
+    ServerInfo_User *data = session->getUserInfo();
+    const QString name = QString::fromStdString(data->name());
+
+    // Readers don't take a lock, so only publish the session once its user info is complete
+    users.insert(name, session);
+    usersBySessionId.insert(data->session_id(), session);
+    usersCount.ref();
+    if (isModerator(*data)) {
+        moderatorsCount.ref();
+        QMutexLocker moderatorsLocker(&onlineModeratorsMutex);
+        onlineModerators << name.simplified();
+    }
+
     Event_UserJoined event;
     event.mutable_user_info()->CopyFrom(session->copyUserInfo(false));
     SessionEvent *se = Server_ProtocolHandler::prepareSessionEvent(event);
-    for (auto &client : clients)
-        if (client->getAcceptsUserListChanges())
-            client->sendProtocolItem(*se);
+    {
+        RcuReadLocker locker(&clientsRcu);
+        for (auto &client : getClients())
+            if (client->getAcceptsUserListChanges())
+                client->sendProtocolItem(*se);
+    }
     delete se;
 
     event.mutable_user_info()->CopyFrom(session->copyUserInfo(true, true, true));
-    locker.unlock();
-
-    if (hasClientId) {
-        // update users database table with client id
-        databaseInterface->updateUsersClientID(name, clientid);
-    }
-    databaseInterface->updateUsersLastLoginData(name, clientVersion);
     se = Server_ProtocolHandler::prepareSessionEvent(event);
     sendIsl_SessionEvent(*se);
     delete se;
+}
 
-    return authState;
+void Server::addSuspendedSession(Server_SuspendedSession *suspendedSession)
+{
+    const QString userName = QString::fromStdString(suspendedSession->getUserInfo()->name());
+    qDebug() << "Server::addSuspendedSession: name=" << userName;
+
+    QMutexLocker locker(&suspendedSessionsMutex);
+    Server_SuspendedSession *previous = suspendedSessions.value(userName);
+    suspendedSessions.insert(userName, suspendedSession);
+    locker.unlock();
+
+    if (previous)
+        releaseSuspendedSession(previous);
+}
+
+Server_SuspendedSession *Server::takeSuspendedSession(const QString &userName, const QString &resumeToken)
+{
+    QMutexLocker locker(&suspendedSessionsMutex);
+    Server_SuspendedSession *suspendedSession = suspendedSessions.value(userName);
+    if (!suspendedSession || !PasswordHasher::tokensEqual(suspendedSession->getResumeToken(), resumeToken))
+        return nullptr;
+    suspendedSessions.remove(userName);
+    return suspendedSession;
+}
+
+void Server::discardSuspendedSession(const QString &userName)
+{
+    suspendedSessionsMutex.lock();
+    Server_SuspendedSession *suspendedSession = suspendedSessions.take(userName);
+    suspendedSessionsMutex.unlock();
+
+    if (suspendedSession)
+        releaseSuspendedSession(suspendedSession);
+}
+
+void Server::releaseSuspendedSession(Server_SuspendedSession *suspendedSession)
+{
+    ServerInfo_User *data = suspendedSession->getUserInfo();
+    qDebug() << "Server::releaseSuspendedSession: name=" << QString::fromStdString(data->name());
+
+    suspendedSession->handOverPlayers(nullptr);
+    if (data->has_session_id())
+        emit endSession(data->session_id());
+    delete suspendedSession;
+}
+
+void Server::expireSuspendedSessions()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QList<Server_SuspendedSession *> expired;
+
+    suspendedSessionsMutex.lock();
+    QMutableMapIterator<QString, Server_SuspendedSession *> sessionIterator(suspendedSessions);
+    while (sessionIterator.hasNext()) {
+        if (sessionIterator.next().value()->getExpiresAt() <= now) {
+            expired.append(sessionIterator.value());
+            sessionIterator.remove();
+        }
+    }
+    suspendedSessionsMutex.unlock();
+
+    for (Server_SuspendedSession *suspendedSession : expired)
+        releaseSuspendedSession(suspendedSession);
 }
 
 void Server::addPersistentPlayer(const QString &userName, int roomId, int gameId, int playerId)
@@ -206,7 +300,7 @@ QList<PlayerReference> Server::getPersistentPlayerReferences(const QString &user
 
 Server_AbstractUserInterface *Server::findUser(const QString &userName) const
 {
-    // Call this only with clientsLock set.
+    // Call this only inside a clientsRcu read section.
 
     Server_AbstractUserInterface *userHandler = users.value(userName);
     if (userHandler)
@@ -218,76 +312,89 @@ Server_AbstractUserInterface *Server::findUser(const QString &userName) const
 void Server::addClient(Server_ProtocolHandler *client)
 {
     if (client->getConnectionType() == "tcp")
-        tcpUserCount++;
+        tcpUserCount.ref();
 
     if (client->getConnectionType() == "websocket")
-        webSocketUserCount++;
+        webSocketUserCount.ref();
 
-    QWriteLocker locker(&clientsLock);
+    QMutexLocker locker(&clientsMutex);
     clients << client;
 }
 
 void Server::removeClient(Server_ProtocolHandler *client)
 {
-    int clientIndex = clients.indexOf(client);
-    if (clientIndex == -1) {
+    clientsMutex.lock();
+    const bool clientRemoved = clients.removeOne(client);
+    const int clientCount = clients.size();
+    clientsMutex.unlock();
+    if (!clientRemoved) {
         qWarning() << "tried to remove non existing client";
         return;
     }
 
     if (client->getConnectionType() == "tcp")
-        tcpUserCount--;
+        tcpUserCount.deref();
 
     if (client->getConnectionType() == "websocket")
-        webSocketUserCount--;
+        webSocketUserCount.deref();
 
-    QWriteLocker locker(&clientsLock);
-    clients.removeAt(clientIndex);
     ServerInfo_User *data = client->getUserInfo();
     if (data) {
-        Event_UserLeft event;
-        event.set_name(data->name());
-        SessionEvent *se = Server_ProtocolHandler::prepareSessionEvent(event);
-        for (auto &_client : clients)
-            if (_client->getAcceptsUserListChanges())
-                _client->sendProtocolItem(*se);
-        sendIsl_SessionEvent(*se);
-        delete se;
-
-        users.remove(QString::fromStdString(data->name()));
+        // A newer session of the same user may already have replaced this one
+        users.remove(QString::fromStdString(data->name()), client);
+        usersCount.deref();
+        if (isModerator(*data)) {
+            moderatorsCount.deref();
+            QMutexLocker moderatorsLocker(&onlineModeratorsMutex);
+            onlineModerators.removeOne(QString::fromStdString(data->name()).simplified());
+        }
         qDebug() << "Server::removeClient: name=" << QString::fromStdString(data->name());
 
         if (data->has_session_id()) {
             const qint64 sessionId = data->session_id();
             usersBySessionId.remove(sessionId);
-            emit endSession(sessionId);
+            // A suspended session keeps the database session open until it is resumed or expires
+            if (!client->isSuspended())
+                emit endSession(sessionId);
             qDebug() << "closed session id:" << sessionId;
         }
+
+        Event_UserLeft event;
+        event.set_name(data->name());
+        SessionEvent *se = Server_ProtocolHandler::prepareSessionEvent(event);
+        {
+            RcuReadLocker locker(&clientsRcu);
+            for (auto &_client : getClients())
+                if (_client->getAcceptsUserListChanges())
+                    _client->sendProtocolItem(*se);
+        }
+        sendIsl_SessionEvent(*se);
+        delete se;
     }
-    qDebug() << "Server::removeClient: removed" << (void *)client << ";" << clients.size() << "clients; "
+
+    // The client is unreachable now; wait for readers that looked it up earlier before it may be deleted.
+    clientsRcu.synchronize();
+
+    qDebug() << "Server::removeClient: removed" << (void *)client << ";" << clientCount << "clients; "
              << users.size() << "users left";
 }
 
-QList<QString> Server::getOnlineModeratorList() const
+bool Server::isModerator(const ServerInfo_User &userInfo)
 {
-    // clients list should be locked by calling function prior to iteration otherwise sigfaults may occur
-    QList<QString> results;
-    for (auto &client : clients) {
-        ServerInfo_User *data = client->getUserInfo();
+    // TODO: this line should be updated in the event there is any type of new user level created
+    return userInfo.user_level() & ServerInfo_User::IsModerator || userInfo.user_level() & ServerInfo_User::IsAdmin;
+}
 
-        // TODO: this line should be updated in the event there is any type of new user level created
-        if (data &&
-            (data->user_level() & ServerInfo_User::IsModerator || data->user_level() & ServerInfo_User::IsAdmin))
-            results << QString::fromStdString(data->name()).simplified();
-    }
-    return results;
+QList<QString> Server::getOnlineModeratorList() const
+{
+    // The list is maintained in loginUser() and removeClient(), no read section needed
+    QMutexLocker locker(&onlineModeratorsMutex);
+    return onlineModerators;
 }
 
 void Server::externalUserJoined(const ServerInfo_User &userInfo)
 {
     // This function is always called from the main thread via signal/slot.
-    clientsLock.lockForWrite();
-
     Server_RemoteUserInterface *newUser = new Server_RemoteUserInterface(this, ServerInfo_User_Container(userInfo));
     externalUsers.insert(QString::fromStdString(userInfo.name()), newUser);
     externalUsersBySessionId.insert(userInfo.session_id(), newUser);
@@ -296,11 +403,13 @@ void Server::externalUserJoined(const ServerInfo_User &userInfo)
     event.mutable_user_info()->CopyFrom(userInfo);
 
     SessionEvent *se = Server_ProtocolHandler::prepareSessionEvent(event);
-    for (auto &client : clients)
-        if (client->getAcceptsUserListChanges())
-            client->sendProtocolItem(*se);
+    {
+        RcuReadLocker locker(&clientsRcu);
+        for (auto &client : getClients())
+            if (client->getAcceptsUserListChanges())
+                client->sendProtocolItem(*se);
+    }
     delete se;
-    clientsLock.unlock();
 
     ResponseContainer rc(-1);
     newUser->joinPersistentGames(rc);
@@ -311,10 +420,10 @@ void Server::externalUserLeft(const QString &userName)
 {
     // This function is always called from the main thread via signal/slot.
 
-    clientsLock.lockForWrite();
     Server_AbstractUserInterface *user = externalUsers.take(userName);
+    if (!user)
+        return;
     externalUsersBySessionId.remove(user->getUserInfo()->session_id());
-    clientsLock.unlock();
 
     QMap<int, QPair<int, int>> userGames(user->getGames());
     QMapIterator<int, QPair<int, int>> userGamesIterator(userGames);
@@ -339,17 +448,19 @@ void Server::externalUserLeft(const QString &userName)
     }
     roomsLock.unlock();
 
+    clientsRcu.synchronize();
     delete user;
 
     Event_UserLeft event;
     event.set_name(userName.toStdString());
 
     SessionEvent *se = Server_ProtocolHandler::prepareSessionEvent(event);
-    clientsLock.lockForRead();
-    for (auto &client : clients)
-        if (client->getAcceptsUserListChanges())
-            client->sendProtocolItem(*se);
-    clientsLock.unlock();
+    {
+        RcuReadLocker locker(&clientsRcu);
+        for (auto &client : getClients())
+            if (client->getAcceptsUserListChanges())
+                client->sendProtocolItem(*se);
+    }
     delete se;
 }
 
@@ -431,7 +542,7 @@ void Server::externalJoinGameCommandReceived(const Command_JoinGame &cmd,
 
     try {
         QReadLocker roomsLocker(&roomsLock);
-        QReadLocker clientsLocker(&clientsLock);
+        RcuReadLocker clientsLocker(&clientsRcu);
 
         Server_Room *room = rooms.value(roomId);
         if (!room) {
@@ -518,7 +629,7 @@ void Server::externalGameEventContainerReceived(const GameEventContainer &cont,
 {
     // This function is always called from the main thread via signal/slot.
 
-    QReadLocker usersLocker(&clientsLock);
+    RcuReadLocker usersLocker(&clientsRcu);
 
     Server_ProtocolHandler *client = usersBySessionId.value(sessionId);
     if (!client) {
@@ -532,7 +643,7 @@ void Server::externalResponseReceived(const Response &resp, qint64 sessionId)
 {
     // This function is always called from the main thread via signal/slot.
 
-    QReadLocker usersLocker(&clientsLock);
+    RcuReadLocker usersLocker(&clientsRcu);
 
     Server_ProtocolHandler *client = usersBySessionId.value(sessionId);
     if (!client) {
@@ -551,11 +662,12 @@ void Server::broadcastRoomUpdate(const ServerInfo_Room &roomInfo, bool sendToIsl
 
     SessionEvent *se = Server_ProtocolHandler::prepareSessionEvent(event);
 
-    clientsLock.lockForRead();
-    for (auto &client : clients)
-        if (client->getAcceptsRoomListChanges())
-            client->sendProtocolItem(*se);
-    clientsLock.unlock();
+    {
+        RcuReadLocker locker(&clientsRcu);
+        for (auto &client : getClients())
+            if (client->getAcceptsRoomListChanges())
+                client->sendProtocolItem(*se);
+    }
 
     if (sendToIsl)
         sendIsl_SessionEvent(*se);
@@ -572,25 +684,6 @@ void Server::addRoom(Server_Room *newRoom)
             Qt::QueuedConnection);
 }
 
-int Server::getUsersCount() const
-{
-    QReadLocker locker(&clientsLock);
-    return users.size();
-}
-
-int Server::getGamesCount() const
-{
-    int result = 0;
-    QReadLocker locker(&roomsLock);
-    QMapIterator<int, Server_Room *> roomIterator(rooms);
-    while (roomIterator.hasNext()) {
-        Server_Room *room = roomIterator.next().value();
-        QReadLocker roomLocker(&room->gamesLock);
-        result += room->getGames().size();
-    }
-    return result;
-}
-
 void Server::sendIsl_Response(const Response &item, int serverId, qint64 sessionId)
 {
     IslMessage msg;
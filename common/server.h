@@ -6,8 +6,11 @@
 #include "pb/serverinfo_chat_message.pb.h"
 #include "pb/serverinfo_user.pb.h"
 #include "pb/serverinfo_warning.pb.h"
+#include "rcu_domain.h"
 #include "server_player_reference.h"
+#include "sharded_hash.h"
 
+#include <QAtomicInt>
 #include <QMap>
 #include <QMultiMap>
 #include <QMutex>
@@ -20,6 +23,7 @@ class Server_Game;
 class Server_Room;
 class Server_ProtocolHandler;
 class Server_AbstractUserInterface;
+class Server_SuspendedSession;
 class GameReplay;
 class IslMessage;
 class SessionEvent;
@@ -54,9 +58,15 @@ signals:
     void endSession(qint64 sessionId);
 private slots:
     void broadcastRoomUpdate(const ServerInfo_Room &roomInfo, bool sendToIsl = false);
+    void expireSuspendedSessions();
 
 public:
-    mutable QReadWriteLock clientsLock, roomsLock; // locking order: roomsLock before clientsLock
+    // Rooms are only added at startup and removed at shutdown, so roomsLock is effectively uncontended.
+    mutable QReadWriteLock roomsLock;
+    // Users and clients are looked up without a global lock. Any pointer obtained from getUsers(),
+    // getUsersBySessionId(), getExternalUsers(), getClients() or findUser() is only guaranteed to stay
+    // valid inside a read section on clientsRcu; removal waits for those sections to end.
+    mutable RcuDomain clientsRcu;
     explicit Server(QObject *parent = nullptr);
     virtual ~Server() = default;
     AuthenticationResult loginUser(Server_ProtocolHandler *session,
@@ -69,20 +79,37 @@ public:
                                    QString &clientVersion,
                                    QString &connectionType);
 
+    // Suspended sessions keep the games of a registered user whose connection dropped until it is resumed
+    void addSuspendedSession(Server_SuspendedSession *suspendedSession);
+    // Removes and returns the matching suspended session, the caller takes ownership
+    Server_SuspendedSession *takeSuspendedSession(const QString &userName, const QString &resumeToken);
+    // Ends a suspended session that can't be resumed after all
+    void releaseSuspendedSession(Server_SuspendedSession *suspendedSession);
+    // Ends the suspended session of a user if there is one, e.g. after the user got banned
+    void discardSuspendedSession(const QString &userName);
+    // Makes a session with complete user info visible to lookups and announces the user
+    void publishUser(Server_ProtocolHandler *session);
+
     const QMap<int, Server_Room *> &getRooms()
     {
         return rooms;
     }
 
     Server_AbstractUserInterface *findUser(const QString &userName) const;
-    const QMap<QString, Server_ProtocolHandler *> &getUsers() const
+    const ShardedHash<QString, Server_ProtocolHandler *> &getUsers() const
     {
         return users;
     }
-    const QMap<qint64, Server_ProtocolHandler *> &getUsersBySessionId() const
+    const ShardedHash<qint64, Server_ProtocolHandler *> &getUsersBySessionId() const
     {
         return usersBySessionId;
     }
+    // Returns a snapshot; writers copy the list on modification so iterating it never blocks them
+    QList<Server_ProtocolHandler *> getClients() const
+    {
+        QMutexLocker locker(&clientsMutex);
+        return clients;
+    }
     virtual QMap<QString, bool> getServerRequiredFeatureList() const
     {
         return QMap<QString, bool>();
@@ -178,6 +205,21 @@ public:
     {
         return false;
     }
+    // Game list changes of a room are coalesced and sent as one delta frame per interval (ms); 0 sends immediately
+    virtual int getGameListUpdateInterval() const
+    {
+        return 250;
+    }
+    // Seconds a dropped session can be resumed for; 0 disables session resuming
+    virtual int getSessionResumeTimeout() const
+    {
+        return 0;
+    }
+    // Game events kept for a session until the client acknowledges them
+    virtual int getSessionResumeBufferSize() const
+    {
+        return 256;
+    }
 
     Server_DatabaseInterface *getDatabaseInterface() const;
     int getNextLocalGameId()
@@ -193,7 +235,7 @@ public:
     void sendIsl_GameCommand(const CommandContainer &item, int serverId, qint64 sessionId, int roomId, int playerId);
     void sendIsl_RoomCommand(const CommandContainer &item, int serverId, qint64 sessionId, int roomId);
 
-    const QMap<QString, Server_AbstractUserInterface *> &getExternalUsers() const
+    const ShardedHash<QString, Server_AbstractUserInterface *> &getExternalUsers() const
     {
         return externalUsers;
     }
@@ -201,22 +243,49 @@ public:
     void addPersistentPlayer(const QString &userName, int roomId, int gameId, int playerId);
     void removePersistentPlayer(const QString &userName, int roomId, int gameId, int playerId);
     QList<PlayerReference> getPersistentPlayerReferences(const QString &userName) const;
-    int getUsersCount() const;
-    int getGamesCount() const;
+
+    // The following counters are maintained when clients, users and games are added or removed,
+    // so they can be read at any time without holding any lock.
+    int getUsersCount() const
+    {
+        return usersCount.loadAcquire();
+    }
+    int getModeratorsCount() const
+    {
+        return moderatorsCount.loadAcquire();
+    }
+    int getGamesCount() const
+    {
+        return gamesCount.loadAcquire();
+    }
     int getTCPUserCount() const
     {
-        return tcpUserCount;
+        return tcpUserCount.loadAcquire();
     }
     int getWebSocketUserCount() const
     {
-        return webSocketUserCount;
+        return webSocketUserCount.loadAcquire();
+    }
+    void incGamesCount()
+    {
+        gamesCount.ref();
+    }
+    void decGamesCount()
+    {
+        gamesCount.deref();
     }
 
 private:
     QMultiMap<QString, PlayerReference> persistentPlayers;
     mutable QReadWriteLock persistentPlayersLock;
-    int nextLocalGameId, tcpUserCount, webSocketUserCount;
+    int nextLocalGameId;
     QMutex nextLocalGameIdMutex;
+    QAtomicInt usersCount, moderatorsCount, gamesCount, tcpUserCount, webSocketUserCount;
+    QStringList onlineModerators;
+    mutable QMutex onlineModeratorsMutex;
+    QMap<QString, Server_SuspendedSession *> suspendedSessions;
+    mutable QMutex suspendedSessionsMutex;
+    static bool isModerator(const ServerInfo_User &userInfo);
 
 protected slots:
     void externalUserJoined(const ServerInfo_User &userInfo);
@@ -241,10 +310,11 @@ protected:
     void prepareDestroy();
     void setDatabaseInterface(Server_DatabaseInterface *_databaseInterface);
     QList<Server_ProtocolHandler *> clients;
-    QMap<qint64, Server_ProtocolHandler *> usersBySessionId;
-    QMap<QString, Server_ProtocolHandler *> users;
-    QMap<qint64, Server_AbstractUserInterface *> externalUsersBySessionId;
-    QMap<QString, Server_AbstractUserInterface *> externalUsers;
+    mutable QMutex clientsMutex;
+    ShardedHash<qint64, Server_ProtocolHandler *> usersBySessionId;
+    ShardedHash<QString, Server_ProtocolHandler *> users;
+    ShardedHash<qint64, Server_AbstractUserInterface *> externalUsersBySessionId;
+    ShardedHash<QString, Server_AbstractUserInterface *> externalUsers;
     QMap<int, Server_Room *> rooms;
     QMap<QThread *, Server_DatabaseInterface *> databaseInterfaces;
     void addRoom(Server_Room *newRoom);
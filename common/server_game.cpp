@@ -162,13 +162,14 @@ void Server_Game::storeGameInformation()
 
     SessionEvent *sessionEvent = Server_ProtocolHandler::prepareSessionEvent(replayEvent);
     Server *server = room->getServer();
-    server->clientsLock.lockForRead();
-    for (auto userName : allPlayersEver + allSpectatorsEver) {
-        Server_AbstractUserInterface *userHandler = server->findUser(userName);
-        if (userHandler && server->getStoreReplaysEnabled())
-            userHandler->sendProtocolItem(*sessionEvent);
+    {
+        RcuReadLocker clientsLocker(&server->clientsRcu);
+        for (auto userName : allPlayersEver + allSpectatorsEver) {
+            Server_AbstractUserInterface *userHandler = server->findUser(userName);
+            if (userHandler && server->getStoreReplaysEnabled())
+                userHandler->sendProtocolItem(*sessionEvent);
+        }
     }
-    server->clientsLock.unlock();
     delete sessionEvent;
 
     if (server->getStoreReplaysEnabled()) {
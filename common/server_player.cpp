@@ -2371,7 +2371,8 @@ void Server_Player::setUserInterface(Server_AbstractUserInterface *_userInterfac
     userInterface = _userInterface;
     playerMutex.unlock();
 
-    pingTime = _userInterface ? 0 : -1;
+    // A suspended session stands in for the user but doesn't count as connected
+    pingTime = (_userInterface && _userInterface->getLastCommandTime() != -1) ? 0 : -1;
 
     Event_PlayerPropertiesChanged event;
     event.mutable_player_properties()->set_ping_seconds(pingTime);
@@ -2382,13 +2383,18 @@ void Server_Player::setUserInterface(Server_AbstractUserInterface *_userInterfac
     ges.sendToGame(game);
 }
 
-void Server_Player::disconnectClient()
+/**
+ * Returns false if the player was removed from the game. Otherwise the player stays in the game, bound to standIn
+ * if the session can still be resumed.
+ */
+bool Server_Player::disconnectClient(Server_AbstractUserInterface *standIn)
 {
     if (!(userInfo->user_level() & ServerInfo_User::IsRegistered) || spectator) {
         game->removePlayer(this, Event_Leave::USER_DISCONNECTED);
-    } else {
-        setUserInterface(nullptr);
+        return false;
     }
+    setUserInterface(standIn);
+    return true;
 }
 
 void Server_Player::getInfo(ServerInfo_Player *info,
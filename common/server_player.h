@@ -100,7 +100,7 @@ public:
         return userInterface;
     }
     void setUserInterface(Server_AbstractUserInterface *_userInterface);
-    void disconnectClient();
+    bool disconnectClient(Server_AbstractUserInterface *standIn = nullptr);
 
     bool getReadyStart() const
     {
@@ -3,6 +3,7 @@
 #include "debug_pb_message.h"
 #include "featureset.h"
 #include "get_pb_extension.h"
+#include "passwordhasher.h"
 #include "pb/commands.pb.h"
 #include "pb/event_game_joined.pb.h"
 #include "pb/event_list_rooms.pb.h"
@@ -16,10 +17,12 @@
 #include "pb/response_join_room.pb.h"
 #include "pb/response_list_users.pb.h"
 #include "pb/response_login.pb.h"
+#include "pb/response_resume_session.pb.h"
 #include "pb/serverinfo_user.pb.h"
 #include "server_database_interface.h"
 #include "server_game.h"
 #include "server_player.h"
+#include "server_resumable_session.h"
 #include "server_room.h"
 #include "trice_limits.h"
 
@@ -33,7 +36,8 @@ Server_ProtocolHandler::Server_ProtocolHandler(Server *_server,
                                                QObject *parent)
     : QObject(parent), Server_AbstractUserInterface(_server), deleted(false), databaseInterface(_databaseInterface),
       authState(NotLoggedIn), usingRealPassword(false), acceptsUserListChanges(false), acceptsRoomListChanges(false),
-      idleClientWarningSent(false), timeRunning(0), lastDataReceived(0), lastActionReceived(0)
+      acceptsMessageFragments(false), idleClientWarningSent(false), suspendedSession(nullptr), timeRunning(0),
+      lastDataReceived(0), lastActionReceived(0)
 
 {
     connect(server, SIGNAL(pingClockTimeout()), this, SLOT(pingClockTimeout()));
@@ -45,7 +49,7 @@ Server_ProtocolHandler::~Server_ProtocolHandler()
 
 // This function must only be called from the thread this object lives in.
 // Except when the server is shutting down.
-// The thread must not hold any server locks when calling this (e.g. clientsLock, roomsLock).
+// The thread must not hold any server locks when calling this (e.g. roomsLock) nor be inside a clientsRcu read section.
 void Server_ProtocolHandler::prepareDestroy()
 {
     if (deleted)
@@ -80,18 +84,38 @@ void Server_ProtocolHandler::prepareDestroy()
             continue;
         }
 
-        p->disconnectClient();
+        if (p->disconnectClient(suspendedSession) && suspendedSession)
+            suspendedSession->playerAddedToGame(gameIterator.key(), gameIterator.value().first,
+                                                gameIterator.value().second);
 
         game->gameMutex.unlock();
         room->gamesLock.unlock();
     }
     server->roomsLock.unlock();
 
+    if (eventLog)
+        eventLog->detach();
+
     server->removeClient(this);
+    // Only now, so that a resuming session can't be published before this one is gone
+    if (suspendedSession)
+        server->addSuspendedSession(suspendedSession);
 
     deleteLater();
 }
 
+void Server_ProtocolHandler::connectionLost()
+{
+    if (deleted)
+        return;
+
+    if (!resumeToken.isEmpty() && userInfo && server->getSessionResumeTimeout() > 0) {
+        const qint64 expiresAt = QDateTime::currentMSecsSinceEpoch() + server->getSessionResumeTimeout() * 1000LL;
+        suspendedSession = new Server_SuspendedSession(server, *this, resumeToken, eventLog, expiresAt);
+    }
+    prepareDestroy();
+}
+
 void Server_ProtocolHandler::sendProtocolItem(const Response &item)
 {
     ServerMessage msg;
@@ -116,7 +140,10 @@ void Server_ProtocolHandler::sendProtocolItem(const GameEventContainer &item)
     msg.mutable_game_event_container()->CopyFrom(item);
     msg.set_message_type(ServerMessage::GAME_EVENT_CONTAINER);
 
-    transmitProtocolItem(msg);
+    if (eventLog)
+        eventLog->send(msg);
+    else
+        transmitProtocolItem(msg);
 }
 
 void Server_ProtocolHandler::sendProtocolItem(const RoomEvent &item)
@@ -146,6 +173,9 @@ Response::ResponseCode Server_ProtocolHandler::processSessionCommandContainer(co
             case SessionCommand::LOGIN:
                 resp = cmdLogin(sc.GetExtension(Command_Login::ext), rc);
                 break;
+            case SessionCommand::RESUME_SESSION:
+                resp = cmdResumeSession(sc.GetExtension(Command_ResumeSession::ext), rc);
+                break;
             case SessionCommand::MESSAGE:
                 resp = cmdMessage(sc.GetExtension(Command_Message::ext), rc);
                 break;
@@ -404,7 +434,7 @@ void Server_ProtocolHandler::pingClockTimeout()
     }
 
     if (timeRunning - lastDataReceived > server->getMaxPlayerInactivityTime())
-        prepareDestroy();
+        connectionLost();
 
     if (!userInfo || QString::fromStdString(userInfo->privlevel()).toLower() == "none") {
         if ((server->getIdleClientTimeout() > 0) && (idleClientWarningSent)) {
@@ -427,8 +457,10 @@ void Server_ProtocolHandler::pingClockTimeout()
     ++timeRunning;
 }
 
-Response::ResponseCode Server_ProtocolHandler::cmdPing(const Command_Ping & /*cmd*/, ResponseContainer & /*rc*/)
+Response::ResponseCode Server_ProtocolHandler::cmdPing(const Command_Ping &cmd, ResponseContainer & /*rc*/)
 {
+    if (eventLog && cmd.has_last_seq_num())
+        eventLog->acknowledge(cmd.last_seq_num());
     return Response::RespOk;
 }
 
@@ -464,6 +496,8 @@ Response::ResponseCode Server_ProtocolHandler::cmdLogin(const Command_Login &cmd
         receivedClientFeatures.insert(nameFromStdString(cmd.clientfeatures(i)).simplified(), false);
     }
 
+    acceptsMessageFragments = receivedClientFeatures.contains("message_fragments");
+
     missingClientFeatures =
         features.identifyMissingFeatures(receivedClientFeatures, server->getServerRequiredFeatureList());
 
@@ -550,18 +584,78 @@ Response::ResponseCode Server_ProtocolHandler::cmdLogin(const Command_Login &cmd
             re->add_missing_features(i.key().toStdString().c_str());
     }
 
+    // Game events are only logged from here on, so they can be replayed if the connection drops
+    if (authState == PasswordRight && receivedClientFeatures.contains("session_resume") &&
+        server->getSessionResumeTimeout() > 0) {
+        resumeToken = PasswordHasher::generateSessionToken();
+        eventLog = QSharedPointer<Server_GameEventLog>(new Server_GameEventLog(server->getSessionResumeBufferSize()));
+        eventLog->attach(this, 0);
+        re->set_resume_token(resumeToken.toStdString());
+        re->set_resume_timeout(static_cast<quint32>(server->getSessionResumeTimeout()));
+    }
+
     joinPersistentGames(rc);
     databaseInterface->removeForgotPassword(userName);
     rc.setResponseExtension(re);
     return Response::RespOk;
 }
 
+Response::ResponseCode Server_ProtocolHandler::cmdResumeSession(const Command_ResumeSession &cmd,
+                                                                ResponseContainer &rc)
+{
+    if (userInfo != 0)
+        return Response::RespContextError;
+
+    const QString userName = nameFromStdString(cmd.user_name());
+    const QString token = QString::fromStdString(cmd.resume_token());
+    if (token.isEmpty())
+        return Response::RespLoginNeeded;
+
+    Server_SuspendedSession *suspended = server->takeSuspendedSession(userName, token);
+    if (!suspended)
+        return Response::RespLoginNeeded;
+
+    // Bans placed while the connection was down, or on the address the client now comes from, still apply
+    QString banReason;
+    int banSecondsRemaining = 0;
+    const QString clientId = QString::fromStdString(suspended->getUserInfo()->clientid());
+    if (databaseInterface->checkUserIsBanned(getAddress(), userName, clientId, banReason, banSecondsRemaining)) {
+        server->releaseSuspendedSession(suspended);
+        return Response::RespUserIsBanned;
+    }
+
+    // The user is already authenticated and has a database session, so no further queries are needed here
+    QSharedPointer<Server_GameEventLog> log = suspended->getEventLog();
+    if (!log->attach(this, cmd.last_seq_num())) {
+        // Some of the missed events are gone, the client has to log in again and get a fresh game state
+        server->releaseSuspendedSession(suspended);
+        return Response::RespLoginNeeded;
+    }
+
+    setUserInfo(*suspended->getUserInfo());
+    userInfo->set_address(getAddress().toStdString());
+    // A token is only good for one resume, the next one needs the token handed out here
+    resumeToken = PasswordHasher::generateSessionToken();
+    eventLog = log;
+    authState = PasswordRight;
+    usingRealPassword = false;
+
+    server->publishUser(this);
+    suspended->handOverPlayers(this);
+    delete suspended;
+
+    Response_ResumeSession *re = new Response_ResumeSession;
+    re->set_resume_token(resumeToken.toStdString());
+    rc.setResponseExtension(re);
+    return Response::RespOk;
+}
+
 Response::ResponseCode Server_ProtocolHandler::cmdMessage(const Command_Message &cmd, ResponseContainer &rc)
 {
     if (authState == NotLoggedIn)
         return Response::RespLoginNeeded;
 
-    QReadLocker locker(&server->clientsLock);
+    RcuReadLocker locker(&server->clientsRcu);
 
     QString receiver = nameFromStdString(cmd.user_name());
     Server_AbstractUserInterface *userInterface = server->findUser(receiver);
@@ -630,7 +724,7 @@ Response::ResponseCode Server_ProtocolHandler::cmdGetUserInfo(const Command_GetU
         re->mutable_user_info()->CopyFrom(*userInfo);
     else {
 
-        QReadLocker locker(&server->clientsLock);
+        RcuReadLocker locker(&server->clientsRcu);
 
         ServerInfo_User_Container *infoSource = server->findUser(userName);
         if (!infoSource) {
@@ -711,16 +805,15 @@ Response::ResponseCode Server_ProtocolHandler::cmdListUsers(const Command_ListUs
         return Response::RespLoginNeeded;
 
     Response_ListUsers *re = new Response_ListUsers;
-    server->clientsLock.lockForRead();
-    QMapIterator<QString, Server_ProtocolHandler *> userIterator = server->getUsers();
-    while (userIterator.hasNext())
-        re->add_user_list()->CopyFrom(userIterator.next().value()->copyUserInfo(false));
-    QMapIterator<QString, Server_AbstractUserInterface *> extIterator = server->getExternalUsers();
-    while (extIterator.hasNext())
-        re->add_user_list()->CopyFrom(extIterator.next().value()->copyUserInfo(false));
 
+    // Subscribe before taking the snapshot: a user joining in between is reported twice rather than missed.
     acceptsUserListChanges = true;
-    server->clientsLock.unlock();
+
+    RcuReadLocker locker(&server->clientsRcu);
+    for (auto *user : server->getUsers().values())
+        re->add_user_list()->CopyFrom(user->copyUserInfo(false));
+    for (auto *user : server->getExternalUsers().values())
+        re->add_user_list()->CopyFrom(user->copyUserInfo(false));
 
     rc.setResponseExtension(re);
     return Response::RespOk;
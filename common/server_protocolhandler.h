@@ -8,6 +8,7 @@
 
 #include <QObject>
 #include <QPair>
+#include <QSharedPointer>
 
 class Features;
 class Server_DatabaseInterface;
@@ -16,6 +17,8 @@ class ServerInfo_User;
 class Server_Room;
 class QTimer;
 class FeatureSet;
+class Server_GameEventLog;
+class Server_SuspendedSession;
 
 class ServerMessage;
 class Response;
@@ -31,6 +34,7 @@ class AdminCommand;
 
 class Command_Ping;
 class Command_Login;
+class Command_ResumeSession;
 class Command_Register;
 class Command_Message;
 class Command_ListUsers;
@@ -55,7 +59,11 @@ protected:
     bool usingRealPassword;
     bool acceptsUserListChanges;
     bool acceptsRoomListChanges;
+    bool acceptsMessageFragments;
     bool idleClientWarningSent;
+    QString resumeToken;
+    QSharedPointer<Server_GameEventLog> eventLog;
+    Server_SuspendedSession *suspendedSession;
     virtual void logDebugMessage(const QString & /* message */)
     {
     }
@@ -68,6 +76,7 @@ private:
 
     Response::ResponseCode cmdPing(const Command_Ping &cmd, ResponseContainer &rc);
     Response::ResponseCode cmdLogin(const Command_Login &cmd, ResponseContainer &rc);
+    Response::ResponseCode cmdResumeSession(const Command_ResumeSession &cmd, ResponseContainer &rc);
     Response::ResponseCode cmdMessage(const Command_Message &cmd, ResponseContainer &rc);
     Response::ResponseCode cmdGetGamesOfUser(const Command_GetGamesOfUser &cmd, ResponseContainer &rc);
     Response::ResponseCode cmdGetUserInfo(const Command_GetUserInfo &cmd, ResponseContainer &rc);
@@ -105,6 +114,8 @@ private slots:
     void pingClockTimeout();
 public slots:
     void prepareDestroy();
+    // Like prepareDestroy(), but leaves the session resumable if the client supports it
+    void connectionLost();
 
 public:
     Server_ProtocolHandler(Server *_server, Server_DatabaseInterface *_databaseInterface, QObject *parent = 0);
@@ -118,6 +129,10 @@ public:
     {
         return acceptsRoomListChanges;
     }
+    bool isSuspended() const
+    {
+        return suspendedSession != nullptr;
+    }
     virtual QString getAddress() const = 0;
     virtual QString getConnectionType() const = 0;
     Server_DatabaseInterface *getDatabaseInterface() const
@@ -136,6 +151,11 @@ public:
     void sendProtocolItem(const SessionEvent &item);
     void sendProtocolItem(const GameEventContainer &item);
     void sendProtocolItem(const RoomEvent &item);
+    // Used by the game event log, which has already numbered the item
+    void transmitLoggedItem(const ServerMessage &item)
+    {
+        transmitProtocolItem(item);
+    }
 };
 
 #endif
@@ -0,0 +1,101 @@
+#include "server_resumable_session.h"
+
+#include "server.h"
+#include "server_game.h"
+#include "server_player.h"
+#include "server_protocolhandler.h"
+#include "server_room.h"
+
+Server_GameEventLog::Server_GameEventLog(int _maxSize) : target(nullptr), lastSeqNum(0), maxSize(_maxSize)
+{
+}
+
+void Server_GameEventLog::send(ServerMessage &item)
+{
+    // Numbering and transmitting under the same lock keeps the client's stream in sequence order
+    QMutexLocker locker(&mutex);
+    item.set_seq_num(++lastSeqNum);
+    entries.append(item);
+    while (entries.size() > maxSize)
+        entries.removeFirst();
+
+    if (target)
+        target->transmitLoggedItem(item);
+}
+
+void Server_GameEventLog::acknowledge(quint64 seqNum)
+{
+    QMutexLocker locker(&mutex);
+    while (!entries.isEmpty() && entries.first().seq_num() <= seqNum)
+        entries.removeFirst();
+}
+
+bool Server_GameEventLog::attach(Server_ProtocolHandler *_target, quint64 lastReceivedSeqNum)
+{
+    QMutexLocker locker(&mutex);
+    if (lastReceivedSeqNum > lastSeqNum)
+        return false;
+    const quint64 firstKept = entries.isEmpty() ? lastSeqNum + 1 : entries.first().seq_num();
+    if (firstKept > lastReceivedSeqNum + 1)
+        return false;
+
+    target = _target;
+    for (const ServerMessage &item : entries)
+        if (item.seq_num() > lastReceivedSeqNum)
+            target->transmitLoggedItem(item);
+    return true;
+}
+
+void Server_GameEventLog::detach()
+{
+    QMutexLocker locker(&mutex);
+    target = nullptr;
+}
+
+Server_SuspendedSession::Server_SuspendedSession(Server *_server,
+                                                 const ServerInfo_User_Container &_userInfoContainer,
+                                                 const QString &_resumeToken,
+                                                 QSharedPointer<Server_GameEventLog> _eventLog,
+                                                 qint64 _expiresAt)
+    : Server_AbstractUserInterface(_server, _userInfoContainer), resumeToken(_resumeToken), eventLog(_eventLog),
+      expiresAt(_expiresAt)
+{
+}
+
+void Server_SuspendedSession::sendProtocolItem(const GameEventContainer &item)
+{
+    ServerMessage msg;
+    msg.mutable_game_event_container()->CopyFrom(item);
+    msg.set_message_type(ServerMessage::GAME_EVENT_CONTAINER);
+
+    eventLog->send(msg);
+}
+
+void Server_SuspendedSession::handOverPlayers(Server_AbstractUserInterface *userInterface)
+{
+    QMapIterator<int, QPair<int, int>> gameIterator(getGames());
+
+    server->roomsLock.lockForRead();
+    while (gameIterator.hasNext()) {
+        gameIterator.next();
+
+        Server_Room *room = server->getRooms().value(gameIterator.value().first);
+        if (!room)
+            continue;
+        QReadLocker roomGamesLocker(&room->gamesLock);
+
+        Server_Game *game = room->getGames().value(gameIterator.key());
+        if (!game)
+            continue;
+        QMutexLocker gameLocker(&game->gameMutex);
+
+        Server_Player *player = game->getPlayers().value(gameIterator.value().second);
+        if (!player)
+            continue;
+
+        player->setUserInterface(userInterface);
+        if (userInterface)
+            userInterface->playerAddedToGame(game->getGameId(), room->getId(), player->getPlayerId());
+    }
+    server->roomsLock.unlock();
+}
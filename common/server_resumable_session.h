@@ -0,0 +1,95 @@
+#ifndef SERVER_RESUMABLE_SESSION_H
+#define SERVER_RESUMABLE_SESSION_H
+
+#include "pb/server_message.pb.h"
+#include "server_abstractuserinterface.h"
+
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+
+class Server_ProtocolHandler;
+
+/**
+ * Numbers the game events sent to one user and keeps those the client hasn't acknowledged yet.
+ *
+ * The log outlives a dropped connection: while the session is suspended, events are only recorded, and the
+ * session resuming it gets the missed events replayed before any new one. Thread safe.
+ */
+class Server_GameEventLog
+{
+private:
+    mutable QMutex mutex;
+    Server_ProtocolHandler *target;
+    QList<ServerMessage> entries;
+    quint64 lastSeqNum;
+    int maxSize;
+
+public:
+    explicit Server_GameEventLog(int _maxSize);
+
+    // Assigns the next sequence number to item, records it and transmits it to the attached session
+    void send(ServerMessage &item);
+    void acknowledge(quint64 seqNum);
+    // Replays everything after lastReceivedSeqNum to _target; fails if some of it has already been dropped
+    bool attach(Server_ProtocolHandler *_target, quint64 lastReceivedSeqNum);
+    void detach();
+};
+
+/**
+ * Stands in for a registered user whose connection dropped, until the client resumes the session or it expires.
+ * The user's players stay bound to it, so game events keep being recorded in the event log.
+ */
+class Server_SuspendedSession : public Server_AbstractUserInterface
+{
+private:
+    QString resumeToken;
+    QSharedPointer<Server_GameEventLog> eventLog;
+    qint64 expiresAt;
+
+public:
+    Server_SuspendedSession(Server *_server,
+                            const ServerInfo_User_Container &_userInfoContainer,
+                            const QString &_resumeToken,
+                            QSharedPointer<Server_GameEventLog> _eventLog,
+                            qint64 _expiresAt);
+
+    // The player shows up as disconnected to everyone else in the game
+    int getLastCommandTime() const
+    {
+        return -1;
+    }
+    bool addSaidMessageSize(int /*size*/)
+    {
+        return false;
+    }
+    const QString &getResumeToken() const
+    {
+        return resumeToken;
+    }
+    QSharedPointer<Server_GameEventLog> getEventLog() const
+    {
+        return eventLog;
+    }
+    qint64 getExpiresAt() const
+    {
+        return expiresAt;
+    }
+
+    // Binds the players of this session to the given interface (nullptr when the session expires)
+    void handOverPlayers(Server_AbstractUserInterface *userInterface);
+
+    // Only game events can be caught up on, everything else is refreshed by the client after resuming
+    void sendProtocolItem(const Response & /*item*/)
+    {
+    }
+    void sendProtocolItem(const SessionEvent & /*item*/)
+    {
+    }
+    void sendProtocolItem(const GameEventContainer &item);
+    void sendProtocolItem(const RoomEvent & /*item*/)
+    {
+    }
+};
+
+#endif
@@ -15,6 +15,7 @@
 
 #include <QDateTime>
 #include <QDebug>
+#include <QTimer>
 #include <google/protobuf/descriptor.h>
 
 Server_Room::Server_Room(int _id,
@@ -29,8 +30,14 @@ Server_Room::Server_Room(int _id,
                          Server *parent)
     : QObject(parent), id(_id), chatHistorySize(_chatHistorySize), name(_name), description(_description),
       permissionLevel(_permissionLevel), privilegeLevel(_privilegeLevel), autoJoin(_autoJoin),
-      joinMessage(_joinMessage), gameTypes(_gameTypes), gamesLock(QReadWriteLock::Recursive)
+      joinMessage(_joinMessage), gameTypes(_gameTypes), gamesCount(0), usersCount(0),
+      gamesLock(QReadWriteLock::Recursive)
 {
+    gameListUpdateTimer = new QTimer(this);
+    gameListUpdateTimer->setSingleShot(true);
+    gameListUpdateTimer->setInterval(parent->getGameListUpdateInterval());
+    connect(gameListUpdateTimer, SIGNAL(timeout()), this, SLOT(flushGameListUpdates()));
+
     connect(this, SIGNAL(gameListChanged(ServerInfo_Game)), this, SLOT(broadcastGameListUpdate(ServerInfo_Game)),
             Qt::QueuedConnection);
 }
@@ -145,7 +152,12 @@ void Server_Room::addClient(Server_ProtocolHandler *client)
     roomInfo.set_room_id(id);
 
     usersLock.lockForWrite();
-    users.insert(QString::fromStdString(client->getUserInfo()->name()), client);
+    const QString userName = QString::fromStdString(client->getUserInfo()->name());
+    // a user joining again replaces the old entry, which is already counted
+    if (!users.contains(userName))
+        usersCount.ref();
+    users.insert(userName, client);
+    usersJoinedSinceFlush.insert(userName);
     roomInfo.set_player_count(users.size() + externalUsers.size());
     usersLock.unlock();
 
@@ -161,7 +173,10 @@ void Server_Room::addClient(Server_ProtocolHandler *client)
 void Server_Room::removeClient(Server_ProtocolHandler *client)
 {
     usersLock.lockForWrite();
-    users.remove(QString::fromStdString(client->getUserInfo()->name()));
+    const QString userName = QString::fromStdString(client->getUserInfo()->name());
+    if (users.remove(userName))
+        usersCount.deref();
+    usersJoinedSinceFlush.remove(userName);
 
     ServerInfo_Room roomInfo;
     roomInfo.set_room_id(id);
@@ -341,9 +356,162 @@ void Server_Room::sendRoomEvent(RoomEvent *event, bool sendToIsl)
 
 void Server_Room::broadcastGameListUpdate(const ServerInfo_Game &gameInfo, bool sendToIsl)
 {
-    Event_ListGames event;
-    event.add_game_list()->CopyFrom(gameInfo);
-    sendRoomEvent(prepareRoomEvent(event), sendToIsl);
+    // This function is always called from the main thread, either via signal/slot or by updateExternalGameList.
+    // Only the latest state of each game is kept; flushGameListUpdates() sends what changed since the last frame.
+    pendingGameListUpdates.insert(gameInfo.game_id(), gameInfo);
+    if (sendToIsl)
+        pendingIslGameListUpdates.insert(gameInfo.game_id());
+
+    if (gameListUpdateTimer->interval() <= 0)
+        flushGameListUpdates();
+    else if (!gameListUpdateTimer->isActive())
+        gameListUpdateTimer->start();
+}
+
+void Server_Room::flushGameListUpdates()
+{
+    if (pendingGameListUpdates.isEmpty())
+        return;
+
+    Event_ListGames clientEvent, fullEvent, islEvent;
+    QMapIterator<int, ServerInfo_Game> pendingIterator(pendingGameListUpdates);
+    while (pendingIterator.hasNext()) {
+        pendingIterator.next();
+        const int gameId = pendingIterator.key();
+        const ServerInfo_Game &gameInfo = pendingIterator.value();
+
+        // Other servers keep full copies of our games, so they always get the complete info
+        if (pendingIslGameListUpdates.contains(gameId))
+            islEvent.add_game_list()->CopyFrom(gameInfo);
+        // Users that joined since the last frame may have seen a state that is neither the baseline nor the current
+        // one, so a delta against the baseline could miss a field that changed and changed back
+        fullEvent.add_game_list()->CopyFrom(gameInfo);
+
+        if (gameInfo.closed() || !gameInfo.has_player_count()) {
+            // Always announce removals: a user may have received the game in a room snapshot
+            // even though it was never part of a frame.
+            sentGameInfo.remove(gameId);
+            clientEvent.add_game_list()->CopyFrom(gameInfo);
+            continue;
+        }
+
+        auto sent = sentGameInfo.find(gameId);
+        if (sent == sentGameInfo.end()) {
+            clientEvent.add_game_list()->CopyFrom(gameInfo);
+            sentGameInfo.insert(gameId, gameInfo);
+        } else if (makeGameInfoDelta(sent.value(), gameInfo, *clientEvent.add_game_list())) {
+            sent.value() = gameInfo;
+        } else {
+            clientEvent.mutable_game_list()->RemoveLast();
+        }
+    }
+    pendingGameListUpdates.clear();
+    pendingIslGameListUpdates.clear();
+
+    RoomEvent *clientRoomEvent = prepareRoomEvent(clientEvent);
+    RoomEvent *fullRoomEvent = prepareRoomEvent(fullEvent);
+    usersLock.lockForWrite();
+    {
+        QMapIterator<QString, Server_ProtocolHandler *> userIterator(users);
+        while (userIterator.hasNext()) {
+            userIterator.next();
+            if (usersJoinedSinceFlush.contains(userIterator.key()))
+                userIterator.value()->sendProtocolItem(*fullRoomEvent);
+            else if (clientEvent.game_list_size() > 0)
+                userIterator.value()->sendProtocolItem(*clientRoomEvent);
+        }
+        usersJoinedSinceFlush.clear();
+    }
+    usersLock.unlock();
+    delete clientRoomEvent;
+    delete fullRoomEvent;
+
+    if (islEvent.game_list_size() > 0) {
+        RoomEvent *event = prepareRoomEvent(islEvent);
+        getServer()->sendIsl_RoomEvent(*event);
+        delete event;
+    }
+}
+
+/**
+ * Fills delta with the identifying fields of current plus every field that differs from previous.
+ * Clients apply it with MergeFrom, replacing repeated fields that are present.
+ * Returns false if nothing changed.
+ */
+bool Server_Room::makeGameInfoDelta(const ServerInfo_Game &previous,
+                                    const ServerInfo_Game &current,
+                                    ServerInfo_Game &delta)
+{
+    using google::protobuf::FieldDescriptor;
+    using google::protobuf::Reflection;
+
+    if (current.has_server_id())
+        delta.set_server_id(current.server_id());
+    delta.set_room_id(current.room_id());
+    delta.set_game_id(current.game_id());
+
+    const Reflection *reflection = current.GetReflection();
+    const google::protobuf::Descriptor *descriptor = current.GetDescriptor();
+    bool changed = false;
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+        const FieldDescriptor *field = descriptor->field(i);
+        if (field->is_repeated()) {
+            if (field->cpp_type() != FieldDescriptor::CPPTYPE_INT32) {
+                // Only game_types is repeated at the moment; anything else falls back to a full update
+                delta.CopyFrom(current);
+                return true;
+            }
+            const int size = reflection->FieldSize(current, field);
+            bool equal = size == reflection->FieldSize(previous, field);
+            for (int j = 0; equal && j < size; ++j)
+                equal = reflection->GetRepeatedInt32(current, field, j) ==
+                        reflection->GetRepeatedInt32(previous, field, j);
+            if (!equal) {
+                for (int j = 0; j < size; ++j)
+                    reflection->AddInt32(&delta, field, reflection->GetRepeatedInt32(current, field, j));
+                changed = true;
+            }
+            continue;
+        }
+        if (!reflection->HasField(current, field))
+            continue;
+
+        bool equal = reflection->HasField(previous, field);
+        switch (field->cpp_type()) {
+            case FieldDescriptor::CPPTYPE_INT32:
+                equal = equal && reflection->GetInt32(current, field) == reflection->GetInt32(previous, field);
+                if (!equal)
+                    reflection->SetInt32(&delta, field, reflection->GetInt32(current, field));
+                break;
+            case FieldDescriptor::CPPTYPE_UINT32:
+                equal = equal && reflection->GetUInt32(current, field) == reflection->GetUInt32(previous, field);
+                if (!equal)
+                    reflection->SetUInt32(&delta, field, reflection->GetUInt32(current, field));
+                break;
+            case FieldDescriptor::CPPTYPE_BOOL:
+                equal = equal && reflection->GetBool(current, field) == reflection->GetBool(previous, field);
+                if (!equal)
+                    reflection->SetBool(&delta, field, reflection->GetBool(current, field));
+                break;
+            case FieldDescriptor::CPPTYPE_STRING:
+                equal = equal && reflection->GetString(current, field) == reflection->GetString(previous, field);
+                if (!equal)
+                    reflection->SetString(&delta, field, reflection->GetString(current, field));
+                break;
+            case FieldDescriptor::CPPTYPE_MESSAGE:
+                equal = equal && reflection->GetMessage(current, field).SerializeAsString() ==
+                                     reflection->GetMessage(previous, field).SerializeAsString();
+                if (!equal)
+                    reflection->MutableMessage(&delta, field)->CopyFrom(reflection->GetMessage(current, field));
+                break;
+            default:
+                // ServerInfo_Game has no other field types; anything unexpected falls back to a full update
+                delta.CopyFrom(current);
+                return true;
+        }
+        changed = changed || !equal;
+    }
+    return changed;
 }
 
 void Server_Room::addGame(Server_Game *game)
@@ -356,6 +524,8 @@ void Server_Room::addGame(Server_Game *game)
 
     game->gameMutex.lock();
     games.insert(game->getGameId(), game);
+    gamesCount.ref();
+    getServer()->incGamesCount();
     ServerInfo_Game gameInfo;
     game->getInfo(gameInfo);
     roomInfo.set_game_count(games.size() + externalGames.size());
@@ -383,7 +553,10 @@ void Server_Room::removeGame(Server_Game *game)
     game->getInfo(gameInfo);
     emit gameListChanged(gameInfo);
 
-    games.remove(game->getGameId());
+    if (games.remove(game->getGameId())) {
+        gamesCount.deref();
+        getServer()->decGamesCount();
+    }
 
     ServerInfo_Room roomInfo;
     roomInfo.set_room_id(id);
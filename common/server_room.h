@@ -5,11 +5,13 @@
 #include "pb/serverinfo_chat_message.pb.h"
 #include "serverinfo_user_container.h"
 
+#include <QAtomicInt>
 #include <QList>
 #include <QMap>
 #include <QMutex>
 #include <QObject>
 #include <QReadWriteLock>
+#include <QSet>
 #include <QStringList>
 
 class Server_DatabaseInterface;
@@ -25,6 +27,8 @@ class Command_JoinGame;
 class ResponseContainer;
 class Server_AbstractUserInterface;
 
+class QTimer;
+
 class Server_Room : public QObject
 {
     Q_OBJECT
@@ -47,8 +51,21 @@ private:
     QMap<QString, Server_ProtocolHandler *> users;
     QMap<QString, ServerInfo_User_Container> externalUsers;
     QList<ServerInfo_ChatMessage> chatHistory;
+    QAtomicInt gamesCount, usersCount;
+
+    // Game list coalescing, only touched from the main thread
+    QTimer *gameListUpdateTimer;
+    QMap<int, ServerInfo_Game> pendingGameListUpdates;
+    QSet<int> pendingIslGameListUpdates;
+    QMap<int, ServerInfo_Game> sentGameInfo;
+    // Users that joined since the last frame and got a room snapshot newer than sentGameInfo, guarded by usersLock
+    QSet<QString> usersJoinedSinceFlush;
+    static bool makeGameInfoDelta(const ServerInfo_Game &previous,
+                                  const ServerInfo_Game &current,
+                                  ServerInfo_Game &delta);
 private slots:
     void broadcastGameListUpdate(const ServerInfo_Game &gameInfo, bool sendToIsl = true);
+    void flushGameListUpdates();
 
 public:
     mutable QReadWriteLock usersLock;
@@ -106,6 +123,15 @@ public:
     {
         return externalGames;
     }
+    // Local games and users of this room, readable without gamesLock or usersLock
+    int getGamesCount() const
+    {
+        return gamesCount.loadAcquire();
+    }
+    int getUsersCount() const
+    {
+        return usersCount.loadAcquire();
+    }
     Server *getServer() const;
     const ServerInfo_Room &
     getInfo(ServerInfo_Room &result, bool complete, bool showGameTypes = false, bool includeExternalData = true) const;
@@ -0,0 +1,126 @@
+#ifndef SHARDED_HASH_H
+#define SHARDED_HASH_H
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+
+/**
+ * A hash map split into a fixed number of independently locked shards.
+ *
+ * Keys are partitioned by qHash(), so writers only block readers that happen to look up a key in the same shard.
+ * Every method is thread safe; methods touching all shards (values(), toHash()) lock one shard at a time and
+ * therefore return a snapshot that may be slightly out of date while writers are active.
+ */
+template <typename Key, typename T, int ShardCount = 16> class ShardedHash
+{
+private:
+    struct Shard
+    {
+        mutable QReadWriteLock lock;
+        QHash<Key, T> hash;
+    };
+    Shard shards[ShardCount];
+    QAtomicInt count;
+
+    Shard &shardFor(const Key &key)
+    {
+        return shards[qHash(key) % ShardCount];
+    }
+    const Shard &shardFor(const Key &key) const
+    {
+        return shards[qHash(key) % ShardCount];
+    }
+
+public:
+    ShardedHash() : count(0)
+    {
+    }
+    ShardedHash(const ShardedHash &) = delete;
+    ShardedHash &operator=(const ShardedHash &) = delete;
+
+    T value(const Key &key, const T &defaultValue = T()) const
+    {
+        const Shard &shard = shardFor(key);
+        QReadLocker locker(&shard.lock);
+        return shard.hash.value(key, defaultValue);
+    }
+
+    bool contains(const Key &key) const
+    {
+        const Shard &shard = shardFor(key);
+        QReadLocker locker(&shard.lock);
+        return shard.hash.contains(key);
+    }
+
+    void insert(const Key &key, const T &value)
+    {
+        Shard &shard = shardFor(key);
+        QWriteLocker locker(&shard.lock);
+        if (!shard.hash.contains(key))
+            count.ref();
+        shard.hash.insert(key, value);
+    }
+
+    bool remove(const Key &key)
+    {
+        Shard &shard = shardFor(key);
+        QWriteLocker locker(&shard.lock);
+        if (!shard.hash.remove(key))
+            return false;
+        count.deref();
+        return true;
+    }
+
+    // Removes the entry only if it still maps to value, so a stale owner can't remove its successor
+    bool remove(const Key &key, const T &value)
+    {
+        Shard &shard = shardFor(key);
+        QWriteLocker locker(&shard.lock);
+        auto it = shard.hash.find(key);
+        if (it == shard.hash.end() || !(it.value() == value))
+            return false;
+        shard.hash.erase(it);
+        count.deref();
+        return true;
+    }
+
+    T take(const Key &key)
+    {
+        Shard &shard = shardFor(key);
+        QWriteLocker locker(&shard.lock);
+        if (!shard.hash.contains(key))
+            return T();
+        count.deref();
+        return shard.hash.take(key);
+    }
+
+    int size() const
+    {
+        return count.loadAcquire();
+    }
+
+    QList<T> values() const
+    {
+        QList<T> result;
+        for (const Shard &shard : shards) {
+            QReadLocker locker(&shard.lock);
+            result.append(shard.hash.values());
+        }
+        return result;
+    }
+
+    QHash<Key, T> toHash() const
+    {
+        QHash<Key, T> result;
+        for (const Shard &shard : shards) {
+            QReadLocker locker(&shard.lock);
+            for (auto it = shard.hash.constBegin(); it != shard.hash.constEnd(); ++it)
+                result.insert(it.key(), it.value());
+        }
+        return result;
+    }
+};
+
+#endif
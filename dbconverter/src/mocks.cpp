@@ -35,6 +35,10 @@ QString SettingsCache::getSettingsPath()
 {
     return "";
 }
+QString SettingsCache::getCachePath() const
+{
+    return "";
+}
 void SettingsCache::translateLegacySettings()
 {
 }
@@ -211,6 +215,9 @@ void SettingsCache::setChatMention(QT_STATE_CHANGED_T /* _chatMention */)
 void SettingsCache::setChatMentionCompleter(const QT_STATE_CHANGED_T /* _enableMentionCompleter */)
 {
 }
+void SettingsCache::setChatScrollback(int /* _chatScrollback */)
+{
+}
 void SettingsCache::setChatMentionForeground(QT_STATE_CHANGED_T /* _chatMentionForeground */)
 {
 }
@@ -262,6 +269,9 @@ void SettingsCache::setNetworkCacheSizeInMB(const int /* _networkCacheSize */)
 void SettingsCache::setNetworkRedirectCacheTtl(const int /* _redirectCacheTtl */)
 {
 }
+void SettingsCache::setPicDownloadConnectionsPerHost(const int /* _picDownloadConnectionsPerHost */)
+{
+}
 void SettingsCache::setClientID(const QString & /* _clientID */)
 {
 }
@@ -80,14 +80,13 @@ IslInterface::~IslInterface()
     }
     server->roomsLock.unlock();
 
-    server->clientsLock.lockForRead();
-    QMapIterator<QString, Server_AbstractUserInterface *> extUsers(server->getExternalUsers());
+    RcuReadLocker clientsLocker(&server->clientsRcu);
+    QHashIterator<QString, Server_AbstractUserInterface *> extUsers(server->getExternalUsers().toHash());
     while (extUsers.hasNext()) {
         extUsers.next();
         if (extUsers.value()->getUserInfo()->server_id() == serverId)
             emit externalUserLeft(extUsers.key());
     }
-    server->clientsLock.unlock();
 }
 
 void IslInterface::initServer()
@@ -137,11 +136,11 @@ void IslInterface::initServer()
     Event_ServerCompleteList event;
     event.set_server_id(server->getServerID());
 
-    server->clientsLock.lockForRead();
-    QMapIterator<QString, Server_ProtocolHandler *> userIterator(server->getUsers());
-    while (userIterator.hasNext())
-        event.add_user_list()->CopyFrom(userIterator.next().value()->copyUserInfo(true, true));
-    server->clientsLock.unlock();
+    {
+        RcuReadLocker clientsLocker(&server->clientsRcu);
+        for (auto *user : server->getUsers().values())
+            event.add_user_list()->CopyFrom(user->copyUserInfo(true, true));
+    }
 
     server->roomsLock.lockForRead();
     QMapIterator<int, Server_Room *> roomIterator(server->getRooms());
@@ -373,7 +372,7 @@ void IslInterface::processSessionEvent(const SessionEvent &event, qint64 session
             sessionEvent_UserLeft(event.GetExtension(Event_UserLeft::ext));
             break;
         case SessionEvent::GAME_JOINED: {
-            QReadLocker clientsLocker(&server->clientsLock);
+            RcuReadLocker clientsLocker(&server->clientsRcu);
             Server_AbstractUserInterface *client = server->getUsersBySessionId().value(sessionId);
             if (!client) {
                 qDebug() << "IslInterface::processSessionEvent: session id" << sessionId << "not found";
@@ -387,7 +386,7 @@ void IslInterface::processSessionEvent(const SessionEvent &event, qint64 session
         }
         case SessionEvent::USER_MESSAGE:
         case SessionEvent::REPLAY_ADDED: {
-            QReadLocker clientsLocker(&server->clientsLock);
+            RcuReadLocker clientsLocker(&server->clientsRcu);
             Server_AbstractUserInterface *client = server->getUsersBySessionId().value(sessionId);
             if (!client) {
                 qDebug() << "IslInterface::processSessionEvent: session id" << sessionId << "not found";
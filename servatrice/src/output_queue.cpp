@@ -0,0 +1,161 @@
+#include "output_queue.h"
+
+#include "pb/event_game_joined.pb.h"
+#include "pb/event_list_games.pb.h"
+#include "pb/event_list_rooms.pb.h"
+#include "pb/event_room_say.pb.h"
+#include "pb/event_user_joined.pb.h"
+#include "pb/event_user_left.pb.h"
+#include "pb/room_event.pb.h"
+#include "pb/session_event.pb.h"
+
+OutputQueue::OutputQueue() : lastTransferId(0), fragmentSize(0), maxBroadcastBacklog(0)
+{
+}
+
+OutputQueue::Lane OutputQueue::laneFor(const ServerMessage &item)
+{
+    switch (item.message_type()) {
+        case ServerMessage::GAME_EVENT_CONTAINER:
+            return GameLane;
+        case ServerMessage::ROOM_EVENT:
+            return BroadcastLane;
+        case ServerMessage::SESSION_EVENT: {
+            const SessionEvent &event = item.session_event();
+            // The game state events that follow would be ignored by the client if they overtook this one
+            if (event.HasExtension(Event_GameJoined::ext))
+                return GameLane;
+            if (event.HasExtension(Event_UserJoined::ext) || event.HasExtension(Event_UserLeft::ext) ||
+                event.HasExtension(Event_ListRooms::ext))
+                return BroadcastLane;
+            return ResponseLane;
+        }
+        default:
+            return ResponseLane;
+    }
+}
+
+bool OutputQueue::isEmpty() const
+{
+    for (const LaneQueue &lane : lanes)
+        if (!lane.items.isEmpty() || !lane.transfer.isEmpty())
+            return false;
+    return true;
+}
+
+void OutputQueue::enqueue(const ServerMessage &item)
+{
+    const Lane lane = laneFor(item);
+    if (lane == BroadcastLane) {
+        if (mergeGameList(item))
+            return;
+        if (maxBroadcastBacklog > 0 && lanes[BroadcastLane].items.size() >= maxBroadcastBacklog)
+            dropRoomChat();
+    }
+    lanes[lane].items.append(item);
+}
+
+/**
+ * Folds a game list update into one for the same room that is still waiting in the broadcast lane.
+ * Updates are applied the same way the client does, so the result is identical to receiving both.
+ */
+bool OutputQueue::mergeGameList(const ServerMessage &item)
+{
+    if (item.message_type() != ServerMessage::ROOM_EVENT || !item.room_event().HasExtension(Event_ListGames::ext))
+        return false;
+
+    const RoomEvent &roomEvent = item.room_event();
+    QList<ServerMessage> &items = lanes[BroadcastLane].items;
+    for (int i = items.size() - 1; i >= 0; --i) {
+        if (items[i].message_type() != ServerMessage::ROOM_EVENT ||
+            items[i].room_event().room_id() != roomEvent.room_id() ||
+            !items[i].room_event().HasExtension(Event_ListGames::ext))
+            continue;
+
+        Event_ListGames *queuedList = items[i].mutable_room_event()->MutableExtension(Event_ListGames::ext);
+        for (const ServerInfo_Game &game : roomEvent.GetExtension(Event_ListGames::ext).game_list()) {
+            ServerInfo_Game *target = nullptr;
+            for (int j = 0; j < queuedList->game_list_size(); ++j) {
+                if (queuedList->game_list(j).game_id() == game.game_id()) {
+                    target = queuedList->mutable_game_list(j);
+                    break;
+                }
+            }
+            if (!target) {
+                queuedList->add_game_list()->CopyFrom(game);
+            } else if (game.closed()) {
+                target->CopyFrom(game);
+            } else {
+                if (game.game_types_size() > 0)
+                    target->clear_game_types();
+                target->MergeFrom(game);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+// Chat is the only broadcast that can be lost without leaving the client in a wrong state
+void OutputQueue::dropRoomChat()
+{
+    QList<ServerMessage> &items = lanes[BroadcastLane].items;
+    for (int i = 0; i < items.size(); ++i) {
+        if (items[i].message_type() == ServerMessage::ROOM_EVENT &&
+            items[i].room_event().HasExtension(Event_RoomSay::ext)) {
+            items.removeAt(i);
+            return;
+        }
+    }
+}
+
+bool OutputQueue::takeNext(ServerMessage &item, bool allowFragments)
+{
+    for (LaneQueue &lane : lanes) {
+        if (!lane.transfer.isEmpty()) {
+            takeFragment(lane, item);
+            return true;
+        }
+        if (lane.items.isEmpty())
+            continue;
+
+        item.Swap(&lane.items.first());
+        lane.items.removeFirst();
+        if (!allowFragments || fragmentSize <= 0)
+            return true;
+
+#if GOOGLE_PROTOBUF_VERSION > 3001000
+        const int size = static_cast<int>(item.ByteSizeLong());
+#else
+        const int size = item.ByteSize();
+#endif
+        if (size <= fragmentSize)
+            return true;
+
+        lane.transfer.resize(size);
+        item.SerializeToArray(lane.transfer.data(), size);
+        lane.transferOffset = 0;
+        lane.transferId = ++lastTransferId;
+        takeFragment(lane, item);
+        return true;
+    }
+    return false;
+}
+
+void OutputQueue::takeFragment(LaneQueue &lane, ServerMessage &item)
+{
+    const int length = qMin(fragmentSize, lane.transfer.size() - lane.transferOffset);
+
+    item.Clear();
+    item.set_message_type(ServerMessage::FRAGMENT);
+    ServerMessage::Fragment *fragment = item.mutable_fragment();
+    fragment->set_message_id(lane.transferId);
+    fragment->set_total_size(static_cast<quint32>(lane.transfer.size()));
+    fragment->set_data(lane.transfer.constData() + lane.transferOffset, static_cast<size_t>(length));
+
+    lane.transferOffset += length;
+    if (lane.transferOffset >= lane.transfer.size()) {
+        lane.transfer.clear();
+        lane.transferOffset = 0;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef OUTPUT_QUEUE_H
+#define OUTPUT_QUEUE_H
+
+#include "pb/server_message.pb.h"
+
+#include <QByteArray>
+#include <QList>
+
+/**
+ * Outbound messages of a single session, split into priority lanes.
+ *
+ * Game events are sent before responses, and responses before room and session broadcasts. Order is kept within a
+ * lane. Game list updates waiting in the broadcast lane are merged, and room chat is dropped first once that lane
+ * grows too long. Messages larger than the fragment size are sent one slice at a time, so higher lanes can get
+ * through between two slices.
+ *
+ * Not thread safe; the owner guards it with its own mutex.
+ */
+class OutputQueue
+{
+public:
+    enum Lane
+    {
+        GameLane,
+        ResponseLane,
+        BroadcastLane,
+        LaneCount
+    };
+
+    OutputQueue();
+
+    void setFragmentSize(int _fragmentSize)
+    {
+        fragmentSize = _fragmentSize;
+    }
+    void setMaxBroadcastBacklog(int _maxBroadcastBacklog)
+    {
+        maxBroadcastBacklog = _maxBroadcastBacklog;
+    }
+
+    bool isEmpty() const;
+    void enqueue(const ServerMessage &item);
+    /**
+     * Takes the next message to write to the socket.
+     * With allowFragments set, oversized messages are returned as a sequence of FRAGMENT messages.
+     */
+    bool takeNext(ServerMessage &item, bool allowFragments);
+
+    static Lane laneFor(const ServerMessage &item);
+
+private:
+    struct LaneQueue
+    {
+        QList<ServerMessage> items;
+        QByteArray transfer;
+        int transferOffset = 0;
+        quint32 transferId = 0;
+    };
+    LaneQueue lanes[LaneCount];
+    quint32 lastTransferId;
+    int fragmentSize;
+    int maxBroadcastBacklog;
+
+    bool mergeGameList(const ServerMessage &item);
+    void dropRoomChat();
+    void takeFragment(LaneQueue &lane, ServerMessage &item);
+};
+
+#endif
@@ -86,7 +86,6 @@ void Servatrice_GameServer::incomingConnection(qintptr socketDescriptor)
     Servatrice_ConnectionPool *pool = findLeastUsedConnectionPool();
 
     auto ssi = new TcpServerSocketInterface(server, pool->getDatabaseInterface());
-    connect(ssi, SIGNAL(incTxBytes(qint64)), this, SLOT(incTxBytes(qint64)));
     ssi->moveToThread(pool->thread());
     pool->addClient();
     connect(ssi, SIGNAL(destroyed()), pool, SLOT(removeClient()));
@@ -156,7 +155,6 @@ void Servatrice_WebsocketGameServer::onNewConnection()
     Servatrice_ConnectionPool *pool = findLeastUsedConnectionPool();
 
     auto ssi = new WebsocketServerSocketInterface(server, pool->getDatabaseInterface());
-    connect(ssi, SIGNAL(incTxBytes(quint64)), this, SLOT(incTxBytes(quint64)));
     /*
      * Due to a Qt limitation, websockets can't be moved to another thread.
      * This will hopefully change in Qt6 if QtWebSocket will be integrated in QtNetwork
@@ -210,7 +208,7 @@ Servatrice::~Servatrice()
     gameServer->close();
 
     // we are destroying the clients outside their thread!
-    for (auto *client : clients) {
+    for (auto *client : getClients()) {
         client->prepareDestroy();
     }
 
@@ -515,8 +513,8 @@ QList<ServerProperties> Servatrice::getServerList() const
 int Servatrice::getUsersWithAddress(const QHostAddress &address) const
 {
     int result = 0;
-    QReadLocker locker(&clientsLock);
-    for (auto client : clients)
+    RcuReadLocker locker(&clientsRcu);
+    for (auto client : getClients())
         if (static_cast<AbstractServerSocketInterface *>(client)->getPeerAddress() == address)
             ++result;
 
@@ -526,8 +524,8 @@ int Servatrice::getUsersWithAddress(const QHostAddress &address) const
 QList<AbstractServerSocketInterface *> Servatrice::getUsersWithAddressAsList(const QHostAddress &address) const
 {
     QList<AbstractServerSocketInterface *> result;
-    QReadLocker locker(&clientsLock);
-    for (auto client : clients)
+    RcuReadLocker locker(&clientsRcu);
+    for (auto client : getClients())
         if (static_cast<AbstractServerSocketInterface *>(client)->getPeerAddress() == address)
             result.append(static_cast<AbstractServerSocketInterface *>(client));
     return result;
@@ -582,24 +580,19 @@ void Servatrice::statusUpdate()
     if (!servatriceDatabaseInterface->checkSql())
         return;
 
-    const int uc = getUsersCount(); // for correct mutex locking order
+    // All of these are lock-free counters maintained by the server as clients and games come and go
+    const int uc = getUsersCount();
 
     const QStringList mods_info = getOnlineModeratorList();
-    const int mc = mods_info.size();
+    const int mc = getModeratorsCount();
     const QString ml = mods_info.join(", ");
 
     const int gc = getGamesCount();
 
     uptime += statusUpdateClock->interval() / 1000;
 
-    txBytesMutex.lock();
-    quint64 tx = txBytes;
-    txBytes = 0;
-    txBytesMutex.unlock();
-    rxBytesMutex.lock();
-    quint64 rx = rxBytes;
-    rxBytes = 0;
-    rxBytesMutex.unlock();
+    const quint64 tx = txBytes.fetchAndStoreRelaxed(0);
+    const quint64 rx = rxBytes.fetchAndStoreRelaxed(0);
 
     QSqlQuery *query = servatriceDatabaseInterface->prepareQuery(
         "insert into {prefix}_uptime (id_server, timest, uptime, users_count, mods_count, mods_list, games_count, "
@@ -679,16 +672,12 @@ void Servatrice::scheduleShutdown(const QString &reason, int minutes)
 
 void Servatrice::incTxBytes(quint64 num)
 {
-    txBytesMutex.lock();
-    txBytes += num;
-    txBytesMutex.unlock();
+    txBytes.fetchAndAddRelaxed(num);
 }
 
 void Servatrice::incRxBytes(quint64 num)
 {
-    rxBytesMutex.lock();
-    rxBytes += num;
-    rxBytesMutex.unlock();
+    rxBytes.fetchAndAddRelaxed(num);
 }
 
 void Servatrice::shutdownTimeout()
@@ -710,10 +699,11 @@ void Servatrice::shutdownTimeout()
             se = Server_ProtocolHandler::prepareSessionEvent(event);
         }
 
-        clientsLock.lockForRead();
-        for (auto &client : clients)
-            client->sendProtocolItem(*se);
-        clientsLock.unlock();
+        {
+            RcuReadLocker locker(&clientsRcu);
+            for (auto &client : getClients())
+                client->sendProtocolItem(*se);
+        }
         delete se;
 
         if (!shutdownMinutes) {
@@ -914,6 +904,36 @@ int Servatrice::getMaxGameInactivityTime() const
     return settingsCache->value("game/max_game_inactivity_time", 120).toInt();
 }
 
+int Servatrice::getGameListUpdateInterval() const
+{
+    return settingsCache->value("game/game_list_update_interval", 250).toInt();
+}
+
+int Servatrice::getOutputFragmentSize() const
+{
+    return settingsCache->value("server/output_fragment_size", 65536).toInt();
+}
+
+int Servatrice::getOutputSocketBacklog() const
+{
+    return settingsCache->value("server/output_socket_backlog", 262144).toInt();
+}
+
+int Servatrice::getMaxBroadcastBacklog() const
+{
+    return settingsCache->value("server/max_broadcast_backlog", 1000).toInt();
+}
+
+int Servatrice::getSessionResumeTimeout() const
+{
+    return settingsCache->value("server/session_resume_timeout", 60).toInt();
+}
+
+int Servatrice::getSessionResumeBufferSize() const
+{
+    return settingsCache->value("server/session_resume_buffer_size", 500).toInt();
+}
+
 int Servatrice::getMaxPlayerInactivityTime() const
 {
     return settingsCache->value("server/max_player_inactivity_time", 15).toInt();
@@ -22,6 +22,7 @@
 
 #include "server.h"
 
+#include <QAtomicInteger>
 #include <QHostAddress>
 #include <QMetaType>
 #include <QMutex>
@@ -165,8 +166,7 @@ private:
     Servatrice_DatabaseInterface *servatriceDatabaseInterface;
     int serverId;
     int uptime;
-    QMutex txBytesMutex, rxBytesMutex;
-    quint64 txBytes, rxBytes;
+    QAtomicInteger<quint64> txBytes, rxBytes;
 
     QString shutdownReason;
     int shutdownMinutes;
@@ -266,6 +266,12 @@ public:
     int getMaxCommandCountPerInterval() const override;
     int getMaxUserTotal() const override;
     bool permitCreateGameAsJudge() const override;
+    int getGameListUpdateInterval() const override;
+    int getOutputFragmentSize() const;
+    int getOutputSocketBacklog() const;
+    int getMaxBroadcastBacklog() const;
+    int getSessionResumeTimeout() const override;
+    int getSessionResumeBufferSize() const override;
     int getMaxTcpUserLimit() const;
     int getMaxWebSocketUserLimit() const;
     int getUsersWithAddress(const QHostAddress &address) const;
@@ -85,8 +85,12 @@ AbstractServerSocketInterface::AbstractServerSocketInterface(Servatrice *_server
                                                              Servatrice_DatabaseInterface *_databaseInterface,
                                                              QObject *parent)
     : Server_ProtocolHandler(_server, _databaseInterface, parent), servatrice(_server),
-      sqlInterface(reinterpret_cast<Servatrice_DatabaseInterface *>(databaseInterface))
+      sqlInterface(reinterpret_cast<Servatrice_DatabaseInterface *>(databaseInterface)),
+      maxSocketBacklog(_server->getOutputSocketBacklog())
 {
+    outputQueue.setFragmentSize(servatrice->getOutputFragmentSize());
+    outputQueue.setMaxBroadcastBacklog(servatrice->getMaxBroadcastBacklog());
+
     // Never call flushOutputQueue directly from outputQueueChanged. In case of a socket error,
     // it could lead to this object being destroyed while another function is still on the call stack. -> mutex
     // deadlocks etc.
@@ -128,18 +132,18 @@ void AbstractServerSocketInterface::catchSocketError(QAbstractSocket::SocketErro
 {
     qDebug() << "Socket error:" << socketError;
 
-    prepareDestroy();
+    connectionLost();
 }
 
 void AbstractServerSocketInterface::catchSocketDisconnected()
 {
-    prepareDestroy();
+    connectionLost();
 }
 
 void AbstractServerSocketInterface::transmitProtocolItem(const ServerMessage &item)
 {
     outputQueueMutex.lock();
-    outputQueue.append(item);
+    outputQueue.enqueue(item);
     outputQueueMutex.unlock();
 
     emit outputQueueChanged();
@@ -472,6 +476,7 @@ void AbstractServerSocketInterface::deckDelDirHelper(int basePathId)
 
 void AbstractServerSocketInterface::sendServerMessage(const QString userName, const QString message)
 {
+    RcuReadLocker clientsLocker(&servatrice->clientsRcu);
     AbstractServerSocketInterface *user =
         static_cast<AbstractServerSocketInterface *>(server->getUsers().value(userName));
     if (!user)
@@ -887,19 +892,19 @@ Response::ResponseCode AbstractServerSocketInterface::cmdWarnUser(const Command_
     }
 
     if (sqlInterface->addWarning(userName, sendingModerator, warningReason, clientId)) {
-        servatrice->clientsLock.lockForRead();
-        AbstractServerSocketInterface *user =
-            static_cast<AbstractServerSocketInterface *>(server->getUsers().value(userName));
         QList<QString> moderatorList = server->getOnlineModeratorList();
-        servatrice->clientsLock.unlock();
-
-        if (user != nullptr) {
-            Event_NotifyUser event;
-            event.set_type(Event_NotifyUser::WARNING);
-            event.set_warning_reason(warningReason.toStdString());
-            SessionEvent *se = user->prepareSessionEvent(event);
-            user->sendProtocolItem(*se);
-            delete se;
+        {
+            RcuReadLocker clientsLocker(&servatrice->clientsRcu);
+            AbstractServerSocketInterface *user =
+                static_cast<AbstractServerSocketInterface *>(server->getUsers().value(userName));
+            if (user != nullptr) {
+                Event_NotifyUser event;
+                event.set_type(Event_NotifyUser::WARNING);
+                event.set_warning_reason(warningReason.toStdString());
+                SessionEvent *se = user->prepareSessionEvent(event);
+                user->sendProtocolItem(*se);
+                delete se;
+            }
         }
 
         for (QString &moderator : moderatorList) {
@@ -950,48 +955,55 @@ Response::ResponseCode AbstractServerSocketInterface::cmdBanFromServer(const Com
     query->bindValue(":client_id", nameFromStdString(cmd.clientid()));
     sqlInterface->execSqlQuery(query);
 
-    servatrice->clientsLock.lockForRead();
+    // A dropped connection of the banned user must not be resumable, resuming checks bans for everything else
+    if (!userName.isEmpty())
+        server->discardSuspendedSession(userName);
+
     QList<QString> moderatorList = server->getOnlineModeratorList();
-    QList<AbstractServerSocketInterface *> userList = servatrice->getUsersWithAddressAsList(QHostAddress(address));
-
-    if (!userName.isEmpty()) {
-        AbstractServerSocketInterface *user =
-            static_cast<AbstractServerSocketInterface *>(server->getUsers().value(userName));
-        if (user && !userList.contains(user))
-            userList.append(user);
-    }
-
-    if (userName.isEmpty() && address.isEmpty() && (!clientId.isEmpty())) {
-        QSqlQuery *clientIdQuery =
-            sqlInterface->prepareQuery("select name from {prefix}_users where clientid = :client_id");
-        clientIdQuery->bindValue(":client_id", nameFromStdString(cmd.clientid()));
-        sqlInterface->execSqlQuery(clientIdQuery);
-        if (!sqlInterface->execSqlQuery(clientIdQuery)) {
-            qDebug("ClientID username ban lookup failed: SQL Error");
-        } else {
-            while (clientIdQuery->next()) {
-                userName = clientIdQuery->value(0).toString();
-                AbstractServerSocketInterface *user =
-                    static_cast<AbstractServerSocketInterface *>(server->getUsers().value(userName));
-                if (user && !userList.contains(user))
-                    userList.append(user);
+    {
+        // The collected sessions are only guaranteed to stay alive inside the read section
+        RcuReadLocker clientsLocker(&servatrice->clientsRcu);
+        QList<AbstractServerSocketInterface *> userList = servatrice->getUsersWithAddressAsList(QHostAddress(address));
+
+        if (!userName.isEmpty()) {
+            AbstractServerSocketInterface *user =
+                static_cast<AbstractServerSocketInterface *>(server->getUsers().value(userName));
+            if (user && !userList.contains(user))
+                userList.append(user);
+        }
+
+        if (userName.isEmpty() && address.isEmpty() && (!clientId.isEmpty())) {
+            QSqlQuery *clientIdQuery =
+                sqlInterface->prepareQuery("select name from {prefix}_users where clientid = :client_id");
+            clientIdQuery->bindValue(":client_id", nameFromStdString(cmd.clientid()));
+            sqlInterface->execSqlQuery(clientIdQuery);
+            if (!sqlInterface->execSqlQuery(clientIdQuery)) {
+                qDebug("ClientID username ban lookup failed: SQL Error");
+            } else {
+                while (clientIdQuery->next()) {
+                    userName = clientIdQuery->value(0).toString();
+                    server->discardSuspendedSession(userName);
+                    AbstractServerSocketInterface *user =
+                        static_cast<AbstractServerSocketInterface *>(server->getUsers().value(userName));
+                    if (user && !userList.contains(user))
+                        userList.append(user);
+                }
             }
         }
-    }
-    servatrice->clientsLock.unlock();
 
-    if (!userList.isEmpty()) {
-        Event_ConnectionClosed event;
-        event.set_reason(Event_ConnectionClosed::BANNED);
-        if (cmd.has_visible_reason())
-            event.set_reason_str(visibleReason.toStdString());
-        if (minutes)
-            event.set_end_time(QDateTime::currentDateTime().addSecs(60 * minutes).toSecsSinceEpoch());
-        for (int i = 0; i < userList.size(); ++i) {
-            SessionEvent *se = userList[i]->prepareSessionEvent(event);
-            userList[i]->sendProtocolItem(*se);
-            delete se;
-            QMetaObject::invokeMethod(userList[i], "prepareDestroy", Qt::QueuedConnection);
+        if (!userList.isEmpty()) {
+            Event_ConnectionClosed event;
+            event.set_reason(Event_ConnectionClosed::BANNED);
+            if (cmd.has_visible_reason())
+                event.set_reason_str(visibleReason.toStdString());
+            if (minutes)
+                event.set_end_time(QDateTime::currentDateTime().addSecs(60 * minutes).toSecsSinceEpoch());
+            for (int i = 0; i < userList.size(); ++i) {
+                SessionEvent *se = userList[i]->prepareSessionEvent(event);
+                userList[i]->sendProtocolItem(*se);
+                delete se;
+                QMetaObject::invokeMethod(userList[i], "prepareDestroy", Qt::QueuedConnection);
+            }
         }
     }
 
@@ -1591,6 +1603,7 @@ bool AbstractServerSocketInterface::addAdminFlagToUser(const QString &userName,
         return false;
     }
 
+    RcuReadLocker clientsLocker(&servatrice->clientsRcu);
     AbstractServerSocketInterface *user =
         static_cast<AbstractServerSocketInterface *>(server->getUsers().value(userName));
     if (user) {
@@ -1615,6 +1628,7 @@ bool AbstractServerSocketInterface::removeAdminFlagFromUser(const QString &userN
         return false;
     }
 
+    RcuReadLocker clientsLocker(&servatrice->clientsRcu);
     AbstractServerSocketInterface *user =
         static_cast<AbstractServerSocketInterface *>(server->getUsers().value(userName));
     if (user) {
@@ -1792,6 +1806,8 @@ TcpServerSocketInterface::TcpServerSocketInterface(Servatrice *_server,
     socket = new QTcpSocket(this);
     socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
     connect(socket, SIGNAL(readyRead()), this, SLOT(readClient()));
+    // Resume sending what was held back in the output queue once the socket has drained
+    connect(socket, SIGNAL(bytesWritten(qint64)), this, SLOT(flushOutputQueue()), Qt::QueuedConnection);
     connect(socket, SIGNAL(disconnected()), this, SLOT(catchSocketDisconnected()));
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
     connect(socket, SIGNAL(errorOccurred(QAbstractSocket::SocketError)), this,
@@ -1806,6 +1822,8 @@ TcpServerSocketInterface::~TcpServerSocketInterface()
 {
     logger->logMessage("TcpServerSocketInterface destructor", this);
 
+    // Last chance to send anything, don't hold messages back anymore
+    maxSocketBacklog = 0;
     flushOutputQueue();
 }
 
@@ -1833,12 +1851,12 @@ void TcpServerSocketInterface::initSessionDeprecated()
 void TcpServerSocketInterface::flushOutputQueue()
 {
     QMutexLocker locker(&outputQueueMutex);
-    if (outputQueue.isEmpty())
+    if (outputQueue.isEmpty() || socketBacklogFull())
         return;
 
     int totalBytes = 0;
-    while (!outputQueue.isEmpty()) {
-        ServerMessage item = outputQueue.takeFirst();
+    ServerMessage item;
+    while (!socketBacklogFull() && outputQueue.takeNext(item, acceptsMessageFragments)) {
         locker.unlock();
 
         QByteArray buf;
@@ -1860,7 +1878,7 @@ void TcpServerSocketInterface::flushOutputQueue()
         locker.relock();
     }
     locker.unlock();
-    emit incTxBytes(totalBytes);
+    servatrice->incTxBytes(totalBytes);
     // see above wrt mutex
     flushSocket();
 }
@@ -2040,8 +2058,8 @@ void WebsocketServerSocketInterface::flushOutputQueue()
         return;
 
     qint64 totalBytes = 0;
-    while (!outputQueue.isEmpty()) {
-        ServerMessage item = outputQueue.takeFirst();
+    ServerMessage item;
+    while (outputQueue.takeNext(item, acceptsMessageFragments)) {
         locker.unlock();
 
         QByteArray buf;
@@ -2059,7 +2077,7 @@ void WebsocketServerSocketInterface::flushOutputQueue()
         locker.relock();
     }
     locker.unlock();
-    emit incTxBytes(totalBytes);
+    servatrice->incTxBytes(totalBytes);
     // see above wrt mutex
     flushSocket();
 }
@@ -20,6 +20,7 @@
 #ifndef SERVERSOCKETINTERFACE_H
 #define SERVERSOCKETINTERFACE_H
 
+#include "output_queue.h"
 #include "server_protocolhandler.h"
 
 #include <QHostAddress>
@@ -63,7 +64,6 @@ protected slots:
     virtual void flushOutputQueue() = 0;
 signals:
     void outputQueueChanged();
-    void incTxBytes(qint64 amount);
 
 protected:
     void logDebugMessage(const QString &message);
@@ -71,10 +71,16 @@ protected:
 
     virtual void writeToSocket(QByteArray &data) = 0;
     virtual void flushSocket() = 0;
+    // While true, queued messages wait in their priority lanes instead of piling up in the socket buffer
+    virtual bool socketBacklogFull() const
+    {
+        return false;
+    }
 
     Servatrice *servatrice;
-    QList<ServerMessage> outputQueue;
+    OutputQueue outputQueue;
     QMutex outputQueueMutex;
+    int maxSocketBacklog; // bytes, 0 = no limit
 
 private:
     Servatrice_DatabaseInterface *sqlInterface;
@@ -189,6 +195,10 @@ protected:
     {
         socket->flush();
     };
+    bool socketBacklogFull() const
+    {
+        return maxSocketBacklog > 0 && socket->bytesToWrite() >= maxSocketBacklog;
+    }
     void initSessionDeprecated();
     bool initTcpSession();
 protected slots:
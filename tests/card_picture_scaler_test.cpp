@@ -0,0 +1,152 @@
+#include "../cockatrice/src/client/ui/card_picture_scaler.h"
+
+#include "gtest/gtest.h"
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QHash>
+#include <QPainter>
+#include <QPixmap>
+#include <QTemporaryDir>
+#include <QThread>
+#include <iostream>
+
+namespace
+{
+const int boardSize = 200;
+const int distinctPictures = 40;
+const QSize fullSize(745, 1040);
+const QSize tableSize(146, 204);
+
+QList<QImage> makePictures()
+{
+    QList<QImage> pictures;
+    for (int i = 0; i < distinctPictures; ++i) {
+        QImage picture(fullSize, QImage::Format_RGB32);
+        QPainter painter(&picture);
+        QLinearGradient gradient(0, 0, fullSize.width(), fullSize.height());
+        gradient.setColorAt(0, QColor::fromHsv(i * 9, 200, 200));
+        gradient.setColorAt(1, QColor::fromHsv(i * 9 + 120, 200, 60));
+        painter.fillRect(picture.rect(), gradient);
+        pictures << picture;
+    }
+    return pictures;
+}
+
+QString sizeKey(int card)
+{
+    return QString("card_%1_%2x%3").arg(card).arg(tableSize.width()).arg(tableSize.height());
+}
+
+/**
+ * A whole board of cards appears at once. Scaling every picture while painting the first frame was what made the
+ * client hitch; with the scaler the gui thread only queues the work and uploads finished pictures. The frame times
+ * depend on the machine, so they are only reported.
+ */
+TEST(CardPictureScalerTest, BoardScaledOffGuiThread)
+{
+    const QList<QImage> pictures = makePictures();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int card = 0; card < boardSize; ++card) {
+        QPixmap pixmap = QPixmap::fromImage(pictures.at(card % distinctPictures))
+                             .scaled(tableSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        ASSERT_FALSE(pixmap.isNull());
+    }
+    const qint64 synchronousFrame = timer.elapsed();
+
+    QTemporaryDir thumbnailDir;
+    CardPictureScaler scaler(thumbnailDir.path());
+    QThread *guiThread = QThread::currentThread();
+    QAtomicInt jobsOnGuiThread, jobs;
+    QObject::connect(
+        &scaler, &CardPictureScaler::jobFinished,
+        [guiThread, &jobsOnGuiThread, &jobs](const QString &, const QImage &, int) {
+            jobs.ref();
+            if (QThread::currentThread() == guiThread)
+                jobsOnGuiThread.ref();
+        },
+        Qt::DirectConnection);
+    QHash<QString, int> uploads;
+    QHash<QString, QPixmap> uploaded;
+    QObject::connect(&scaler, &CardPictureScaler::scaled,
+                     [&uploads, &uploaded](const QString &key, const QImage &image) {
+                         ++uploads[key];
+                         uploaded.insert(key, QPixmap::fromImage(image));
+                     });
+
+    // painting the first frame only queues the work; repainting before a picture is done doesn't queue it again
+    timer.restart();
+    for (int repaint = 0; repaint < 2; ++repaint) {
+        for (int card = 0; card < boardSize; ++card) {
+            scaler.scale(QString("card_%1").arg(card), sizeKey(card), tableSize, pictures.at(card % distinctPictures));
+        }
+    }
+    qint64 worstFrame = timer.elapsed();
+    ASSERT_EQ(scaler.getPendingCount(), boardSize);
+
+    QElapsedTimer total;
+    total.start();
+    int frames = 1;
+    while (uploaded.size() < boardSize && total.elapsed() < 60000) {
+        timer.restart();
+        QCoreApplication::processEvents();
+        worstFrame = qMax(worstFrame, timer.elapsed());
+        ++frames;
+        QThread::msleep(16);
+    }
+    scaler.waitForDone();
+    QCoreApplication::processEvents();
+
+    std::cout << "[ BENCH    ] " << boardSize << " cards: synchronous frame " << synchronousFrame
+              << "ms, pipelined worst frame " << worstFrame << "ms over " << frames << " frames" << std::endl;
+
+    ASSERT_EQ(uploaded.size(), boardSize);
+    for (int card = 0; card < boardSize; ++card) {
+        ASSERT_EQ(uploaded.value(sizeKey(card)).width(), tableSize.width());
+        ASSERT_EQ(uploads.value(sizeKey(card)), 1) << "a size was handed out more than once";
+    }
+    ASSERT_EQ(jobs.loadAcquire(), boardSize) << "a size was scaled more than once";
+    ASSERT_EQ(jobsOnGuiThread.loadAcquire(), 0) << "pictures were scaled on the gui thread";
+}
+
+TEST(CardPictureScalerTest, FindsThumbnailsFromEarlierRuns)
+{
+    QTemporaryDir thumbnailDir;
+    const QImage picture = makePictures().first();
+    QImage result;
+    {
+        CardPictureScaler scaler(thumbnailDir.path());
+        QObject::connect(&scaler, &CardPictureScaler::scaled,
+                         [&result](const QString &, const QImage &image) { result = image; });
+        // nothing on disk yet
+        scaler.scale("card_Island", "card_Island_146204", tableSize, QImage());
+        scaler.waitForDone();
+        QCoreApplication::processEvents();
+        ASSERT_TRUE(result.isNull());
+
+        scaler.scale("card_Island", "card_Island_146204", tableSize, picture);
+        scaler.waitForDone();
+        QCoreApplication::processEvents();
+        ASSERT_FALSE(result.isNull());
+    }
+
+    result = QImage();
+    CardPictureScaler scaler(thumbnailDir.path());
+    QObject::connect(&scaler, &CardPictureScaler::scaled,
+                     [&result](const QString &, const QImage &image) { result = image; });
+    scaler.scale("card_Island", "card_Island_146204", tableSize, QImage());
+    scaler.waitForDone();
+    QCoreApplication::processEvents();
+    ASSERT_EQ(result.width(), tableSize.width());
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // pixmaps need a gui application, but not a screen
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
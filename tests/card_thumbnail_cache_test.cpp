@@ -0,0 +1,130 @@
+#include "../cockatrice/src/client/ui/card_thumbnail_cache.h"
+
+#include "gtest/gtest.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+
+namespace
+{
+// noise doesn't compress, so the size of a thumbnail on disk is predictable
+QImage noiseImage(const QSize &size, int seed)
+{
+    QImage image(size, QImage::Format_ARGB32);
+    quint32 state = static_cast<quint32>(seed) * 2654435761u + 1;
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            state = state * 1664525u + 1013904223u;
+            image.setPixel(x, y, state | 0xff000000u);
+        }
+    }
+    return image;
+}
+
+TEST(CardThumbnailCacheTest, RoundTrip)
+{
+    QTemporaryDir dir;
+    CardThumbnailCache cache(dir.path());
+    const QImage image = noiseImage({63, 88}, 1);
+
+    cache.store("card_Island", {63, 88}, image, cache.getGeneration());
+    ASSERT_EQ(cache.load("card_Island", {63, 88}), image);
+    ASSERT_TRUE(cache.load("card_Island", {126, 176}).isNull()) << "other sizes are separate thumbnails";
+    ASSERT_TRUE(cache.load("card_Forest", {63, 88}).isNull());
+}
+
+TEST(CardThumbnailCacheTest, SurvivesRestart)
+{
+    QTemporaryDir dir;
+    const QImage image = noiseImage({63, 88}, 2);
+    {
+        CardThumbnailCache cache(dir.path());
+        cache.store("card_Island", {63, 88}, image, cache.getGeneration());
+    }
+
+    CardThumbnailCache cache(dir.path());
+    ASSERT_EQ(cache.getCount(), 1);
+    ASSERT_EQ(cache.load("card_Island", {63, 88}), image);
+}
+
+TEST(CardThumbnailCacheTest, DropsThumbnailsScaledBeforeClear)
+{
+    QTemporaryDir dir;
+    CardThumbnailCache cache(dir.path());
+    const int staleGeneration = cache.getGeneration();
+    cache.store("card_Island", {63, 88}, noiseImage({63, 88}, 3), staleGeneration);
+
+    cache.clear();
+    cache.store("card_Forest", {63, 88}, noiseImage({63, 88}, 4), staleGeneration);
+
+    ASSERT_EQ(cache.getCount(), 0);
+    ASSERT_TRUE(cache.load("card_Island", {63, 88}).isNull());
+    ASSERT_TRUE(cache.load("card_Forest", {63, 88}).isNull());
+}
+
+TEST(CardThumbnailCacheTest, EvictsLeastRecentlyUsed)
+{
+    QTemporaryDir dir;
+    // a 256x256 noise png takes about 200KB, so eight of them don't fit into 1MB
+    CardThumbnailCache cache(dir.path(), 1);
+    for (int i = 0; i < 8; ++i) {
+        cache.store(QString("card_%1").arg(i), {256, 256}, noiseImage({256, 256}, i), cache.getGeneration());
+    }
+
+    ASSERT_LE(cache.getSize(), 1024 * 1024);
+    ASSERT_LT(cache.getCount(), 8);
+    ASSERT_TRUE(cache.load("card_0", {256, 256}).isNull()) << "the oldest thumbnail goes first";
+    ASSERT_FALSE(cache.load("card_7", {256, 256}).isNull()) << "the newest thumbnail is kept";
+}
+
+TEST(CardThumbnailCacheTest, DropsThumbnailsOfChangedCustomPictures)
+{
+    QTemporaryDir dir;
+    CardThumbnailCache cache(dir.path() + "/thumbnails");
+    const QString customPicture = dir.path() + "/Island.png";
+    ASSERT_TRUE(noiseImage({63, 88}, 5).save(customPicture));
+
+    cache.store("card_Island", {63, 88}, noiseImage({63, 88}, 6), cache.getGeneration(), "Island", customPicture);
+    ASSERT_FALSE(cache.load("card_Island", {63, 88}).isNull()) << "the custom picture didn't change yet";
+
+    // an edit while the client isn't running only shows in the modification time
+    QFile file(customPicture);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+    file.close();
+    ASSERT_TRUE(cache.load("card_Island", {63, 88}).isNull());
+    ASSERT_EQ(cache.getCount(), 0);
+
+    cache.store("card_Island", {63, 88}, noiseImage({63, 88}, 7), cache.getGeneration(), "Island", customPicture);
+    ASSERT_TRUE(QFile::remove(customPicture));
+    ASSERT_TRUE(cache.load("card_Island", {63, 88}).isNull()) << "the custom picture is gone";
+}
+
+TEST(CardThumbnailCacheTest, InvalidatesCards)
+{
+    QTemporaryDir dir;
+    CardThumbnailCache cache(dir.path());
+    const int staleGeneration = cache.getGeneration();
+    cache.store("card_Island", {63, 88}, noiseImage({63, 88}, 8), staleGeneration, "Island");
+    cache.store("card_Island", {126, 176}, noiseImage({126, 176}, 9), staleGeneration, "Island");
+    cache.store("card_Forest", {63, 88}, noiseImage({63, 88}, 10), staleGeneration, "Forest");
+
+    cache.invalidateCards({"Island"});
+    ASSERT_TRUE(cache.load("card_Island", {63, 88}).isNull());
+    ASSERT_TRUE(cache.load("card_Island", {126, 176}).isNull());
+    ASSERT_FALSE(cache.load("card_Forest", {63, 88}).isNull()) << "other cards keep their thumbnails";
+
+    // a scale that was running while the picture changed may have used the old one
+    cache.store("card_Island", {63, 88}, noiseImage({63, 88}, 11), staleGeneration, "Island");
+    ASSERT_TRUE(cache.load("card_Island", {63, 88}).isNull());
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
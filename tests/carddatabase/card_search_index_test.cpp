@@ -0,0 +1,180 @@
+#include "../../cockatrice/src/game/cards/card_search_index.h"
+#include "mocks.h"
+
+#include "gtest/gtest.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+
+const QStringList firstWords = {"Goblin", "Elvish", "Serra", "Llanowar", "Shivan", "Ancestral", "Dark", "Lightning"};
+const QStringList secondWords = {"Guide", "Mystic", "Angel", "Elves", "Dragon", "Recall", "Ritual", "Bolt", "Aether"};
+const QStringList texts = {"Draw a card.", "Destroy target creature. It can't be regenerated.",
+                           "Add {G}.", "Flying, vigilance", "Lightning Bolt deals 3 damage to any target.",
+                           "Counter target spell. Draw a card at the beginning of the next turn's upkeep."};
+
+void writeSyntheticDatabase(const QString &fileName, int cardCount)
+{
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    QTextStream out(&file);
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<cockatrice_carddatabase version=\"4\">\n<sets>\n"
+        << "<set><name>S</name><longname>Set</longname><settype>Expansion</settype>"
+        << "<releasedate>2020-01-01</releasedate></set>\n</sets>\n<cards>\n";
+    for (int card = 0; card < cardCount; ++card) {
+        out << "<card><name>" << firstWords.at(card % firstWords.size()) << " "
+            << secondWords.at((card / firstWords.size()) % secondWords.size()) << " " << card << "</name><text>"
+            << texts.at(card % texts.size()) << "</text><prop><type>Instant</type><maintype>Instant</maintype>"
+            << "</prop><set uuid=\"uuid-" << card << "\">S</set><tablerow>2</tablerow></card>\n";
+    }
+    out << "</cards>\n</cockatrice_carddatabase>\n";
+}
+
+class CardSearchIndexTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        QTemporaryDir tempDir;
+        ASSERT_TRUE(tempDir.isValid());
+        const QString source = tempDir.filePath("cards.xml");
+        writeSyntheticDatabase(source, 30000);
+
+        db = new CardDatabase;
+        db->clear();
+        ASSERT_EQ(Ok, db->loadFromFile(source));
+        cards = db->getCardList();
+        index = new CardSearchIndex(cards);
+    }
+
+    static void TearDownTestCase()
+    {
+        delete index;
+        cards.clear();
+        delete db;
+    }
+
+    static CardDatabase *db;
+    static QList<CardInfoPtr> cards;
+    static CardSearchIndex *index;
+};
+
+CardDatabase *CardSearchIndexTest::db = nullptr;
+QList<CardInfoPtr> CardSearchIndexTest::cards;
+CardSearchIndex *CardSearchIndexTest::index = nullptr;
+
+const QStringList nameQueries = {"goblin", "bolt 29", "serra angel", "aether", "lves", "12345", "nothing like it"};
+const QStringList textQueries = {"draw a card", "destroy target", "damage", "{g}", "upkeep", "hexproof"};
+
+TEST_F(CardSearchIndexTest, CandidatesContainEveryMatch)
+{
+    ASSERT_EQ(index->size(), cards.size());
+    for (const QString &query : nameQueries + textQueries + QStringList{"", "g", "go"}) {
+        const QBitArray names = index->nameCandidates(query);
+        const QBitArray texts = index->textCandidates(query);
+        if (query.size() < 3) {
+            ASSERT_TRUE(names.isNull()) << query.toStdString();
+            ASSERT_TRUE(texts.isNull()) << query.toStdString();
+            continue;
+        }
+
+        for (const CardInfoPtr &card : cards) {
+            const int id = index->idOf(card.data());
+            ASSERT_GE(id, 0);
+            if (card->getName().toCaseFolded().contains(query)) {
+                ASSERT_TRUE(names.testBit(id)) << query.toStdString() << " " << card->getName().toStdString();
+            }
+            if (card->getText().toCaseFolded().contains(query)) {
+                ASSERT_TRUE(texts.testBit(id)) << query.toStdString() << " " << card->getName().toStdString();
+            }
+        }
+    }
+
+    ASSERT_EQ(index->nameCandidates("nothing like it").count(true), 0);
+    ASSERT_EQ(index->idOf(nullptr), -1);
+}
+
+TEST_F(CardSearchIndexTest, NamesWithPrefix)
+{
+    for (const QString &prefix : QStringList{"goblin g", "Serra Angel 1", "LLANOWAR", "aether", "zzz", ""}) {
+        QStringList expected;
+        const QString simplePrefix = CardInfo::simplifyName(prefix);
+        for (const CardInfoPtr &card : cards) {
+            if (card->getSimpleName().startsWith(simplePrefix)) {
+                expected << card->getName();
+            }
+        }
+
+        QStringList names = index->namesWithPrefix(prefix);
+        std::sort(expected.begin(), expected.end());
+        std::sort(names.begin(), names.end());
+        ASSERT_EQ(names, expected) << prefix.toStdString();
+        ASSERT_LE(index->namesWithPrefix(prefix, 10).size(), 10);
+    }
+}
+
+/**
+ * Typing in the deck editor search box matches every card name and text again; compare scanning all of them with
+ * narrowing them down with the index first and only matching the candidates.
+ */
+TEST_F(CardSearchIndexTest, LatencyBenchmark)
+{
+    // the display model keeps the folded strings and the id of every card next to each other the same way
+    QVector<QString> foldedNames, foldedTexts;
+    QVector<int> ids;
+    for (const CardInfoPtr &card : cards) {
+        foldedNames << card->getName().toCaseFolded();
+        foldedTexts << card->getText().toCaseFolded();
+        ids << index->idOf(card.data());
+    }
+
+    for (const QString &query : nameQueries + textQueries) {
+        const bool isName = nameQueries.contains(query);
+        const QVector<QString> &folded = isName ? foldedNames : foldedTexts;
+
+        QElapsedTimer timer;
+        timer.start();
+        int scanned = 0;
+        for (int i = 0; i < folded.size(); ++i) {
+            scanned += folded.at(i).contains(query);
+        }
+        const qint64 scanTime = timer.nsecsElapsed();
+
+        timer.restart();
+        const QBitArray candidates = isName ? index->nameCandidates(query) : index->textCandidates(query);
+        int indexed = 0;
+        for (int i = 0; i < folded.size(); ++i) {
+            indexed += CardSearchIndex::isCandidate(candidates, ids.at(i)) && folded.at(i).contains(query);
+        }
+        const qint64 indexTime = timer.nsecsElapsed();
+
+        std::cout << "[ BENCH    ] " << (isName ? "name" : "text") << " \"" << query.toStdString() << "\": scan "
+                  << scanTime / 1000 << "us, index " << indexTime / 1000 << "us, " << candidates.count(true)
+                  << " candidates, " << indexed << " matches" << std::endl;
+        ASSERT_EQ(indexed, scanned) << query.toStdString();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QStringList names = index->namesWithPrefix("goblin", 50);
+    std::cout << "[ BENCH    ] prefix \"goblin\": " << timer.nsecsElapsed() / 1000 << "us, " << names.size()
+              << " names" << std::endl;
+
+    timer.restart();
+    const CardSearchIndex rebuilt(cards);
+    std::cout << "[ BENCH    ] building the index for " << rebuilt.size() << " cards: " << timer.elapsed() << "ms"
+              << std::endl;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    settingsCache = new SettingsCache;
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,140 @@
+#include "../../cockatrice/src/game/cards/card_database_cache.h"
+#include "mocks.h"
+
+#include "gtest/gtest.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <iostream>
+
+namespace
+{
+
+QStringList testSources()
+{
+    return QStringList() << QString("%1/cards.xml").arg(CARDDB_DATADIR) << QString("%1/tokens.xml").arg(CARDDB_DATADIR);
+}
+
+LoadStatus loadSources(CardDatabase &db, const QStringList &sources)
+{
+    db.clear();
+    LoadStatus status = Ok;
+    for (const QString &source : sources) {
+        if (db.loadFromFile(source) != Ok)
+            status = Invalid;
+    }
+    return status;
+}
+
+void writeSyntheticDatabase(const QString &fileName, int cardCount)
+{
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    QTextStream out(&file);
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<cockatrice_carddatabase version=\"4\">\n<sets>\n";
+    for (int set = 0; set < 20; ++set) {
+        out << "<set><name>S" << set << "</name><longname>Set " << set
+            << "</longname><settype>Expansion</settype><releasedate>2020-01-01</releasedate></set>\n";
+    }
+    out << "</sets>\n<cards>\n";
+    for (int card = 0; card < cardCount; ++card) {
+        out << "<card><name>Card " << card << "</name><text>When Card " << card
+            << " enters the battlefield, draw a card.</text><prop><colors>G</colors><manacost>2G</manacost>"
+            << "<cmc>3</cmc><type>Creature - Cat</type><maintype>Creature</maintype><pt>3/3</pt></prop>"
+            << "<set rarity=\"common\" uuid=\"uuid-" << card << "\">S" << card % 20 << "</set>"
+            << "<set rarity=\"rare\" uuid=\"uuid-r" << card << "\">S" << (card + 7) % 20 << "</set>"
+            << "<tablerow>2</tablerow></card>\n";
+    }
+    out << "</cards>\n</cockatrice_carddatabase>\n";
+}
+
+TEST(CardDatabaseCacheTest, RoundTrip)
+{
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    CardDatabaseCache cache(tempDir.filePath("cards.cache"));
+    const QStringList sources = testSources();
+
+    CardDatabase parsed;
+    ASSERT_EQ(Ok, loadSources(parsed, sources));
+    ASSERT_TRUE(cache.save(parsed, sources));
+
+    CardDatabase cached;
+    cached.clear();
+    ASSERT_TRUE(cache.load(cached, sources));
+    ASSERT_EQ(parsed.getCardList().size(), cached.getCardList().size());
+    ASSERT_EQ(parsed.getSetList().size(), cached.getSetList().size());
+
+    for (const CardInfoPtr &card : parsed.getCardList()) {
+        CardInfoPtr cachedCard = cached.getCard(card->getName());
+        ASSERT_FALSE(cachedCard.isNull()) << card->getName().toStdString();
+        ASSERT_EQ(card->getText(), cachedCard->getText());
+        ASSERT_EQ(card->getIsToken(), cachedCard->getIsToken());
+        ASSERT_EQ(card->getTableRow(), cachedCard->getTableRow());
+        ASSERT_EQ(card->getProperties(), cachedCard->getProperties());
+        for (const QString &property : card->getProperties())
+            ASSERT_EQ(card->getProperty(property), cachedCard->getProperty(property));
+        ASSERT_EQ(card->getSets().keys(), cachedCard->getSets().keys());
+        ASSERT_EQ(card->getRelatedCards().size(), cachedCard->getRelatedCards().size());
+    }
+}
+
+TEST(CardDatabaseCacheTest, RejectsStaleSnapshot)
+{
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString source = tempDir.filePath("cards.xml");
+    ASSERT_TRUE(QFile::copy(QString("%1/cards.xml").arg(CARDDB_DATADIR), source));
+    CardDatabaseCache cache(tempDir.filePath("cards.cache"));
+
+    CardDatabase db;
+    ASSERT_EQ(Ok, loadSources(db, {source}));
+    ASSERT_TRUE(cache.save(db, {source}));
+
+    db.clear();
+    ASSERT_FALSE(cache.load(db, {source, QString("%1/tokens.xml").arg(CARDDB_DATADIR)}))
+        << "Snapshot accepted for a different list of sources";
+    ASSERT_EQ(0, db.getCardList().size());
+
+    QFile file(source);
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write("<!-- changed -->\n");
+    file.close();
+    ASSERT_FALSE(cache.load(db, {source})) << "Snapshot accepted after a source changed";
+    ASSERT_EQ(0, db.getCardList().size());
+}
+
+TEST(CardDatabaseCacheTest, StartupBenchmark)
+{
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString source = tempDir.filePath("cards.xml");
+    writeSyntheticDatabase(source, 20000);
+    CardDatabaseCache cache(tempDir.filePath("cards.cache"));
+
+    CardDatabase db;
+    QElapsedTimer timer;
+    timer.start();
+    ASSERT_EQ(Ok, loadSources(db, {source}));
+    const qint64 parseTime = timer.elapsed();
+    const int cardCount = db.getCardList().size();
+    ASSERT_TRUE(cache.save(db, {source}));
+
+    db.clear();
+    timer.restart();
+    ASSERT_TRUE(cache.load(db, {source}));
+    const qint64 cacheTime = timer.elapsed();
+    ASSERT_EQ(cardCount, db.getCardList().size());
+
+    std::cout << "[ BENCH    ] " << cardCount << " cards: xml " << parseTime << "ms, snapshot " << cacheTime << "ms"
+              << std::endl;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    settingsCache = new SettingsCache;
+    return RUN_ALL_TESTS();
+}
@@ -1,6 +1,18 @@
+#include "../../cockatrice/src/game/cards/card_properties.h"
 #include "mocks.h"
 
 #include "gtest/gtest.h"
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QXmlStreamReader>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 namespace
 {
@@ -30,6 +42,289 @@ TEST(CardDatabaseTest, LoadXml)
     ASSERT_EQ(0, db->getAllMainCardTypes().size()) << "Types not empty after clear";
     ASSERT_EQ(NotLoaded, db->getLoadStatus()) << "Incorrect status after clear";
 }
+
+void writeDatabase(const QString &fileName, const QString &sets, const QString &cards)
+{
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write(QString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<cockatrice_carddatabase version=\"4\">\n"
+                       "<sets>%1</sets>\n<cards>%2</cards>\n</cockatrice_carddatabase>\n")
+                   .arg(sets, cards)
+                   .toUtf8());
+}
+
+QString setXml(const QString &shortName, const QString &longName)
+{
+    return QString("<set><name>%1</name><longname>%2</longname><settype>Expansion</settype>"
+                   "<releasedate>2020-01-01</releasedate></set>")
+        .arg(shortName, longName);
+}
+
+QString cardXml(const QString &name, const QString &setName, const QString &text)
+{
+    return QString("<card><name>%1</name><set>%2</set><tablerow>0</tablerow><text>%3</text>"
+                   "<prop><type>Creature</type><maintype>Creature</maintype></prop></card>")
+        .arg(name, setName, text);
+}
+
+TEST(CardDatabaseTest, MergeKeepsLoadOrderPrecedence)
+{
+    if (settingsCache == nullptr)
+        settingsCache = new SettingsCache;
+    SettingsCache &settings = SettingsCache::instance();
+    const QString cardDatabasePath = settings.getCardDatabasePath();
+    const QString tokenDatabasePath = settings.getTokenDatabasePath();
+    const QString spoilerDatabasePath = settings.getSpoilerCardDatabasePath();
+    const QString customCardDatabasePath = settings.getCustomCardDatabasePath();
+
+    // Every file disagrees with the ones loaded before it about a set or a card they share
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_TRUE(QDir(dir.path()).mkdir("custom"));
+    writeDatabase(dir.filePath("cards.xml"), setXml("CAT", "Main Cats"),
+                  cardXml("Cat", "CAT", "from the main database"));
+    writeDatabase(dir.filePath("tokens.xml"), setXml("CAT", "Token Cats"),
+                  cardXml("Cat", "CAT", "from the tokens") + cardXml("Kitten", "CAT", "from the tokens"));
+    writeDatabase(dir.filePath("spoiler.xml"), setXml("CAT", "Spoiler Cats") + setXml("SPL", "Spoiler"),
+                  cardXml("Cat", "SPL", "from the spoilers") + cardXml("Kitten", "SPL", "from the spoilers") +
+                      cardXml("Lion", "SPL", "from the spoilers"));
+    writeDatabase(dir.filePath("custom/a.xml"), setXml("SPL", "First Custom") + setXml("CST", "First Custom"),
+                  cardXml("Lion", "CAT", "from the first custom set") +
+                      cardXml("Tiger", "CST", "from the first custom set"));
+    writeDatabase(dir.filePath("custom/b.xml"), setXml("CST", "Second Custom"),
+                  cardXml("Tiger", "CST", "from the second custom set"));
+    settings.setCardDatabasePath(dir.filePath("cards.xml"));
+    settings.setTokenDatabasePath(dir.filePath("tokens.xml"));
+    settings.setSpoilerDatabasePath(dir.filePath("spoiler.xml"));
+    settings.setCustomCardDatabasePath(dir.filePath("custom"));
+
+    CardDatabase db;
+    // the files are parsed on several threads, so give a wrong merge order a few chances to show up
+    for (int attempt = 0; attempt < 20; ++attempt) {
+        // a snapshot would skip parsing and merging altogether
+        QFile::remove(settings.getCachePath() + "/cards.cache");
+        ASSERT_EQ(Ok, db.loadCardDatabases());
+        ASSERT_EQ(4, db.getCardList().size());
+        ASSERT_EQ(3, db.getSetList().size());
+
+        // the first file that contains a card keeps it, later files only add their printings
+        EXPECT_EQ("from the main database", db.getCard("Cat")->getText());
+        EXPECT_EQ("from the tokens", db.getCard("Kitten")->getText());
+        EXPECT_EQ("from the spoilers", db.getCard("Lion")->getText());
+        EXPECT_EQ("from the first custom set", db.getCard("Tiger")->getText());
+        EXPECT_TRUE(db.getCard("Cat")->getSets().contains("SPL"));
+        EXPECT_TRUE(db.getCard("Lion")->getSets().contains("CAT"));
+
+        // the first file that mentions a set keeps its definition, later printings are moved onto it
+        EXPECT_EQ("Main Cats", db.getSet("CAT")->getLongName());
+        EXPECT_EQ("Spoiler", db.getSet("SPL")->getLongName());
+        EXPECT_EQ("First Custom", db.getSet("CST")->getLongName());
+        EXPECT_EQ(db.getSet("CAT"), db.getCard("Kitten")->getSets().value("CAT").first().getPtr());
+        EXPECT_EQ(db.getSet("CAT"), db.getCard("Lion")->getSets().value("CAT").first().getPtr());
+        EXPECT_EQ(db.getSet("SPL"), db.getCard("Cat")->getSets().value("SPL").first().getPtr());
+        if (HasFailure())
+            break;
+    }
+
+    settings.setCardDatabasePath(cardDatabasePath);
+    settings.setTokenDatabasePath(tokenDatabasePath);
+    settings.setSpoilerDatabasePath(spoilerDatabasePath);
+    settings.setCustomCardDatabasePath(customCardDatabasePath);
+}
+
+TEST(CardDatabaseTest, PropertiesShareValues)
+{
+    CardProperties first, second;
+    first.insert("rarity", QString("com") + "mon");
+    first.insert("uuid", "1234");
+    second.insert("rarity", QString("comm") + "on");
+    second.insert("rarity", "rare");
+    second.insert("rarity", QString("com") + "mon");
+
+    ASSERT_EQ(2, first.keys().size());
+    ASSERT_EQ(1, second.size()) << "Inserting a property again doesn't replace it";
+    ASSERT_EQ("common", second.value("rarity"));
+    ASSERT_TRUE(first.value("rarity").isSharedWith(second.value("rarity"))) << "Rarity values aren't interned";
+    ASSERT_FALSE(first.contains("manacost"));
+    ASSERT_EQ(QString(), first.value("never-used-property"));
+}
+
+TEST(CardDatabaseTest, PropertiesKeepTheirValuesInColumns)
+{
+    CardProperties properties;
+    for (const QString &colors : {"W", "WU", "UBR", "WUBRG", "UW", "WW", "C", "GX", "W/U", ""}) {
+        properties.insert("colors", colors);
+        ASSERT_EQ(colors, properties.value("colors")) << "Colors " << colors.toStdString() << " changed";
+    }
+    properties.insert("coloridentity", "BG");
+    properties.insert("format-modern", "legal");
+    properties.insert("uuid", "1234");
+    properties.insert("format-modern", "banned");
+    ASSERT_EQ(4, properties.size());
+    ASSERT_EQ("BG", properties.value("coloridentity"));
+    ASSERT_EQ("banned", properties.value("format-modern"));
+    ASSERT_EQ("1234", properties.value("uuid"));
+
+    CardProperties copy(QVariantHash({{"colors", "GW"}, {"rarity", "rare"}, {"picurl", "http://example.com"}}));
+    ASSERT_EQ(3, copy.size());
+    ASSERT_EQ("GW", copy.value("colors"));
+    ASSERT_EQ("rare", copy.value("rarity"));
+    ASSERT_EQ("http://example.com", copy.value("picurl"));
+    ASSERT_TRUE(copy.keys().contains("picurl"));
+}
+
+TEST(CardDatabaseTest, PropertiesInternConcurrently)
+{
+    const int threadCount = 8;
+    const int keysPerThread = 200;
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([t, &failed]() {
+            CardProperties properties;
+            for (int i = 0; i < keysPerThread; ++i) {
+                const QString name = QString("concurrent-%1-%2").arg(t).arg(i);
+                properties.insert(name, QString::number(i));
+                // an enum column, its values are interned as well
+                const QString type = QString("Creature - %1 %2").arg(t).arg(i % 50);
+                properties.insert("type", type);
+                // Lookups race with the other threads publishing new names and values
+                if (properties.value(name) != QString::number(i) || properties.contains("concurrent-0-0") != (t == 0))
+                    failed = true;
+                if (properties.value("type") != type)
+                    failed = true;
+            }
+            const QStringList keys = properties.keys();
+            const QString lastName = QString("concurrent-%1-%2").arg(t).arg(keysPerThread - 1);
+            if (keys.size() != keysPerThread + 1 || !keys.contains(lastName))
+                failed = true;
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+
+    ASSERT_FALSE(failed) << "A property was lost or misread while names were interned on other threads";
+    ASSERT_LE(threadCount * keysPerThread, CardProperties::internedKeyCount());
+}
+
+#ifdef __GLIBC__
+size_t allocatedBytes()
+{
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+    return mallinfo2().uordblks;
+#else
+    return static_cast<size_t>(mallinfo().uordblks);
+#endif
+}
+
+// Properties of a synthetic card, every string is a fresh allocation like it is when parsing the xml
+QVector<QPair<QString, QString>> syntheticProperties(int card)
+{
+    static const QStringList formats = {"standard", "pioneer", "modern",   "legacy",      "vintage",
+                                        "pauper",   "brawl",   "historic", "alchemy",     "explorer",
+                                        "timeless", "penny",   "duel",     "oathbreaker", "commander"};
+    QVector<QPair<QString, QString>> properties;
+    properties.append({QString("mana") + "cost", QString("%1").arg(card % 7) + "G"});
+    properties.append({QString("c") + "mc", QString::number(card % 7 + 1)});
+    properties.append({QString("col") + "ors", QString("G")});
+    properties.append({QString("type"), QString("Creature - ") + "Elf"});
+    properties.append({QString("main") + "type", QString("Creature")});
+    properties.append({QString("p") + "t", QString("%1/%2").arg(card % 5).arg(card % 4)});
+    properties.append({QString("lay") + "out", QString("nor") + "mal"});
+    properties.append({QString("uu") + "id", QString("00000000-0000-0000-0000-%1").arg(card, 12, 10, QChar('0'))});
+    for (const QString &format : formats)
+        properties.append({QString("format-") + format, card % 3 ? QString("le") + "gal" : QString("ban") + "ned"});
+    return properties;
+}
+
+TEST(CardDatabaseTest, PropertiesMemoryFootprint)
+{
+    const int cardCount = 5000;
+
+    const size_t hashStart = allocatedBytes();
+    QVector<QVariantHash> hashes(cardCount);
+    for (int card = 0; card < cardCount; ++card)
+        for (const auto &property : syntheticProperties(card))
+            hashes[card].insert(property.first, property.second);
+    const size_t hashBytes = allocatedBytes() - hashStart;
+
+    const size_t internedStart = allocatedBytes();
+    QVector<CardProperties> interned(cardCount);
+    for (int card = 0; card < cardCount; ++card)
+        for (const auto &property : syntheticProperties(card))
+            interned[card].insert(property.first, property.second);
+    const size_t internedBytes = allocatedBytes() - internedStart;
+
+    std::cout << "Properties of " << cardCount << " cards: QVariantHash " << hashBytes / 1024 << " KiB, interned "
+              << internedBytes / 1024 << " KiB" << std::endl;
+    ASSERT_LT(internedBytes, hashBytes);
+}
+
+// The properties of every card and printing in a cards.xml, the way the parser reads them
+QVector<QVector<QPair<QString, QString>>> readProperties(const QString &fileName)
+{
+    QVector<QVector<QPair<QString, QString>>> all;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return all;
+
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement)
+            continue;
+        if (xml.name() == QLatin1String("prop")) {
+            QVector<QPair<QString, QString>> properties;
+            while (xml.readNextStartElement()) {
+                const QString name = xml.name().toString();
+                properties.append({name, xml.readElementText()});
+            }
+            all.append(properties);
+        } else if (xml.name() == QLatin1String("set") && !xml.attributes().isEmpty()) {
+            // a printing, the sets of the <sets> list have no attributes
+            QVector<QPair<QString, QString>> properties;
+            for (const QXmlStreamAttribute &attribute : xml.attributes())
+                properties.append({attribute.name().toString(), attribute.value().toString()});
+            all.append(properties);
+        }
+    }
+    return all;
+}
+
+/**
+ * Reports the bytes per card and printing that their properties take, stored as QVariantHash and as CardProperties.
+ * Point CARDDB_MEMORY_REPORT_FILE at the cards.xml oracle makes from AllPrintings for the full report, the test
+ * database is used otherwise.
+ */
+TEST(CardDatabaseTest, PropertiesMemoryReport)
+{
+    const QByteArray reportFile = qgetenv("CARDDB_MEMORY_REPORT_FILE");
+    const QString fileName = reportFile.isEmpty() ? QString(CARDDB_DATADIR "cards.xml") : QString(reportFile);
+    const auto properties = readProperties(fileName);
+    ASSERT_FALSE(properties.isEmpty()) << "No properties in " << fileName.toStdString();
+
+    // every string is a fresh allocation, like it is when parsing the xml
+    auto copy = [](const QString &string) { return QString(string.constData(), string.size()); };
+
+    const size_t hashStart = allocatedBytes();
+    QVector<QVariantHash> hashes(properties.size());
+    for (int i = 0; i < properties.size(); ++i)
+        for (const auto &property : properties.at(i))
+            hashes[i].insert(copy(property.first), copy(property.second));
+    const size_t hashBytes = allocatedBytes() - hashStart;
+
+    const size_t internedStart = allocatedBytes();
+    QVector<CardProperties> interned(properties.size());
+    for (int i = 0; i < properties.size(); ++i)
+        for (const auto &property : properties.at(i))
+            interned[i].insert(copy(property.first), copy(property.second));
+    const size_t internedBytes = allocatedBytes() - internedStart;
+
+    std::cout << "Properties of the " << properties.size() << " cards and printings in " << fileName.toStdString()
+              << ": " << hashBytes / properties.size() << " bytes each as QVariantHash, "
+              << internedBytes / properties.size() << " bytes each in columns" << std::endl;
+    EXPECT_LT(internedBytes, hashBytes);
+}
+#endif
 } // namespace
 
 int main(int argc, char **argv)
@@ -0,0 +1,173 @@
+#include "../../cockatrice/src/game/filters/filter_plan.h"
+#include "../../cockatrice/src/game/filters/filter_tree.h"
+#include "mocks.h"
+
+#include "gtest/gtest.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <iostream>
+
+namespace
+{
+
+void writeSyntheticDatabase(const QString &fileName, int cardCount)
+{
+    static const QStringList colors = {"", "W", "U", "B", "R", "G", "WU", "BG", "URG", "WUBRG"};
+    static const QStringList types = {"Creature - Cat", "Instant", "Sorcery", "Legendary Planeswalker - Teferi",
+                                      "Artifact Creature - Golem"};
+    static const QStringList rarities = {"common", "uncommon", "rare", "mythic"};
+    static const QStringList formats = {"standard", "pioneer", "modern", "legacy", "vintage", "commander"};
+
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    QTextStream out(&file);
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<cockatrice_carddatabase version=\"4\">\n<sets>\n";
+    for (int set = 0; set < 20; ++set) {
+        out << "<set><name>S" << set << "</name><longname>Set " << set
+            << "</longname><settype>Expansion</settype><releasedate>2020-01-01</releasedate></set>\n";
+    }
+    out << "</sets>\n<cards>\n";
+    for (int card = 0; card < cardCount; ++card) {
+        const QString type = types.at(card % types.size());
+        const int cmc = card % 9;
+        out << "<card><name>Card " << card << "</name><text>When Card " << card << " enters the battlefield, "
+            << (card % 3 ? "draw a card." : "destroy target creature.") << "</text><prop><colors>"
+            << colors.at(card % colors.size()) << "</colors><manacost>" << cmc << "G" << (card % 4 ? "" : "U")
+            << "</manacost><cmc>" << (card % 50 ? QString::number(cmc) : QString("%1 // 2").arg(cmc)) << "</cmc><type>"
+            << type << "</type><maintype>" << type.section(' ', 0, 0) << "</maintype>";
+        if (type.contains("Creature")) {
+            out << "<pt>" << card % 7 << "/" << (card % 5 ? QString::number(card % 6) : QString("*")) << "</pt>";
+        }
+        if (type.contains("Planeswalker")) {
+            out << "<loyalty>" << (card % 7 ? QString::number(card % 7) : QString("X")) << "</loyalty>";
+        }
+        for (int format = 0; format < formats.size(); ++format) {
+            out << "<format-" << formats.at(format) << ">" << ((card + format) % 3 ? "legal" : "banned")
+                << "</format-" << formats.at(format) << ">";
+        }
+        out << "</prop><set rarity=\"" << rarities.at(card % rarities.size()) << "\" uuid=\"uuid-" << card << "\">S"
+            << card % 20 << "</set><tablerow>2</tablerow></card>\n";
+    }
+    out << "</cards>\n</cockatrice_carddatabase>\n";
+}
+
+class FilterPlanTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        QTemporaryDir tempDir;
+        ASSERT_TRUE(tempDir.isValid());
+        const QString source = tempDir.filePath("cards.xml");
+        writeSyntheticDatabase(source, 30000);
+
+        db = new CardDatabase;
+        db->clear();
+        ASSERT_EQ(Ok, db->loadFromFile(source));
+        cards = db->getCardList();
+        fields = FilterPlan::extractFields(cards);
+    }
+
+    static void TearDownTestCase()
+    {
+        fields.clear();
+        cards.clear();
+        delete db;
+    }
+
+    static CardDatabase *db;
+    static QList<CardInfoPtr> cards;
+    static QVector<CardFilterFields> fields;
+};
+
+CardDatabase *FilterPlanTest::db = nullptr;
+QList<CardInfoPtr> FilterPlanTest::cards;
+QVector<CardFilterFields> FilterPlanTest::fields;
+
+TEST_F(FilterPlanTest, MatchesFilterTree)
+{
+    const QList<QPair<CardFilter::Attr, QStringList>> terms = {
+        {CardFilter::AttrName, {"card 1", "CARD 29999", "nope"}},
+        {CardFilter::AttrType, {"creature", "Planeswalker"}},
+        {CardFilter::AttrColor, {"g", "green blue", "WU", "colorless", "c", ""}},
+        {CardFilter::AttrText, {"draw", "DESTROY target"}},
+        {CardFilter::AttrSet, {"s3", "Set 12", "S"}},
+        {CardFilter::AttrManaCost, {"g", "gu", "3g"}},
+        {CardFilter::AttrCmc, {"3", ">=4", "<2", "=0", ">8", "bogus"}},
+        {CardFilter::AttrRarity, {"m", "rare", "C", "u"}},
+        {CardFilter::AttrPow, {"3", ">4", "*"}},
+        {CardFilter::AttrTough, {"*", "<=1", "0"}},
+        {CardFilter::AttrLoyalty, {"x", "3", ">=5"}},
+        {CardFilter::AttrFormat, {"modern", "Commander", "unknown"}},
+    };
+
+    for (const auto &attrTerms : terms) {
+        for (int type = 0; type < CardFilter::TypeEnd; ++type) {
+            FilterTree tree;
+            for (const QString &term : attrTerms.second) {
+                tree.termNode(attrTerms.first, static_cast<CardFilter::Type>(type), term);
+            }
+
+            const FilterPlan plan(&tree);
+            const QBitArray accepted =
+                FilterPlan::run(fields, [&plan](const CardFilterFields &card) { return plan.accepts(card); });
+            for (int i = 0; i < cards.size(); ++i) {
+                ASSERT_EQ(accepted.testBit(i), tree.acceptsCard(cards.at(i)))
+                    << CardFilter::attrName(attrTerms.first).toStdString() << " "
+                    << CardFilter::typeName(static_cast<CardFilter::Type>(type)).toStdString() << " "
+                    << cards.at(i)->getName().toStdString();
+            }
+        }
+    }
+}
+
+/**
+ * Every keystroke in the deck editor filters the whole database again; compare checking the filter tree card by card
+ * with compiling it into a plan and running that over the extracted fields. Only the results have to match, the
+ * timings depend on the machine and are just reported.
+ */
+TEST_F(FilterPlanTest, FullDatabaseBenchmark)
+{
+    FilterTree tree;
+    tree.termNode(CardFilter::AttrColor, CardFilter::TypeAnd, "green");
+    tree.termNode(CardFilter::AttrCmc, CardFilter::TypeAnd, ">=2");
+    tree.termNode(CardFilter::AttrManaCost, CardFilter::TypeAnd, "g");
+    tree.termNode(CardFilter::AttrType, CardFilter::TypeOr, "creature");
+    tree.termNode(CardFilter::AttrType, CardFilter::TypeOr, "planeswalker");
+    tree.termNode(CardFilter::AttrRarity, CardFilter::TypeAndNot, "m");
+    tree.termNode(CardFilter::AttrFormat, CardFilter::TypeAnd, "modern");
+
+    QElapsedTimer timer;
+    timer.start();
+    QBitArray expected(cards.size());
+    for (int i = 0; i < cards.size(); ++i) {
+        expected.setBit(i, tree.acceptsCard(cards.at(i)));
+    }
+    const qint64 treeTime = timer.elapsed();
+
+    timer.restart();
+    const FilterPlan plan(&tree);
+    const QBitArray accepted =
+        FilterPlan::run(fields, [&plan](const CardFilterFields &card) { return plan.accepts(card); });
+    const qint64 planTime = timer.elapsed();
+
+    timer.restart();
+    FilterPlan::extractFields(cards);
+    const qint64 extractTime = timer.elapsed();
+
+    std::cout << "[ BENCH    ] " << cards.size() << " cards: filter tree " << treeTime << "ms, compiled plan "
+              << planTime << "ms (" << accepted.count(true) << " accepted), extracting fields " << extractTime
+              << "ms" << std::endl;
+
+    ASSERT_EQ(accepted, expected);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    settingsCache = new SettingsCache;
+    return RUN_ALL_TESTS();
+}
@@ -1,6 +1,8 @@
 
 #include "mocks.h"
 
+#include <QDir>
+
 CardDatabaseSettings::CardDatabaseSettings(QString settingPath, QObject *parent)
     : SettingsManager(settingPath + "cardDatabase.ini", parent)
 {
@@ -35,6 +37,10 @@ QString SettingsCache::getSettingsPath()
 {
     return "";
 }
+QString SettingsCache::getCachePath() const
+{
+    return QDir::tempPath() + "/cockatrice_carddatabase_test";
+}
 void SettingsCache::translateLegacySettings()
 {
 }
@@ -113,17 +119,21 @@ void SettingsCache::setThemesPath(const QString & /* _themesPath */)
 void SettingsCache::setPicsPath(const QString & /* _picsPath */)
 {
 }
-void SettingsCache::setCardDatabasePath(const QString & /* _cardDatabasePath */)
+void SettingsCache::setCardDatabasePath(const QString &_cardDatabasePath)
 {
+    cardDatabasePath = _cardDatabasePath;
 }
-void SettingsCache::setCustomCardDatabasePath(const QString & /* _customCardDatabasePath */)
+void SettingsCache::setCustomCardDatabasePath(const QString &_customCardDatabasePath)
 {
+    customCardDatabasePath = _customCardDatabasePath;
 }
-void SettingsCache::setSpoilerDatabasePath(const QString & /* _spoilerDatabasePath */)
+void SettingsCache::setSpoilerDatabasePath(const QString &_spoilerDatabasePath)
 {
+    spoilerDatabasePath = _spoilerDatabasePath;
 }
-void SettingsCache::setTokenDatabasePath(const QString & /* _tokenDatabasePath */)
+void SettingsCache::setTokenDatabasePath(const QString &_tokenDatabasePath)
 {
+    tokenDatabasePath = _tokenDatabasePath;
 }
 void SettingsCache::setThemeName(const QString & /* _themeName */)
 {
@@ -215,6 +225,9 @@ void SettingsCache::setChatMention(QT_STATE_CHANGED_T /* _chatMention */)
 void SettingsCache::setChatMentionCompleter(const QT_STATE_CHANGED_T /* _enableMentionCompleter */)
 {
 }
+void SettingsCache::setChatScrollback(int /* _chatScrollback */)
+{
+}
 void SettingsCache::setChatMentionForeground(QT_STATE_CHANGED_T /* _chatMentionForeground */)
 {
 }
@@ -266,6 +279,9 @@ void SettingsCache::setNetworkCacheSizeInMB(const int /* _networkCacheSize */)
 void SettingsCache::setNetworkRedirectCacheTtl(const int /* _redirectCacheTtl */)
 {
 }
+void SettingsCache::setPicDownloadConnectionsPerHost(const int /* _picDownloadConnectionsPerHost */)
+{
+}
 void SettingsCache::setClientID(const QString & /* _clientID */)
 {
 }
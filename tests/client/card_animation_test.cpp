@@ -0,0 +1,153 @@
+#include "../../cockatrice/src/client/tabs/tab_game.h"
+#include "../../cockatrice/src/client/tabs/tab_supervisor.h"
+#include "../../cockatrice/src/game/cards/card_item.h"
+#include "../../cockatrice/src/game/game_scene.h"
+#include "../../cockatrice/src/game/player/player.h"
+#include "../../cockatrice/src/game/zones/card_zone.h"
+#include "../../cockatrice/src/server/remote/remote_client.h"
+#include "../../cockatrice/src/settings/cache_settings.h"
+#include "client_globals.h"
+#include "pb/event_game_state_changed.pb.h"
+#include "pb/game_event_container.pb.h"
+#include "pb/game_replay.pb.h"
+
+#include "gtest/gtest.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGraphicsView>
+#include <QtMath>
+#include <memory>
+
+namespace
+{
+
+int tapAngle(const CardItem *card)
+{
+    const QTransform transform = card->transform();
+    return qRound(qRadiansToDegrees(qAtan2(transform.m12(), transform.m11())));
+}
+
+void processEventsFor(int ms)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < ms) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, ms);
+    }
+}
+
+/**
+ * A replay tab showing a single untapped card on the table. Nothing shows the scene until a test opens a view on it.
+ */
+class CardAnimationTest : public ::testing::Test
+{
+protected:
+    RemoteClient client;
+    TabSupervisor tabSupervisor{&client};
+    std::unique_ptr<TabGame> game;
+    CardItem *card = nullptr;
+    GameScene *scene = nullptr;
+
+    void SetUp() override
+    {
+        SettingsCache::instance().setTapAnimation(QT_STATE_CHANGED_T(Qt::Checked));
+
+        Event_GameStateChanged state;
+        state.set_game_started(true);
+        ServerInfo_Player *player = state.add_player_list();
+        player->mutable_properties()->set_player_id(0);
+        player->mutable_properties()->mutable_user_info()->set_name("Player 0");
+        ServerInfo_Zone *table = player->add_zone_list();
+        table->set_name("table");
+        table->set_card_count(1);
+        ServerInfo_Card *tableCard = table->add_card_list();
+        tableCard->set_id(1);
+        tableCard->set_name("Grizzly Bears");
+        tableCard->set_x(0);
+        tableCard->set_y(0);
+
+        auto *replay = new GameReplay;
+        replay->mutable_game_info()->set_game_id(1);
+        replay->mutable_game_info()->set_max_players(1);
+        GameEventContainer *cont = replay->add_event_list();
+        GameEvent *event = cont->add_event_list();
+        event->set_player_id(-1);
+        event->MutableExtension(Event_GameStateChanged::ext)->CopyFrom(state);
+
+        // the tab takes ownership of the replay
+        game = std::make_unique<TabGame>(&tabSupervisor, replay);
+        game->processGameEventContainer(replay->event_list(0), nullptr, Player::EventProcessingOptions());
+        ASSERT_EQ(game->getPlayers().size(), 1);
+        const CardList &cards = game->getPlayers().first()->getZones().value("table")->getCards();
+        ASSERT_EQ(cards.size(), 1);
+        card = cards.first();
+        scene = static_cast<GameScene *>(card->scene());
+        ASSERT_NE(scene, nullptr);
+    }
+};
+
+TEST_F(CardAnimationTest, AnimationAdvancesByTheElapsedTime)
+{
+    QGraphicsView view(scene);
+    view.show();
+    card->setTapped(true);
+    ASSERT_EQ(tapAngle(card), 0) << "A visible card doesn't jump to the end of the animation";
+
+    EXPECT_TRUE(card->animationEvent(TAP_ANIMATION_MS / 3));
+    EXPECT_EQ(tapAngle(card), 30);
+    EXPECT_TRUE(card->animationEvent(0));
+    EXPECT_EQ(tapAngle(card), 31) << "Even a frame shorter than a millisecond makes progress";
+    EXPECT_FALSE(card->animationEvent(10 * TAP_ANIMATION_MS));
+    EXPECT_EQ(tapAngle(card), 90) << "A long frame doesn't rotate past the end";
+
+    card->setTapped(false);
+    EXPECT_TRUE(card->animationEvent(TAP_ANIMATION_MS / 2));
+    EXPECT_EQ(tapAngle(card), 45);
+    EXPECT_FALSE(card->animationEvent(TAP_ANIMATION_MS));
+    EXPECT_EQ(tapAngle(card), 0);
+}
+
+TEST_F(CardAnimationTest, AnimationRunsWhileTheSceneIsShown)
+{
+    QGraphicsView view(scene);
+    view.show();
+    card->setTapped(true);
+    processEventsFor(5 * TAP_ANIMATION_MS);
+
+    EXPECT_EQ(tapAngle(card), 90);
+    EXPECT_GT(scene->getAnimationFrameStatistics().frames, 0);
+}
+
+TEST_F(CardAnimationTest, HiddenSceneFinishesAtOnce)
+{
+    card->setTapped(true);
+    EXPECT_EQ(tapAngle(card), 90);
+
+    processEventsFor(5 * TAP_ANIMATION_MS);
+    EXPECT_EQ(scene->getAnimationFrameStatistics().frames, 0) << "Nothing ticks for a scene nobody sees";
+}
+
+TEST_F(CardAnimationTest, HidingTheSceneFinishesRunningAnimations)
+{
+    QGraphicsView view(scene);
+    view.show();
+    card->setTapped(true);
+    ASSERT_EQ(tapAngle(card), 0);
+
+    // like switching to another tab before the first frame
+    view.hide();
+    processEventsFor(5 * TAP_ANIMATION_MS);
+    EXPECT_EQ(tapAngle(card), 90);
+    EXPECT_EQ(scene->getAnimationFrameStatistics().frames, 0);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // the scene needs a gui application, but not a screen
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ClientGlobals globals;
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+#include "../../cockatrice/src/game/cards/card_database.h"
+#include "../../cockatrice/src/game/cards/card_database_model.h"
+#include "client_globals.h"
+
+#include "gtest/gtest.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMetaObject>
+
+namespace
+{
+
+// How the P/T column compared powers and toughnesses before the keys were prepared once per card
+int lessThanNumerically(const QString &left, const QString &right)
+{
+    if (left == right) {
+        return 0;
+    }
+
+    bool okLeft, okRight;
+    float leftNum = left.toFloat(&okLeft);
+    float rightNum = right.toFloat(&okRight);
+
+    if (okLeft && okRight) {
+        if (leftNum < rightNum) {
+            return -1;
+        } else if (leftNum > rightNum) {
+            return 1;
+        } else {
+            return 0;
+        }
+    }
+    // try and parsing again, for weird ones like "1+*"
+    QString leftAfterNum = "";
+    QString rightAfterNum = "";
+    if (!okLeft) {
+        int leftNumIndex = 0;
+        for (; leftNumIndex < left.length(); leftNumIndex++) {
+            if (!left.at(leftNumIndex).isDigit()) {
+                break;
+            }
+        }
+        if (leftNumIndex != 0) {
+            leftNum = left.left(leftNumIndex).toFloat(&okLeft);
+            leftAfterNum = left.right(leftNumIndex);
+        }
+    }
+    if (!okRight) {
+        int rightNumIndex = 0;
+        for (; rightNumIndex < right.length(); rightNumIndex++) {
+            if (!right.at(rightNumIndex).isDigit()) {
+                break;
+            }
+        }
+        if (rightNumIndex != 0) {
+            rightNum = right.left(rightNumIndex).toFloat(&okRight);
+            rightAfterNum = right.right(rightNumIndex);
+        }
+    }
+    if (okLeft && okRight) {
+        if (leftNum != rightNum) {
+            // both parsed as numbers, but different number
+            if (leftNum < rightNum) {
+                return -1;
+            } else {
+                return 1;
+            }
+        } else {
+            // both parsed, same number, but at least one has something else
+            // so compare the part after the number - prefer nothing
+            return QString::localeAwareCompare(leftAfterNum, rightAfterNum);
+        }
+    } else if (okLeft) {
+        return -1;
+    } else if (okRight) {
+        return 1;
+    }
+    // couldn't parse it, just return String comparison
+    return QString::localeAwareCompare(left, right);
+}
+
+int sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+class NumericSortKeys : public CardDatabaseDisplayModel
+{
+public:
+    static int compare(const QString &left, const QString &right)
+    {
+        return compareNumerically(numericSortKey(left), numericSortKey(right));
+    }
+};
+
+TEST(CardDatabaseModelTest, NumericSortKeysKeepTheOrder)
+{
+    const QStringList values = {"0", "1",   "2",     "10",  "-1", "1.5", "01", "*",     "1+*", "2+*", "*+1", "X",
+                                "?", "1d4", "1d4+1", "7-*", "",   "3/3", "+1", "1.5+*", " 1",  "1 ",  "∞",   "½"};
+    for (const QString &left : values) {
+        for (const QString &right : values) {
+            EXPECT_EQ(sign(NumericSortKeys::compare(left, right)), sign(lessThanNumerically(left, right)))
+                << "\"" << left.toStdString() << "\" and \"" << right.toStdString() << "\" switched places";
+        }
+    }
+}
+
+/**
+ * The deck editor's view of a database with a few cards, filtered by name.
+ */
+class CardDatabaseDisplayModelTest : public ::testing::Test
+{
+protected:
+    CardDatabase db;
+    CardDatabaseModel model{&db, false};
+    CardDatabaseDisplayModel displayModel;
+    QList<CardInfoPtr> cards;
+
+    void SetUp() override
+    {
+        for (const QString &name : {"Bear", "Elf One", "Goblin", "Elf Two"}) {
+            cards << CardInfo::newInstance(name);
+            db.addCard(cards.last());
+        }
+        displayModel.setSourceModel(&model);
+        ASSERT_EQ(shownNames(), QStringList({"Bear", "Elf One", "Goblin", "Elf Two"}));
+    }
+
+    QStringList shownNames() const
+    {
+        QStringList names;
+        for (int row = 0; row < displayModel.rowCount(); ++row) {
+            names << displayModel.index(row, CardDatabaseModel::NameColumn).data().toString();
+        }
+        return names;
+    }
+
+    // Long enough for the filter delay and a filter run on a handful of cards
+    static void settle()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (timer.elapsed() < 300) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        }
+    }
+};
+
+TEST_F(CardDatabaseDisplayModelTest, StaleFilterResultIsDiscarded)
+{
+    displayModel.setCardName("elf");
+    settle();
+    ASSERT_EQ(shownNames(), QStringList({"Elf One", "Elf Two"}));
+
+    // the rows move up while the filter is running, its result would accept "Goblin" instead of "Elf One"
+    ASSERT_TRUE(QMetaObject::invokeMethod(&displayModel, "refilter", Qt::DirectConnection));
+    db.removeCard(cards.takeFirst());
+    settle();
+    EXPECT_EQ(shownNames(), QStringList({"Elf One", "Elf Two"}));
+}
+
+TEST_F(CardDatabaseDisplayModelTest, ClearingTheFilterShowsEverythingAtOnce)
+{
+    displayModel.setCardName("elf");
+    settle();
+    ASSERT_EQ(shownNames().size(), 2);
+
+    displayModel.clearFilterAll();
+    EXPECT_EQ(shownNames(), QStringList({"Bear", "Elf One", "Goblin", "Elf Two"}));
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // the card database needs a gui application for its pictures, but not a screen
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ClientGlobals globals;
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
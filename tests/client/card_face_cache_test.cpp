@@ -0,0 +1,151 @@
+#include "../../cockatrice/src/client/tabs/tab_game.h"
+#include "../../cockatrice/src/client/tabs/tab_supervisor.h"
+#include "../../cockatrice/src/game/cards/card_item.h"
+#include "../../cockatrice/src/game/player/player.h"
+#include "../../cockatrice/src/server/remote/remote_client.h"
+#include "../../cockatrice/src/settings/cache_settings.h"
+#include "client_globals.h"
+#include "pb/event_game_state_changed.pb.h"
+#include "pb/game_event_container.pb.h"
+#include "pb/game_replay.pb.h"
+
+#include "gtest/gtest.h"
+#include <QApplication>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPainter>
+#include <memory>
+
+namespace
+{
+
+// Counts how often the face is painted, as opposed to drawn from the cache
+class FaceCountingCardItem : public CardItem
+{
+public:
+    using CardItem::CardItem;
+    int facePaints = 0;
+
+protected:
+    void paintFace(QPainter *painter, const QSizeF &translatedSize, int angle) override
+    {
+        ++facePaints;
+        CardItem::paintFace(painter, translatedSize, angle);
+    }
+};
+
+/**
+ * A card of the only player of a replay tab, in the scene of the tab.
+ */
+class CardFaceCacheTest : public ::testing::Test
+{
+protected:
+    RemoteClient client;
+    TabSupervisor tabSupervisor{&client};
+    std::unique_ptr<TabGame> game;
+    FaceCountingCardItem *card = nullptr;
+    QRectF area;
+
+    void SetUp() override
+    {
+        // a hovered card would be painted at its scaled size
+        SettingsCache::instance().setCardScaling(QT_STATE_CHANGED_T(Qt::Unchecked));
+
+        Event_GameStateChanged state;
+        state.set_game_started(true);
+        ServerInfo_Player *player = state.add_player_list();
+        player->mutable_properties()->set_player_id(0);
+        player->mutable_properties()->mutable_user_info()->set_name("Player 0");
+
+        auto *replay = new GameReplay;
+        replay->mutable_game_info()->set_game_id(1);
+        replay->mutable_game_info()->set_max_players(1);
+        GameEvent *event = replay->add_event_list()->add_event_list();
+        event->set_player_id(-1);
+        event->MutableExtension(Event_GameStateChanged::ext)->CopyFrom(state);
+
+        // the tab takes ownership of the replay
+        game = std::make_unique<TabGame>(&tabSupervisor, replay);
+        game->processGameEventContainer(replay->event_list(0), nullptr, Player::EventProcessingOptions());
+        ASSERT_EQ(game->getPlayers().size(), 1);
+        Player *owner = game->getPlayers().first();
+
+        card = new FaceCountingCardItem(owner, nullptr, "Grizzly Bears", QString(), 1);
+        owner->scene()->addItem(card);
+        area = card->sceneBoundingRect().adjusted(-CARD_WIDTH, -CARD_HEIGHT, CARD_WIDTH, CARD_HEIGHT);
+        render();
+        ASSERT_EQ(card->facePaints, 1);
+    }
+
+    void TearDown() override
+    {
+        // before its owner goes away with the tab
+        delete card;
+    }
+
+    void render()
+    {
+        QImage image(area.size().toSize() * 2, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        card->scene()->render(&painter, QRectF(image.rect()), area);
+    }
+};
+
+TEST_F(CardFaceCacheTest, PaintsTheFaceOnce)
+{
+    render();
+    render();
+    EXPECT_EQ(card->facePaints, 1);
+}
+
+TEST_F(CardFaceCacheTest, HoverSelectionAndTappingKeepTheFace)
+{
+    card->setHovered(true);
+    render();
+    card->setSelected(true);
+    render();
+    card->setHovered(false);
+    card->setSelected(false);
+    render();
+    card->setTapped(true, false);
+    render();
+    EXPECT_EQ(card->facePaints, 1);
+}
+
+TEST_F(CardFaceCacheTest, AttributesOnTheFaceRepaintIt)
+{
+    int facePaints = card->facePaints;
+    auto expectRepainted = [this, &facePaints](const char *attribute) {
+        render();
+        EXPECT_EQ(card->facePaints, ++facePaints) << "Changing the " << attribute << " kept the old face";
+    };
+
+    card->setCounter(0, 3);
+    expectRepainted("counters");
+    card->setAnnotation("Haste");
+    expectRepainted("annotation");
+    card->setPT("3/3");
+    expectRepainted("power and toughness");
+    card->setDoesntUntap(true);
+    expectRepainted("doesn't untap flag");
+    card->setColor("g");
+    expectRepainted("color");
+    card->setFaceDown(true);
+    expectRepainted("face down state");
+    SettingsCache::instance().setMaxFontSize(SettingsCache::instance().getMaxFontSize() + 1);
+    expectRepainted("maximum font size");
+    SettingsCache::instance().setDisplayCardNames(QT_STATE_CHANGED_T(Qt::Unchecked));
+    expectRepainted("card name setting");
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // the scene needs a gui application, but not a screen
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ClientGlobals globals;
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
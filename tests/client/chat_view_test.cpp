@@ -0,0 +1,160 @@
+#include "../../cockatrice/src/client/tabs/tab_supervisor.h"
+#include "../../cockatrice/src/server/chat_view/chat_view.h"
+#include "../../cockatrice/src/server/remote/remote_client.h"
+#include "../../cockatrice/src/settings/cache_settings.h"
+#include "client_globals.h"
+
+#include "gtest/gtest.h"
+#include <QApplication>
+#include <QTextBlock>
+#include <memory>
+
+namespace
+{
+
+const int scrollback = 10;
+
+class NoUsers : public UserlistProxy
+{
+public:
+    bool isOwnUserRegistered() const override
+    {
+        return false;
+    }
+    QString getOwnUsername() const override
+    {
+        return "me";
+    }
+    bool isUserBuddy(const QString & /* userName */) const override
+    {
+        return false;
+    }
+    bool isUserIgnored(const QString & /* userName */) const override
+    {
+        return false;
+    }
+    const ServerInfo_User *getOnlineUser(const QString & /* userName */) const override
+    {
+        return nullptr;
+    }
+};
+
+/**
+ * A chat keeping the last ten messages, like the message log of a replay with a short scrollback.
+ */
+class ChatViewTest : public ::testing::Test
+{
+protected:
+    RemoteClient client;
+    TabSupervisor tabSupervisor{&client};
+    NoUsers userlistProxy;
+    std::unique_ptr<ChatView> chat;
+
+    void SetUp() override
+    {
+        SettingsCache::instance().setChatScrollback(scrollback);
+        chat = std::make_unique<ChatView>(&tabSupervisor, &userlistProxy, nullptr, false);
+    }
+
+    void appendMessages(int first, int last)
+    {
+        for (int i = first; i <= last; ++i) {
+            chat->appendHtml(QString("message %1").arg(i));
+        }
+    }
+
+    // The messages in the chat, without the empty block it starts with
+    QStringList messages() const
+    {
+        QStringList result;
+        for (QTextBlock block = chat->document()->begin().next(); block.isValid(); block = block.next()) {
+            result << block.text();
+        }
+        return result;
+    }
+
+    static QStringList expectedMessages(int first, int last)
+    {
+        QStringList result;
+        for (int i = first; i <= last; ++i) {
+            result << QString("message %1").arg(i);
+        }
+        return result;
+    }
+};
+
+TEST_F(ChatViewTest, TrimmingKeepsTheNewestMessages)
+{
+    // a tenth more than the scrollback is allowed before anything is removed
+    appendMessages(1, 12);
+    EXPECT_EQ(messages(), expectedMessages(1, 12));
+
+    int length = chat->getLength();
+    appendMessages(13, 13);
+    EXPECT_EQ(messages(), expectedMessages(3, 13));
+    EXPECT_EQ(chat->document()->blockCount(), scrollback + 2);
+    EXPECT_GT(chat->getLength(), length) << "The length counts the removed messages as well";
+}
+
+TEST_F(ChatViewTest, TruncateAfterTrimming)
+{
+    appendMessages(1, 5);
+    const int length = chat->getLength();
+    const bool evenNumber = chat->getEvenNumber();
+    appendMessages(6, 15);
+    ASSERT_EQ(messages(), expectedMessages(5, 15));
+
+    chat->truncateChat(length, evenNumber);
+    EXPECT_EQ(messages(), expectedMessages(5, 5));
+    EXPECT_EQ(chat->document()->blockCount(), 2);
+    EXPECT_EQ(chat->getLength(), length);
+    EXPECT_EQ(chat->getEvenNumber(), evenNumber);
+
+    // going on from there ends up where the chat was before
+    appendMessages(6, 15);
+    EXPECT_EQ(messages(), expectedMessages(5, 15));
+}
+
+TEST_F(ChatViewTest, TruncateToMessagesThatWereTrimmed)
+{
+    appendMessages(1, 3);
+    const int length = chat->getLength();
+    const bool evenNumber = chat->getEvenNumber();
+    appendMessages(4, 4);
+    const int nextLength = chat->getLength();
+    appendMessages(5, 15);
+    ASSERT_EQ(messages(), expectedMessages(5, 15));
+
+    // nothing of the chat at that point is left, so all of it goes
+    chat->truncateChat(length, evenNumber);
+    EXPECT_EQ(messages(), QStringList());
+    EXPECT_EQ(chat->document()->blockCount(), 1);
+    EXPECT_EQ(chat->getLength(), length);
+
+    appendMessages(4, 4);
+    EXPECT_EQ(messages(), expectedMessages(4, 4));
+    EXPECT_EQ(chat->getLength(), nextLength) << "The chat has the length it had the first time around";
+
+    // truncating again within what is left
+    chat->truncateChat(length, evenNumber);
+    EXPECT_EQ(messages(), QStringList());
+    EXPECT_EQ(chat->getLength(), length);
+}
+
+TEST_F(ChatViewTest, TruncatePastTheEndKeepsEverything)
+{
+    appendMessages(1, 15);
+    chat->truncateChat(chat->getLength(), chat->getEvenNumber());
+    EXPECT_EQ(messages(), expectedMessages(5, 15));
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // the client's globals need a gui application, but not a screen
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ClientGlobals globals;
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,52 @@
+#include "client_globals.h"
+
+#include "../../cockatrice/src/client/sound_engine.h"
+#include "../../cockatrice/src/client/ui/theme_manager.h"
+#include "../../cockatrice/src/main.h"
+#include "../../cockatrice/src/settings/cache_settings.h"
+#include "rng_sfmt.h"
+
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QTranslator>
+
+// the globals and functions main.cpp defines in the client
+QTranslator *translator;
+RNG_Abstract *rng;
+SoundEngine *soundEngine;
+QSystemTrayIcon *trayIcon;
+ThemeManager *themeManager;
+
+const QString translationPrefix = "cockatrice";
+QString translationPath;
+
+void installNewTranslator()
+{
+}
+
+QString const generateClientID()
+{
+    return "test";
+}
+
+ClientGlobals::ClientGlobals()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QCoreApplication::setOrganizationName("Cockatrice");
+    QCoreApplication::setApplicationName("Cockatrice");
+
+    SettingsCache::instance().setSoundEnabled(QT_STATE_CHANGED_T(Qt::Unchecked));
+
+    rng = new RNG_SFMT;
+    themeManager = new ThemeManager;
+    soundEngine = new SoundEngine;
+    translator = new QTranslator;
+}
+
+ClientGlobals::~ClientGlobals()
+{
+    delete translator;
+    delete soundEngine;
+    delete themeManager;
+    delete rng;
+}
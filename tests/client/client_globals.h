@@ -0,0 +1,17 @@
+#ifndef CLIENT_GLOBALS_H
+#define CLIENT_GLOBALS_H
+
+/**
+ * Sets up the globals that main() of the client creates, for tests linking cockatrice_client. Settings are kept in
+ * the test locations of QStandardPaths rather than the ones of the user, and sound is turned off.
+ *
+ * Needs a QApplication to exist already.
+ */
+class ClientGlobals
+{
+public:
+    ClientGlobals();
+    ~ClientGlobals();
+};
+
+#endif
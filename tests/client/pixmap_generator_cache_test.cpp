@@ -0,0 +1,140 @@
+#include "../../cockatrice/src/client/ui/pixel_map_generator.h"
+#include "client_globals.h"
+
+#include "gtest/gtest.h"
+#include <QApplication>
+#include <QSet>
+#include <QTemporaryDir>
+#include <iterator>
+
+namespace
+{
+
+const PixmapGeneratorCache::Generator generators[] = {
+    PixmapGeneratorCache::Phase,   PixmapGeneratorCache::Counter,   PixmapGeneratorCache::Ping,
+    PixmapGeneratorCache::Country, PixmapGeneratorCache::UserLevel, PixmapGeneratorCache::Lock,
+};
+
+class PixmapGeneratorCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        for (PixmapGeneratorCache::Generator generator : generators) {
+            PixmapGeneratorCache::clear(generator);
+        }
+    }
+};
+
+TEST_F(PixmapGeneratorCacheTest, BucketHeights)
+{
+    QSet<int> buckets;
+    for (int height = 1; height <= 1000; ++height) {
+        const int bucket = PixmapGeneratorCache::bucketHeight(height);
+        ASSERT_GE(bucket, height) << "Pictures are only ever scaled down";
+        ASSERT_LE(bucket, qMax(16, height * 3 / 2 + 1)) << "Height " << height << " renders a needlessly large picture";
+        ASSERT_EQ(PixmapGeneratorCache::bucketHeight(bucket), bucket) << "A bucket height is its own bucket";
+        buckets.insert(bucket);
+    }
+    EXPECT_EQ(PixmapGeneratorCache::bucketHeight(16), 16);
+    EXPECT_EQ(PixmapGeneratorCache::bucketHeight(17), 24);
+    EXPECT_LT(buckets.size(), 16) << "Resizing a view renders a picture for every few heights only";
+}
+
+TEST_F(PixmapGeneratorCacheTest, KeysKeepTheirParts)
+{
+    const quint64 key = PixmapGeneratorCache::key(PixmapGeneratorCache::Lock, 0xabcdef, 0x12345678);
+    EXPECT_EQ(key >> 56, quint64(PixmapGeneratorCache::Lock));
+    EXPECT_EQ((key >> 32) & 0xffffff, 0xabcdefu);
+    EXPECT_EQ(key & 0xffffffff, 0x12345678u);
+
+    // no part spills over into the one next to it
+    QSet<quint64> keys;
+    for (PixmapGeneratorCache::Generator generator : generators) {
+        for (int size : {0, 1, 0xffffff}) {
+            for (quint32 id : {0u, 1u, 0xffffffffu}) {
+                keys.insert(PixmapGeneratorCache::key(generator, size, id));
+            }
+        }
+    }
+    EXPECT_EQ(keys.size(), int(std::size(generators)) * 3 * 3);
+}
+
+TEST_F(PixmapGeneratorCacheTest, DropsLeastRecentlyUsedAboveTheLimit)
+{
+    QPixmap pixmap(64, 64);
+    pixmap.fill(Qt::red);
+    const int cost = qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024);
+    const int fitting = PIXMAP_GENERATOR_CACHE_LIMIT / cost;
+    auto key = [](quint32 id) { return PixmapGeneratorCache::key(PixmapGeneratorCache::Ping, 64, id); };
+
+    PixmapGeneratorCache::insert(key(0), pixmap);
+    for (int id = 1; id <= 2 * fitting; ++id) {
+        PixmapGeneratorCache::insert(key(id), pixmap);
+        // the first pixmap keeps being used
+        if (id % (fitting / 4) == 0) {
+            QPixmap found;
+            ASSERT_TRUE(PixmapGeneratorCache::find(key(0), found));
+        }
+    }
+
+    QPixmap found;
+    int cached = 0;
+    for (int id = 0; id <= 2 * fitting; ++id) {
+        if (PixmapGeneratorCache::find(key(id), found)) {
+            ++cached;
+        }
+    }
+    EXPECT_LE(cached, fitting);
+    EXPECT_TRUE(PixmapGeneratorCache::find(key(0), found)) << "A pixmap in use was dropped";
+    EXPECT_FALSE(PixmapGeneratorCache::find(key(1), found)) << "An unused pixmap stayed above the limit";
+    EXPECT_TRUE(PixmapGeneratorCache::find(key(2 * fitting), found)) << "The newest pixmap was dropped";
+}
+
+TEST_F(PixmapGeneratorCacheTest, ClearOnlyDropsItsGenerator)
+{
+    QPixmap pixmap(16, 16);
+    pixmap.fill(Qt::red);
+    PixmapGeneratorCache::insert(PixmapGeneratorCache::key(PixmapGeneratorCache::Phase, 16, 1), pixmap);
+    PixmapGeneratorCache::insert(PixmapGeneratorCache::key(PixmapGeneratorCache::Counter, 16, 1), pixmap);
+
+    PixmapGeneratorCache::clear(PixmapGeneratorCache::Phase);
+    QPixmap found;
+    EXPECT_FALSE(PixmapGeneratorCache::find(PixmapGeneratorCache::key(PixmapGeneratorCache::Phase, 16, 1), found));
+    EXPECT_TRUE(PixmapGeneratorCache::find(PixmapGeneratorCache::key(PixmapGeneratorCache::Counter, 16, 1), found));
+}
+
+TEST_F(PixmapGeneratorCacheTest, ClearDropsThePicturesScaledFrom)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("lock.png");
+    QImage image(32, 32, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    ASSERT_TRUE(image.save(path));
+
+    auto colorAt = [&path]() {
+        return PixmapGeneratorCache::themePixmap(PixmapGeneratorCache::Lock, path, QSize(16, 16))
+            .toImage()
+            .pixelColor(8, 8);
+    };
+    EXPECT_EQ(colorAt(), QColor(Qt::red));
+
+    image.fill(Qt::green);
+    ASSERT_TRUE(image.save(path));
+    EXPECT_EQ(colorAt(), QColor(Qt::red)) << "The picture is scaled from the one read before";
+
+    PixmapGeneratorCache::clear(PixmapGeneratorCache::Lock);
+    EXPECT_EQ(colorAt(), QColor(Qt::green)) << "The picture wasn't read again after clearing its generator";
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // pixmaps need a gui application, but not a screen
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ClientGlobals globals;
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
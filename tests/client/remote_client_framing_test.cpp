@@ -0,0 +1,180 @@
+#include "../../cockatrice/src/server/remote/remote_client.h"
+#include "client_globals.h"
+#include "pb/event_server_identification.pb.h"
+#include "pb/event_server_message.pb.h"
+#include "pb/server_message.pb.h"
+#include "pb/session_event.pb.h"
+
+#include "gtest/gtest.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <functional>
+
+namespace
+{
+
+// A message as the server puts it on the wire: its length as four big-endian bytes, then the message
+QByteArray frame(const ServerMessage &message)
+{
+    const std::string data = message.SerializeAsString();
+    const auto length = static_cast<quint32>(data.size());
+    QByteArray framed;
+    framed.append(static_cast<char>(length >> 24));
+    framed.append(static_cast<char>(length >> 16));
+    framed.append(static_cast<char>(length >> 8));
+    framed.append(static_cast<char>(length));
+    framed.append(data.data(), static_cast<int>(data.size()));
+    return framed;
+}
+
+QByteArray serverMessage(const QString &text)
+{
+    ServerMessage message;
+    message.set_message_type(ServerMessage::SESSION_EVENT);
+    message.mutable_session_event()->MutableExtension(Event_ServerMessage::ext)->set_message(text.toStdString());
+    return frame(message);
+}
+
+// Makes the client give up on the connection
+QByteArray wrongProtocolVersion()
+{
+    ServerMessage message;
+    message.set_message_type(ServerMessage::SESSION_EVENT);
+    message.mutable_session_event()->MutableExtension(Event_ServerIdentification::ext)->set_protocol_version(0);
+    return frame(message);
+}
+
+bool processEventsUntil(const std::function<bool()> &done)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!done() && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+    }
+    return done();
+}
+
+// Long enough for a write on the loopback device to be read by the client
+void settle()
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 100) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+    }
+}
+
+/**
+ * A client connected to a local server that writes whatever a test hands it, one write per read of the client.
+ */
+class RemoteClientFramingTest : public ::testing::Test
+{
+protected:
+    QTcpServer server;
+    RemoteClient client;
+    QTcpSocket *connection = nullptr;
+    QStringList received;
+    int mismatches = 0;
+
+    void SetUp() override
+    {
+        QObject::connect(&client, &AbstractClient::serverMessageEventReceived,
+                         [this](const Event_ServerMessage &event) {
+                             received << QString::fromStdString(event.message());
+                         });
+        QObject::connect(&client, &RemoteClient::protocolVersionMismatch, [this]() { ++mismatches; });
+        ASSERT_TRUE(server.listen(QHostAddress::LocalHost));
+        connectToServer();
+    }
+
+    void connectToServer()
+    {
+        client.connectToServer("127.0.0.1", server.serverPort(), "user", QString());
+        ASSERT_TRUE(processEventsUntil([this]() { return server.hasPendingConnections(); }));
+        connection = server.nextPendingConnection();
+    }
+
+    void send(const QByteArray &data)
+    {
+        connection->write(data);
+        ASSERT_TRUE(connection->waitForBytesWritten(5000));
+        settle();
+    }
+
+    void expectReceived(const QStringList &messages)
+    {
+        EXPECT_TRUE(processEventsUntil([this, &messages]() { return received.size() >= messages.size(); }));
+        settle();
+        EXPECT_EQ(received, messages);
+    }
+};
+
+TEST_F(RemoteClientFramingTest, SeveralMessagesInOneRead)
+{
+    send(serverMessage("one") + serverMessage("two") + serverMessage("three"));
+    expectReceived({"one", "two", "three"});
+
+    send(serverMessage("four") + serverMessage("five"));
+    expectReceived({"one", "two", "three", "four", "five"});
+}
+
+TEST_F(RemoteClientFramingTest, SplitHeader)
+{
+    const QByteArray data = serverMessage("one") + serverMessage("two");
+    const int secondHeader = serverMessage("one").size();
+
+    // the first read is too short to tell the current protocol from the old one
+    send(data.left(2));
+    send(data.mid(2, secondHeader));
+    expectReceived({"one"});
+
+    send(data.mid(2 + secondHeader, 1));
+    send(data.mid(3 + secondHeader, 2));
+    EXPECT_EQ(received, QStringList({"one"}));
+    send(data.mid(5 + secondHeader));
+    expectReceived({"one", "two"});
+}
+
+TEST_F(RemoteClientFramingTest, SplitBody)
+{
+    const QByteArray first = serverMessage("one");
+    const QByteArray second = serverMessage("a longer message that arrives in pieces");
+    send(first + second.left(6));
+    expectReceived({"one"});
+
+    for (int i = 6; i < second.size() - 1; i += 7) {
+        send(second.mid(i, qMin(7, second.size() - 1 - i)));
+    }
+    EXPECT_EQ(received, QStringList({"one"})) << "A message was parsed before all of it arrived";
+
+    // the rest of the message followed by the next one
+    send(second.right(1) + serverMessage("three"));
+    expectReceived({"one", "a longer message that arrives in pieces", "three"});
+}
+
+TEST_F(RemoteClientFramingTest, DisconnectMidBuffer)
+{
+    send(serverMessage("one") + wrongProtocolVersion() + serverMessage("two"));
+    expectReceived({"one"});
+    EXPECT_EQ(mismatches, 1);
+    EXPECT_EQ(client.getStatus(), StatusDisconnected);
+
+    // nothing of the old connection is left over for the next one
+    delete connection;
+    connectToServer();
+    send(serverMessage("three"));
+    expectReceived({"one", "three"});
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // the client's globals need a gui application, but not a screen
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ClientGlobals globals;
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
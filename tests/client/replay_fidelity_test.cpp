@@ -0,0 +1,542 @@
+#include "../../cockatrice/src/client/network/replay_timeline_widget.h"
+#include "../../cockatrice/src/client/tabs/tab_game.h"
+#include "../../cockatrice/src/client/tabs/tab_supervisor.h"
+#include "../../cockatrice/src/game/headless_game_state.h"
+#include "../../cockatrice/src/game/player/player.h"
+#include "../../cockatrice/src/game/zones/card_zone.h"
+#include "../../cockatrice/src/server/remote/remote_client.h"
+#include "client_globals.h"
+#include "pb/card_attributes.pb.h"
+#include "pb/color.pb.h"
+#include "pb/event_attach_card.pb.h"
+#include "pb/event_create_arrow.pb.h"
+#include "pb/event_create_token.pb.h"
+#include "pb/event_delete_arrow.pb.h"
+#include "pb/event_destroy_card.pb.h"
+#include "pb/event_draw_cards.pb.h"
+#include "pb/event_game_state_changed.pb.h"
+#include "pb/event_move_card.pb.h"
+#include "pb/event_set_active_phase.pb.h"
+#include "pb/event_set_active_player.pb.h"
+#include "pb/event_set_card_attr.pb.h"
+#include "pb/event_set_card_counter.pb.h"
+#include "pb/event_set_counter.pb.h"
+#include "pb/game_event_container.pb.h"
+#include "pb/game_replay.pb.h"
+
+#include "gtest/gtest.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+
+const int deckSize = 60;
+const int secondsPerTurn = 6;
+const char *const zoneNames[] = {"deck", "hand", "table", "grave", "rfg", "sb", "stack"};
+const char *const cardNames[] = {"Forest", "Llanowar Elves", "Grizzly Bears", "Giant Growth", "Serra Angel"};
+
+template <typename T> void addEvent(GameEventContainer *cont, int playerId, const T &event)
+{
+    GameEvent *gameEvent = cont->add_event_list();
+    gameEvent->set_player_id(playerId);
+    gameEvent->MutableExtension(T::ext)->CopyFrom(event);
+}
+
+/**
+ * Writes down a game between two players the way the server records it for a replay. Every turn the active player
+ * untaps, draws a card, plays and taps it, and the other player loses some life. Every few turns the card gets a
+ * counter, a token attached to it or an arrow pointing at the other player. Old cards go to the graveyard and from
+ * there back into the library, so the game can go on for as long as needed.
+ */
+class ReplayRecorder
+{
+public:
+    explicit ReplayRecorder(int turns)
+    {
+        recordStart();
+        for (int turn = 0; turn < turns; ++turn) {
+            recordTurn(turn);
+        }
+    }
+    const GameReplay &getReplay() const
+    {
+        return replay;
+    }
+
+private:
+    struct PlayerState
+    {
+        int deckCount = deckSize;
+        // cards played from the hand, oldest first
+        QList<int> table;
+        // card on the table -> token attached to it
+        QMap<int, int> tokens;
+        // top first
+        QList<int> grave;
+        int arrowId = -1;
+        int nextArrowId = 0;
+        int life = 20;
+    };
+
+    GameReplay replay;
+    PlayerState players[2];
+    int nextCardId = 1000;
+    int seconds = 0;
+
+    GameEventContainer *newContainer()
+    {
+        GameEventContainer *cont = replay.add_event_list();
+        cont->set_seconds_elapsed(seconds);
+        return cont;
+    }
+    template <typename T> void record(int playerId, const T &event)
+    {
+        addEvent(newContainer(), playerId, event);
+    }
+
+    void recordStart()
+    {
+        ServerInfo_Game *gameInfo = replay.mutable_game_info();
+        gameInfo->set_game_id(1);
+        gameInfo->set_description("Recorded game");
+        gameInfo->set_max_players(2);
+        gameInfo->set_player_count(2);
+
+        // the replay starts with what an omniscient spectator gets
+        Event_GameStateChanged state;
+        state.set_game_started(true);
+        state.set_active_player_id(0);
+        state.set_active_phase(0);
+        for (int playerId = 0; playerId < 2; ++playerId) {
+            ServerInfo_Player *player = state.add_player_list();
+            ServerInfo_PlayerProperties *properties = player->mutable_properties();
+            properties->set_player_id(playerId);
+            properties->mutable_user_info()->set_name("Player " + std::to_string(playerId));
+            for (const char *zoneName : zoneNames) {
+                player->add_zone_list()->set_name(zoneName);
+            }
+            player->mutable_zone_list(0)->set_card_count(deckSize);
+
+            ServerInfo_Counter *life = player->add_counter_list();
+            life->set_id(0);
+            life->set_name("life");
+            life->set_count(players[playerId].life);
+            life->set_radius(25);
+            color *lifeColor = life->mutable_counter_color();
+            lifeColor->set_r(255);
+            lifeColor->set_g(255);
+            lifeColor->set_b(255);
+            lifeColor->set_a(255);
+        }
+        record(-1, state);
+    }
+
+    void recordTurn(int turn)
+    {
+        const int playerId = turn % 2;
+        const int otherPlayerId = 1 - playerId;
+        PlayerState &player = players[playerId];
+        seconds = 1 + turn * secondsPerTurn;
+
+        Event_SetActivePlayer activePlayer;
+        activePlayer.set_active_player_id(playerId);
+        record(-1, activePlayer);
+
+        Event_SetCardAttr untap;
+        untap.set_zone_name("table");
+        untap.set_attribute(AttrTapped);
+        untap.set_attr_value("0");
+        record(playerId, untap);
+
+        Event_SetActivePhase phase;
+        phase.set_phase(2);
+        record(-1, phase);
+
+        const int drawnId = nextCardId++;
+        const std::string cardName = cardNames[turn % (sizeof(cardNames) / sizeof(cardNames[0]))];
+        Event_DrawCards draw;
+        draw.set_number(1);
+        ServerInfo_Card *drawn = draw.add_cards();
+        drawn->set_id(drawnId);
+        drawn->set_name(cardName);
+        record(playerId, draw);
+        --player.deckCount;
+
+        ++seconds;
+        phase.set_phase(3);
+        record(-1, phase);
+
+        const int playedId = nextCardId++;
+        Event_MoveCard play;
+        play.set_card_id(drawnId);
+        play.set_card_name(cardName);
+        play.set_start_player_id(playerId);
+        play.set_start_zone("hand");
+        play.set_position(-1);
+        play.set_target_player_id(playerId);
+        play.set_target_zone("table");
+        play.set_x((turn / 2) % 20);
+        play.set_y(0);
+        play.set_new_card_id(playedId);
+        record(playerId, play);
+        player.table.append(playedId);
+
+        Event_SetCardAttr tap;
+        tap.set_zone_name("table");
+        tap.set_card_id(playedId);
+        tap.set_attribute(AttrTapped);
+        tap.set_attr_value("1");
+        record(playerId, tap);
+
+        ++seconds;
+        if (turn % 3 == 0) {
+            Event_SetCardCounter counter;
+            counter.set_zone_name("table");
+            counter.set_card_id(playedId);
+            counter.set_counter_id(0);
+            counter.set_counter_value(turn % 4 + 1);
+            record(playerId, counter);
+        }
+        if ((turn / 2) % 3 == 1) {
+            const int tokenId = nextCardId++;
+            Event_CreateToken token;
+            token.set_zone_name("table");
+            token.set_card_id(tokenId);
+            token.set_card_name("Saproling");
+            token.set_color("g");
+            token.set_pt("1/1");
+            token.set_destroy_on_zone_change(true);
+            token.set_x((turn / 2) % 20);
+            token.set_y(1);
+            record(playerId, token);
+
+            Event_AttachCard attach;
+            attach.set_start_zone("table");
+            attach.set_card_id(tokenId);
+            attach.set_target_player_id(playerId);
+            attach.set_target_zone("table");
+            attach.set_target_card_id(playedId);
+            record(playerId, attach);
+            player.tokens.insert(playedId, tokenId);
+        }
+        if (player.arrowId != -1) {
+            Event_DeleteArrow deleteArrow;
+            deleteArrow.set_arrow_id(player.arrowId);
+            record(playerId, deleteArrow);
+            player.arrowId = -1;
+        }
+        if ((turn / 2) % 2 == 0) {
+            Event_CreateArrow arrow;
+            ServerInfo_Arrow *arrowInfo = arrow.mutable_arrow_info();
+            arrowInfo->set_id(player.nextArrowId);
+            arrowInfo->set_start_player_id(playerId);
+            arrowInfo->set_start_zone("table");
+            arrowInfo->set_start_card_id(playedId);
+            arrowInfo->set_target_player_id(otherPlayerId);
+            color *arrowColor = arrowInfo->mutable_arrow_color();
+            arrowColor->set_r(255);
+            arrowColor->set_a(255);
+            record(playerId, arrow);
+            player.arrowId = player.nextArrowId++;
+        }
+
+        ++seconds;
+        PlayerState &otherPlayer = players[otherPlayerId];
+        otherPlayer.life = otherPlayer.life > 3 ? otherPlayer.life - 1 - turn % 3 : 20;
+        Event_SetCounter life;
+        life.set_counter_id(0);
+        life.set_value(otherPlayer.life);
+        record(otherPlayerId, life);
+
+        // keep the table and the graveyard from growing forever
+        ++seconds;
+        if (player.table.size() > 8) {
+            const int oldId = player.table.takeFirst();
+            if (player.tokens.contains(oldId)) {
+                const int tokenId = player.tokens.take(oldId);
+                GameEventContainer *cont = newContainer();
+                Event_AttachCard unattach;
+                unattach.set_start_zone("table");
+                unattach.set_card_id(tokenId);
+                addEvent(cont, playerId, unattach);
+                Event_DestroyCard destroy;
+                destroy.set_zone_name("table");
+                destroy.set_card_id(tokenId);
+                addEvent(cont, playerId, destroy);
+            }
+
+            const int buriedId = nextCardId++;
+            Event_MoveCard bury;
+            bury.set_card_id(oldId);
+            bury.set_start_player_id(playerId);
+            bury.set_start_zone("table");
+            bury.set_position(-1);
+            bury.set_target_player_id(playerId);
+            bury.set_target_zone("grave");
+            bury.set_x(0);
+            bury.set_y(0);
+            bury.set_new_card_id(buriedId);
+            record(playerId, bury);
+            player.grave.prepend(buriedId);
+        }
+        if (player.grave.size() > 5) {
+            Event_MoveCard shuffleIn;
+            shuffleIn.set_card_id(player.grave.takeLast());
+            shuffleIn.set_start_player_id(playerId);
+            shuffleIn.set_start_zone("grave");
+            shuffleIn.set_position(-1);
+            shuffleIn.set_target_player_id(playerId);
+            shuffleIn.set_target_zone("deck");
+            shuffleIn.set_x(player.deckCount);
+            shuffleIn.set_y(0);
+            shuffleIn.set_new_card_id(-1);
+            record(playerId, shuffleIn);
+            ++player.deckCount;
+        }
+    }
+};
+
+// The game as shown, see TabGame::currentGameState()
+Event_GameStateChanged sceneState(const TabGame &game)
+{
+    Event_GameStateChanged state;
+    for (const Player *player : game.getPlayers()) {
+        player->writePlayerInfo(state.add_player_list());
+    }
+    return state;
+}
+
+// Applies the events like seeking backwards does
+void applyEvents(TabGame &game, const GameReplay &replay, int from, int to)
+{
+    Player::EventProcessingOptions options;
+    options |= Player::EventProcessingOption::SKIP_REVEAL_WINDOW;
+    options |= Player::EventProcessingOption::SKIP_TAP_ANIMATION;
+    for (int i = from; i < to; ++i) {
+        game.processGameEventContainer(replay.event_list(i), nullptr, options);
+    }
+}
+
+/**
+ * The parts of the players both the scene and HeadlessGameState keep track of, sorted and with every field set. The
+ * cards in hidden zones are only counted, neither side knows what they are.
+ */
+std::string describePlayers(const Event_GameStateChanged &state, const QSet<HeadlessGameState::ZoneKey> &hiddenZones)
+{
+    QMap<int, const ServerInfo_Player *> players;
+    for (const ServerInfo_Player &player : state.player_list()) {
+        players.insert(player.properties().player_id(), &player);
+    }
+
+    Event_GameStateChanged description;
+    for (const ServerInfo_Player *player : players) {
+        const int playerId = player->properties().player_id();
+        ServerInfo_Player *described = description.add_player_list();
+        described->mutable_properties()->set_player_id(playerId);
+        described->mutable_properties()->set_conceded(player->properties().conceded());
+
+        QMap<std::string, const ServerInfo_Zone *> zones;
+        for (const ServerInfo_Zone &zone : player->zone_list()) {
+            zones.insert(zone.name(), &zone);
+        }
+        for (const ServerInfo_Zone *zone : zones) {
+            ServerInfo_Zone *describedZone = described->add_zone_list();
+            describedZone->set_name(zone->name());
+            describedZone->set_card_count(zone->card_count());
+            describedZone->set_always_reveal_top_card(zone->always_reveal_top_card());
+            if (hiddenZones.contains(HeadlessGameState::ZoneKey(playerId, QString::fromStdString(zone->name())))) {
+                continue;
+            }
+            for (const ServerInfo_Card &card : zone->card_list()) {
+                ServerInfo_Card *describedCard = describedZone->add_card_list();
+                describedCard->set_id(card.id());
+                describedCard->set_name(card.name());
+                describedCard->set_provider_id(card.provider_id());
+                if (zone->name() == "table") {
+                    describedCard->set_x(card.x());
+                    describedCard->set_y(card.y());
+                }
+                describedCard->set_tapped(card.tapped());
+                describedCard->set_attacking(card.attacking());
+                describedCard->set_face_down(card.face_down());
+                describedCard->set_pt(card.pt());
+                describedCard->set_annotation(card.annotation());
+                describedCard->set_color(card.color());
+                describedCard->set_destroy_on_zone_change(card.destroy_on_zone_change());
+                describedCard->set_doesnt_untap(card.doesnt_untap());
+                QMap<int, int> counters;
+                for (const ServerInfo_CardCounter &counter : card.counter_list()) {
+                    counters.insert(counter.id(), counter.value());
+                }
+                for (auto counter = counters.constBegin(); counter != counters.constEnd(); ++counter) {
+                    ServerInfo_CardCounter *describedCounter = describedCard->add_counter_list();
+                    describedCounter->set_id(counter.key());
+                    describedCounter->set_value(counter.value());
+                }
+                if (card.has_attach_player_id()) {
+                    describedCard->set_attach_player_id(card.attach_player_id());
+                    describedCard->set_attach_zone(card.attach_zone());
+                    describedCard->set_attach_card_id(card.attach_card_id());
+                }
+            }
+        }
+
+        QMap<int, const ServerInfo_Counter *> counters;
+        for (const ServerInfo_Counter &counter : player->counter_list()) {
+            counters.insert(counter.id(), &counter);
+        }
+        for (const ServerInfo_Counter *counter : counters) {
+            ServerInfo_Counter *describedCounter = described->add_counter_list();
+            describedCounter->set_id(counter->id());
+            describedCounter->set_name(counter->name());
+            describedCounter->set_count(counter->count());
+        }
+
+        QMap<int, const ServerInfo_Arrow *> arrows;
+        for (const ServerInfo_Arrow &arrow : player->arrow_list()) {
+            arrows.insert(arrow.id(), &arrow);
+        }
+        for (const ServerInfo_Arrow *arrow : arrows) {
+            ServerInfo_Arrow *describedArrow = described->add_arrow_list();
+            describedArrow->set_id(arrow->id());
+            describedArrow->set_start_player_id(arrow->start_player_id());
+            describedArrow->set_start_zone(arrow->start_zone());
+            describedArrow->set_start_card_id(arrow->start_card_id());
+            describedArrow->set_target_player_id(arrow->target_player_id());
+            if (!arrow->target_zone().empty()) {
+                describedArrow->set_target_zone(arrow->target_zone());
+                describedArrow->set_target_card_id(arrow->target_card_id());
+            }
+        }
+    }
+    return description.DebugString();
+}
+
+void clickTimeline(ReplayTimelineWidget *timeline, qreal fraction)
+{
+    QMouseEvent click(QEvent::MouseButtonPress, QPointF(fraction * timeline->width(), 1), Qt::LeftButton,
+                      Qt::LeftButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(timeline, &click);
+}
+
+class ReplayFidelityTest : public ::testing::Test
+{
+protected:
+    RemoteClient client;
+    TabSupervisor tabSupervisor{&client};
+
+    std::unique_ptr<TabGame> openReplay(const GameReplay &replay)
+    {
+        // the tab takes ownership of the replay
+        return std::make_unique<TabGame>(&tabSupervisor, new GameReplay(replay));
+    }
+};
+
+TEST_F(ReplayFidelityTest, GameStateRoundTripsThroughTheScene)
+{
+    const GameReplay replay = ReplayRecorder(200).getReplay();
+    const int middle = replay.event_list_size() / 2;
+
+    std::unique_ptr<TabGame> played = openReplay(replay);
+    applyEvents(*played, replay, 0, middle);
+    const Event_GameStateChanged snapshot = sceneState(*played);
+    ASSERT_EQ(snapshot.player_list_size(), 2);
+
+    // shown on a scene that only saw the start of the game, the way a keyframe gets restored
+    std::unique_ptr<TabGame> restored = openReplay(replay);
+    applyEvents(*restored, replay, 0, 1);
+    GameEventContainer restore;
+    addEvent(&restore, -1, snapshot);
+    restored->processGameEventContainer(restore, nullptr, Player::EventProcessingOptions());
+    EXPECT_EQ(sceneState(*restored).DebugString(), snapshot.DebugString());
+
+    // the cards, counters, arrows and attachments it put back behave like the ones that were there
+    applyEvents(*played, replay, middle, replay.event_list_size());
+    applyEvents(*restored, replay, middle, replay.event_list_size());
+    EXPECT_EQ(sceneState(*restored).DebugString(), sceneState(*played).DebugString());
+}
+
+/**
+ * Folds every event of a game into a HeadlessGameState and plays it on the scene as well, the two have to agree after
+ * each of them.
+ */
+TEST_F(ReplayFidelityTest, HeadlessStateMatchesTheScene)
+{
+    const GameReplay replay = ReplayRecorder(300).getReplay();
+    std::unique_ptr<TabGame> game = openReplay(replay);
+    applyEvents(*game, replay, 0, 1);
+
+    // set up like TabGame::replayFastForward() does
+    QSet<HeadlessGameState::ZoneKey> hiddenZones;
+    for (const Player *player : game->getPlayers()) {
+        for (const CardZone *zone : player->getZones()) {
+            if (!zone->contentsKnown()) {
+                hiddenZones.insert(HeadlessGameState::ZoneKey(player->getId(), zone->getName()));
+            }
+        }
+    }
+    HeadlessGameState state(sceneState(*game), hiddenZones);
+
+    for (int i = 1; i < replay.event_list_size(); ++i) {
+        ASSERT_TRUE(state.apply(replay.event_list(i)));
+        applyEvents(*game, replay, i, i + 1);
+        ASSERT_EQ(describePlayers(state.getState(), hiddenZones), describePlayers(sceneState(*game), hiddenZones))
+            << "after event " << i << ": " << replay.event_list(i).ShortDebugString();
+    }
+}
+
+/**
+ * Plays a two hour game in steps the way the replay timer does, then clicks back to a few points of the timeline.
+ * Each seek restores the closest keyframe. It has to end up where applying every event from the start of the game
+ * does, which is what seeking backwards did before keyframes and is timed for comparison.
+ */
+TEST_F(ReplayFidelityTest, SeekBenchmark)
+{
+    const GameReplay replay = ReplayRecorder(1200).getReplay();
+    const int length = replay.event_list(replay.event_list_size() - 1).seconds_elapsed() * 1000;
+
+    std::unique_ptr<TabGame> game = openReplay(replay);
+    auto *timeline = game->findChild<ReplayTimelineWidget *>();
+    ASSERT_NE(timeline, nullptr);
+    timeline->resize(1000, timeline->height());
+
+    QElapsedTimer timer;
+    timer.start();
+    const int step = 5000;
+    for (int time = 0; time < length; time += step) {
+        timeline->skipByAmount(step);
+    }
+    std::cout << "[ BENCH    ] played " << timeline->getCurrentEvent() << " events over " << length / 60000
+              << " minutes in " << timer.elapsed() << "ms" << std::endl;
+
+    for (qreal fraction : {0.9, 0.5, 0.1}) {
+        timer.restart();
+        clickTimeline(timeline, fraction);
+        const qint64 seekTime = timer.elapsed();
+        const int eventCount = timeline->getCurrentEvent();
+
+        std::unique_ptr<TabGame> fromStart = openReplay(replay);
+        timer.restart();
+        applyEvents(*fromStart, replay, 0, eventCount);
+        const qint64 fromStartTime = timer.elapsed();
+
+        std::cout << "[ BENCH    ] seek back to event " << eventCount << ": " << seekTime << "ms from a keyframe, "
+                  << fromStartTime << "ms from the start" << std::endl;
+        EXPECT_EQ(sceneState(*game).DebugString(), sceneState(*fromStart).DebugString());
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // the scene needs a gui application, but not a screen
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ClientGlobals globals;
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
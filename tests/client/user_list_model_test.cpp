@@ -0,0 +1,160 @@
+#include "../../cockatrice/src/server/user/user_list_model.h"
+#include "client_globals.h"
+
+#include "gtest/gtest.h"
+#include <QApplication>
+#include <QPersistentModelIndex>
+
+namespace
+{
+
+ServerInfo_User user(const QString &name, int level = ServerInfo_User::IsUser)
+{
+    ServerInfo_User info;
+    info.set_name(name.toStdString());
+    info.set_user_level(level);
+    return info;
+}
+
+QStringList shownNames(const UserListModel &model)
+{
+    QStringList names;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        names << model.index(row, UserListModel::NameColumn).data().toString();
+    }
+    return names;
+}
+
+/**
+ * Counts what the views of the model are told.
+ */
+class UserListModelTest : public ::testing::Test
+{
+protected:
+    UserListModel model;
+    QList<QPair<int, int>> insertions;
+    int layoutChanges = 0;
+
+    void SetUp() override
+    {
+        QObject::connect(&model, &QAbstractItemModel::rowsInserted,
+                         [this](const QModelIndex &, int first, int last) { insertions.append({first, last}); });
+        QObject::connect(&model, &QAbstractItemModel::layoutChanged, [this]() { ++layoutChanges; });
+    }
+
+    // the model waits for the event loop to insert and sort
+    static void runEventLoop()
+    {
+        QCoreApplication::processEvents();
+    }
+};
+
+TEST_F(UserListModelTest, BurstIsInsertedAtOnce)
+{
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(model.processUserInfo(user(QString("user%1").arg(i)), true));
+    }
+    EXPECT_EQ(model.getUserCount(), 100);
+    EXPECT_TRUE(model.contains("user42"));
+    EXPECT_EQ(model.rowCount(), 0) << "Users are shown once the event loop runs";
+
+    runEventLoop();
+    EXPECT_EQ(model.rowCount(), 100);
+    ASSERT_EQ(insertions.size(), 1);
+    EXPECT_EQ(insertions.first(), qMakePair(0, 99));
+
+    // users removed before they were shown never reach the view
+    model.processUserInfo(user("late"), true);
+    EXPECT_TRUE(model.removeUser("late"));
+    runEventLoop();
+    EXPECT_EQ(model.rowCount(), 100);
+    EXPECT_EQ(insertions.size(), 1);
+}
+
+TEST_F(UserListModelTest, BurstIsSortedOnce)
+{
+    model.processUserInfo(user("carol"), false);
+    model.processUserInfo(user("bob"), true);
+    model.processUserInfo(user("dave", ServerInfo_User::IsUser | ServerInfo_User::IsRegistered), true);
+    model.processUserInfo(user("alice"), true);
+    runEventLoop();
+    EXPECT_EQ(layoutChanges, 1);
+    EXPECT_EQ(shownNames(model), QStringList({"dave", "alice", "bob", "carol"}));
+
+    // changes to users already shown are sorted in one go as well
+    model.setUserOnline("carol", true);
+    model.setUserOnline("alice", false);
+    model.processUserInfo(user("bob", ServerInfo_User::IsUser | ServerInfo_User::IsModerator), true);
+    model.processUserInfo(user("erin"), true);
+    EXPECT_EQ(layoutChanges, 1);
+    runEventLoop();
+    EXPECT_EQ(layoutChanges, 2);
+    EXPECT_EQ(shownNames(model), QStringList({"bob", "dave", "carol", "erin", "alice"}));
+}
+
+TEST_F(UserListModelTest, OnlineCountFollowsTheUsers)
+{
+    EXPECT_TRUE(model.processUserInfo(user("alice"), true));
+    EXPECT_FALSE(model.processUserInfo(user("alice"), true));
+    EXPECT_FALSE(model.processUserInfo(user("alice"), true));
+    EXPECT_EQ(model.getOnlineCount(), 1) << "Updating an online user counted them again";
+
+    model.processUserInfo(user("bob"), false);
+    EXPECT_EQ(model.getOnlineCount(), 1);
+    model.processUserInfo(user("bob"), true);
+    EXPECT_EQ(model.getOnlineCount(), 2);
+    model.processUserInfo(user("alice"), false);
+    EXPECT_EQ(model.getOnlineCount(), 1);
+    EXPECT_TRUE(model.setUserOnline("alice", true));
+    EXPECT_TRUE(model.setUserOnline("alice", true));
+    EXPECT_EQ(model.getOnlineCount(), 2);
+    EXPECT_FALSE(model.setUserOnline("nobody", true));
+    EXPECT_EQ(model.getOnlineCount(), 2);
+
+    runEventLoop();
+    EXPECT_TRUE(model.removeUser("bob"));
+    EXPECT_EQ(model.getOnlineCount(), 1);
+    model.processUserInfo(user("carol"), true);
+    EXPECT_TRUE(model.removeUser("carol"));
+    EXPECT_EQ(model.getOnlineCount(), 1) << "Removing a user that wasn't shown yet";
+    EXPECT_FALSE(model.removeUser("carol"));
+    EXPECT_EQ(model.getOnlineCount(), 1);
+}
+
+TEST_F(UserListModelTest, PersistentIndexesFollowTheirUser)
+{
+    for (const QString &name : {"alice", "bob", "carol", "dave"}) {
+        model.processUserInfo(user(name), true);
+    }
+    runEventLoop();
+    ASSERT_EQ(shownNames(model), QStringList({"alice", "bob", "carol", "dave"}));
+
+    // like the selection and current index of a view
+    QList<QPersistentModelIndex> indexes;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        indexes.append(QPersistentModelIndex(model.index(row, row % UserListModel::ColumnCount)));
+    }
+
+    model.setUserOnline("alice", false);
+    model.processUserInfo(user("dave", ServerInfo_User::IsUser | ServerInfo_User::IsAdmin), true);
+    runEventLoop();
+    ASSERT_EQ(shownNames(model), QStringList({"dave", "bob", "carol", "alice"}));
+
+    const QStringList names = {"alice", "bob", "carol", "dave"};
+    for (int i = 0; i < indexes.size(); ++i) {
+        ASSERT_TRUE(indexes.at(i).isValid());
+        EXPECT_EQ(indexes.at(i).column(), i % UserListModel::ColumnCount);
+        EXPECT_EQ(model.getUserAt(indexes.at(i).row()).name(), names.at(i).toStdString());
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // the level and country pictures need a gui application, but not a screen
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ClientGlobals globals;
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,129 @@
+#include "../../cockatrice/src/client/tabs/tab_game.h"
+#include "../../cockatrice/src/client/tabs/tab_supervisor.h"
+#include "../../cockatrice/src/game/player/player.h"
+#include "../../cockatrice/src/game/zones/card_zone.h"
+#include "../../cockatrice/src/server/remote/remote_client.h"
+#include "client_globals.h"
+#include "pb/event_game_state_changed.pb.h"
+#include "pb/event_move_card.pb.h"
+#include "pb/game_event_container.pb.h"
+#include "pb/game_replay.pb.h"
+
+#include "gtest/gtest.h"
+#include <QApplication>
+#include <memory>
+
+namespace
+{
+
+const int handSize = 7;
+
+/**
+ * A replay tab with a player holding a hand of cards and an empty table.
+ */
+class ZoneLayoutTest : public ::testing::Test
+{
+protected:
+    RemoteClient client;
+    TabSupervisor tabSupervisor{&client};
+    std::unique_ptr<TabGame> game;
+    CardZone *hand = nullptr;
+    CardZone *table = nullptr;
+
+    void SetUp() override
+    {
+        Event_GameStateChanged state;
+        state.set_game_started(true);
+        ServerInfo_Player *player = state.add_player_list();
+        player->mutable_properties()->set_player_id(0);
+        player->mutable_properties()->mutable_user_info()->set_name("Player 0");
+        ServerInfo_Zone *handInfo = player->add_zone_list();
+        handInfo->set_name("hand");
+        handInfo->set_card_count(handSize);
+        for (int i = 0; i < handSize; ++i) {
+            ServerInfo_Card *card = handInfo->add_card_list();
+            card->set_id(i);
+            card->set_name("Grizzly Bears");
+        }
+        player->add_zone_list()->set_name("table");
+
+        auto *replay = new GameReplay;
+        replay->mutable_game_info()->set_game_id(1);
+        replay->mutable_game_info()->set_max_players(1);
+        GameEvent *event = replay->add_event_list()->add_event_list();
+        event->set_player_id(-1);
+        event->MutableExtension(Event_GameStateChanged::ext)->CopyFrom(state);
+
+        // the tab takes ownership of the replay
+        game = std::make_unique<TabGame>(&tabSupervisor, replay);
+        process(replay->event_list(0));
+        ASSERT_EQ(game->getPlayers().size(), 1);
+        hand = game->getPlayers().first()->getZones().value("hand");
+        table = game->getPlayers().first()->getZones().value("table");
+        ASSERT_NE(hand, nullptr);
+        ASSERT_NE(table, nullptr);
+        ASSERT_EQ(hand->getCards().size(), handSize);
+    }
+
+    void process(const GameEventContainer &cont)
+    {
+        game->processGameEventContainer(cont, nullptr, Player::EventProcessingOptions());
+    }
+
+    // Plays the first cards of the hand onto the table, like a server playing several cards at once
+    static GameEventContainer playCards(int count)
+    {
+        GameEventContainer cont;
+        for (int i = 0; i < count; ++i) {
+            GameEvent *event = cont.add_event_list();
+            event->set_player_id(0);
+            Event_MoveCard *move = event->MutableExtension(Event_MoveCard::ext);
+            move->set_card_id(i);
+            move->set_card_name("Grizzly Bears");
+            move->set_start_player_id(0);
+            move->set_start_zone("hand");
+            move->set_target_player_id(0);
+            move->set_target_zone("table");
+            move->set_x(i);
+            move->set_y(0);
+            move->set_new_card_id(100 + i);
+        }
+        return cont;
+    }
+};
+
+TEST_F(ZoneLayoutTest, EachZoneIsLaidOutOncePerContainer)
+{
+    const int handLayouts = hand->getLayoutCount();
+    const int tableLayouts = table->getLayoutCount();
+
+    process(playCards(5));
+    EXPECT_EQ(hand->getCards().size(), handSize - 5);
+    EXPECT_EQ(table->getCards().size(), 5);
+    EXPECT_EQ(hand->getLayoutCount() - handLayouts, 1);
+    EXPECT_EQ(table->getLayoutCount() - tableLayouts, 1);
+    EXPECT_FALSE(ZoneLayoutBatch::isActive());
+}
+
+TEST_F(ZoneLayoutTest, ZonesOutsideTheContainerAreNotLaidOut)
+{
+    const int tableLayouts = table->getLayoutCount();
+
+    // a container without any card moving, like a player passing the turn
+    process(GameEventContainer());
+    EXPECT_EQ(table->getLayoutCount(), tableLayouts);
+
+    process(playCards(1));
+    EXPECT_EQ(table->getLayoutCount() - tableLayouts, 1);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // the client's globals need a gui application, but not a screen
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    ClientGlobals globals;
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
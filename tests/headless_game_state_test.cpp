@@ -0,0 +1,272 @@
+#include "../cockatrice/src/game/headless_game_state.h"
+#include "pb/card_attributes.pb.h"
+#include "pb/event_attach_card.pb.h"
+#include "pb/event_create_arrow.pb.h"
+#include "pb/event_create_token.pb.h"
+#include "pb/event_draw_cards.pb.h"
+#include "pb/event_join.pb.h"
+#include "pb/event_move_card.pb.h"
+#include "pb/event_set_active_player.pb.h"
+#include "pb/event_set_card_attr.pb.h"
+#include "pb/event_set_card_counter.pb.h"
+#include "pb/game_event_container.pb.h"
+
+#include "gtest/gtest.h"
+#include <QElapsedTimer>
+#include <iostream>
+
+namespace
+{
+
+const int cardsPerPlayer = 60;
+const char *const zoneNames[] = {"deck", "hand", "table", "grave", "rfg", "sb", "stack"};
+
+// Player 0 is the one watching, so the hand of player 1 and both decks are hidden
+Event_GameStateChanged initialState()
+{
+    Event_GameStateChanged state;
+    state.set_game_started(true);
+    for (int player = 0; player < 2; ++player) {
+        ServerInfo_Player *playerInfo = state.add_player_list();
+        playerInfo->mutable_properties()->set_player_id(player);
+        for (const char *zoneName : zoneNames) {
+            playerInfo->add_zone_list()->set_name(zoneName);
+        }
+        ServerInfo_Zone *deck = playerInfo->mutable_zone_list(0);
+        for (int card = 0; card < cardsPerPlayer; ++card) {
+            deck->add_card_list();
+        }
+        deck->set_card_count(cardsPerPlayer);
+    }
+    return state;
+}
+
+QSet<HeadlessGameState::ZoneKey> hiddenZones()
+{
+    return {{0, "deck"}, {1, "deck"}, {1, "hand"}};
+}
+
+template <typename T> GameEventContainer container(int playerId, const T &event)
+{
+    GameEventContainer cont;
+    GameEvent *gameEvent = cont.add_event_list();
+    gameEvent->set_player_id(playerId);
+    gameEvent->MutableExtension(T::ext)->CopyFrom(event);
+    return cont;
+}
+
+GameEventContainer drawCards(int playerId, int number, int firstId = -1)
+{
+    Event_DrawCards draw;
+    draw.set_number(number);
+    for (int i = 0; firstId != -1 && i < number; ++i) {
+        ServerInfo_Card *card = draw.add_cards();
+        card->set_id(firstId + i);
+        card->set_name("Card " + std::to_string(firstId + i));
+    }
+    return container(playerId, draw);
+}
+
+GameEventContainer moveCard(int playerId,
+                            int cardId,
+                            const std::string &startZone,
+                            const std::string &targetZone,
+                            int newCardId,
+                            int x = -1,
+                            int y = 0)
+{
+    Event_MoveCard move;
+    move.set_card_id(cardId);
+    move.set_start_player_id(playerId);
+    move.set_start_zone(startZone);
+    move.set_position(-1);
+    move.set_target_player_id(playerId);
+    move.set_target_zone(targetZone);
+    move.set_x(x);
+    move.set_y(y);
+    move.set_new_card_id(newCardId);
+    return container(playerId, move);
+}
+
+const ServerInfo_Zone &zone(const HeadlessGameState &state, int playerId, int zoneIndex)
+{
+    return state.getState().player_list(playerId).zone_list(zoneIndex);
+}
+
+TEST(HeadlessGameStateTest, MovesCardsLikeTheZones)
+{
+    HeadlessGameState state(initialState(), hiddenZones());
+    ASSERT_TRUE(state.apply(drawCards(0, 3, 100)));
+    ASSERT_TRUE(state.apply(drawCards(1, 2)));
+    EXPECT_EQ(zone(state, 0, 0).card_count(), cardsPerPlayer - 3);
+    ASSERT_EQ(zone(state, 0, 1).card_list_size(), 3);
+    EXPECT_EQ(zone(state, 0, 1).card_list(2).name(), "Card 102");
+    ASSERT_EQ(zone(state, 1, 1).card_list_size(), 2);
+    EXPECT_EQ(zone(state, 1, 1).card_list(0).id(), -1);
+
+    // the table keeps the position and state of the card, the graveyard resets it
+    ASSERT_TRUE(state.apply(moveCard(0, 101, "hand", "table", 200, 3, 1)));
+    const ServerInfo_Card &played = zone(state, 0, 2).card_list(0);
+    EXPECT_EQ(played.id(), 200);
+    EXPECT_EQ(played.name(), "Card 101");
+    EXPECT_EQ(played.x(), 3);
+    EXPECT_EQ(played.y(), 1);
+
+    Event_SetCardAttr tap;
+    tap.set_zone_name("table");
+    tap.set_card_id(200);
+    tap.set_attribute(AttrTapped);
+    tap.set_attr_value("1");
+    ASSERT_TRUE(state.apply(container(0, tap)));
+    EXPECT_TRUE(zone(state, 0, 2).card_list(0).tapped());
+
+    ASSERT_TRUE(state.apply(moveCard(0, 200, "table", "grave", 300)));
+    EXPECT_EQ(zone(state, 0, 2).card_list_size(), 0);
+    ASSERT_EQ(zone(state, 0, 3).card_list_size(), 1);
+    EXPECT_FALSE(zone(state, 0, 3).card_list(0).tapped());
+    EXPECT_EQ(zone(state, 0, 3).card_list(0).name(), "Card 101");
+
+    // putting a card on top of the hidden deck hides its name
+    ASSERT_TRUE(state.apply(moveCard(0, 300, "grave", "deck", -1, 0)));
+    EXPECT_EQ(zone(state, 0, 0).card_count(), cardsPerPlayer - 2);
+    EXPECT_EQ(zone(state, 0, 0).card_list(0).id(), -1);
+    EXPECT_TRUE(zone(state, 0, 0).card_list(0).name().empty());
+
+    // moving a card that isn't there is ignored like the scene does
+    ASSERT_TRUE(state.apply(moveCard(0, 12345, "grave", "table", 1)));
+    EXPECT_EQ(zone(state, 0, 2).card_list_size(), 0);
+}
+
+TEST(HeadlessGameStateTest, FollowsTokensCountersArrowsAndAttachments)
+{
+    HeadlessGameState state(initialState(), hiddenZones(), [](const QString &cardName) {
+        return cardName == "Goblin" ? QString("1/1") : QString();
+    });
+
+    for (int id : {10, 11}) {
+        Event_CreateToken token;
+        token.set_zone_name("table");
+        token.set_card_id(id);
+        token.set_card_name("Goblin");
+        token.set_x(id);
+        ASSERT_TRUE(state.apply(container(0, token)));
+    }
+    ASSERT_EQ(zone(state, 0, 2).card_list_size(), 2);
+    EXPECT_EQ(zone(state, 0, 2).card_list(0).pt(), "1/1");
+
+    Event_SetCardCounter counter;
+    counter.set_zone_name("table");
+    counter.set_card_id(10);
+    counter.set_counter_id(1);
+    counter.set_counter_value(3);
+    ASSERT_TRUE(state.apply(container(0, counter)));
+    ASSERT_EQ(zone(state, 0, 2).card_list(0).counter_list_size(), 1);
+    EXPECT_EQ(zone(state, 0, 2).card_list(0).counter_list(0).value(), 3);
+    counter.set_counter_value(0);
+    ASSERT_TRUE(state.apply(container(0, counter)));
+    EXPECT_EQ(zone(state, 0, 2).card_list(0).counter_list_size(), 0);
+
+    Event_AttachCard attach;
+    attach.set_start_zone("table");
+    attach.set_card_id(11);
+    attach.set_target_player_id(0);
+    attach.set_target_zone("table");
+    attach.set_target_card_id(10);
+    ASSERT_TRUE(state.apply(container(0, attach)));
+    // like the scene, the attached card leaves the grid
+    EXPECT_EQ(zone(state, 0, 2).card_list(1).x(), -1);
+
+    Event_CreateArrow arrow;
+    ServerInfo_Arrow *arrowInfo = arrow.mutable_arrow_info();
+    arrowInfo->set_id(1);
+    arrowInfo->set_start_player_id(0);
+    arrowInfo->set_start_zone("table");
+    arrowInfo->set_start_card_id(11);
+    arrowInfo->set_target_player_id(0);
+    arrowInfo->set_target_zone("table");
+    arrowInfo->set_target_card_id(10);
+    ASSERT_TRUE(state.apply(container(0, arrow)));
+    ASSERT_EQ(state.getState().player_list(0).arrow_list_size(), 1);
+
+    // moving within the table keeps both pointing at the card
+    ASSERT_TRUE(state.apply(moveCard(0, 10, "table", "table", 20, 5)));
+    EXPECT_EQ(zone(state, 0, 2).card_list(0).attach_card_id(), 20);
+    EXPECT_EQ(state.getState().player_list(0).arrow_list(0).target_card_id(), 20);
+
+    // leaving the table removes the arrow, the attached card follows
+    ASSERT_TRUE(state.apply(moveCard(0, 20, "table", "rfg", 30)));
+    EXPECT_EQ(state.getState().player_list(0).arrow_list_size(), 0);
+    EXPECT_EQ(zone(state, 0, 2).card_list(0).attach_zone(), "rfg");
+    EXPECT_EQ(zone(state, 0, 2).card_list(0).attach_card_id(), 30);
+}
+
+TEST(HeadlessGameStateTest, LeavesUnsupportedContainersAlone)
+{
+    HeadlessGameState state(initialState(), hiddenZones());
+    const std::string before = state.getState().SerializeAsString();
+
+    // the join can't be folded, so the draw before it has to wait for the scene as well
+    GameEventContainer cont = drawCards(0, 1, 100);
+    GameEvent *join = cont.add_event_list();
+    join->set_player_id(2);
+    join->MutableExtension(Event_Join::ext);
+    EXPECT_FALSE(HeadlessGameState::canApply(cont));
+    EXPECT_FALSE(state.apply(cont));
+    EXPECT_EQ(state.getState().SerializeAsString(), before);
+
+    Event_SetActivePlayer activePlayer;
+    activePlayer.set_active_player_id(1);
+    EXPECT_TRUE(state.apply(container(-1, activePlayer)));
+    EXPECT_EQ(state.getState().active_player_id(), 1);
+    EXPECT_EQ(state.getState().active_phase(), -1);
+}
+
+/**
+ * Folds a long game worth of the most common events: drawing, playing, tapping, untapping everything and putting
+ * cards back into the library.
+ */
+TEST(HeadlessGameStateTest, FoldBenchmark)
+{
+    std::vector<GameEventContainer> events;
+    int nextId = 1000;
+    for (int turn = 0; events.size() < 100000; ++turn) {
+        const int player = turn % 2;
+        events.push_back(drawCards(player, 1, nextId));
+        const int drawn = nextId++;
+        events.push_back(moveCard(player, drawn, "hand", "table", nextId, turn % 10, turn % 3));
+        const int played = nextId++;
+
+        Event_SetCardAttr tap;
+        tap.set_zone_name("table");
+        tap.set_card_id(played);
+        tap.set_attribute(AttrTapped);
+        tap.set_attr_value("1");
+        events.push_back(container(player, tap));
+        tap.clear_card_id();
+        tap.set_attr_value("0");
+        events.push_back(container(player, tap));
+
+        events.push_back(moveCard(player, played, "table", "deck", -1, turn % 40));
+    }
+
+    HeadlessGameState state(initialState(), hiddenZones());
+    QElapsedTimer timer;
+    timer.start();
+    for (const GameEventContainer &cont : events) {
+        ASSERT_TRUE(state.apply(cont));
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    std::cout << "[ BENCH    ] " << events.size() << " events folded in " << elapsed / 1000000 << "ms, "
+              << static_cast<qint64>(events.size()) * 1000000 / qMax<qint64>(elapsed, 1) << " events per ms"
+              << std::endl;
+    EXPECT_EQ(zone(state, 0, 0).card_count() + zone(state, 0, 1).card_count() + zone(state, 0, 2).card_count(),
+              cardsPerPlayer);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,221 @@
+#include "../cockatrice/src/client/ui/picture_download_scheduler.h"
+
+#include "gtest/gtest.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <functional>
+
+namespace
+{
+/**
+ * Minimal HTTP server standing in for a picture host. Every request is answered after a short delay, so that several
+ * of them are in flight at once, with a body repeating the requested path.
+ */
+class HttpStandIn
+{
+public:
+    QStringList requestedPaths;
+    int inFlight = 0;
+    int maxInFlight = 0;
+    // requests for these paths are answered with "503 Service Unavailable" this many times
+    QHash<QString, int> failuresLeft;
+
+    HttpStandIn()
+    {
+        server.listen(QHostAddress::LocalHost);
+        QObject::connect(&server, &QTcpServer::newConnection, [this]() {
+            while (QTcpSocket *socket = server.nextPendingConnection()) {
+                QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() { readRequests(socket); });
+            }
+        });
+    }
+
+    QUrl url(const QString &path) const
+    {
+        return QUrl(QString("http://127.0.0.1:%1%2").arg(server.serverPort()).arg(path));
+    }
+
+private:
+    QTcpServer server;
+    QHash<QTcpSocket *, QByteArray> buffers;
+
+    void readRequests(QTcpSocket *socket)
+    {
+        QByteArray &buffer = buffers[socket];
+        buffer += socket->readAll();
+        int end;
+        while ((end = buffer.indexOf("\r\n\r\n")) != -1) {
+            const QList<QByteArray> requestLine = buffer.left(buffer.indexOf("\r\n")).split(' ');
+            buffer.remove(0, end + 4);
+            const QString path = QString::fromUtf8(requestLine.value(1));
+
+            requestedPaths << path;
+            maxInFlight = qMax(maxInFlight, ++inFlight);
+            QTimer::singleShot(50, socket, [this, socket, path]() { respond(socket, path); });
+        }
+    }
+
+    void respond(QTcpSocket *socket, const QString &path)
+    {
+        --inFlight;
+        if (failuresLeft.value(path) > 0) {
+            --failuresLeft[path];
+            socket->write("HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n\r\n");
+            return;
+        }
+
+        const QByteArray body = path.toUtf8();
+        socket->write("HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: " +
+                      QByteArray::number(body.size()) + "\r\n\r\n" + body);
+    }
+};
+
+class PictureDownloadSchedulerTest : public ::testing::Test
+{
+protected:
+    HttpStandIn server;
+    QNetworkAccessManager networkManager;
+    QStringList finishedPaths;
+    QHash<QString, QNetworkReply::NetworkError> errors;
+
+    void watch(PictureDownloadScheduler &scheduler)
+    {
+        QObject::connect(&scheduler, &PictureDownloadScheduler::downloadFinished,
+                         [this](const QUrl &url, QNetworkReply *reply) {
+                             finishedPaths << url.path();
+                             errors.insert(url.path(), reply->error());
+                         });
+    }
+
+    static bool waitFor(const std::function<bool()> &condition, int timeoutMs = 5000)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (!condition() && timer.elapsed() < timeoutMs) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        }
+        return condition();
+    }
+
+    static void settle(int ms)
+    {
+        waitFor([]() { return false; }, ms);
+    }
+};
+
+TEST_F(PictureDownloadSchedulerTest, LimitsConnectionsPerHost)
+{
+    PictureDownloadScheduler scheduler(&networkManager, 2);
+    watch(scheduler);
+
+    for (int i = 0; i < 6; ++i) {
+        scheduler.enqueue(QNetworkRequest(server.url(QString("/card%1").arg(i))),
+                          PictureDownloadScheduler::PriorityVisible);
+    }
+    ASSERT_LE(scheduler.getRunningCount(), 2);
+
+    ASSERT_TRUE(waitFor([this]() { return finishedPaths.size() == 6; }));
+    ASSERT_EQ(server.maxInFlight, 2) << "two downloads should have been running side by side";
+    for (const QNetworkReply::NetworkError error : errors) {
+        ASSERT_EQ(error, QNetworkReply::NoError);
+    }
+}
+
+TEST_F(PictureDownloadSchedulerTest, StartsHigherPrioritiesFirst)
+{
+    PictureDownloadScheduler scheduler(&networkManager, 1);
+    watch(scheduler);
+
+    scheduler.enqueue(QNetworkRequest(server.url("/running")), PictureDownloadScheduler::PriorityPrefetch);
+    scheduler.enqueue(QNetworkRequest(server.url("/prefetch")), PictureDownloadScheduler::PriorityPrefetch);
+    scheduler.enqueue(QNetworkRequest(server.url("/visible")), PictureDownloadScheduler::PriorityVisible);
+    scheduler.enqueue(QNetworkRequest(server.url("/boosted")), PictureDownloadScheduler::PriorityPrefetch);
+    scheduler.raisePriority(server.url("/boosted"), PictureDownloadScheduler::PriorityHovered);
+
+    ASSERT_TRUE(waitFor([this]() { return finishedPaths.size() == 4; }));
+    ASSERT_EQ(server.requestedPaths, QStringList({"/running", "/boosted", "/visible", "/prefetch"}));
+}
+
+TEST_F(PictureDownloadSchedulerTest, LoweredDownloadsWaitForTheVisibleOnes)
+{
+    PictureDownloadScheduler scheduler(&networkManager, 1);
+    watch(scheduler);
+
+    scheduler.enqueue(QNetworkRequest(server.url("/running")), PictureDownloadScheduler::PriorityPrefetch);
+    scheduler.enqueue(QNetworkRequest(server.url("/scrolled-away")), PictureDownloadScheduler::PriorityVisible);
+    scheduler.enqueue(QNetworkRequest(server.url("/visible")), PictureDownloadScheduler::PriorityVisible);
+    scheduler.enqueue(QNetworkRequest(server.url("/prefetch")), PictureDownloadScheduler::PriorityPrefetch);
+    scheduler.lowerPriority(server.url("/scrolled-away"), PictureDownloadScheduler::PriorityPrefetch);
+    // lowering never raises
+    scheduler.lowerPriority(server.url("/prefetch"), PictureDownloadScheduler::PriorityHovered);
+
+    ASSERT_TRUE(waitFor([this]() { return finishedPaths.size() == 4; }));
+    ASSERT_EQ(server.requestedPaths, QStringList({"/running", "/visible", "/prefetch", "/scrolled-away"}));
+}
+
+TEST_F(PictureDownloadSchedulerTest, DownloadsIdenticalUrlsOnce)
+{
+    PictureDownloadScheduler scheduler(&networkManager, 4);
+    watch(scheduler);
+
+    scheduler.enqueue(QNetworkRequest(server.url("/island")), PictureDownloadScheduler::PriorityPrefetch);
+    scheduler.enqueue(QNetworkRequest(server.url("/island")), PictureDownloadScheduler::PriorityVisible);
+    scheduler.enqueue(QNetworkRequest(server.url("/island")), PictureDownloadScheduler::PriorityHovered);
+
+    ASSERT_TRUE(waitFor([this]() { return !finishedPaths.isEmpty(); }));
+    settle(200);
+    ASSERT_EQ(server.requestedPaths, QStringList({"/island"}));
+    ASSERT_EQ(finishedPaths, QStringList({"/island"}));
+}
+
+TEST_F(PictureDownloadSchedulerTest, CancelsQueuedAndRunningDownloads)
+{
+    PictureDownloadScheduler scheduler(&networkManager, 1);
+    watch(scheduler);
+
+    scheduler.enqueue(QNetworkRequest(server.url("/scrolledAway")), PictureDownloadScheduler::PriorityVisible);
+    scheduler.enqueue(QNetworkRequest(server.url("/neverShown")), PictureDownloadScheduler::PriorityVisible);
+    scheduler.enqueue(QNetworkRequest(server.url("/kept")), PictureDownloadScheduler::PriorityVisible);
+    scheduler.cancel(server.url("/neverShown"));
+    ASSERT_TRUE(waitFor([this]() { return server.requestedPaths.contains("/scrolledAway"); }));
+    scheduler.cancel(server.url("/scrolledAway"));
+
+    ASSERT_TRUE(waitFor([this]() { return finishedPaths.contains("/kept"); }));
+    settle(200);
+    ASSERT_EQ(finishedPaths, QStringList({"/kept"}));
+    ASSERT_FALSE(server.requestedPaths.contains("/neverShown"));
+    ASSERT_EQ(scheduler.getRunningCount() + scheduler.getQueuedCount(), 0);
+}
+
+TEST_F(PictureDownloadSchedulerTest, RetriesTransientFailures)
+{
+    PictureDownloadScheduler scheduler(&networkManager, 2);
+    scheduler.setRetryPolicy(3, 10);
+    watch(scheduler);
+    server.failuresLeft.insert("/flaky", 2);
+    server.failuresLeft.insert("/down", 10);
+
+    scheduler.enqueue(QNetworkRequest(server.url("/flaky")), PictureDownloadScheduler::PriorityVisible);
+    scheduler.enqueue(QNetworkRequest(server.url("/down")), PictureDownloadScheduler::PriorityVisible);
+
+    ASSERT_TRUE(waitFor([this]() { return finishedPaths.size() == 2; }));
+    ASSERT_EQ(errors.value("/flaky"), QNetworkReply::NoError);
+    ASSERT_EQ(server.requestedPaths.count("/flaky"), 3);
+    ASSERT_NE(errors.value("/down"), QNetworkReply::NoError);
+    ASSERT_EQ(server.requestedPaths.count("/down"), 4) << "the first attempt and three retries";
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,174 @@
+#include "../cockatrice/src/client/network/replay_keyframes.h"
+
+#include "gtest/gtest.h"
+#include <QElapsedTimer>
+#include <iostream>
+#include <random>
+
+namespace
+{
+
+TEST(ReplayKeyframesTest, DueEveryIntervalOfEventsOrTime)
+{
+    ReplayKeyframes keyframes(100, 10000);
+    EXPECT_FALSE(keyframes.isDue(0, 0));
+    EXPECT_FALSE(keyframes.isDue(99, 9999));
+    EXPECT_TRUE(keyframes.isDue(100, 0));
+    EXPECT_TRUE(keyframes.isDue(1, 10000));
+
+    ReplayKeyframes::Keyframe keyframe;
+    keyframe.eventIndex = 100;
+    keyframe.eventTime = 5000;
+    keyframes.insert(keyframe);
+    EXPECT_FALSE(keyframes.isDue(100, 5000));
+    EXPECT_FALSE(keyframes.isDue(150, 14999));
+    EXPECT_TRUE(keyframes.isDue(200, 6000));
+    EXPECT_TRUE(keyframes.isDue(101, 15000));
+    // seeking back before the first keyframe fills the gap again
+    EXPECT_TRUE(keyframes.isDue(50, 10000));
+}
+
+TEST(ReplayKeyframesTest, ClosestKeyframeAtOrBeforeEvent)
+{
+    ReplayKeyframes keyframes;
+    for (int eventIndex : {300, 100, 200}) {
+        ReplayKeyframes::Keyframe keyframe;
+        keyframe.eventIndex = eventIndex;
+        keyframes.insert(keyframe);
+    }
+    ASSERT_EQ(keyframes.size(), 3);
+
+    EXPECT_EQ(keyframes.closest(99), nullptr);
+    EXPECT_EQ(keyframes.closest(100)->eventIndex, 100);
+    EXPECT_EQ(keyframes.closest(299)->eventIndex, 200);
+    EXPECT_EQ(keyframes.closest(100000)->eventIndex, 300);
+
+    keyframes.clear();
+    EXPECT_EQ(keyframes.closest(100000), nullptr);
+}
+
+const int playerCount = 2;
+const int cardsPerPlayer = 100;
+const char *const zoneNames[] = {"deck", "hand", "table", "grave", "rfg", "sb", "stack"};
+const int zoneCount = sizeof(zoneNames) / sizeof(zoneNames[0]);
+
+Event_GameStateChanged initialState()
+{
+    Event_GameStateChanged state;
+    state.set_game_started(true);
+    for (int player = 0; player < playerCount; ++player) {
+        ServerInfo_Player *playerInfo = state.add_player_list();
+        playerInfo->mutable_properties()->set_player_id(player);
+        for (const char *zoneName : zoneNames) {
+            playerInfo->add_zone_list()->set_name(zoneName);
+        }
+        ServerInfo_Zone *deck = playerInfo->mutable_zone_list(0);
+        for (int card = 0; card < cardsPerPlayer; ++card) {
+            ServerInfo_Card *cardInfo = deck->add_card_list();
+            cardInfo->set_id(card);
+            cardInfo->set_name("Card " + std::to_string(card));
+        }
+        deck->set_card_count(cardsPerPlayer);
+    }
+    return state;
+}
+
+// Stand-in for the client applying a move card event; the real one goes through the whole scene graph and is far
+// more expensive, which only makes the difference larger
+void applyEvent(Event_GameStateChanged &state, int eventIndex)
+{
+    ServerInfo_Player *player = state.mutable_player_list(eventIndex % playerCount);
+    for (int attempt = 0; attempt < zoneCount; ++attempt) {
+        ServerInfo_Zone *from = player->mutable_zone_list((eventIndex / playerCount + attempt) % zoneCount);
+        if (from->card_list_size() == 0) {
+            continue;
+        }
+        ServerInfo_Zone *to = player->mutable_zone_list((eventIndex * 7 + attempt + 1) % zoneCount);
+        if (to == from) {
+            continue;
+        }
+        ServerInfo_Card *card = to->add_card_list();
+        card->CopyFrom(from->card_list(from->card_list_size() - 1));
+        card->set_tapped(eventIndex % 3 == 0);
+        card->set_x(eventIndex % 10);
+        from->mutable_card_list()->RemoveLast();
+        from->set_card_count(from->card_list_size());
+        to->set_card_count(to->card_list_size());
+        state.set_active_phase(eventIndex % 11);
+        return;
+    }
+}
+
+/**
+ * Seeks around in a two hour replay, once applying every event from the start like rewinding used to, once starting
+ * from the closest keyframe.
+ */
+TEST(ReplayKeyframesTest, SeekBenchmark)
+{
+    const int eventCount = 40000;
+    const int durationMs = 2 * 60 * 60 * 1000;
+    auto eventTime = [=](int eventIndex) { return static_cast<int>(qint64(eventIndex) * durationMs / eventCount); };
+
+    ReplayKeyframes keyframes;
+    Event_GameStateChanged state = initialState();
+    QElapsedTimer timer;
+    timer.start();
+    qint64 captureTime = 0;
+    for (int i = 0; i < eventCount; ++i) {
+        if (keyframes.isDue(i, eventTime(i))) {
+            QElapsedTimer captureTimer;
+            captureTimer.start();
+            ReplayKeyframes::Keyframe keyframe;
+            keyframe.eventIndex = i;
+            keyframe.eventTime = eventTime(i);
+            keyframe.state.CopyFrom(state);
+            keyframes.insert(keyframe);
+            captureTime += captureTimer.nsecsElapsed();
+        }
+        applyEvent(state, i);
+    }
+    const qint64 playbackTime = timer.elapsed();
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> targets(0, eventCount);
+    const int seekCount = 50;
+    qint64 fullTime = 0, keyframeTime = 0, fullEvents = 0, keyframeEvents = 0;
+    for (int seek = 0; seek < seekCount; ++seek) {
+        const int target = targets(random);
+
+        timer.restart();
+        Event_GameStateChanged fromStart = initialState();
+        for (int i = 0; i < target; ++i) {
+            applyEvent(fromStart, i);
+        }
+        fullTime += timer.nsecsElapsed();
+        fullEvents += target;
+
+        timer.restart();
+        const ReplayKeyframes::Keyframe *keyframe = keyframes.closest(target);
+        Event_GameStateChanged fromKeyframe = keyframe ? keyframe->state : initialState();
+        for (int i = keyframe ? keyframe->eventIndex : 0; i < target; ++i) {
+            applyEvent(fromKeyframe, i);
+            ++keyframeEvents;
+        }
+        keyframeTime += timer.nsecsElapsed();
+
+        ASSERT_EQ(fromKeyframe.SerializeAsString(), fromStart.SerializeAsString()) << "seek to " << target;
+        ASSERT_LT(target - (keyframe ? keyframe->eventIndex : 0), ReplayKeyframes::DEFAULT_EVENT_INTERVAL);
+    }
+
+    std::cout << "[ BENCH    ] " << eventCount << " events, " << keyframes.size() << " keyframes taken in "
+              << captureTime / 1000000 << "ms of " << playbackTime << "ms playback" << std::endl;
+    std::cout << "[ BENCH    ] seek from the start: " << fullTime / seekCount / 1000 << "us, "
+              << fullEvents / seekCount << " events per seek" << std::endl;
+    std::cout << "[ BENCH    ] seek from a keyframe: " << keyframeTime / seekCount / 1000 << "us, "
+              << keyframeEvents / seekCount << " events per seek" << std::endl;
+    ASSERT_LT(keyframeEvents, fullEvents);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,254 @@
+#include "../common/rcu_domain.h"
+#include "../common/server.h"
+#include "../common/server_protocolhandler.h"
+#include "../common/sharded_hash.h"
+#include "pb/server_message.pb.h"
+#include "pb/serverinfo_user.pb.h"
+
+#include "gtest/gtest.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QString>
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int userCount = 2000;
+const int churnThreads = 4;
+const int churnOperationsPerThread = 4000;
+const int chatThreads = 4;
+const quint32 aliveMagic = 0xC0C0A7E5;
+const quint32 deadMagic = 0xDEADBEEF;
+const qint64 maxChurnSlowdown = 10;
+const qint64 minMeasurableNs = 1000;
+
+// A connection without a socket; the magic value shows whether a reader got hold of a deleted session
+class FakeSession : public Server_ProtocolHandler
+{
+public:
+    quint32 magic;
+
+    FakeSession(Server *_server, const QString &name, qint64 sessionId)
+        : Server_ProtocolHandler(_server, nullptr), magic(aliveMagic)
+    {
+        ServerInfo_User info;
+        info.set_name(name.toStdString());
+        info.set_session_id(sessionId);
+        setUserInfo(info);
+    }
+    ~FakeSession() override
+    {
+        magic = deadMagic;
+    }
+    QString getAddress() const override
+    {
+        return "127.0.0.1";
+    }
+    QString getConnectionType() const override
+    {
+        return "tcp";
+    }
+
+protected:
+    void transmitProtocolItem(const ServerMessage & /* item */) override
+    {
+    }
+};
+
+QString userName(int i)
+{
+    return QStringLiteral("user%1").arg(i);
+}
+
+// The steps a connection goes through on login and logout, in the order the socket interfaces do them
+FakeSession *login(Server &server, const QString &name, qint64 sessionId)
+{
+    auto *session = new FakeSession(&server, name, sessionId);
+    server.addClient(session);
+    server.publishUser(session);
+    return session;
+}
+
+void logout(Server &server, FakeSession *session)
+{
+    server.removeClient(session);
+    delete session;
+}
+
+qint64 percentile(std::vector<qint64> &samples, double p)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[static_cast<size_t>(p * (samples.size() - 1))];
+}
+
+/**
+ * Logs users in and out of a real Server on several threads while "chat" threads look them up, the way
+ * cmdMessage does. Each churn thread owns its own slice of user names, like one connection owns its session.
+ * Returns the 99th percentile lookup latency in ns.
+ */
+qint64 runWithChurn(Server &server, bool churn, std::atomic<int> &deadSeen, std::atomic<int> &wrongNameSeen)
+{
+    std::vector<std::vector<FakeSession *>> sessions(churnThreads, std::vector<FakeSession *>(userCount, nullptr));
+    std::atomic<qint64> nextSessionId(1);
+    for (int i = 0; i < userCount; i += 2)
+        sessions[i % churnThreads][i] = login(server, userName(i), nextSessionId++);
+
+    std::atomic<bool> stop(false);
+    std::vector<std::vector<qint64>> samples(chatThreads);
+    std::vector<std::thread> chatters;
+    for (int t = 0; t < chatThreads; ++t) {
+        chatters.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            std::uniform_int_distribution<int> dist(0, userCount - 1);
+            QElapsedTimer timer;
+            while (!stop || samples[t].size() < 1000) {
+                const QString name = userName(dist(rng));
+                timer.start();
+                RcuReadLocker locker(&server.clientsRcu);
+                auto *session = dynamic_cast<FakeSession *>(server.findUser(name));
+                if (session) {
+                    if (session->magic != aliveMagic)
+                        ++deadSeen;
+                    else if (QString::fromStdString(session->getUserInfo()->name()) != name)
+                        ++wrongNameSeen;
+                }
+                samples[t].push_back(timer.nsecsElapsed());
+            }
+        });
+    }
+
+    std::vector<std::thread> churners;
+    if (churn) {
+        for (int t = 0; t < churnThreads; ++t) {
+            churners.emplace_back([&, t] {
+                std::mt19937 rng(100 + t);
+                std::uniform_int_distribution<int> dist(0, userCount / churnThreads - 1);
+                for (int i = 0; i < churnOperationsPerThread; ++i) {
+                    const int user = dist(rng) * churnThreads + t;
+                    FakeSession *&session = sessions[t][user];
+                    if (session) {
+                        logout(server, session);
+                        session = nullptr;
+                    } else {
+                        session = login(server, userName(user), nextSessionId++);
+                    }
+                }
+            });
+        }
+    }
+    for (auto &thread : churners)
+        thread.join();
+    stop = true;
+    for (auto &thread : chatters)
+        thread.join();
+
+    // Whatever the interleaving, the directory has to match the sessions that are still logged in
+    int loggedIn = 0;
+    for (const auto &threadSessions : sessions) {
+        for (FakeSession *session : threadSessions) {
+            if (!session)
+                continue;
+            ++loggedIn;
+            const QString name = QString::fromStdString(session->getUserInfo()->name());
+            EXPECT_EQ(server.getUsers().value(name), session) << name.toStdString() << " isn't looked up correctly";
+            EXPECT_EQ(server.getUsersBySessionId().value(session->getUserInfo()->session_id()), session);
+        }
+    }
+    EXPECT_EQ(server.getUsers().size(), loggedIn);
+    EXPECT_EQ(server.getUsersBySessionId().size(), loggedIn);
+    EXPECT_EQ(server.getUsersCount(), loggedIn);
+    EXPECT_EQ(server.getTCPUserCount(), loggedIn);
+    EXPECT_EQ(server.getClients().size(), loggedIn);
+
+    for (auto &threadSessions : sessions)
+        for (FakeSession *session : threadSessions)
+            if (session)
+                logout(server, session);
+
+    std::vector<qint64> all;
+    for (auto &threadSamples : samples)
+        all.insert(all.end(), threadSamples.begin(), threadSamples.end());
+    return percentile(all, 0.99);
+}
+
+TEST(UserDirectoryStressTest, ShardedHashKeepsCountConsistent)
+{
+    ShardedHash<int, int> hash;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 10000; ++i) {
+                hash.insert(t * 10000 + i, i);
+                if (i % 2)
+                    hash.remove(t * 10000 + i);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    ASSERT_EQ(hash.size(), 8 * 5000);
+    ASSERT_EQ(hash.values().size(), 8 * 5000);
+    ASSERT_EQ(hash.toHash().size(), 8 * 5000);
+}
+
+TEST(UserDirectoryStressTest, RemoveOnlyMatchingValue)
+{
+    ShardedHash<QString, int> hash;
+    hash.insert("user", 1);
+    hash.insert("user", 2);
+    ASSERT_FALSE(hash.remove("user", 1)) << "A stale session must not remove its successor";
+    ASSERT_EQ(hash.value("user"), 2);
+    ASSERT_TRUE(hash.remove("user", 2));
+    ASSERT_EQ(hash.size(), 0);
+}
+
+TEST(UserDirectoryStressTest, StaleSessionKeepsSuccessor)
+{
+    Server server;
+    FakeSession *oldSession = login(server, "user", 1);
+    FakeSession *newSession = login(server, "user", 2);
+
+    logout(server, oldSession);
+    ASSERT_EQ(server.getUsers().value("user"), newSession) << "Logging out the old session removed its successor";
+    ASSERT_EQ(server.getUsersBySessionId().value(2), newSession);
+    ASSERT_FALSE(server.getUsersBySessionId().contains(1));
+
+    logout(server, newSession);
+    ASSERT_EQ(server.getUsers().size(), 0);
+    ASSERT_EQ(server.getClients().size(), 0);
+}
+
+TEST(UserDirectoryStressTest, ChurnKeepsDirectoryConsistent)
+{
+    std::atomic<int> deadSeen(0), wrongNameSeen(0);
+
+    Server idleServer;
+    const qint64 idleP99 = runWithChurn(idleServer, false, deadSeen, wrongNameSeen);
+    Server churnServer;
+    const qint64 churnP99 = runWithChurn(churnServer, true, deadSeen, wrongNameSeen);
+
+    std::cout << "chat lookup p99 (ns): idle " << idleP99 << ", with login churn " << churnP99 << std::endl;
+
+    ASSERT_EQ(deadSeen.load(), 0) << "A reader saw a session that had already been deleted";
+    ASSERT_EQ(wrongNameSeen.load(), 0) << "A name was looked up to another user's session";
+
+    // Readers don't wait for logins, so churn may only cost what the busier cores do. Compared to the idle run
+    // rather than a fixed bound, with the idle time rounded up to what the clock can tell apart.
+    EXPECT_LE(churnP99, maxChurnSlowdown * qMax(idleP99, minMeasurableNs))
+        << "Login churn slowed down chat lookups " << churnP99 / qMax(idleP99, qint64(1)) << " times";
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // the server announces logins to other servers through queued signals
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,124 @@
+#include "../cockatrice/src/game/zones/zone_layout_batch.h"
+
+#include "gtest/gtest.h"
+#include <memory>
+
+namespace
+{
+
+class CountingZone : public ZoneLayoutBatch::Target
+{
+public:
+    int layouts = 0;
+    CountingZone *dependent = nullptr;
+
+    // Like CardZone::addCard() and CardZone::takeCard(), which lay out the zone after every card
+    void moveCard()
+    {
+        requestLayout();
+    }
+
+protected:
+    void performLayout() override
+    {
+        ++layouts;
+        // like a table zone laying out the zone of an attached card
+        if (dependent) {
+            dependent->requestLayout();
+        }
+    }
+};
+
+// Stand-in for TabGame::processGameEventContainer() with a container of card moves between two zones
+void processContainer(CountingZone &from, CountingZone &to, int moveCount)
+{
+    ZoneLayoutBatch layoutBatch;
+    for (int i = 0; i < moveCount; ++i) {
+        from.moveCard();
+        to.moveCard();
+    }
+}
+
+TEST(ZoneLayoutBatchTest, LaysOutImmediatelyWithoutBatch)
+{
+    CountingZone zone;
+    ASSERT_FALSE(ZoneLayoutBatch::isActive());
+    zone.moveCard();
+    zone.moveCard();
+    ASSERT_EQ(zone.layouts, 2);
+}
+
+TEST(ZoneLayoutBatchTest, OneRelayoutPerZoneAndContainer)
+{
+    CountingZone table, graveyard, hand;
+    processContainer(table, graveyard, 30);
+    ASSERT_EQ(table.layouts, 1);
+    ASSERT_EQ(graveyard.layouts, 1);
+    ASSERT_EQ(hand.layouts, 0);
+
+    processContainer(hand, table, 7);
+    ASSERT_EQ(table.layouts, 2);
+    ASSERT_EQ(hand.layouts, 1);
+    ASSERT_FALSE(ZoneLayoutBatch::isActive());
+}
+
+TEST(ZoneLayoutBatchTest, NestedBatchesLayOutWhenTheOutermostEnds)
+{
+    CountingZone table, stack;
+    {
+        ZoneLayoutBatch outer;
+        table.moveCard();
+        {
+            ZoneLayoutBatch inner;
+            table.moveCard();
+            stack.moveCard();
+        }
+        ASSERT_EQ(table.layouts, 0);
+        ASSERT_EQ(stack.layouts, 0);
+    }
+    ASSERT_EQ(table.layouts, 1);
+    ASSERT_EQ(stack.layouts, 1);
+}
+
+TEST(ZoneLayoutBatchTest, LayoutsRequestedWhileFlushingJoinTheBatch)
+{
+    CountingZone table, hand;
+    table.dependent = &hand;
+    {
+        ZoneLayoutBatch layoutBatch;
+        table.moveCard();
+        hand.moveCard();
+    }
+    // the table asking for the hand while the batch ended doesn't lay it out a second time
+    ASSERT_EQ(hand.layouts, 1);
+    ASSERT_EQ(table.layouts, 1);
+
+    CountingZone stack;
+    hand.dependent = &stack;
+    processContainer(table, table, 3);
+    // requested by a zone laid out while the batch ended, after everything else was done
+    ASSERT_EQ(hand.layouts, 2);
+    ASSERT_EQ(stack.layouts, 1);
+    ASSERT_EQ(stack.getLayoutCount(), 1);
+    ASSERT_FALSE(ZoneLayoutBatch::isActive());
+}
+
+TEST(ZoneLayoutBatchTest, DeletedZonesAreNotLaidOut)
+{
+    CountingZone table;
+    {
+        ZoneLayoutBatch layoutBatch;
+        auto removed = std::make_unique<CountingZone>();
+        removed->moveCard();
+        table.moveCard();
+        // a player leaving in the middle of a container takes their zones along
+    }
+    ASSERT_EQ(table.layouts, 1);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -21,15 +21,20 @@ export class RoomPersistence {
   }
 
   static updateGames(roomId: number, gameList: Game[]) {
-    const game = gameList[0];
+    const room = RoomsSelectors.getRoom(store.getState(), roomId);
 
-    if (!game.gameType) {
-      const room = RoomsSelectors.getRoom(store.getState(), roomId);
+    if (room) {
+      const { gametypeMap } = room;
+      const knownGames = new Set(room.gameList.map(({ gameId }) => gameId));
 
-      if (room) {
-        const { gametypeMap } = room;
-        NormalizeService.normalizeGameObject(game, gametypeMap);
-      }
+      gameList.forEach(game => {
+        if (!knownGames.has(game.gameId)) {
+          NormalizeService.normalizeGameObject(game, gametypeMap);
+        } else if (game.gameTypes && game.gameTypes.length) {
+          // Updates for known games only carry the changed fields, so leave the missing ones alone
+          game.gameType = gametypeMap[game.gameTypes[0]];
+        }
+      });
     }
 
     RoomsDispatch.updateGames(roomId, gameList);